@@ -0,0 +1,82 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/nr-binary-trace-file.h"
+
+#include <fstream>
+#include <iostream>
+
+/**
+ * \file nr-binary-trace-to-csv.cc
+ * \ingroup examples
+ * \brief Offline converter of the binary traces of NrPhyRxTrace and
+ * NrMacRxTrace to CSV.
+ *
+ * With the attribute BinaryFormat of NrPhyRxTrace or NrMacRxTrace, the traces
+ * are written as fixed-width binary records into .bin files. This program
+ * converts such a file to CSV, with a first line of column names:
+ *
+ * ./ns3 run "nr-binary-trace-to-csv --input=RxPacketTrace.bin --output=RxPacketTrace.csv"
+ *
+ * Without an output file, the CSV is written to the standard output.
+ */
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "The binary trace file", input);
+    cmd.AddValue("output", "The CSV file, the standard output if empty", output);
+    cmd.Parse(argc, argv);
+
+    std::ifstream in(input.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cerr << "Could not open " << input << std::endl;
+        return 1;
+    }
+
+    bool converted;
+    if (output.empty())
+    {
+        converted = NrBinaryTraceFile::ConvertToCsv(in, std::cout);
+    }
+    else
+    {
+        std::ofstream out(output.c_str());
+        if (!out.is_open())
+        {
+            std::cerr << "Could not open " << output << std::endl;
+            return 1;
+        }
+        converted = NrBinaryTraceFile::ConvertToCsv(in, out);
+    }
+
+    if (!converted)
+    {
+        std::cerr << input << " is not a binary trace, or is truncated" << std::endl;
+        return 1;
+    }
+    return 0;
+}
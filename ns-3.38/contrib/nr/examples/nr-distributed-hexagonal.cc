@@ -0,0 +1,203 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-distributed-helper.h"
+#include "ns3/nr-module.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <iostream>
+
+/**
+ * \file nr-distributed-hexagonal.cc
+ * \ingroup examples
+ * \brief Distributed simulation of a hexagonal NR deployment
+ *
+ * The sites of a hexagonal grid with three sectors are distributed over the
+ * MPI ranks, each rank simulating the cells of its sites and their UEs (see
+ * HexagonalGridScenarioHelper::SetNumPartitions). The ranks exchange the
+ * interference between their cells through the NrDistributedHelper. The
+ * UEs have a full buffer in DL, without EPC, and every rank prints the mean
+ * DL SINR of its UEs.
+ *
+ * The example needs ns-3 configured with --enable-mpi, and runs on several
+ * processes of the same machine with:
+ *
+ * mpirun -np 4 ./ns3 run "nr-distributed-hexagonal --numRings=2"
+ *
+ * With a single process, it runs the same scenario sequentially.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("NrDistributedHexagonal");
+
+/**
+ * The DL SINR of the UEs of this rank
+ */
+struct SinrStats
+{
+    double m_sum{0.0};    //!< the sum of the SINR, linear
+    uint64_t m_count{0};  //!< the number of SINR values
+};
+
+/**
+ * Trace sink of NrUePhy::DlDataSinr
+ * \param stats the statistics
+ * \param cellId the cell id
+ * \param rnti the RNTI
+ * \param sinr the SINR, linear
+ * \param bwpId the BWP id
+ * \param streamId the stream id
+ */
+static void
+ReportSinr(SinrStats* stats,
+           uint16_t cellId,
+           uint16_t rnti,
+           double sinr,
+           uint16_t bwpId,
+           uint8_t streamId)
+{
+    stats->m_sum += sinr;
+    stats->m_count++;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numRings = 1;
+    uint32_t uesPerCell = 2;
+    uint16_t numerology = 1;
+    double centralFrequency = 3.5e9;
+    double bandwidth = 20e6;
+    double txPowerBs = 43;
+    Time simTime = MilliSeconds(500);
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numRings", "The number of outer rings of sites", numRings);
+    cmd.AddValue("uesPerCell", "The number of UEs per cell", uesPerCell);
+    cmd.AddValue("numerology", "The numerology of the BWP", numerology);
+    cmd.AddValue("centralFrequency", "The central frequency in Hz", centralFrequency);
+    cmd.AddValue("bandwidth", "The bandwidth in Hz", bandwidth);
+    cmd.AddValue("txPowerBs", "The TX power of the gNBs in dBm", txPowerBs);
+    cmd.AddValue("simTime", "The simulated time", simTime);
+    cmd.Parse(argc, argv);
+
+    MpiInterface::Enable(&argc, &argv);
+    if (MpiInterface::GetSize() > 1)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::DistributedSimulatorImpl"));
+    }
+    const uint32_t rank = MpiInterface::GetSystemId();
+
+    /*
+     * UMa sites with three sectors, distributed in contiguous groups over the
+     * ranks; every rank creates all the nodes.
+     */
+    HexagonalGridScenarioHelper scenario;
+    scenario.SetScenarioParameters("UMa");
+    scenario.SetNumRings(numRings);
+    const uint32_t numCells = scenario.GetNumSites() * 3;
+    scenario.SetUtNumber(numCells * uesPerCell);
+    scenario.SetNumPartitions(MpiInterface::GetSize());
+    scenario.CreateScenario();
+    const double sector0AngleRad = scenario.GetAntennaOrientationRadians(0);
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                         TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(centralFrequency,
+                                                   bandwidth,
+                                                   1,
+                                                   BandwidthPartInfo::UMa);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(numerology));
+    nrHelper->SetGnbPhyAttribute("TxPower", DoubleValue(txPowerBs));
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(8));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(1));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(1));
+
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(scenario.GetBaseStations(), allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(scenario.GetUserTerminals(), allBwps);
+
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    randomStream += nrHelper->AssignStreams(ueDevs, randomStream);
+
+    for (uint32_t cellId = 0; cellId < gnbDevs.GetN(); ++cellId)
+    {
+        Ptr<UniformPlanarArray> antenna = DynamicCast<UniformPlanarArray>(
+            nrHelper->GetGnbPhy(gnbDevs.Get(cellId), 0)->GetSpectrumPhy()->GetAntenna());
+        antenna->SetAttribute(
+            "BearingAngle",
+            DoubleValue(sector0AngleRad + scenario.GetSectorIndex(cellId) * 2.0 * M_PI / 3.0));
+    }
+
+    for (auto it = gnbDevs.Begin(); it != gnbDevs.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueDevs.Begin(); it != ueDevs.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    /*
+     * Every rank attaches all the UEs, so that the devices of the other ranks
+     * are configured as on their own rank, but only the local UEs connect.
+     */
+    SinrStats stats;
+    for (uint32_t ueId = 0; ueId < ueDevs.GetN(); ++ueId)
+    {
+        Ptr<NetDevice> ueDev = ueDevs.Get(ueId);
+        nrHelper->AttachToEnb(ueDev, gnbDevs.Get(scenario.GetCellIndex(ueId)));
+        if (ueDev->GetNode()->GetSystemId() == rank)
+        {
+            nrHelper->ActivateDataRadioBearer(ueDev, EpsBearer(EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+            nrHelper->GetUePhy(ueDev, 0)->TraceConnectWithoutContext(
+                "DlDataSinr",
+                MakeBoundCallback(&ReportSinr, &stats));
+        }
+    }
+
+    Ptr<NrDistributedHelper> distributedHelper = CreateObject<NrDistributedHelper>();
+    distributedHelper->Install(gnbDevs, ueDevs);
+
+    Simulator::Stop(simTime);
+    Simulator::Run();
+
+    std::cout << "Rank " << rank << " of " << MpiInterface::GetSize() << ": " << numCells
+              << " cells, mean DL SINR "
+              << (stats.m_count > 0 ? 10 * std::log10(stats.m_sum / stats.m_count) : 0.0)
+              << " dB over " << stats.m_count << " receptions" << std::endl;
+
+    Simulator::Destroy();
+    MpiInterface::Disable();
+    return 0;
+}
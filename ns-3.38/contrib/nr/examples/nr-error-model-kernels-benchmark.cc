@@ -0,0 +1,146 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/nr-eesm-ir-t1.h"
+#include "ns3/nr-error-model-kernels.h"
+#include "ns3/nr-lte-mi-error-model.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+/**
+ * \file nr-error-model-kernels-benchmark.cc
+ * \ingroup examples
+ * \brief Micro-benchmark of the error model evaluation with every instruction
+ * set of NrErrorModelKernels supported by the machine.
+ *
+ * A TB reception evaluates the error model once, and the AMC evaluates it for
+ * several MCSs of every CQI report. This program evaluates the EESM (HARQ-IR,
+ * table 1) and the MIESM error models for random SINRs over the given number
+ * of RBs, with the scalar kernels and with the vector ones, and prints the time
+ * per evaluation and the largest difference of the TBLER to the scalar kernels.
+ *
+ * ./ns3 run "nr-error-model-kernels-benchmark --numRbs=273 --evaluations=100000"
+ */
+
+using namespace ns3;
+
+/**
+ * Evaluate an error model for every SINR, with the MCS cycling through all MCSs
+ * \param errorModel the error model
+ * \param sinrs the SINRs
+ * \param rbs the allocated RBs
+ * \param evaluations the number of evaluations
+ * \param tbler the TBLER of every evaluation
+ * \return the time per evaluation in microseconds
+ */
+static double
+Evaluate(Ptr<NrErrorModel> errorModel,
+         const std::vector<SpectrumValue>& sinrs,
+         const std::vector<int>& rbs,
+         uint32_t evaluations,
+         std::vector<double>& tbler)
+{
+    tbler.clear();
+    uint8_t numMcs = errorModel->GetMaxMcs() + 1;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < evaluations; ++i)
+    {
+        uint8_t mcs = i % numMcs;
+        Ptr<NrErrorModelOutput> output =
+            errorModel->GetTbDecodificationStats(sinrs[i % sinrs.size()],
+                                                 rbs,
+                                                 100 * rbs.size() * (1 + mcs),
+                                                 mcs,
+                                                 NrErrorModel::NrErrorModelHistory());
+        tbler.push_back(output->m_tbler);
+    }
+    auto time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    return time.count() / evaluations;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numRbs = 273;
+    uint32_t evaluations = 100000;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numRbs", "Number of allocated RBs", numRbs);
+    cmd.AddValue("evaluations", "Number of error model evaluations", evaluations);
+    cmd.Parse(argc, argv);
+
+    std::vector<double> frequencies;
+    std::vector<int> rbs;
+    for (uint32_t rb = 0; rb < numRbs; ++rb)
+    {
+        frequencies.push_back(3.5e9 + rb * 360e3);
+        rbs.push_back(rb);
+    }
+    Ptr<const SpectrumModel> model = Create<SpectrumModel>(frequencies);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> sinrDb(-5.0, 30.0);
+    std::vector<SpectrumValue> sinrs;
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        SpectrumValue sinr(model);
+        for (uint32_t rb = 0; rb < numRbs; ++rb)
+        {
+            sinr[rb] = std::pow(10.0, sinrDb(rng) / 10.0);
+        }
+        sinrs.push_back(sinr);
+    }
+
+    std::cout << "Evaluations: " << evaluations << " with " << numRbs << " RBs" << std::endl;
+    for (Ptr<NrErrorModel> errorModel : {Ptr<NrErrorModel>(CreateObject<NrEesmIrT1>()),
+                                         Ptr<NrErrorModel>(CreateObject<NrLteMiErrorModel>())})
+    {
+        std::vector<double> scalarTbler;
+        for (auto isa : {NrErrorModelKernels::SCALAR,
+                         NrErrorModelKernels::AVX2,
+                         NrErrorModelKernels::AVX512})
+        {
+            if (!NrErrorModelKernels::IsSupported(isa))
+            {
+                continue;
+            }
+            NrErrorModelKernels::SetIsa(isa);
+            std::vector<double> tbler;
+            double time = Evaluate(errorModel, sinrs, rbs, evaluations, tbler);
+            double maxDiff = 0.0;
+            if (isa == NrErrorModelKernels::SCALAR)
+            {
+                scalarTbler = tbler;
+            }
+            for (uint32_t i = 0; i < tbler.size(); ++i)
+            {
+                maxDiff = std::max(maxDiff, std::abs(tbler[i] - scalarTbler[i]));
+            }
+            std::cout << errorModel->GetInstanceTypeId().GetName() << " "
+                      << NrErrorModelKernels::GetIsaName(isa) << ": " << time
+                      << " us per evaluation, max TBLER difference " << maxDiff << std::endl;
+        }
+    }
+
+    NrErrorModelKernels::SetIsa(NrErrorModelKernels::AUTO);
+    Simulator::Destroy();
+    return 0;
+}
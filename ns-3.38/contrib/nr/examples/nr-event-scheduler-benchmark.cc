@@ -0,0 +1,388 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+
+/**
+ * \file nr-event-scheduler-benchmark.cc
+ * \ingroup examples
+ * \brief Benchmark of the event schedulers of the simulator with the events
+ * of an NR simulation.
+ *
+ * The events of an NR simulation are mostly slotted: every PHY schedules the
+ * start of the next slot, the start and the end of the variable TTIs of the
+ * slot at symbol boundaries, and the MAC messages with the L1/L2 latency of a
+ * few slots. The applications and the HARQ timers add irregular events, and
+ * most of the timers are removed before they expire.
+ *
+ * This program generates such an event trace for the given number of gNBs
+ * and UEs, or reads it from a file, and replays it against every scheduler:
+ * before an event is inserted or removed, the events up to its insertion
+ * time are removed from the scheduler, as the simulator does. It prints the
+ * time of the replay and the scheduler operations per second. The scheduler
+ * of a simulation is chosen with the global value SchedulerType, e.g.
+ * --SchedulerType=ns3::TimingWheelScheduler.
+ *
+ * The trace file has one operation per line, with times in nanoseconds:
+ * "I <now> <timestamp>" inserts an event at the given time, "R <now> <line>"
+ * removes the event inserted at the given line (counted from 0), if it is
+ * still pending. A generated trace can be written with --writeTrace.
+ *
+ * ./ns3 run "nr-event-scheduler-benchmark --numerology=1 --gnbs=7 --uesPerGnb=10"
+ */
+
+using namespace ns3;
+
+/**
+ * An operation of the trace
+ */
+struct TraceOperation
+{
+    uint64_t m_now;     //!< the simulation time of the operation, in nanoseconds
+    uint64_t m_ts;      //!< the timestamp of the inserted event, in nanoseconds
+    int64_t m_removeOf; //!< the operation of the removed event, -1 for an insertion
+};
+
+/**
+ * Generate the event trace of slotted PHYs and their MAC, applications and
+ * HARQ timers
+ * \param numPhys the number of PHYs
+ * \param slotNs the slot duration in nanoseconds
+ * \param durationNs the duration of the trace in nanoseconds
+ * \param appIntervalNs the mean interval between the packets of a PHY
+ * \param bler the probability that a HARQ timer is not removed by the feedback
+ * \return the trace
+ */
+static std::vector<TraceOperation>
+GenerateNrTrace(uint32_t numPhys,
+                uint64_t slotNs,
+                uint64_t durationNs,
+                double appIntervalNs,
+                double bler)
+{
+    enum Kind
+    {
+        SLOT,
+        VAR_TTI_START,
+        VAR_TTI_END,
+        MAC,
+        APP,
+        FEEDBACK,
+        OTHER
+    };
+
+    struct Pending
+    {
+        uint64_t m_ts;
+        uint64_t m_op;
+        Kind m_kind;
+        uint32_t m_phy;
+        int64_t m_timer;
+
+        bool operator>(const Pending& o) const
+        {
+            return m_ts > o.m_ts || (m_ts == o.m_ts && m_op > o.m_op);
+        }
+    };
+
+    std::vector<TraceOperation> trace;
+    std::vector<bool> fired;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending;
+    std::mt19937_64 rng(1);
+    std::exponential_distribution<double> appInterval(1.0 / appIntervalNs);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const uint64_t symbolNs = slotNs / 14;
+    const uint64_t l1l2Ns = 2 * slotNs;
+
+    auto insert = [&](uint64_t now, uint64_t ts, Kind kind, uint32_t phy, int64_t timer) {
+        pending.push({ts, trace.size(), kind, phy, timer});
+        trace.push_back({now, ts, -1});
+        fired.push_back(false);
+        return static_cast<int64_t>(trace.size() - 1);
+    };
+
+    for (uint32_t phy = 0; phy < numPhys; ++phy)
+    {
+        insert(0, 0, SLOT, phy, -1);
+        insert(0, static_cast<uint64_t>(appInterval(rng)), APP, phy, -1);
+    }
+
+    while (!pending.empty())
+    {
+        Pending ev = pending.top();
+        pending.pop();
+        fired[ev.m_op] = true;
+        uint64_t now = ev.m_ts;
+        switch (ev.m_kind)
+        {
+        case SLOT: {
+            if (now + slotNs < durationNs)
+            {
+                insert(now, now + slotNs, SLOT, ev.m_phy, -1);
+            }
+            // DL CTRL, a few data var TTIs and UL CTRL over the 14 symbols
+            uint32_t symbol = 0;
+            while (symbol < 14)
+            {
+                uint32_t length = symbol == 0 || symbol == 13 ? 1 : 1 + rng() % (13 - symbol);
+                insert(now, now + symbol * symbolNs, VAR_TTI_START, ev.m_phy, -1);
+                insert(now, now + (symbol + length) * symbolNs, VAR_TTI_END, ev.m_phy, -1);
+                symbol += length;
+            }
+            // the MAC of the slot after the L1/L2 latency
+            insert(now, now + l1l2Ns, MAC, ev.m_phy, -1);
+            break;
+        }
+        case VAR_TTI_END: {
+            if (uniform(rng) < 0.5)
+            {
+                // a transport block: the HARQ timer and the feedback
+                int64_t timer =
+                    insert(now, now + 10 * slotNs + rng() % slotNs, OTHER, ev.m_phy, -1);
+                insert(now, now + l1l2Ns + symbolNs, FEEDBACK, ev.m_phy, timer);
+            }
+            break;
+        }
+        case FEEDBACK: {
+            if (uniform(rng) >= bler && !fired[ev.m_timer])
+            {
+                trace.push_back({now, 0, ev.m_timer});
+                fired.push_back(true);
+                // the timer does not fire anymore
+                fired[ev.m_timer] = true;
+            }
+            break;
+        }
+        case APP: {
+            uint64_t next = now + static_cast<uint64_t>(appInterval(rng));
+            if (next < durationNs)
+            {
+                insert(now, next, APP, ev.m_phy, -1);
+            }
+            // the delivery of the packet, a few milliseconds later
+            insert(now, now + 500000 + rng() % 5000000, OTHER, ev.m_phy, -1);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    return trace;
+}
+
+/**
+ * Read a trace file
+ * \param fileName the name of the file
+ * \param trace the trace
+ * \return false if the file cannot be read
+ */
+static bool
+ReadTrace(const std::string& fileName, std::vector<TraceOperation>& trace)
+{
+    std::ifstream in(fileName.c_str());
+    if (!in.is_open())
+    {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        char op;
+        TraceOperation operation;
+        uint64_t value;
+        if (!(fields >> op >> operation.m_now >> value))
+        {
+            continue;
+        }
+        if (op == 'I')
+        {
+            operation.m_ts = value;
+            operation.m_removeOf = -1;
+        }
+        else if (op == 'R' && value < trace.size())
+        {
+            operation.m_ts = 0;
+            operation.m_removeOf = static_cast<int64_t>(value);
+        }
+        else
+        {
+            return false;
+        }
+        trace.push_back(operation);
+    }
+    return true;
+}
+
+/**
+ * Write a trace file
+ * \param fileName the name of the file
+ * \param trace the trace
+ */
+static void
+WriteTrace(const std::string& fileName, const std::vector<TraceOperation>& trace)
+{
+    std::ofstream out(fileName.c_str());
+    for (const auto& operation : trace)
+    {
+        if (operation.m_removeOf < 0)
+        {
+            out << "I " << operation.m_now << " " << operation.m_ts << "\n";
+        }
+        else
+        {
+            out << "R " << operation.m_now << " " << operation.m_removeOf << "\n";
+        }
+    }
+}
+
+/**
+ * Replay a trace against a scheduler
+ * \param scheduler the scheduler
+ * \param trace the trace
+ * \param operations the number of scheduler operations
+ * \return the time of the replay in seconds
+ */
+static double
+Replay(Ptr<Scheduler> scheduler, const std::vector<TraceOperation>& trace, uint64_t& operations)
+{
+    std::vector<Scheduler::Event> events(trace.size());
+    std::vector<bool> inScheduler(trace.size(), false);
+    operations = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < trace.size(); ++i)
+    {
+        const TraceOperation& operation = trace[i];
+        uint64_t now = static_cast<uint64_t>(NanoSeconds(operation.m_now).GetTimeStep());
+        while (!scheduler->IsEmpty() && scheduler->PeekNext().key.m_ts <= now)
+        {
+            inScheduler[scheduler->RemoveNext().key.m_uid] = false;
+            operations++;
+        }
+        if (operation.m_removeOf < 0)
+        {
+            Scheduler::Event& ev = events[i];
+            ev.impl = nullptr;
+            ev.key.m_ts =
+                std::max(static_cast<uint64_t>(NanoSeconds(operation.m_ts).GetTimeStep()), now);
+            ev.key.m_uid = i;
+            ev.key.m_context = 0;
+            scheduler->Insert(ev);
+            inScheduler[i] = true;
+        }
+        else if (inScheduler[operation.m_removeOf])
+        {
+            scheduler->Remove(events[operation.m_removeOf]);
+            inScheduler[operation.m_removeOf] = false;
+        }
+        operations++;
+    }
+    while (!scheduler->IsEmpty())
+    {
+        scheduler->RemoveNext();
+        operations++;
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint16_t numerology = 1;
+    uint32_t gnbs = 7;
+    uint32_t uesPerGnb = 10;
+    double simTime = 2.0;
+    double appInterval = 0.001;
+    double bler = 0.1;
+    uint32_t runs = 3;
+    std::string traceFile;
+    std::string writeTrace;
+    std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::CalendarScheduler,"
+                             "ns3::PriorityQueueScheduler,ns3::TimingWheelScheduler";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numerology", "The numerology of the generated trace", numerology);
+    cmd.AddValue("gnbs", "The number of gNBs of the generated trace", gnbs);
+    cmd.AddValue("uesPerGnb", "The number of UEs per gNB of the generated trace", uesPerGnb);
+    cmd.AddValue("simTime", "The duration of the generated trace in seconds", simTime);
+    cmd.AddValue("appInterval",
+                 "The mean interval between packets of a node in seconds",
+                 appInterval);
+    cmd.AddValue("bler", "The probability that a HARQ timer expires", bler);
+    cmd.AddValue("traceFile", "Replay this trace file instead of a generated trace", traceFile);
+    cmd.AddValue("writeTrace", "Write the generated trace to this file", writeTrace);
+    cmd.AddValue("schedulers", "Comma-separated TypeIds of the schedulers", schedulers);
+    cmd.AddValue("runs", "The number of replays per scheduler", runs);
+    cmd.Parse(argc, argv);
+
+    uint64_t slotNs = 1000000 >> numerology;
+    std::vector<TraceOperation> trace;
+    if (!traceFile.empty())
+    {
+        if (!ReadTrace(traceFile, trace))
+        {
+            std::cerr << "Could not read the trace " << traceFile << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        trace = GenerateNrTrace(gnbs * (1 + uesPerGnb),
+                                slotNs,
+                                static_cast<uint64_t>(simTime * 1e9),
+                                appInterval * 1e9,
+                                bler);
+        if (!writeTrace.empty())
+        {
+            WriteTrace(writeTrace, trace);
+        }
+    }
+
+    std::cout << "Trace of " << trace.size() << " operations" << std::endl;
+    std::istringstream names(schedulers);
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        ObjectFactory factory(name);
+        if (name == "ns3::TimingWheelScheduler")
+        {
+            factory.Set("Granularity", TimeValue(NanoSeconds(slotNs)));
+        }
+        double best = 0.0;
+        uint64_t operations = 0;
+        for (uint32_t run = 0; run < runs; ++run)
+        {
+            double time = Replay(factory.Create<Scheduler>(), trace, operations);
+            best = run == 0 ? time : std::min(best, time);
+        }
+        std::cout << name << ": " << best << " s, " << operations / best
+                  << " operations per second" << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,120 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/nr-mac-scheduler-ressource-manager.h"
+
+#include <chrono>
+#include <iostream>
+
+/**
+ * \file nr-ressource-grid-benchmark.cc
+ * \ingroup examples
+ * \brief Micro-benchmark of the per-slot read access of the RedCap ressource manager.
+ *
+ * The schedulers read the allocations of every slot and BWP through
+ * NrMacSchedulerRessourceManager::getSlotRessources. This program measures
+ * the cost of one such access with the zero-copy slot view, and the cost of
+ * the deep copy into nested std::vectors that was returned before.
+ *
+ * With numerology 1 and 12 RedCap BWPs there are 2000 slots * 12 BWPs = 24000
+ * accesses per simulated second. To run it with the default configuration:
+ *
+ * ./ns3 run "nr-ressource-grid-benchmark --bwpCount=14 --slots=20000"
+ */
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint16_t bwpCount = 14;
+    uint32_t slots = 20000;
+    std::string pattern = "DL|DL|S|UL|UL|UL|UL|UL|UL|UL|";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("bwpCount", "Number of BWPs (the last two span the whole bandwidth)", bwpCount);
+    cmd.AddValue("slots", "Number of slots to read", slots);
+    cmd.AddValue("tddPattern", "TDD pattern of the ressource manager", pattern);
+    cmd.Parse(argc, argv);
+
+    const uint8_t numerology = 1;
+    NrMacSchedulerRessourceManager manager(pattern, numerology, 1, 0, "", bwpCount, false);
+    for (uint16_t bwp = 0; bwp < bwpCount; ++bwp)
+    {
+        uint16_t bwInRbg = bwp < bwpCount - 2 ? 51 : 51 * (bwpCount - 2);
+        manager.configureBwp(bwp, bwInRbg, 1);
+    }
+
+    uint64_t viewSum = 0;
+    auto start = std::chrono::steady_clock::now();
+    SfnSf sfn(0, 0, 0, numerology);
+    for (uint32_t slot = 0; slot < slots; ++slot, sfn.Add(1))
+    {
+        for (uint16_t bwp = 0; bwp < bwpCount; ++bwp)
+        {
+            NrMacSchedulerSlotView view = manager.getSlotRessources(bwp, sfn, LteNrTddSlotType::UL);
+            for (size_t sym = 0; sym < view.size(); ++sym)
+            {
+                for (uint16_t rb = 0; rb < view.GetNumRb(); ++rb)
+                {
+                    viewSum += view[sym][rb] != 0;
+                }
+            }
+        }
+    }
+    auto viewTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    uint64_t copySum = 0;
+    start = std::chrono::steady_clock::now();
+    sfn = SfnSf(0, 0, 0, numerology);
+    for (uint32_t slot = 0; slot < slots; ++slot, sfn.Add(1))
+    {
+        for (uint16_t bwp = 0; bwp < bwpCount; ++bwp)
+        {
+            // what the schedulers got before: a fresh nested copy of the slot
+            NrMacSchedulerSlotView view = manager.getSlotRessources(bwp, sfn, LteNrTddSlotType::UL);
+            std::vector<std::vector<int>> slotRes(view.size(), std::vector<int>(view.GetNumRb(), 0));
+            for (size_t sym = 0; sym < view.size(); ++sym)
+            {
+                for (uint16_t rb = 0; rb < view.GetNumRb(); ++rb)
+                {
+                    slotRes[sym][rb] = view[sym][rb];
+                }
+            }
+            for (size_t sym = 0; sym < slotRes.size(); ++sym)
+            {
+                for (uint16_t rb = 0; rb < slotRes[sym].size(); ++rb)
+                {
+                    copySum += slotRes[sym][rb] != 0;
+                }
+            }
+        }
+    }
+    auto copyTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    NS_ABORT_MSG_IF(viewSum != copySum, "Slot view and copy differ");
+
+    uint64_t accesses = static_cast<uint64_t>(slots) * bwpCount;
+    std::cout << "Slot accesses: " << accesses << std::endl;
+    std::cout << "Slot view:   " << viewTime.count() / accesses << " us per slot and BWP" << std::endl;
+    std::cout << "Nested copy: " << copyTime.count() / accesses << " us per slot and BWP" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
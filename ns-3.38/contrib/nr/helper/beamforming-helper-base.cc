@@ -51,7 +51,16 @@ BeamformingHelperBase::RunTask(const Ptr<NrGnbNetDevice>& gNbDev,
     NS_LOG_INFO(" Run beamforming task for gNB:" << gNbDev->GetNode()->GetId()
                                                  << " and UE:" << ueDev->GetNode()->GetId());
     BeamformingVectorPair bfPair = GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+    ApplyBeamformingVectors(gNbDev, ueDev, gnbSpectrumPhy, ueSpectrumPhy, bfPair);
+}
 
+void
+BeamformingHelperBase::ApplyBeamformingVectors(const Ptr<NrGnbNetDevice>& gNbDev,
+                                               const Ptr<NrUeNetDevice>& ueDev,
+                                               const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                               const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                               const BeamformingVectorPair& bfPair) const
+{
     NS_ASSERT(bfPair.first.first.GetSize() && bfPair.second.first.GetSize());
     gnbSpectrumPhy->GetBeamManager()->SaveBeamformingVector(bfPair.first, ueDev);
     ueSpectrumPhy->GetBeamManager()->SaveBeamformingVector(bfPair.second, gNbDev);
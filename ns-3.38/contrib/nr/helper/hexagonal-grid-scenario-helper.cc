@@ -374,13 +374,39 @@ HexagonalGridScenarioHelper::GetHexagonalCellCenter(const Vector& sitePos, uint1
     return center;
 }
 
+void
+HexagonalGridScenarioHelper::SetNumPartitions(uint32_t numPartitions)
+{
+    NS_ABORT_MSG_IF(numPartitions == 0, "At least one partition is needed");
+    m_numPartitions = numPartitions;
+}
+
+uint32_t
+HexagonalGridScenarioHelper::GetPartition(std::size_t cellId) const
+{
+    // the sites are numbered ring by ring, so that groups of consecutive sites are neighbours
+    return static_cast<uint32_t>(GetSiteIndex(cellId) * m_numPartitions / GetNumSites());
+}
+
+void
+HexagonalGridScenarioHelper::CreateNodes()
+{
+    for (std::size_t cellId = 0; cellId < m_numBs; ++cellId)
+    {
+        m_bs.Add(CreateObject<Node>(GetPartition(cellId)));
+    }
+    for (std::size_t utId = 0; utId < m_numUt; ++utId)
+    {
+        m_ut.Add(CreateObject<Node>(GetPartition(GetCellIndex(utId))));
+    }
+}
+
 void
 HexagonalGridScenarioHelper::CreateScenario()
 {
     m_hexagonalRadius = m_isd / 3;
 
-    m_bs.Create(m_numBs);
-    m_ut.Create(m_numUt);
+    CreateNodes();
 
     NS_ASSERT(m_isd > 0);
     NS_ASSERT(m_numRings < 6);
@@ -478,8 +504,7 @@ HexagonalGridScenarioHelper::CreateScenarioWithMobility(const Vector& speed, dou
 {
     m_hexagonalRadius = m_isd / 3;
 
-    m_bs.Create(m_numBs);
-    m_ut.Create(m_numUt);
+    CreateNodes();
 
     NS_ASSERT(m_isd > 0);
     NS_ASSERT(m_numRings < 6);
@@ -114,7 +114,31 @@ class HexagonalGridScenarioHelper : public NodeDistributionScenarioInterface
      */
     void SetMaxUeDistanceToClosestSite(double maxUeDistanceToClosestSite);
 
+    /**
+     * \brief Sets the number of processes of a distributed simulation
+     *
+     * The sites are split into numPartitions groups of neighbouring sites.
+     * The nodes of the gNBs of a group, and of the UEs placed in their cells,
+     * are created with the system id of the group, which is the MPI rank that
+     * simulates them. See NrDistributedHelper. The default, 1, creates every
+     * node with system id 0.
+     * \param numPartitions the number of processes
+     */
+    void SetNumPartitions(uint32_t numPartitions);
+
+    /**
+     * \brief Gets the process of a distributed simulation that simulates a cell
+     * \param cellId Cell index
+     * \return the system id of the nodes of the cell
+     */
+    uint32_t GetPartition(std::size_t cellId) const;
+
   private:
+    /**
+     * \brief Create the gNB and UE nodes, with the system id of their cell
+     */
+    void CreateNodes();
+
     uint8_t m_numRings{0}; //!< Number of outer rings of sites around the central site
     Vector m_centralPos{Vector(0, 0, 0)}; //!< Central site position
     double m_hexagonalRadius{0.0};        //!< Cell radius
@@ -130,6 +154,7 @@ class HexagonalGridScenarioHelper : public NodeDistributionScenarioInterface
 
     std::string m_resultsDir; //!< results directory for the gnuplot file
     std::string m_simTag;     //!< simTag for the gnuplot file
+    uint32_t m_numPartitions{1}; //!< number of processes of a distributed simulation
 };
 
 } // namespace ns3
@@ -7,14 +7,20 @@
 #include "ideal-beamforming-helper.h"
 
 #include <ns3/beam-manager.h>
+#include <ns3/boolean.h>
 #include <ns3/ideal-beamforming-algorithm.h>
 #include <ns3/log.h>
+#include <ns3/mobility-model.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <ns3/nr-gnb-phy.h>
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/nr-ue-phy.h>
 #include <ns3/object-factory.h>
+#include <ns3/thread-pool.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
 #include <ns3/vector.h>
 
 namespace ns3
@@ -24,6 +30,7 @@ NS_LOG_COMPONENT_DEFINE("IdealBeamformingHelper");
 NS_OBJECT_ENSURE_REGISTERED(IdealBeamformingHelper);
 
 IdealBeamformingHelper::IdealBeamformingHelper()
+    : m_incrementalUpdate(true)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -43,6 +50,24 @@ IdealBeamformingHelper::DoInitialize()
     BeamformingHelperBase::DoInitialize();
 }
 
+void
+IdealBeamformingHelper::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& mobility : m_trackedMobility)
+    {
+        mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&IdealBeamformingHelper::CourseChange, this));
+    }
+    m_trackedMobility.clear();
+    m_movedMobility.clear();
+    m_searchedChannel.clear();
+    m_spectrumPhyPairToDevicePair.clear();
+    m_threadPool.reset();
+    BeamformingHelperBase::DoDispose();
+}
+
 TypeId
 IdealBeamformingHelper::GetTypeId()
 {
@@ -62,7 +87,21 @@ IdealBeamformingHelper::GetTypeId()
                           TimeValue(MilliSeconds(100)),
                           MakeTimeAccessor(&IdealBeamformingHelper::SetPeriodicity,
                                            &IdealBeamformingHelper::GetPeriodicity),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("IncrementalUpdate",
+                          "If true, at each period only the beams of the pairs of devices which "
+                          "moved, or whose channel matrix was regenerated, are searched again. "
+                          "If false, the beams of all the pairs are searched again.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&IdealBeamformingHelper::m_incrementalUpdate),
+                          MakeBooleanChecker())
+            .AddAttribute("NumThreads",
+                          "Number of threads searching the beams of a period. The searches are "
+                          "prepared and their beams saved in the simulation thread in the order "
+                          "of the pairs, so the results do not depend on this value.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&IdealBeamformingHelper::SetNumThreads),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -89,25 +128,159 @@ IdealBeamformingHelper::AddBeamformingTask(const Ptr<NrGnbNetDevice>& gnbDev,
             Ptr<NrSpectrumPhy> gnbSpectrumPhy = gnbDev->GetPhy(ccId)->GetSpectrumPhy(arrayIndex);
             Ptr<NrSpectrumPhy> ueSpectrumPhy = ueDev->GetPhy(ccId)->GetSpectrumPhy(arrayIndex);
 
-            m_spectrumPhyPairToDevicePair[std::make_pair(gnbSpectrumPhy, ueSpectrumPhy)] =
-                std::make_pair(gnbDev, ueDev);
+            SpectrumPhyPair phys = std::make_pair(gnbSpectrumPhy, ueSpectrumPhy);
+            m_spectrumPhyPairToDevicePair[phys] = std::make_pair(gnbDev, ueDev);
+
+            for (const auto& mobility :
+                 {gnbSpectrumPhy->GetMobility(), ueSpectrumPhy->GetMobility()})
+            {
+                if (m_trackedMobility.insert(mobility).second)
+                {
+                    mobility->TraceConnectWithoutContext(
+                        "CourseChange",
+                        MakeCallback(&IdealBeamformingHelper::CourseChange, this));
+                }
+            }
 
             RunTask(gnbDev, ueDev, gnbSpectrumPhy, ueSpectrumPhy);
+            if (m_beamformingAlgorithm->DependsOnChannel())
+            {
+                m_searchedChannel[phys] = GetChannelMatrix(phys);
+            }
         }
     }
 }
 
 void
-IdealBeamformingHelper::Run() const
+IdealBeamformingHelper::Run()
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO("Running the beamforming method. There are :"
                 << m_spectrumPhyPairToDevicePair.size() << " tasks.");
+    if (m_spectrumPhyPairToDevicePair.empty())
+    {
+        return;
+    }
+
+    // prepare the searches in the simulation thread, in the order of the pairs
+    const bool dependsOnChannel = m_beamformingAlgorithm->DependsOnChannel();
+    std::vector<std::map<SpectrumPhyPair, DevicePair>::const_iterator> tasks;
+    std::vector<std::unique_ptr<BeamSearchTask>> searches;
+    for (auto it = m_spectrumPhyPairToDevicePair.cbegin();
+         it != m_spectrumPhyPairToDevicePair.cend();
+         ++it)
+    {
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix;
+        if (dependsOnChannel)
+        {
+            channelMatrix = GetChannelMatrix(it->first);
+        }
+        if (!NeedsUpdate(it->first, channelMatrix))
+        {
+            continue;
+        }
+        if (dependsOnChannel)
+        {
+            m_searchedChannel[it->first] = channelMatrix;
+        }
+        tasks.push_back(it);
+        searches.push_back(m_beamformingAlgorithm->PrepareBeamSearch(it->first.first,
+                                                                     it->first.second));
+    }
+    m_movedMobility.clear();
+    NS_LOG_INFO("Searching the beams of " << searches.size() << " tasks.");
+
+    // the searches only use what they were given when prepared
+    std::vector<BeamformingVectorPair> bfPairs(searches.size());
+    auto runSearches = [&searches, &bfPairs](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            bfPairs[i] = searches[i]->Run();
+        }
+    };
+    if (m_threadPool && searches.size() > 1)
+    {
+        m_threadPool->ParallelFor(searches.size(), runSearches);
+    }
+    else
+    {
+        runSearches(0, searches.size());
+    }
 
-    for (const auto& task : m_spectrumPhyPairToDevicePair)
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+    {
+        const auto& task = *tasks[i];
+        NS_LOG_INFO(" Run beamforming task for gNB:"
+                    << task.second.first->GetNode()->GetId()
+                    << " and UE:" << task.second.second->GetNode()->GetId());
+        ApplyBeamformingVectors(task.second.first,
+                                task.second.second,
+                                task.first.first,
+                                task.first.second,
+                                bfPairs[i]);
+    }
+}
+
+void
+IdealBeamformingHelper::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_threadPool.reset(numThreads > 1 ? new ThreadPool(numThreads) : nullptr);
+}
+
+void
+IdealBeamformingHelper::CourseChange(Ptr<const MobilityModel> mobility)
+{
+    m_movedMobility.insert(mobility);
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelMatrix>
+IdealBeamformingHelper::GetChannelMatrix(const SpectrumPhyPair& phys) const
+{
+    Ptr<const ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<const ThreeGppSpectrumPropagationLossModel>(
+            phys.first->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel());
+    if (threeGppSplm == nullptr)
+    {
+        return nullptr;
+    }
+    // the same call as the algorithm, which regenerates the channel if it is outdated
+    return threeGppSplm->GetChannelModel()->GetChannel(
+        phys.first->GetMobility(),
+        phys.second->GetMobility(),
+        phys.first->GetAntenna()->GetObject<PhasedArrayModel>(),
+        phys.second->GetAntenna()->GetObject<PhasedArrayModel>());
+}
+
+bool
+IdealBeamformingHelper::NeedsUpdate(
+    const SpectrumPhyPair& phys,
+    const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix) const
+{
+    if (!m_incrementalUpdate)
+    {
+        return true;
+    }
+    for (const auto& mobility : {phys.first->GetMobility(), phys.second->GetMobility()})
+    {
+        if (m_movedMobility.count(mobility) != 0)
+        {
+            return true;
+        }
+        Vector velocity = mobility->GetVelocity();
+        if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+        {
+            // the position changes without a course change
+            return true;
+        }
+    }
+    if (!m_beamformingAlgorithm->DependsOnChannel())
     {
-        RunTask(task.second.first, task.second.second, task.first.first, task.first.second);
+        return false;
     }
+    auto it = m_searchedChannel.find(phys);
+    return channelMatrix == nullptr || it == m_searchedChannel.end() ||
+           it->second != channelMatrix;
 }
 
 BeamformingVectorPair
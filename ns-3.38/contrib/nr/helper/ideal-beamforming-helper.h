@@ -8,8 +8,12 @@
 
 #include "ns3/event-id.h"
 #include <ns3/beamforming-vector.h>
+#include <ns3/matrix-based-channel-model.h>
 #include <ns3/nstime.h>
 
+#include <memory>
+#include <set>
+
 #ifndef SRC_NR_HELPER_IDEAL_BEAMFORMING_HELPER_H_
 #define SRC_NR_HELPER_IDEAL_BEAMFORMING_HELPER_H_
 
@@ -19,10 +23,22 @@ namespace ns3
 class NrGnbNetDevice;
 class NrUeNetDevice;
 class IdealBeamformingAlgorithm;
+class MobilityModel;
+class ThreadPool;
 
 /**
  * \ingroup helper
  * \brief The IdealBeamformingHelper class
+ *
+ * At each period, the beams of a pair of devices are searched again only if
+ * they may have changed: one of the devices had a course change or has a
+ * velocity, or, for the algorithms depending on the channel, the channel
+ * matrix of the pair was regenerated (or is not a 3GPP one). The attribute
+ * IncrementalUpdate disables this, and searches all the pairs again.
+ *
+ * The searches of a period are prepared in the simulation thread, run on
+ * NumThreads threads, and their beams saved in the simulation thread, in the
+ * order of the pairs, so the results do not depend on the number of threads.
  */
 class IdealBeamformingHelper : public BeamformingHelperBase
 {
@@ -60,9 +76,17 @@ class IdealBeamformingHelper : public BeamformingHelperBase
     Time GetPeriodicity() const;
 
     /**
-     * \brief Run beamforming task
+     * \brief Run the beamforming tasks of the pairs whose beams may have
+     * changed since the last run
+     */
+    virtual void Run();
+
+    /**
+     * \brief Set the number of threads searching the beams of a period
+     * \param numThreads the number of threads, 1 searches them in the
+     * simulation thread
      */
-    virtual void Run() const;
+    void SetNumThreads(uint32_t numThreads);
 
     /**
      * \brief Specify among which devices the beamforming algorithm should be
@@ -76,6 +100,7 @@ class IdealBeamformingHelper : public BeamformingHelperBase
   protected:
     // inherited from Object
     void DoInitialize() override;
+    void DoDispose() override;
 
     /**
      * \brief The beamforming timer has expired; at the next slot, perform beamforming.
@@ -99,6 +124,36 @@ class IdealBeamformingHelper : public BeamformingHelperBase
         DevicePair; //!< The list of beamforming tasks to be executed
 
     std::map<SpectrumPhyPair, DevicePair> m_spectrumPhyPairToDevicePair;
+
+  private:
+    /**
+     * \brief Mark a mobility model as moved since the last run
+     * \param mobility the mobility model
+     */
+    void CourseChange(Ptr<const MobilityModel> mobility);
+
+    /**
+     * \param phys the spectrum phys of the pair
+     * \return the channel matrix of the pair, or nullptr if the channel is not
+     * a 3GPP one
+     */
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> GetChannelMatrix(
+        const SpectrumPhyPair& phys) const;
+
+    /**
+     * \param phys the spectrum phys of the pair
+     * \param channelMatrix the current channel matrix of the pair, or nullptr
+     * \return true if the beams of the pair have to be searched again
+     */
+    bool NeedsUpdate(const SpectrumPhyPair& phys,
+                     const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix) const;
+
+    bool m_incrementalUpdate; //!< search only the pairs whose beams may have changed
+    std::map<SpectrumPhyPair, Ptr<const MatrixBasedChannelModel::ChannelMatrix>>
+        m_searchedChannel; //!< the channel matrix of the last search of each pair
+    std::set<Ptr<MobilityModel>> m_trackedMobility; //!< mobility models connected to CourseChange
+    std::set<Ptr<const MobilityModel>> m_movedMobility; //!< course changes since the last run
+    std::unique_ptr<ThreadPool> m_threadPool; //!< workers, if more than one thread is used
 };
 
 }; // namespace ns3
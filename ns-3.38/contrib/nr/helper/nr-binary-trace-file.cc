@@ -0,0 +1,468 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nr-binary-trace-file.h"
+
+#include <ns3/abort.h>
+#include <ns3/assert.h>
+#include <ns3/log.h>
+#include <ns3/nr-control-messages.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrBinaryTraceFile");
+
+static const char NR_BINARY_TRACE_MAGIC[] = {'N', 'R', 'B', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t NR_BINARY_TRACE_VERSION = 1;
+
+/**
+ * \brief Write a value of the header
+ * \param file the file
+ * \param value the value
+ */
+template <class T>
+static void
+WriteHeaderValue(std::ofstream& file, T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * \brief Write a string of the header, preceded by its length
+ * \param file the file
+ * \param value the string
+ */
+static void
+WriteHeaderString(std::ofstream& file, const std::string& value)
+{
+    NS_ABORT_MSG_IF(value.size() > std::numeric_limits<uint16_t>::max(),
+                    "Too long string in a binary trace header");
+    WriteHeaderValue<uint16_t>(file, value.size());
+    file.write(value.data(), value.size());
+}
+
+/**
+ * \brief Read a value of the header
+ * \param in the input
+ * \param value the value
+ * \return false if the input is truncated
+ */
+template <class T>
+static bool
+ReadHeaderValue(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/**
+ * \brief Read a string of the header, preceded by its length
+ * \param in the input
+ * \param value the string
+ * \return false if the input is truncated
+ */
+static bool
+ReadHeaderString(std::istream& in, std::string& value)
+{
+    uint16_t size = 0;
+    if (!ReadHeaderValue(in, size))
+    {
+        return false;
+    }
+    value.resize(size);
+    return size == 0 || static_cast<bool>(in.read(&value[0], size));
+}
+
+NrBinaryTraceFile::NrBinaryTraceFile(const std::string& fileName,
+                                     const std::vector<Field>& fields,
+                                     uint32_t bufferSize,
+                                     bool asyncWrite)
+    : m_fields(fields),
+      m_asyncWrite(asyncWrite)
+{
+    NS_LOG_FUNCTION(this << fileName << bufferSize << asyncWrite);
+    NS_ABORT_MSG_IF(fields.empty(), "A binary trace needs at least one field");
+    for (const auto& field : m_fields)
+    {
+        NS_ABORT_MSG_IF(field.m_type == LABEL && (field.m_labels.empty() ||
+                                                  field.m_labels.size() > UINT8_MAX + 1),
+                        "The label field " << field.m_name << " needs 1 to 256 labels");
+        m_recordSize += GetSize(field.m_type);
+    }
+
+    m_file.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Could not open tracefile " << fileName);
+    }
+
+    m_file.write(NR_BINARY_TRACE_MAGIC, sizeof(NR_BINARY_TRACE_MAGIC));
+    WriteHeaderValue<uint32_t>(m_file, NR_BINARY_TRACE_VERSION);
+    WriteHeaderValue<uint32_t>(m_file, m_fields.size());
+    for (const auto& field : m_fields)
+    {
+        WriteHeaderValue<uint8_t>(m_file, field.m_type);
+        WriteHeaderString(m_file, field.m_name);
+        if (field.m_type == LABEL)
+        {
+            WriteHeaderValue<uint16_t>(m_file, field.m_labels.size());
+            for (const auto& label : field.m_labels)
+            {
+                WriteHeaderString(m_file, label);
+            }
+        }
+    }
+
+    // a record never crosses the end of the buffer
+    bufferSize = std::max(bufferSize, m_recordSize);
+    bufferSize -= bufferSize % m_recordSize;
+    m_buffer.resize(bufferSize);
+    if (m_asyncWrite)
+    {
+        m_pending.resize(bufferSize);
+        m_writer = std::thread(&NrBinaryTraceFile::WriterLoop, this);
+    }
+}
+
+NrBinaryTraceFile::~NrBinaryTraceFile()
+{
+    NS_LOG_FUNCTION(this);
+    // drop a partially added record
+    m_bufferUsed = m_recordStart;
+    Flush();
+    if (m_asyncWrite)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_closing = true;
+        }
+        m_cv.notify_all();
+        m_writer.join();
+    }
+    m_file.close();
+}
+
+uint32_t
+NrBinaryTraceFile::GetSize(FieldType type)
+{
+    switch (type)
+    {
+    case UINT8:
+    case LABEL:
+        return sizeof(uint8_t);
+    case UINT16:
+        return sizeof(uint16_t);
+    case UINT32:
+        return sizeof(uint32_t);
+    case UINT64:
+        return sizeof(uint64_t);
+    case INT64:
+    case TIME:
+        return sizeof(int64_t);
+    case DOUBLE:
+        return sizeof(double);
+    }
+    return 0;
+}
+
+void
+NrBinaryTraceFile::AddValue(FieldType type, const void* value, uint32_t size)
+{
+    NS_ASSERT_MSG(m_fields[m_nextField].m_type == type,
+                  "Wrong type of the value of field " << m_fields[m_nextField].m_name);
+    std::memcpy(m_buffer.data() + m_bufferUsed, value, size);
+    m_bufferUsed += size;
+    if (++m_nextField == m_fields.size())
+    {
+        m_nextField = 0;
+        m_recordStart = m_bufferUsed;
+        ++m_numRecords;
+        if (m_bufferUsed == m_buffer.size())
+        {
+            Flush();
+        }
+    }
+}
+
+void
+NrBinaryTraceFile::Add(uint8_t value)
+{
+    AddValue(UINT8, &value, sizeof(value));
+}
+
+void
+NrBinaryTraceFile::Add(uint16_t value)
+{
+    AddValue(UINT16, &value, sizeof(value));
+}
+
+void
+NrBinaryTraceFile::Add(uint32_t value)
+{
+    AddValue(UINT32, &value, sizeof(value));
+}
+
+void
+NrBinaryTraceFile::Add(uint64_t value)
+{
+    AddValue(UINT64, &value, sizeof(value));
+}
+
+void
+NrBinaryTraceFile::Add(int64_t value)
+{
+    AddValue(INT64, &value, sizeof(value));
+}
+
+void
+NrBinaryTraceFile::Add(double value)
+{
+    AddValue(DOUBLE, &value, sizeof(value));
+}
+
+void
+NrBinaryTraceFile::AddTime(int64_t nanoSeconds)
+{
+    AddValue(TIME, &nanoSeconds, sizeof(nanoSeconds));
+}
+
+void
+NrBinaryTraceFile::AddLabel(uint8_t label)
+{
+    NS_ASSERT_MSG(m_fields[m_nextField].m_type != LABEL ||
+                      label < m_fields[m_nextField].m_labels.size(),
+                  "Unknown label " << +label << " of field " << m_fields[m_nextField].m_name);
+    AddValue(LABEL, &label, sizeof(label));
+}
+
+uint64_t
+NrBinaryTraceFile::GetNumRecords() const
+{
+    return m_numRecords;
+}
+
+void
+NrBinaryTraceFile::Flush()
+{
+    if (m_bufferUsed == 0)
+    {
+        return;
+    }
+    if (!m_asyncWrite)
+    {
+        m_file.write(m_buffer.data(), m_bufferUsed);
+    }
+    else
+    {
+        // wait for the previous buffer, then swap the buffers
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return !m_hasPending; });
+        m_buffer.swap(m_pending);
+        m_pendingUsed = m_bufferUsed;
+        m_hasPending = true;
+        lock.unlock();
+        m_cv.notify_all();
+    }
+    m_bufferUsed = 0;
+    m_recordStart = 0;
+}
+
+void
+NrBinaryTraceFile::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_hasPending || m_closing; });
+        if (!m_hasPending)
+        {
+            return;
+        }
+        // the simulation does not touch m_pending until m_hasPending is reset
+        lock.unlock();
+        m_file.write(m_pending.data(), m_pendingUsed);
+        lock.lock();
+        m_hasPending = false;
+        m_cv.notify_all();
+    }
+}
+
+std::vector<NrBinaryTraceFile::Field>
+NrBinaryTraceFile::GetControlMessageFields(const std::string& entity)
+{
+    // in the order of NrControlMessage::messageType
+    static const std::vector<std::string> msgTypes = {"UL_DCI",
+                                                      "DL_DCI",
+                                                      "DL_CQI",
+                                                      "MIB",
+                                                      "SIB1",
+                                                      "RACH_PREAMBLE",
+                                                      "RAR",
+                                                      "BSR",
+                                                      "DL_HARQ",
+                                                      "SR",
+                                                      "SRS",
+                                                      "PAGING"};
+    NS_ASSERT(msgTypes.size() == NrControlMessage::PAGING + 1);
+    return {{"Time", TIME, {}},
+            {"Entity", LABEL, {entity}},
+            {"Frame", UINT32, {}},
+            {"SF", UINT8, {}},
+            {"Slot", UINT8, {}},
+            {"nodeId", UINT16, {}},
+            {"RNTI", UINT16, {}},
+            {"bwpId", UINT8, {}},
+            {"MsgType", LABEL, msgTypes}};
+}
+
+bool
+NrBinaryTraceFile::ConvertToCsv(std::istream& in, std::ostream& out)
+{
+    char magic[sizeof(NR_BINARY_TRACE_MAGIC)];
+    uint32_t version = 0;
+    uint32_t numFields = 0;
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, NR_BINARY_TRACE_MAGIC, sizeof(magic)) != 0 ||
+        !ReadHeaderValue(in, version) || version != NR_BINARY_TRACE_VERSION ||
+        !ReadHeaderValue(in, numFields) || numFields == 0)
+    {
+        return false;
+    }
+
+    std::vector<Field> fields(numFields);
+    uint32_t recordSize = 0;
+    for (auto& field : fields)
+    {
+        uint8_t type = 0;
+        if (!ReadHeaderValue(in, type) || type < UINT8 || type > LABEL ||
+            !ReadHeaderString(in, field.m_name))
+        {
+            return false;
+        }
+        field.m_type = static_cast<FieldType>(type);
+        if (field.m_type == LABEL)
+        {
+            uint16_t numLabels = 0;
+            if (!ReadHeaderValue(in, numLabels))
+            {
+                return false;
+            }
+            field.m_labels.resize(numLabels);
+            for (auto& label : field.m_labels)
+            {
+                if (!ReadHeaderString(in, label))
+                {
+                    return false;
+                }
+            }
+        }
+        recordSize += GetSize(field.m_type);
+    }
+
+    for (uint32_t i = 0; i < numFields; ++i)
+    {
+        out << (i > 0 ? "," : "") << fields[i].m_name;
+    }
+    out << "\n";
+
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    std::vector<char> record(recordSize);
+    while (in.read(record.data(), recordSize))
+    {
+        const char* value = record.data();
+        for (uint32_t i = 0; i < numFields; ++i)
+        {
+            if (i > 0)
+            {
+                out << ",";
+            }
+            switch (fields[i].m_type)
+            {
+            case UINT8: {
+                uint8_t v;
+                std::memcpy(&v, value, sizeof(v));
+                out << +v;
+                break;
+            }
+            case UINT16: {
+                uint16_t v;
+                std::memcpy(&v, value, sizeof(v));
+                out << v;
+                break;
+            }
+            case UINT32: {
+                uint32_t v;
+                std::memcpy(&v, value, sizeof(v));
+                out << v;
+                break;
+            }
+            case UINT64: {
+                uint64_t v;
+                std::memcpy(&v, value, sizeof(v));
+                out << v;
+                break;
+            }
+            case INT64: {
+                int64_t v;
+                std::memcpy(&v, value, sizeof(v));
+                out << v;
+                break;
+            }
+            case DOUBLE: {
+                double v;
+                std::memcpy(&v, value, sizeof(v));
+                out << v;
+                break;
+            }
+            case TIME: {
+                // exact seconds, with the nanoseconds as decimals
+                int64_t v;
+                std::memcpy(&v, value, sizeof(v));
+                uint64_t abs = v < 0 ? -static_cast<uint64_t>(v) : v;
+                out << (v < 0 ? "-" : "") << abs / 1000000000 << "." << std::setw(9)
+                    << std::setfill('0') << abs % 1000000000 << std::setfill(' ');
+                break;
+            }
+            case LABEL: {
+                uint8_t v;
+                std::memcpy(&v, value, sizeof(v));
+                if (v < fields[i].m_labels.size())
+                {
+                    out << fields[i].m_labels[v];
+                }
+                else
+                {
+                    out << +v;
+                }
+                break;
+            }
+            }
+            value += GetSize(fields[i].m_type);
+        }
+        out << "\n";
+    }
+    // a truncated record is an error, the end of the file is not
+    return in.gcount() == 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,226 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_BINARY_TRACE_FILE_H
+#define NR_BINARY_TRACE_FILE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr
+ * \brief Trace file of fixed-width binary records
+ *
+ * The binary format of the traces of NrPhyRxTrace and NrMacRxTrace. A record
+ * is a fixed list of fields, described once in the header of the file. The
+ * records are copied into a large buffer, which is written to the file when
+ * it is full, and when the file is closed. With an asynchronous writer the
+ * full buffer is written by a thread of the file, while the simulation fills
+ * a second buffer.
+ *
+ * The file starts with the magic string "NRBTRACE", the format version and
+ * the fields (type, name and, for LABEL fields, the labels). The records
+ * follow, with the fields in the byte order of the machine and without any
+ * padding. ConvertToCsv converts a file to CSV; the program
+ * nr-binary-trace-to-csv does it offline.
+ *
+ * The values of a record are added in the order of the fields, with the
+ * method of the type of the field:
+ *
+ * \code
+ *   file.AddTime(Simulator::Now().GetNanoSeconds());
+ *   file.Add(static_cast<uint16_t>(cellId));
+ *   file.AddLabel(isDownlink ? 0 : 1);
+ * \endcode
+ *
+ * The record is complete when its last field is added.
+ */
+class NrBinaryTraceFile
+{
+  public:
+    /**
+     * \brief Type of a field
+     */
+    enum FieldType : uint8_t
+    {
+        UINT8 = 1, //!< uint8_t
+        UINT16,    //!< uint16_t
+        UINT32,    //!< uint32_t
+        UINT64,    //!< uint64_t
+        INT64,     //!< int64_t
+        DOUBLE,    //!< double
+        TIME,      //!< int64_t nanoseconds, converted to seconds
+        LABEL      //!< uint8_t index of one of the labels of the field
+    };
+
+    /**
+     * \brief Field of the records
+     */
+    struct Field
+    {
+        std::string m_name;                //!< name, the column of the CSV
+        FieldType m_type;                  //!< type
+        std::vector<std::string> m_labels; //!< the labels of a LABEL field
+    };
+
+    /**
+     * \brief Open the file and write its header
+     *
+     * It is a fatal error if the file cannot be opened.
+     * \param fileName the name of the file
+     * \param fields the fields of the records
+     * \param bufferSize the size of the buffer in bytes
+     * \param asyncWrite write the full buffers with a thread
+     */
+    NrBinaryTraceFile(const std::string& fileName,
+                      const std::vector<Field>& fields,
+                      uint32_t bufferSize,
+                      bool asyncWrite);
+
+    /**
+     * \brief Write the buffered records and close the file
+     *
+     * A partially added record is not written.
+     */
+    ~NrBinaryTraceFile();
+
+    NrBinaryTraceFile(const NrBinaryTraceFile&) = delete;
+    NrBinaryTraceFile& operator=(const NrBinaryTraceFile&) = delete;
+
+    /**
+     * \brief Add the value of an UINT8 field
+     * \param value the value
+     */
+    void Add(uint8_t value);
+    /**
+     * \brief Add the value of an UINT16 field
+     * \param value the value
+     */
+    void Add(uint16_t value);
+    /**
+     * \brief Add the value of an UINT32 field
+     * \param value the value
+     */
+    void Add(uint32_t value);
+    /**
+     * \brief Add the value of an UINT64 field
+     * \param value the value
+     */
+    void Add(uint64_t value);
+    /**
+     * \brief Add the value of an INT64 field
+     * \param value the value
+     */
+    void Add(int64_t value);
+    /**
+     * \brief Add the value of a DOUBLE field
+     * \param value the value
+     */
+    void Add(double value);
+    /**
+     * \brief Add the value of a TIME field
+     * \param nanoSeconds the time in nanoseconds
+     */
+    void AddTime(int64_t nanoSeconds);
+    /**
+     * \brief Add the value of a LABEL field
+     * \param label the index of the label in the labels of the field
+     */
+    void AddLabel(uint8_t label);
+
+    /**
+     * \return the number of complete records added
+     */
+    uint64_t GetNumRecords() const;
+
+    /**
+     * \brief Fields of the control message traces of NrPhyRxTrace and NrMacRxTrace
+     *
+     * Time, Entity, Frame, SF, Slot, nodeId, RNTI, bwpId and MsgType, whose
+     * label is the NrControlMessage::messageType of the message.
+     * \param entity the only label of the Entity field, e.g. "ENB PHY Rxed"
+     * \return the fields
+     */
+    static std::vector<Field> GetControlMessageFields(const std::string& entity);
+
+    /**
+     * \brief Convert a binary trace to CSV
+     *
+     * The first line has the names of the fields. TIME fields are written in
+     * seconds, DOUBLE fields with all their significant digits.
+     * \param in the binary trace, opened in binary mode
+     * \param out the CSV output
+     * \return false if the input is not a binary trace, or is truncated
+     */
+    static bool ConvertToCsv(std::istream& in, std::ostream& out);
+
+  private:
+    /**
+     * \brief Copy the bytes of a value into the buffer
+     * \param type the type of the value
+     * \param value the value
+     * \param size the size of the value
+     */
+    void AddValue(FieldType type, const void* value, uint32_t size);
+
+    /**
+     * \brief Write the buffer, or pass it to the writer thread
+     */
+    void Flush();
+
+    /**
+     * \brief Loop of the writer thread
+     */
+    void WriterLoop();
+
+    /**
+     * \param type a field type
+     * \return the size of a value of the type in bytes
+     */
+    static uint32_t GetSize(FieldType type);
+
+    std::ofstream m_file;          //!< the file
+    std::vector<Field> m_fields;   //!< the fields of the records
+    uint32_t m_recordSize{0};      //!< the size of a record in bytes
+    uint32_t m_nextField{0};       //!< the field of the next value
+    uint64_t m_numRecords{0};      //!< the number of complete records
+    std::vector<char> m_buffer;    //!< the buffer filled by the simulation
+    uint32_t m_bufferUsed{0};      //!< the bytes used in m_buffer
+    uint32_t m_recordStart{0};     //!< the start of the current record in m_buffer
+    bool m_asyncWrite{false};      //!< whether the writer thread is used
+    std::thread m_writer;          //!< the writer thread
+    std::mutex m_mutex;            //!< protects the pending buffer state
+    std::condition_variable m_cv;  //!< signals the pending buffer state
+    std::vector<char> m_pending;   //!< the buffer being written by the writer
+    uint32_t m_pendingUsed{0};     //!< the bytes used in m_pending
+    bool m_hasPending{false};      //!< whether m_pending waits to be written
+    bool m_closing{false};         //!< whether the writer has to stop
+};
+
+} // namespace ns3
+
+#endif /* NR_BINARY_TRACE_FILE_H */
@@ -0,0 +1,293 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nr-distributed-helper.h"
+
+#include <ns3/distributed-simulator-impl.h>
+#include <ns3/log.h>
+#include <ns3/mpi-interface.h>
+#include <ns3/mpi-receiver.h>
+#include <ns3/nr-gnb-net-device.h>
+#include <ns3/nr-gnb-phy.h>
+#include <ns3/nr-spectrum-phy.h>
+#include <ns3/nr-ue-net-device.h>
+#include <ns3/nr-ue-phy.h>
+#include <ns3/packet.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-signal-parameters.h>
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrDistributedHelper");
+
+NS_OBJECT_ENSURE_REGISTERED(NrDistributedHelper);
+
+namespace
+{
+// the MPI messages of ns-3 are limited to 2000 bytes, with the packet metadata
+const uint16_t MAX_VALUES = 400;
+// CC index, stream index and number of values
+const uint32_t HEADER_SIZE = 4;
+} // namespace
+
+NrDistributedHelper::NrDistributedHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrDistributedHelper::~NrDistributedHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+NrDistributedHelper::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrDistributedHelper")
+                            .SetParent<Object>()
+                            .AddConstructor<NrDistributedHelper>();
+    return tid;
+}
+
+Time
+NrDistributedHelper::GetLookAhead(const Ptr<const NrPhy>& phy)
+{
+    return phy->GetSlotPeriod() * (phy->GetL1L2CtrlLatency() - 1);
+}
+
+Time
+NrDistributedHelper::GetLookAhead(const NetDeviceContainer& gnbDevices,
+                                  const NetDeviceContainer& ueDevices)
+{
+    Time lookAhead = Time::Max();
+    for (const NetDeviceContainer* devices : {&gnbDevices, &ueDevices})
+    {
+        for (auto it = devices->Begin(); it != devices->End(); ++it)
+        {
+            for (const auto& phy : GetPhys(*it))
+            {
+                lookAhead = std::min(lookAhead, GetLookAhead(phy));
+            }
+        }
+    }
+    return lookAhead;
+}
+
+int64_t
+NrDistributedHelper::GetSlot(Time time, Time slotPeriod)
+{
+    return time.GetTimeStep() / slotPeriod.GetTimeStep();
+}
+
+Time
+NrDistributedHelper::GetSendTime(int64_t slot, Time slotPeriod)
+{
+    // the signals start within the slot after the propagation delay, and are
+    // sent just before the next slot
+    return TimeStep((slot + 1) * slotPeriod.GetTimeStep() - 1);
+}
+
+Time
+NrDistributedHelper::GetRxTime(int64_t slot, Time slotPeriod, uint32_t l1l2CtrlLatency)
+{
+    return slotPeriod * (slot + l1l2CtrlLatency);
+}
+
+std::vector<Ptr<NrPhy>>
+NrDistributedHelper::GetPhys(const Ptr<NetDevice>& device)
+{
+    std::vector<Ptr<NrPhy>> phys;
+    if (Ptr<NrGnbNetDevice> gnb = DynamicCast<NrGnbNetDevice>(device))
+    {
+        for (uint32_t i = 0; i < gnb->GetCcMapSize(); ++i)
+        {
+            phys.push_back(gnb->GetPhy(i));
+        }
+    }
+    else if (Ptr<NrUeNetDevice> ue = DynamicCast<NrUeNetDevice>(device))
+    {
+        for (uint32_t i = 0; i < ue->GetCcMapSize(); ++i)
+        {
+            phys.push_back(ue->GetPhy(i));
+        }
+    }
+    else
+    {
+        NS_FATAL_ERROR("Not a NR device");
+    }
+    return phys;
+}
+
+void
+NrDistributedHelper::Install(const NetDeviceContainer& gnbDevices,
+                             const NetDeviceContainer& ueDevices)
+{
+    NS_LOG_FUNCTION(this);
+    if (!MpiInterface::IsEnabled() || MpiInterface::GetSize() <= 1)
+    {
+        return;
+    }
+    Ptr<DistributedSimulatorImpl> impl =
+        DynamicCast<DistributedSimulatorImpl>(Simulator::GetImplementation());
+    NS_ABORT_MSG_IF(impl == nullptr,
+                    "The interference of the ranks needs ns3::DistributedSimulatorImpl");
+
+    Time lookAhead = GetLookAhead(gnbDevices, ueDevices);
+    for (auto it = gnbDevices.Begin(); it != gnbDevices.End(); ++it)
+    {
+        InstallDevice(*it);
+    }
+    for (auto it = ueDevices.Begin(); it != ueDevices.End(); ++it)
+    {
+        InstallDevice(*it);
+    }
+    NS_ABORT_MSG_IF(lookAhead <= Time(0), "The interference of the ranks needs L1L2CtrlLatency > 1");
+    NS_LOG_INFO("Rank " << MpiInterface::GetSystemId() << ": " << m_remotePhys.size()
+                        << " PHYs of other ranks, lookahead " << lookAhead);
+    impl->BoundLookAhead(lookAhead);
+}
+
+void
+NrDistributedHelper::InstallDevice(const Ptr<NetDevice>& device)
+{
+    NS_LOG_FUNCTION(this << device);
+    Ptr<Node> node = device->GetNode();
+    std::vector<Ptr<NrPhy>> phys = GetPhys(device);
+
+    if (node->GetSystemId() == MpiInterface::GetSystemId())
+    {
+        Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver>();
+        receiver->SetReceiveCallback(MakeCallback(&NrDistributedHelper::Receive, this, device));
+        device->AggregateObject(receiver);
+        return;
+    }
+
+    for (uint32_t ccIndex = 0; ccIndex < phys.size(); ++ccIndex)
+    {
+        for (uint8_t stream = 0; stream < phys[ccIndex]->GetNumberOfStreams(); ++stream)
+        {
+            RemotePhy remote;
+            remote.m_phy = phys[ccIndex];
+            remote.m_nodeId = node->GetId();
+            remote.m_ifIndex = device->GetIfIndex();
+            remote.m_ccIndex = static_cast<uint8_t>(ccIndex);
+            remote.m_streamIndex = stream;
+            uint32_t index = static_cast<uint32_t>(m_remotePhys.size());
+            m_remotePhys.push_back(remote);
+            phys[ccIndex]->GetSpectrumPhy(stream)->SetPhyRemoteRxCallback(
+                MakeCallback(&NrDistributedHelper::RemoteRx, this, index));
+        }
+    }
+}
+
+void
+NrDistributedHelper::RemoteRx(uint32_t index, Ptr<const SpectrumValue> psd, Time duration)
+{
+    NS_LOG_FUNCTION(this << index << duration);
+    RemotePhy& remote = m_remotePhys.at(index);
+    const Time slotPeriod = remote.m_phy->GetSlotPeriod();
+    const int64_t slot = GetSlot(Simulator::Now(), slotPeriod);
+
+    if (remote.m_energy.empty())
+    {
+        NS_ABORT_MSG_IF(psd->GetValuesN() > MAX_VALUES, "Too many RBs for a MPI message");
+        remote.m_slot = slot;
+        remote.m_energy.assign(psd->GetValuesN(), 0.0);
+        Simulator::Schedule(GetSendTime(slot, slotPeriod) - Simulator::Now(),
+                            &NrDistributedHelper::SendSlot,
+                            this,
+                            index);
+    }
+    NS_ASSERT(remote.m_slot == slot && remote.m_energy.size() == psd->GetValuesN());
+
+    const double seconds = duration.GetSeconds();
+    auto energy = remote.m_energy.begin();
+    for (auto value = psd->ConstValuesBegin(); value != psd->ConstValuesEnd(); ++value, ++energy)
+    {
+        *energy += *value * seconds;
+    }
+}
+
+void
+NrDistributedHelper::SendSlot(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    RemotePhy& remote = m_remotePhys.at(index);
+    const Time slotPeriod = remote.m_phy->GetSlotPeriod();
+    const double slotSeconds = slotPeriod.GetSeconds();
+    const uint16_t numValues = static_cast<uint16_t>(remote.m_energy.size());
+
+    bool interference = false;
+    std::vector<uint8_t> buffer(HEADER_SIZE + numValues * sizeof(float));
+    buffer[0] = remote.m_ccIndex;
+    buffer[1] = remote.m_streamIndex;
+    std::memcpy(&buffer[2], &numValues, sizeof(numValues));
+    for (uint16_t i = 0; i < numValues; ++i)
+    {
+        float psd = static_cast<float>(remote.m_energy[i] / slotSeconds);
+        interference |= psd > 0;
+        std::memcpy(&buffer[HEADER_SIZE + i * sizeof(float)], &psd, sizeof(psd));
+    }
+    remote.m_energy.clear();
+
+    // out of band signals only give zeros
+    if (interference)
+    {
+        Time rxTime =
+            GetRxTime(remote.m_slot, slotPeriod, remote.m_phy->GetL1L2CtrlLatency());
+        MpiInterface::SendPacket(Create<Packet>(buffer.data(), buffer.size()),
+                                 rxTime,
+                                 remote.m_nodeId,
+                                 remote.m_ifIndex);
+    }
+}
+
+void
+NrDistributedHelper::Receive(Ptr<NetDevice> device, Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << device << packet);
+    std::vector<uint8_t> buffer(packet->GetSize());
+    packet->CopyData(buffer.data(), buffer.size());
+    NS_ASSERT(buffer.size() >= HEADER_SIZE);
+    uint16_t numValues;
+    std::memcpy(&numValues, &buffer[2], sizeof(numValues));
+    NS_ASSERT(buffer.size() == HEADER_SIZE + numValues * sizeof(float));
+
+    Ptr<NrPhy> phy = GetPhys(device).at(buffer[0]);
+    Ptr<NrSpectrumPhy> spectrumPhy = phy->GetSpectrumPhy(buffer[1]);
+    Ptr<SpectrumValue> psd = Create<SpectrumValue>(spectrumPhy->GetRxSpectrumModel());
+    NS_ASSERT(psd->GetValuesN() == numValues);
+    auto value = psd->ValuesBegin();
+    for (uint16_t i = 0; i < numValues; ++i, ++value)
+    {
+        float received;
+        std::memcpy(&received, &buffer[HEADER_SIZE + i * sizeof(float)], sizeof(received));
+        *value = received;
+    }
+
+    // a signal without a NR type is only interference
+    Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+    params->psd = psd;
+    params->duration = phy->GetSlotPeriod();
+    spectrumPhy->StartRx(params);
+}
+
+} // namespace ns3
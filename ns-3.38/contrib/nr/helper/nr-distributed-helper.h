@@ -0,0 +1,196 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_DISTRIBUTED_HELPER_H
+#define NR_DISTRIBUTED_HELPER_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/spectrum-value.h>
+
+#include <vector>
+
+namespace ns3
+{
+
+class NrPhy;
+class Packet;
+
+/**
+ * \ingroup helper
+ * \brief Exchange of the interference between the processes of a distributed simulation
+ *
+ * In a distributed simulation (ns3::DistributedSimulatorImpl) every MPI rank
+ * simulates a partition of the cells: the gNBs and UEs whose nodes have the
+ * system id of the rank, see HexagonalGridScenarioHelper::SetNumPartitions.
+ * Every rank creates all the nodes and devices, but only starts the PHYs of
+ * its own nodes, so that the NR devices of the other ranks only receive the
+ * signals of the local transmissions.
+ *
+ * These signals are interference for the rank of the receiving node. They are
+ * not received by the NrSpectrumPhy of the node, but summed up per slot, as
+ * energy per RB. At the end of the slot, the average PSD of the slot is sent to
+ * the rank of the node, in one MPI message per PHY. That rank adds it to the
+ * interference of the PHY over a whole slot, L1L2CtrlLatency slots later.
+ * The lookahead of the simulation is therefore (L1L2CtrlLatency - 1) slots,
+ * instead of the propagation delay between the cells:
+ *
+ * \code
+ *   Ptr<NrDistributedHelper> distributedHelper = CreateObject<NrDistributedHelper>();
+ *   // after the UEs are attached
+ *   distributedHelper->Install(gnbNetDevs, ueNetDevs);
+ * \endcode
+ *
+ * The interference between the cells of different ranks is delayed and
+ * averaged over the slot, and only adds to the interference of the DATA and
+ * SRS receptions. The links between them are computed by the rank of the
+ * transmitter, so that their channels are not reciprocal. The UEs have to be
+ * attached to a gNB of their own rank, and the partitions only communicate
+ * through the interference and the point-to-point links of the core network,
+ * whose delays also bound the lookahead. Without MPI, or with a single rank,
+ * Install does nothing.
+ *
+ * The helper has to be kept until the end of the simulation.
+ */
+class NrDistributedHelper : public Object
+{
+  public:
+    /**
+     * \brief NrDistributedHelper constructor
+     */
+    NrDistributedHelper();
+    /**
+     * \brief ~NrDistributedHelper
+     */
+    ~NrDistributedHelper() override;
+
+    /**
+     * \brief GetTypeId
+     * \return the type id of the object
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Exchange the interference of the devices with the other ranks
+     *
+     * The containers hold the devices of all the ranks, which are installed on
+     * all of them in the same order. The UEs have to be attached before.
+     * \param gnbDevices the gNB devices
+     * \param ueDevices the UE devices
+     */
+    void Install(const NetDeviceContainer& gnbDevices, const NetDeviceContainer& ueDevices);
+
+    /**
+     * \brief Get the lookahead that the interference of a PHY allows
+     * \param phy the PHY
+     * \return (L1L2CtrlLatency - 1) slots of the PHY
+     */
+    static Time GetLookAhead(const Ptr<const NrPhy>& phy);
+
+    /**
+     * \brief Get the lookahead that the interference of the devices allows
+     *
+     * The interference of a slot is sent to the rank of the receiving PHY, a
+     * gNB or a UE one, with the slot period and the latency of that PHY.
+     * \param gnbDevices the gNB devices
+     * \param ueDevices the UE devices
+     * \return the smallest lookahead of all their PHYs
+     */
+    static Time GetLookAhead(const NetDeviceContainer& gnbDevices,
+                             const NetDeviceContainer& ueDevices);
+
+    /**
+     * \brief Get the slot of a received signal
+     * \param time the start of the signal
+     * \param slotPeriod the slot period of the receiving PHY
+     * \return the slot, counted from the start of the simulation
+     */
+    static int64_t GetSlot(Time time, Time slotPeriod);
+
+    /**
+     * \brief Get the time at which the interference of a slot is sent
+     * \param slot the slot of the received signals
+     * \param slotPeriod the slot period of the receiving PHY
+     * \return the last time step of the slot
+     */
+    static Time GetSendTime(int64_t slot, Time slotPeriod);
+
+    /**
+     * \brief Get the time at which the interference of a slot is added to the receiving PHY
+     * \param slot the slot of the received signals
+     * \param slotPeriod the slot period of the receiving PHY
+     * \param l1l2CtrlLatency the L1L2CtrlLatency of the receiving PHY
+     * \return the start of the slot L1L2CtrlLatency slots later
+     */
+    static Time GetRxTime(int64_t slot, Time slotPeriod, uint32_t l1l2CtrlLatency);
+
+  private:
+    /**
+     * \brief A PHY of a node of another rank
+     */
+    struct RemotePhy
+    {
+        Ptr<NrPhy> m_phy;             //!< the PHY
+        uint32_t m_nodeId{0};         //!< the node id
+        uint32_t m_ifIndex{0};        //!< the interface index of the device
+        uint8_t m_ccIndex{0};         //!< the index of the PHY in the device
+        uint8_t m_streamIndex{0};     //!< the stream of the NrSpectrumPhy
+        int64_t m_slot{0};            //!< the slot of m_energy
+        std::vector<double> m_energy; //!< energy per RB of the slot, empty if none
+    };
+
+    /**
+     * \brief Install a device on this rank
+     * \param device the device
+     */
+    void InstallDevice(const Ptr<NetDevice>& device);
+
+    /**
+     * \brief Add a signal received by a PHY of another rank to its slot
+     * \param index the index of the PHY in m_remotePhys
+     * \param psd the received PSD
+     * \param duration the duration of the signal
+     */
+    void RemoteRx(uint32_t index, Ptr<const SpectrumValue> psd, Time duration);
+
+    /**
+     * \brief Send the interference of a slot to the rank of a PHY
+     * \param index the index of the PHY in m_remotePhys
+     */
+    void SendSlot(uint32_t index);
+
+    /**
+     * \brief Add the interference received from another rank to a local PHY
+     * \param device the device of the PHY
+     * \param packet the message
+     */
+    void Receive(Ptr<NetDevice> device, Ptr<Packet> packet);
+
+    /**
+     * \param device a gNB or UE device
+     * \return the PHYs of the device
+     */
+    static std::vector<Ptr<NrPhy>> GetPhys(const Ptr<NetDevice>& device);
+
+    std::vector<RemotePhy> m_remotePhys; //!< the PHYs of the other ranks
+};
+
+} // namespace ns3
+
+#endif /* NR_DISTRIBUTED_HELPER_H */
@@ -626,7 +626,11 @@ NrHelper::CreateUePhy(const Ptr<Node>& n,
     NS_ASSERT_MSG(res, "Propagation model without Frequency attribute");
     phy->InstallCentralFrequency(frequency.Get());
 
-    phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    // in a distributed simulation, the nodes of the other processes are not simulated here
+    if (n->GetSystemId() == Simulator::GetSystemId())
+    {
+        phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    }
 
     // connect CAM and PHY
     Ptr<NrChAccessManager> cam =
@@ -877,7 +881,11 @@ NrHelper::CreateGnbPhy(const Ptr<Node>& n,
     NS_ASSERT_MSG(res, "Propagation model without Frequency attribute");
     phy->InstallCentralFrequency(frequency.Get());
 
-    phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    // in a distributed simulation, the nodes of the other processes are not simulated here
+    if (n->GetSystemId() == Simulator::GetSystemId())
+    {
+        phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    }
 
     // PHY <--> CAM
     Ptr<NrChAccessManager> cam =
@@ -1224,6 +1232,12 @@ NrHelper::AttachToEnb(const Ptr<NetDevice>& ueDevice, const Ptr<NetDevice>& gnbD
 
     NS_ABORT_IF(enbNetDev == nullptr || ueNetDev == nullptr);
 
+    // in a distributed simulation, the UE of another process is only configured
+    // here, so that the signals it receives can be computed, and attached by its process
+    const bool localUe = ueDevice->GetNode()->GetSystemId() == Simulator::GetSystemId();
+    NS_ABORT_MSG_IF(localUe && gnbDevice->GetNode()->GetSystemId() != Simulator::GetSystemId(),
+                    "A UE can only be attached to a gNB of the same process");
+
     for (uint32_t i = 0; i < enbNetDev->GetCcMapSize(); ++i)
     {
         enbNetDev->GetPhy(i)->RegisterUe(ueNetDev->GetImsi(), ueNetDev);
@@ -1237,11 +1251,14 @@ NrHelper::AttachToEnb(const Ptr<NetDevice>& ueDevice, const Ptr<NetDevice>& gnbD
         ueNetDev->GetPhy(i)->SetSymbolsPerSlot(enbNetDev->GetPhy(i)->GetSymbolsPerSlot());
         ueNetDev->GetPhy(i)->SetNumerology(enbNetDev->GetPhy(i)->GetNumerology());
         ueNetDev->GetPhy(i)->SetPattern(enbNetDev->GetPhy(i)->GetPattern());
-        Ptr<EpcUeNas> ueNas = ueNetDev->GetNas();
-        ueNas->Connect(enbNetDev->GetBwpId(i), enbNetDev->GetEarfcn(i));
+        if (localUe)
+        {
+            Ptr<EpcUeNas> ueNas = ueNetDev->GetNas();
+            ueNas->Connect(enbNetDev->GetBwpId(i), enbNetDev->GetEarfcn(i));
+        }
     }
 
-    if (m_epcHelper)
+    if (m_epcHelper && localUe)
     {
         // activate default EPS bearer
         m_epcHelper->ActivateEpsBearer(ueDevice,
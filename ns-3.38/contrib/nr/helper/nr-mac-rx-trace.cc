@@ -6,8 +6,10 @@
 
 #include "nr-mac-rx-trace.h"
 
+#include <ns3/boolean.h>
 #include <ns3/log.h>
 #include <ns3/simulator.h>
+#include <ns3/uinteger.h>
 
 #include <fstream>
 #include <stdio.h>
@@ -29,6 +31,15 @@ std::string NrMacRxTrace::m_rxedUeMacCtrlMsgsFileName;
 std::ofstream NrMacRxTrace::m_txedUeMacCtrlMsgsFile;
 std::string NrMacRxTrace::m_txedUeMacCtrlMsgsFileName;
 
+bool NrMacRxTrace::m_binaryFormat = false;
+uint32_t NrMacRxTrace::m_binaryBufferSize = 4 * 1024 * 1024;
+bool NrMacRxTrace::m_binaryAsyncWrite = true;
+
+std::unique_ptr<NrBinaryTraceFile> NrMacRxTrace::m_rxedGnbMacCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrMacRxTrace::m_txedGnbMacCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrMacRxTrace::m_rxedUeMacCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrMacRxTrace::m_txedUeMacCtrlMsgsBinaryFile;
+
 NrMacRxTrace::NrMacRxTrace()
 {
 }
@@ -54,16 +65,89 @@ NrMacRxTrace::~NrMacRxTrace()
     {
         m_txedUeMacCtrlMsgsFile.close();
     }
+
+    // the binary files write their buffers when destroyed
+    m_rxedGnbMacCtrlMsgsBinaryFile.reset();
+    m_txedGnbMacCtrlMsgsBinaryFile.reset();
+    m_rxedUeMacCtrlMsgsBinaryFile.reset();
+    m_txedUeMacCtrlMsgsBinaryFile.reset();
 }
 
 TypeId
 NrMacRxTrace::GetTypeId()
 {
     static TypeId tid =
-        TypeId("ns3::NrMacRxTrace").SetParent<Object>().AddConstructor<NrMacRxTrace>();
+        TypeId("ns3::NrMacRxTrace")
+            .SetParent<Object>()
+            .AddConstructor<NrMacRxTrace>()
+            .AddAttribute("BinaryFormat",
+                          "Write the traces as fixed-width binary records into .bin files, "
+                          "which nr-binary-trace-to-csv converts to CSV, instead of text lines "
+                          "into .txt files",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrMacRxTrace::SetBinaryFormat),
+                          MakeBooleanChecker())
+            .AddAttribute("BinaryBufferSize",
+                          "Size in bytes of the buffer of each binary trace file",
+                          UintegerValue(4 * 1024 * 1024),
+                          MakeUintegerAccessor(&NrMacRxTrace::SetBinaryBufferSize),
+                          MakeUintegerChecker<uint32_t>(1024))
+            .AddAttribute("BinaryAsyncWrite",
+                          "Write the full buffers of the binary trace files with a thread, "
+                          "while the simulation fills a second buffer",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&NrMacRxTrace::SetBinaryAsyncWrite),
+                          MakeBooleanChecker());
     return tid;
 }
 
+void
+NrMacRxTrace::SetBinaryFormat(bool binaryFormat)
+{
+    m_binaryFormat = binaryFormat;
+}
+
+void
+NrMacRxTrace::SetBinaryBufferSize(uint32_t bufferSize)
+{
+    m_binaryBufferSize = bufferSize;
+}
+
+void
+NrMacRxTrace::SetBinaryAsyncWrite(bool asyncWrite)
+{
+    m_binaryAsyncWrite = asyncWrite;
+}
+
+void
+NrMacRxTrace::WriteBinaryCtrlMsg(std::unique_ptr<NrBinaryTraceFile>& file,
+                                 const std::string& name,
+                                 const std::string& entity,
+                                 SfnSf sfn,
+                                 uint16_t nodeId,
+                                 uint16_t rnti,
+                                 uint8_t bwpId,
+                                 Ptr<const NrControlMessage> msg)
+{
+    if (!file)
+    {
+        file = std::make_unique<NrBinaryTraceFile>(
+            name + ".bin",
+            NrBinaryTraceFile::GetControlMessageFields(entity),
+            m_binaryBufferSize,
+            m_binaryAsyncWrite);
+    }
+    file->AddTime(Simulator::Now().GetNanoSeconds());
+    file->AddLabel(0);
+    file->Add(sfn.GetFrame());
+    file->Add(sfn.GetSubframe());
+    file->Add(sfn.GetSlot());
+    file->Add(nodeId);
+    file->Add(rnti);
+    file->Add(bwpId);
+    file->AddLabel(msg->GetMessageType());
+}
+
 void
 NrMacRxTrace::RxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                          std::string path,
@@ -73,6 +157,19 @@ NrMacRxTrace::RxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                          uint8_t bwpId,
                                          Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_rxedGnbMacCtrlMsgsBinaryFile,
+                           "RxedGnbMacCtrlMsgsTrace",
+                           "ENB MAC Rxed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_rxedGnbMacCtrlMsgsFile.is_open())
     {
         m_rxedGnbMacCtrlMsgsFileName = "RxedGnbMacCtrlMsgsTrace.txt";
@@ -95,7 +192,7 @@ NrMacRxTrace::RxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                  << "\t"
                                  << "bwpId"
                                  << "\t"
-                                 << "MsgType" << std::endl;
+                                 << "MsgType" << "\n";
 
         if (!m_rxedGnbMacCtrlMsgsFile.is_open())
         {
@@ -134,7 +231,7 @@ NrMacRxTrace::RxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
     {
         m_rxedGnbMacCtrlMsgsFile << "Other";
     }
-    m_rxedGnbMacCtrlMsgsFile << std::endl;
+    m_rxedGnbMacCtrlMsgsFile << "\n";
 }
 
 void
@@ -146,6 +243,19 @@ NrMacRxTrace::TxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                          uint8_t bwpId,
                                          Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_txedGnbMacCtrlMsgsBinaryFile,
+                           "TxedGnbMacCtrlMsgsTrace",
+                           "ENB MAC Txed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_txedGnbMacCtrlMsgsFile.is_open())
     {
         m_txedGnbMacCtrlMsgsFileName = "TxedGnbMacCtrlMsgsTrace.txt";
@@ -168,7 +278,7 @@ NrMacRxTrace::TxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                  << "\t"
                                  << "bwpId"
                                  << "\t"
-                                 << "MsgType" << std::endl;
+                                 << "MsgType" << "\n";
 
         if (!m_txedGnbMacCtrlMsgsFile.is_open())
         {
@@ -196,7 +306,7 @@ NrMacRxTrace::TxedGnbMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
         m_txedGnbMacCtrlMsgsFile << "Other";
     }
 
-    m_txedGnbMacCtrlMsgsFile << std::endl;
+    m_txedGnbMacCtrlMsgsFile << "\n";
 }
 
 void
@@ -208,6 +318,19 @@ NrMacRxTrace::RxedUeMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                         uint8_t bwpId,
                                         Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_rxedUeMacCtrlMsgsBinaryFile,
+                           "RxedUeMacCtrlMsgsTrace",
+                           "UE  MAC Rxed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_rxedUeMacCtrlMsgsFile.is_open())
     {
         m_rxedUeMacCtrlMsgsFileName = "RxedUeMacCtrlMsgsTrace.txt";
@@ -230,7 +353,7 @@ NrMacRxTrace::RxedUeMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                 << "\t"
                                 << "bwpId"
                                 << "\t"
-                                << "MsgType" << std::endl;
+                                << "MsgType" << "\n";
 
         if (!m_rxedUeMacCtrlMsgsFile.is_open())
         {
@@ -261,7 +384,7 @@ NrMacRxTrace::RxedUeMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
     {
         m_rxedUeMacCtrlMsgsFile << "Other";
     }
-    m_rxedUeMacCtrlMsgsFile << std::endl;
+    m_rxedUeMacCtrlMsgsFile << "\n";
 }
 
 void
@@ -273,6 +396,19 @@ NrMacRxTrace::TxedUeMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                         uint8_t bwpId,
                                         Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_txedUeMacCtrlMsgsBinaryFile,
+                           "TxedUeMacCtrlMsgsTrace",
+                           "UE  MAC Txed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_txedUeMacCtrlMsgsFile.is_open())
     {
         m_txedUeMacCtrlMsgsFileName = "TxedUeMacCtrlMsgsTrace.txt";
@@ -295,7 +431,7 @@ NrMacRxTrace::TxedUeMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
                                 << "\t"
                                 << "bwpId"
                                 << "\t"
-                                << "MsgType" << std::endl;
+                                << "MsgType" << "\n";
 
         if (!m_txedUeMacCtrlMsgsFile.is_open())
         {
@@ -326,7 +462,7 @@ NrMacRxTrace::TxedUeMacCtrlMsgsCallback(Ptr<NrMacRxTrace> macStats,
     {
         m_txedUeMacCtrlMsgsFile << "Other";
     }
-    m_txedUeMacCtrlMsgsFile << std::endl;
+    m_txedUeMacCtrlMsgsFile << "\n";
 }
 
 } /* namespace ns3 */
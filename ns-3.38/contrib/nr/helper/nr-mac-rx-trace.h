@@ -7,6 +7,8 @@
 #ifndef SRC_NR_HELPER_NR_MAC_RX_TRACE_H_
 #define SRC_NR_HELPER_NR_MAC_RX_TRACE_H_
 
+#include "nr-binary-trace-file.h"
+
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-gnb-mac.h>
 #include <ns3/nr-phy-mac-common.h>
@@ -14,6 +16,7 @@
 #include <ns3/spectrum-value.h>
 
 #include <iostream>
+#include <memory>
 
 namespace ns3
 {
@@ -25,6 +28,27 @@ class NrMacRxTrace : public Object
     ~NrMacRxTrace() override;
     static TypeId GetTypeId();
 
+    /**
+     * \brief Set the format of the trace files
+     *
+     * The binary files of NrBinaryTraceFile have the extension .bin instead
+     * of .txt, and are converted to CSV by the program nr-binary-trace-to-csv.
+     * \param binaryFormat true for the binary format, false for text
+     */
+    void SetBinaryFormat(bool binaryFormat);
+
+    /**
+     * \brief Set the buffer size of the binary trace files
+     * \param bufferSize the size of the buffer of each file in bytes
+     */
+    void SetBinaryBufferSize(uint32_t bufferSize);
+
+    /**
+     * \brief Set whether the binary trace files are written by a thread
+     * \param asyncWrite true to write the full buffers with a thread
+     */
+    void SetBinaryAsyncWrite(bool asyncWrite);
+
     /**
      *  Trace sink for Enb Mac Received Control Messages.
      *
@@ -106,6 +130,30 @@ class NrMacRxTrace : public Object
                                           Ptr<const NrControlMessage> msg);
 
   private:
+    /**
+     * \brief Write a record of a control message trace in the binary format
+     * \param file the trace file, opened if needed
+     * \param name the name of the trace, completed with the extension .bin
+     * \param entity the entity of the trace
+     * \param sfn the SfnSf
+     * \param nodeId the node ID
+     * \param rnti the RNTI
+     * \param bwpId the BWP ID
+     * \param msg the message
+     */
+    static void WriteBinaryCtrlMsg(std::unique_ptr<NrBinaryTraceFile>& file,
+                                   const std::string& name,
+                                   const std::string& entity,
+                                   SfnSf sfn,
+                                   uint16_t nodeId,
+                                   uint16_t rnti,
+                                   uint8_t bwpId,
+                                   Ptr<const NrControlMessage> msg);
+
+    static bool m_binaryFormat;         //!< The `BinaryFormat` attribute.
+    static uint32_t m_binaryBufferSize; //!< The `BinaryBufferSize` attribute.
+    static bool m_binaryAsyncWrite;     //!< The `BinaryAsyncWrite` attribute.
+
     static std::ofstream m_rxedGnbMacCtrlMsgsFile;
     static std::string m_rxedGnbMacCtrlMsgsFileName;
     static std::ofstream m_txedGnbMacCtrlMsgsFile;
@@ -115,6 +163,11 @@ class NrMacRxTrace : public Object
     static std::string m_rxedUeMacCtrlMsgsFileName;
     static std::ofstream m_txedUeMacCtrlMsgsFile;
     static std::string m_txedUeMacCtrlMsgsFileName;
+
+    static std::unique_ptr<NrBinaryTraceFile> m_rxedGnbMacCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_txedGnbMacCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_rxedUeMacCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_txedUeMacCtrlMsgsBinaryFile;
 };
 
 } /* namespace ns3 */
@@ -7,11 +7,13 @@
 
 #include "nr-phy-rx-trace.h"
 
+#include <ns3/boolean.h>
 #include <ns3/log.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/simulator.h>
 #include <ns3/string.h>
+#include <ns3/uinteger.h>
 
 #include <stdio.h>
 
@@ -22,6 +24,21 @@ NS_LOG_COMPONENT_DEFINE("NrPhyRxTrace");
 
 NS_OBJECT_ENSURE_REGISTERED(NrPhyRxTrace);
 
+/**
+ * \return the fields of the binary DL and UL pathloss traces
+ */
+static std::vector<NrBinaryTraceFile::Field>
+GetPathlossFields()
+{
+    return {{"Time(sec)", NrBinaryTraceFile::TIME, {}},
+            {"CellId", NrBinaryTraceFile::UINT16, {}},
+            {"BwpId", NrBinaryTraceFile::UINT16, {}},
+            {"txStreamId", NrBinaryTraceFile::UINT8, {}},
+            {"IMSI", NrBinaryTraceFile::UINT64, {}},
+            {"rxStreamId", NrBinaryTraceFile::UINT8, {}},
+            {"pathLoss(dB)", NrBinaryTraceFile::DOUBLE, {}}};
+}
+
 std::ofstream NrPhyRxTrace::m_dlDataSinrFile;
 std::string NrPhyRxTrace::m_dlDataSinrFileName;
 
@@ -55,6 +72,23 @@ std::string NrPhyRxTrace::m_dlCtrlPathlossFileName;
 std::ofstream NrPhyRxTrace::m_dlDataPathlossFile;
 std::string NrPhyRxTrace::m_dlDataPathlossFileName;
 
+bool NrPhyRxTrace::m_binaryFormat = false;
+uint32_t NrPhyRxTrace::m_binaryBufferSize = 4 * 1024 * 1024;
+bool NrPhyRxTrace::m_binaryAsyncWrite = true;
+
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_dlDataSinrBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_dlCtrlSinrBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_rxPacketTraceBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_txedGnbPhyCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_rxedUePhyCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_txedUePhyCtrlMsgsBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_rxedUePhyDlDciBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_dlPathlossBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_ulPathlossBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_dlCtrlPathlossBinaryFile;
+std::unique_ptr<NrBinaryTraceFile> NrPhyRxTrace::m_dlDataPathlossBinaryFile;
+
 NrPhyRxTrace::NrPhyRxTrace()
 {
 }
@@ -120,6 +154,20 @@ NrPhyRxTrace::~NrPhyRxTrace()
     {
         m_dlDataPathlossFile.close();
     }
+
+    // the binary files write their buffers when destroyed
+    m_dlDataSinrBinaryFile.reset();
+    m_dlCtrlSinrBinaryFile.reset();
+    m_rxPacketTraceBinaryFile.reset();
+    m_rxedGnbPhyCtrlMsgsBinaryFile.reset();
+    m_txedGnbPhyCtrlMsgsBinaryFile.reset();
+    m_rxedUePhyCtrlMsgsBinaryFile.reset();
+    m_txedUePhyCtrlMsgsBinaryFile.reset();
+    m_rxedUePhyDlDciBinaryFile.reset();
+    m_dlPathlossBinaryFile.reset();
+    m_ulPathlossBinaryFile.reset();
+    m_dlCtrlPathlossBinaryFile.reset();
+    m_dlDataPathlossBinaryFile.reset();
 }
 
 TypeId
@@ -135,7 +183,25 @@ NrPhyRxTrace::GetTypeId()
                 "in order to distinguish them, for example: RxPacketTrace-${SimTag}.out. ",
                 StringValue(""),
                 MakeStringAccessor(&NrPhyRxTrace::SetSimTag),
-                MakeStringChecker());
+                MakeStringChecker())
+            .AddAttribute("BinaryFormat",
+                          "Write the traces as fixed-width binary records into .bin files, "
+                          "which nr-binary-trace-to-csv converts to CSV, instead of text lines "
+                          "into .txt files",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrPhyRxTrace::SetBinaryFormat),
+                          MakeBooleanChecker())
+            .AddAttribute("BinaryBufferSize",
+                          "Size in bytes of the buffer of each binary trace file",
+                          UintegerValue(4 * 1024 * 1024),
+                          MakeUintegerAccessor(&NrPhyRxTrace::SetBinaryBufferSize),
+                          MakeUintegerChecker<uint32_t>(1024))
+            .AddAttribute("BinaryAsyncWrite",
+                          "Write the full buffers of the binary trace files with a thread, "
+                          "while the simulation fills a second buffer",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&NrPhyRxTrace::SetBinaryAsyncWrite),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -151,6 +217,144 @@ NrPhyRxTrace::SetResultsFolder(const std::string& resultsFolder)
     m_resultsFolder = resultsFolder;
 }
 
+void
+NrPhyRxTrace::SetBinaryFormat(bool binaryFormat)
+{
+    m_binaryFormat = binaryFormat;
+}
+
+void
+NrPhyRxTrace::SetBinaryBufferSize(uint32_t bufferSize)
+{
+    m_binaryBufferSize = bufferSize;
+}
+
+void
+NrPhyRxTrace::SetBinaryAsyncWrite(bool asyncWrite)
+{
+    m_binaryAsyncWrite = asyncWrite;
+}
+
+std::unique_ptr<NrBinaryTraceFile>
+NrPhyRxTrace::OpenBinaryFile(const std::string& name,
+                             const std::vector<NrBinaryTraceFile::Field>& fields)
+{
+    std::ostringstream oss;
+    oss << m_resultsFolder << name << m_simTag.c_str() << ".bin";
+    return std::make_unique<NrBinaryTraceFile>(oss.str(),
+                                               fields,
+                                               m_binaryBufferSize,
+                                               m_binaryAsyncWrite);
+}
+
+void
+NrPhyRxTrace::WriteBinaryCtrlMsg(std::unique_ptr<NrBinaryTraceFile>& file,
+                                 const std::string& name,
+                                 const std::string& entity,
+                                 SfnSf sfn,
+                                 uint16_t nodeId,
+                                 uint16_t rnti,
+                                 uint8_t bwpId,
+                                 Ptr<const NrControlMessage> msg)
+{
+    if (!file)
+    {
+        file = OpenBinaryFile(name, NrBinaryTraceFile::GetControlMessageFields(entity));
+    }
+    file->AddTime(Simulator::Now().GetNanoSeconds());
+    file->AddLabel(0);
+    file->Add(sfn.GetFrame());
+    file->Add(sfn.GetSubframe());
+    file->Add(sfn.GetSlot());
+    file->Add(nodeId);
+    file->Add(rnti);
+    file->Add(bwpId);
+    file->AddLabel(msg->GetMessageType());
+}
+
+void
+NrPhyRxTrace::WriteBinaryDlDci(uint8_t entity,
+                               SfnSf sfn,
+                               uint16_t nodeId,
+                               uint16_t rnti,
+                               uint8_t bwpId,
+                               uint8_t harqId,
+                               uint32_t k1Delay)
+{
+    if (!m_rxedUePhyDlDciBinaryFile)
+    {
+        m_rxedUePhyDlDciBinaryFile =
+            OpenBinaryFile("RxedUePhyDlDciTrace",
+                           {{"Time", NrBinaryTraceFile::TIME, {}},
+                            {"Entity", NrBinaryTraceFile::LABEL, {"DL DCI Rxed", "HARQ FD Txed"}},
+                            {"Frame", NrBinaryTraceFile::UINT32, {}},
+                            {"SF", NrBinaryTraceFile::UINT8, {}},
+                            {"Slot", NrBinaryTraceFile::UINT8, {}},
+                            {"nodeId", NrBinaryTraceFile::UINT16, {}},
+                            {"RNTI", NrBinaryTraceFile::UINT16, {}},
+                            {"bwpId", NrBinaryTraceFile::UINT8, {}},
+                            {"Harq ID", NrBinaryTraceFile::UINT8, {}},
+                            {"K1 Delay", NrBinaryTraceFile::UINT32, {}}});
+    }
+    m_rxedUePhyDlDciBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+    m_rxedUePhyDlDciBinaryFile->AddLabel(entity);
+    m_rxedUePhyDlDciBinaryFile->Add(sfn.GetFrame());
+    m_rxedUePhyDlDciBinaryFile->Add(sfn.GetSubframe());
+    m_rxedUePhyDlDciBinaryFile->Add(sfn.GetSlot());
+    m_rxedUePhyDlDciBinaryFile->Add(nodeId);
+    m_rxedUePhyDlDciBinaryFile->Add(rnti);
+    m_rxedUePhyDlDciBinaryFile->Add(bwpId);
+    m_rxedUePhyDlDciBinaryFile->Add(harqId);
+    m_rxedUePhyDlDciBinaryFile->Add(k1Delay);
+}
+
+void
+NrPhyRxTrace::WriteBinaryRxPacketTrace(bool downlink, const RxPacketTraceParams& params)
+{
+    if (!m_rxPacketTraceBinaryFile)
+    {
+        m_rxPacketTraceBinaryFile =
+            OpenBinaryFile("RxPacketTrace",
+                           {{"Time", NrBinaryTraceFile::TIME, {}},
+                            {"direction", NrBinaryTraceFile::LABEL, {"DL", "UL"}},
+                            {"frame", NrBinaryTraceFile::UINT32, {}},
+                            {"subF", NrBinaryTraceFile::UINT8, {}},
+                            {"slot", NrBinaryTraceFile::UINT16, {}},
+                            {"1stSym", NrBinaryTraceFile::UINT8, {}},
+                            {"nSymbol", NrBinaryTraceFile::UINT8, {}},
+                            {"cellId", NrBinaryTraceFile::UINT64, {}},
+                            {"bwpId", NrBinaryTraceFile::UINT16, {}},
+                            {"streamId", NrBinaryTraceFile::UINT8, {}},
+                            {"rnti", NrBinaryTraceFile::UINT16, {}},
+                            {"tbSize", NrBinaryTraceFile::UINT32, {}},
+                            {"mcs", NrBinaryTraceFile::UINT8, {}},
+                            {"rv", NrBinaryTraceFile::UINT8, {}},
+                            {"SINR(dB)", NrBinaryTraceFile::DOUBLE, {}},
+                            {"CQI", NrBinaryTraceFile::UINT8, {}},
+                            {"corrupt", NrBinaryTraceFile::UINT8, {}},
+                            {"TBler", NrBinaryTraceFile::DOUBLE, {}}});
+    }
+    m_rxPacketTraceBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+    m_rxPacketTraceBinaryFile->AddLabel(downlink ? 0 : 1);
+    m_rxPacketTraceBinaryFile->Add(params.m_frameNum);
+    m_rxPacketTraceBinaryFile->Add(params.m_subframeNum);
+    m_rxPacketTraceBinaryFile->Add(params.m_slotNum);
+    m_rxPacketTraceBinaryFile->Add(params.m_symStart);
+    m_rxPacketTraceBinaryFile->Add(params.m_numSym);
+    m_rxPacketTraceBinaryFile->Add(params.m_cellId);
+    m_rxPacketTraceBinaryFile->Add(params.m_bwpId);
+    m_rxPacketTraceBinaryFile->Add(params.m_streamId);
+    m_rxPacketTraceBinaryFile->Add(params.m_rnti);
+    m_rxPacketTraceBinaryFile->Add(params.m_tbSize);
+    m_rxPacketTraceBinaryFile->Add(params.m_mcs);
+    m_rxPacketTraceBinaryFile->Add(params.m_rv);
+    m_rxPacketTraceBinaryFile->Add(10 * log10(params.m_sinr));
+    // UL receptions have no CQI, they keep the default of 255
+    m_rxPacketTraceBinaryFile->Add(params.m_cqi);
+    m_rxPacketTraceBinaryFile->Add(static_cast<uint8_t>(params.m_corrupt));
+    m_rxPacketTraceBinaryFile->Add(params.m_tbler);
+}
+
 void
 NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                                  [[maybe_unused]] std::string path,
@@ -162,6 +366,28 @@ NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
 {
     NS_LOG_INFO("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId
                      << "->Generate RsrpSinrTrace");
+
+    if (m_binaryFormat)
+    {
+        if (!m_dlDataSinrBinaryFile)
+        {
+            m_dlDataSinrBinaryFile = OpenBinaryFile("DlDataSinr",
+                                                    {{"Time", NrBinaryTraceFile::TIME, {}},
+                                                     {"CellId", NrBinaryTraceFile::UINT16, {}},
+                                                     {"RNTI", NrBinaryTraceFile::UINT16, {}},
+                                                     {"BWPId", NrBinaryTraceFile::UINT16, {}},
+                                                     {"StreamId", NrBinaryTraceFile::UINT8, {}},
+                                                     {"SINR(dB)", NrBinaryTraceFile::DOUBLE, {}}});
+        }
+        m_dlDataSinrBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+        m_dlDataSinrBinaryFile->Add(cellId);
+        m_dlDataSinrBinaryFile->Add(rnti);
+        m_dlDataSinrBinaryFile->Add(bwpId);
+        m_dlDataSinrBinaryFile->Add(streamId);
+        m_dlDataSinrBinaryFile->Add(10 * log10(avgSinr));
+        return;
+    }
+
     if (!m_dlDataSinrFile.is_open())
     {
         std::ostringstream oss;
@@ -179,7 +405,7 @@ NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                          << "\t"
                          << "StreamId"
                          << "\t"
-                         << "SINR(dB)" << std::endl;
+                         << "SINR(dB)" << "\n";
 
         if (!m_dlDataSinrFile.is_open())
         {
@@ -188,7 +414,7 @@ NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     }
 
     m_dlDataSinrFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << rnti << "\t"
-                     << bwpId << "\t" << +streamId << "\t" << 10 * log10(avgSinr) << std::endl;
+                     << bwpId << "\t" << +streamId << "\t" << 10 * log10(avgSinr) << "\n";
 }
 
 void
@@ -203,6 +429,27 @@ NrPhyRxTrace::DlCtrlSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     NS_LOG_INFO("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId
                      << "->Generate DlCtrlSinrTrace");
 
+    if (m_binaryFormat)
+    {
+        if (!m_dlCtrlSinrBinaryFile)
+        {
+            m_dlCtrlSinrBinaryFile = OpenBinaryFile("DlCtrlSinr",
+                                                    {{"Time", NrBinaryTraceFile::TIME, {}},
+                                                     {"CellId", NrBinaryTraceFile::UINT16, {}},
+                                                     {"RNTI", NrBinaryTraceFile::UINT16, {}},
+                                                     {"BWPId", NrBinaryTraceFile::UINT16, {}},
+                                                     {"StreamId", NrBinaryTraceFile::UINT8, {}},
+                                                     {"SINR(dB)", NrBinaryTraceFile::DOUBLE, {}}});
+        }
+        m_dlCtrlSinrBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+        m_dlCtrlSinrBinaryFile->Add(cellId);
+        m_dlCtrlSinrBinaryFile->Add(rnti);
+        m_dlCtrlSinrBinaryFile->Add(bwpId);
+        m_dlCtrlSinrBinaryFile->Add(streamId);
+        m_dlCtrlSinrBinaryFile->Add(10 * log10(avgSinr));
+        return;
+    }
+
     if (!m_dlCtrlSinrFile.is_open())
     {
         std::ostringstream oss;
@@ -220,7 +467,7 @@ NrPhyRxTrace::DlCtrlSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                          << "\t"
                          << "StreamId"
                          << "\t"
-                         << "SINR(dB)" << std::endl;
+                         << "SINR(dB)" << "\n";
 
         if (!m_dlCtrlSinrFile.is_open())
         {
@@ -229,7 +476,7 @@ NrPhyRxTrace::DlCtrlSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     }
 
     m_dlCtrlSinrFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << rnti << "\t"
-                     << bwpId << "\t" << +streamId << "\t" << 10 * log10(avgSinr) << std::endl;
+                     << bwpId << "\t" << +streamId << "\t" << 10 * log10(avgSinr) << "\n";
 }
 
 void
@@ -274,6 +521,19 @@ NrPhyRxTrace::RxedGnbPhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                          uint8_t bwpId,
                                          Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_rxedGnbPhyCtrlMsgsBinaryFile,
+                           "RxedGnbPhyCtrlMsgsTrace",
+                           "ENB PHY Rxed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_rxedGnbPhyCtrlMsgsFile.is_open())
     {
         std::ostringstream oss;
@@ -297,7 +557,7 @@ NrPhyRxTrace::RxedGnbPhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                  << "\t"
                                  << "bwpId"
                                  << "\t"
-                                 << "MsgType" << std::endl;
+                                 << "MsgType" << "\n";
 
         if (!m_rxedGnbPhyCtrlMsgsFile.is_open())
         {
@@ -340,7 +600,7 @@ NrPhyRxTrace::RxedGnbPhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
     {
         m_rxedGnbPhyCtrlMsgsFile << "Other";
     }
-    m_rxedGnbPhyCtrlMsgsFile << std::endl;
+    m_rxedGnbPhyCtrlMsgsFile << "\n";
 }
 
 void
@@ -352,6 +612,19 @@ NrPhyRxTrace::TxedGnbPhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                          uint8_t bwpId,
                                          Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_txedGnbPhyCtrlMsgsBinaryFile,
+                           "TxedGnbPhyCtrlMsgsTrace",
+                           "ENB PHY Txed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_txedGnbPhyCtrlMsgsFile.is_open())
     {
         std::ostringstream oss;
@@ -375,7 +648,7 @@ NrPhyRxTrace::TxedGnbPhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                  << "\t"
                                  << "bwpId"
                                  << "\t"
-                                 << "MsgType" << std::endl;
+                                 << "MsgType" << "\n";
 
         if (!m_txedGnbPhyCtrlMsgsFile.is_open())
         {
@@ -414,7 +687,7 @@ NrPhyRxTrace::TxedGnbPhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
     {
         m_txedGnbPhyCtrlMsgsFile << "Other";
     }
-    m_txedGnbPhyCtrlMsgsFile << std::endl;
+    m_txedGnbPhyCtrlMsgsFile << "\n";
 }
 
 void
@@ -426,6 +699,19 @@ NrPhyRxTrace::RxedUePhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                         uint8_t bwpId,
                                         Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_rxedUePhyCtrlMsgsBinaryFile,
+                           "RxedUePhyCtrlMsgsTrace",
+                           "UE  PHY Rxed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_rxedUePhyCtrlMsgsFile.is_open())
     {
         std::ostringstream oss;
@@ -449,7 +735,7 @@ NrPhyRxTrace::RxedUePhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                 << "\t"
                                 << "bwpId"
                                 << "\t"
-                                << "MsgType" << std::endl;
+                                << "MsgType" << "\n";
 
         if (!m_rxedUePhyCtrlMsgsFile.is_open())
         {
@@ -488,7 +774,7 @@ NrPhyRxTrace::RxedUePhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
     {
         m_rxedUePhyCtrlMsgsFile << "Other";
     }
-    m_rxedUePhyCtrlMsgsFile << std::endl;
+    m_rxedUePhyCtrlMsgsFile << "\n";
 }
 
 void
@@ -500,6 +786,19 @@ NrPhyRxTrace::TxedUePhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                         uint8_t bwpId,
                                         Ptr<const NrControlMessage> msg)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryCtrlMsg(m_txedUePhyCtrlMsgsBinaryFile,
+                           "TxedUePhyCtrlMsgsTrace",
+                           "UE  PHY Txed",
+                           sfn,
+                           nodeId,
+                           rnti,
+                           bwpId,
+                           msg);
+        return;
+    }
+
     if (!m_txedUePhyCtrlMsgsFile.is_open())
     {
         std::ostringstream oss;
@@ -523,7 +822,7 @@ NrPhyRxTrace::TxedUePhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
                                 << "\t"
                                 << "bwpId"
                                 << "\t"
-                                << "MsgType" << std::endl;
+                                << "MsgType" << "\n";
 
         if (!m_txedUePhyCtrlMsgsFile.is_open())
         {
@@ -566,7 +865,7 @@ NrPhyRxTrace::TxedUePhyCtrlMsgsCallback(Ptr<NrPhyRxTrace> phyStats,
     {
         m_txedUePhyCtrlMsgsFile << "Other";
     }
-    m_txedUePhyCtrlMsgsFile << std::endl;
+    m_txedUePhyCtrlMsgsFile << "\n";
 }
 
 void
@@ -579,6 +878,12 @@ NrPhyRxTrace::RxedUePhyDlDciCallback(Ptr<NrPhyRxTrace> phyStats,
                                      uint8_t harqId,
                                      uint32_t k1Delay)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryDlDci(0, sfn, nodeId, rnti, bwpId, harqId, k1Delay);
+        return;
+    }
+
     if (!m_rxedUePhyDlDciFile.is_open())
     {
         std::ostringstream oss;
@@ -604,7 +909,7 @@ NrPhyRxTrace::RxedUePhyDlDciCallback(Ptr<NrPhyRxTrace> phyStats,
                              << "\t"
                              << "Harq ID"
                              << "\t"
-                             << "K1 Delay" << std::endl;
+                             << "K1 Delay" << "\n";
 
         if (!m_rxedUePhyDlDciFile.is_open())
         {
@@ -618,7 +923,7 @@ NrPhyRxTrace::RxedUePhyDlDciCallback(Ptr<NrPhyRxTrace> phyStats,
                          << static_cast<uint32_t>(sfn.GetSubframe()) << "\t"
                          << static_cast<uint32_t>(sfn.GetSlot()) << "\t" << nodeId << "\t" << rnti
                          << "\t" << static_cast<uint32_t>(bwpId) << "\t"
-                         << static_cast<uint32_t>(harqId) << "\t" << k1Delay << std::endl;
+                         << static_cast<uint32_t>(harqId) << "\t" << k1Delay << "\n";
 }
 
 void
@@ -631,6 +936,12 @@ NrPhyRxTrace::TxedUePhyHarqFeedbackCallback(Ptr<NrPhyRxTrace> phyStats,
                                             uint8_t harqId,
                                             uint32_t k1Delay)
 {
+    if (m_binaryFormat)
+    {
+        WriteBinaryDlDci(1, sfn, nodeId, rnti, bwpId, harqId, k1Delay);
+        return;
+    }
+
     if (!m_rxedUePhyDlDciFile.is_open())
     {
         std::ostringstream oss;
@@ -656,7 +967,7 @@ NrPhyRxTrace::TxedUePhyHarqFeedbackCallback(Ptr<NrPhyRxTrace> phyStats,
                              << "\t"
                              << "Harq ID"
                              << "\t"
-                             << "K1 Delay" << std::endl;
+                             << "K1 Delay" << "\n";
 
         if (!m_rxedUePhyDlDciFile.is_open())
         {
@@ -670,7 +981,7 @@ NrPhyRxTrace::TxedUePhyHarqFeedbackCallback(Ptr<NrPhyRxTrace> phyStats,
                          << static_cast<uint32_t>(sfn.GetSubframe()) << "\t"
                          << static_cast<uint32_t>(sfn.GetSlot()) << "\t" << nodeId << "\t" << rnti
                          << "\t" << static_cast<uint32_t>(bwpId) << "\t"
-                         << static_cast<uint32_t>(harqId) << "\t" << k1Delay << std::endl;
+                         << static_cast<uint32_t>(harqId) << "\t" << k1Delay << "\n";
 }
 
 void
@@ -814,6 +1125,24 @@ NrPhyRxTrace::RxPacketTraceUeCallback(Ptr<NrPhyRxTrace> phyStats,
                                       std::string path,
                                       RxPacketTraceParams params)
 {
+    if (params.m_corrupt)
+    {
+        NS_LOG_DEBUG("DL TB error\t"
+                     << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum << "\t"
+                     << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart << "\t"
+                     << (unsigned)params.m_numSym << "\t" << params.m_rnti << "\t"
+                     << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
+                     << (unsigned)params.m_rv << "\t" << params.m_sinr << "\t"
+                     << (unsigned)params.m_cqi << "\t" << params.m_tbler << "\t" << params.m_corrupt
+                     << "\t" << (unsigned)params.m_bwpId);
+    }
+
+    if (m_binaryFormat)
+    {
+        WriteBinaryRxPacketTrace(true, params);
+        return;
+    }
+
     if (!m_rxPacketTraceFile.is_open())
     {
         std::ostringstream oss;
@@ -855,7 +1184,7 @@ NrPhyRxTrace::RxPacketTraceUeCallback(Ptr<NrPhyRxTrace> phyStats,
                             << "\t"
                             << "corrupt"
                             << "\t"
-                            << "TBler" << std::endl;
+                            << "TBler" << "\n";
 
         if (!m_rxPacketTraceFile.is_open())
         {
@@ -873,26 +1202,32 @@ NrPhyRxTrace::RxPacketTraceUeCallback(Ptr<NrPhyRxTrace> phyStats,
                         << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
                         << (unsigned)params.m_rv << "\t" << 10 * log10(params.m_sinr) << "\t"
                         << (unsigned)params.m_cqi << "\t" << params.m_corrupt << "\t"
-                        << params.m_tbler << std::endl;
+                        << params.m_tbler << "\n";
+}
 
+void
+NrPhyRxTrace::RxPacketTraceEnbCallback(Ptr<NrPhyRxTrace> phyStats,
+                                       std::string path,
+                                       RxPacketTraceParams params)
+{
     if (params.m_corrupt)
     {
-        NS_LOG_DEBUG("DL TB error\t"
+        NS_LOG_DEBUG("UL TB error\t"
                      << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum << "\t"
                      << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart << "\t"
                      << (unsigned)params.m_numSym << "\t" << params.m_rnti << "\t"
                      << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
-                     << (unsigned)params.m_rv << "\t" << params.m_sinr << "\t"
-                     << (unsigned)params.m_cqi << "\t" << params.m_tbler << "\t" << params.m_corrupt
-                     << "\t" << (unsigned)params.m_bwpId);
+                     << (unsigned)params.m_rv << "\t" << params.m_sinr << "\t" << params.m_tbler
+                     << "\t" << params.m_corrupt << "\t" << params.m_sinrMin << "\t"
+                     << params.m_bwpId);
+    }
+
+    if (m_binaryFormat)
+    {
+        WriteBinaryRxPacketTrace(false, params);
+        return;
     }
-}
 
-void
-NrPhyRxTrace::RxPacketTraceEnbCallback(Ptr<NrPhyRxTrace> phyStats,
-                                       std::string path,
-                                       RxPacketTraceParams params)
-{
     if (!m_rxPacketTraceFile.is_open())
     {
         std::ostringstream oss;
@@ -932,7 +1267,7 @@ NrPhyRxTrace::RxPacketTraceEnbCallback(Ptr<NrPhyRxTrace> phyStats,
                             << "\t"
                             << "corrupt"
                             << "\t"
-                            << "TBler" << std::endl;
+                            << "TBler" << "\n";
 
         if (!m_rxPacketTraceFile.is_open())
         {
@@ -948,19 +1283,7 @@ NrPhyRxTrace::RxPacketTraceEnbCallback(Ptr<NrPhyRxTrace> phyStats,
                         << static_cast<uint16_t>(params.m_streamId) << "\t" << params.m_rnti << "\t"
                         << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
                         << (unsigned)params.m_rv << "\t" << 10 * log10(params.m_sinr) << "\t"
-                        << params.m_corrupt << "\t" << params.m_tbler << std::endl;
-
-    if (params.m_corrupt)
-    {
-        NS_LOG_DEBUG("UL TB error\t"
-                     << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum << "\t"
-                     << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart << "\t"
-                     << (unsigned)params.m_numSym << "\t" << params.m_rnti << "\t"
-                     << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
-                     << (unsigned)params.m_rv << "\t" << params.m_sinr << "\t" << params.m_tbler
-                     << "\t" << params.m_corrupt << "\t" << params.m_sinrMin << "\t"
-                     << params.m_bwpId);
-    }
+                        << params.m_corrupt << "\t" << params.m_tbler << "\n";
 }
 
 void
@@ -1026,6 +1349,24 @@ NrPhyRxTrace::WriteDlPathlossTrace(Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                                    Ptr<NrSpectrumPhy> rxNrSpectrumPhy,
                                    double lossDb)
 {
+    if (m_binaryFormat)
+    {
+        if (!m_dlPathlossBinaryFile)
+        {
+            m_dlPathlossBinaryFile = OpenBinaryFile("DlPathlossTrace", GetPathlossFields());
+        }
+        m_dlPathlossBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+        m_dlPathlossBinaryFile->Add(
+            txNrSpectrumPhy->GetDevice()->GetObject<NrGnbNetDevice>()->GetCellId());
+        m_dlPathlossBinaryFile->Add(txNrSpectrumPhy->GetBwpId());
+        m_dlPathlossBinaryFile->Add(txNrSpectrumPhy->GetStreamId());
+        m_dlPathlossBinaryFile->Add(
+            rxNrSpectrumPhy->GetDevice()->GetObject<NrUeNetDevice>()->GetImsi());
+        m_dlPathlossBinaryFile->Add(rxNrSpectrumPhy->GetStreamId());
+        m_dlPathlossBinaryFile->Add(lossDb);
+        return;
+    }
+
     if (!m_dlPathlossFile.is_open())
     {
         std::ostringstream oss;
@@ -1045,7 +1386,7 @@ NrPhyRxTrace::WriteDlPathlossTrace(Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                          << "\t"
                          << "rxStreamId"
                          << "\t"
-                         << "pathLoss(dB)" << std::endl;
+                         << "pathLoss(dB)" << "\n";
 
         if (!m_dlPathlossFile.is_open())
         {
@@ -1058,7 +1399,7 @@ NrPhyRxTrace::WriteDlPathlossTrace(Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                      << "\t" << txNrSpectrumPhy->GetBwpId() << "\t"
                      << +txNrSpectrumPhy->GetStreamId() << "\t"
                      << rxNrSpectrumPhy->GetDevice()->GetObject<NrUeNetDevice>()->GetImsi() << "\t"
-                     << +rxNrSpectrumPhy->GetStreamId() << "\t" << lossDb << std::endl;
+                     << +rxNrSpectrumPhy->GetStreamId() << "\t" << lossDb << "\n";
 }
 
 void
@@ -1066,6 +1407,23 @@ NrPhyRxTrace::WriteUlPathlossTrace(Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                                    Ptr<NrSpectrumPhy> rxNrSpectrumPhy,
                                    double lossDb)
 {
+    if (m_binaryFormat)
+    {
+        if (!m_ulPathlossBinaryFile)
+        {
+            m_ulPathlossBinaryFile = OpenBinaryFile("UlPathlossTrace", GetPathlossFields());
+        }
+        Ptr<NrUeNetDevice> ueDevice = txNrSpectrumPhy->GetDevice()->GetObject<NrUeNetDevice>();
+        m_ulPathlossBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+        m_ulPathlossBinaryFile->Add(ueDevice->GetCellId());
+        m_ulPathlossBinaryFile->Add(txNrSpectrumPhy->GetBwpId());
+        m_ulPathlossBinaryFile->Add(txNrSpectrumPhy->GetStreamId());
+        m_ulPathlossBinaryFile->Add(ueDevice->GetImsi());
+        m_ulPathlossBinaryFile->Add(rxNrSpectrumPhy->GetStreamId());
+        m_ulPathlossBinaryFile->Add(lossDb);
+        return;
+    }
+
     if (!m_ulPathlossFile.is_open())
     {
         std::ostringstream oss;
@@ -1085,7 +1443,7 @@ NrPhyRxTrace::WriteUlPathlossTrace(Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                          << "\t"
                          << "rxStreamId"
                          << "\t"
-                         << "pathLoss(dB)" << std::endl;
+                         << "pathLoss(dB)" << "\n";
 
         if (!m_ulPathlossFile.is_open())
         {
@@ -1098,7 +1456,7 @@ NrPhyRxTrace::WriteUlPathlossTrace(Ptr<NrSpectrumPhy> txNrSpectrumPhy,
                      << "\t" << txNrSpectrumPhy->GetBwpId() << "\t"
                      << +txNrSpectrumPhy->GetStreamId() << "\t"
                      << txNrSpectrumPhy->GetDevice()->GetObject<NrUeNetDevice>()->GetImsi() << "\t"
-                     << +rxNrSpectrumPhy->GetStreamId() << "\t" << lossDb << std::endl;
+                     << +rxNrSpectrumPhy->GetStreamId() << "\t" << lossDb << "\n";
 }
 
 void
@@ -1113,6 +1471,28 @@ NrPhyRxTrace::ReportDlCtrlPathloss([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     NS_LOG_INFO("UE node id:" << ueNodeId << "of " << cellId << " over bwp ID " << bwpId
                               << "->Generate DL CTRL pathloss record: " << lossDb);
 
+    if (m_binaryFormat)
+    {
+        if (!m_dlCtrlPathlossBinaryFile)
+        {
+            m_dlCtrlPathlossBinaryFile =
+                OpenBinaryFile("DlCtrlPathlossTrace",
+                               {{"Time(sec)", NrBinaryTraceFile::TIME, {}},
+                                {"CellId", NrBinaryTraceFile::UINT16, {}},
+                                {"BwpId", NrBinaryTraceFile::UINT8, {}},
+                                {"streamId", NrBinaryTraceFile::UINT8, {}},
+                                {"ueNodeId", NrBinaryTraceFile::UINT32, {}},
+                                {"pathLoss(dB)", NrBinaryTraceFile::DOUBLE, {}}});
+        }
+        m_dlCtrlPathlossBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+        m_dlCtrlPathlossBinaryFile->Add(cellId);
+        m_dlCtrlPathlossBinaryFile->Add(bwpId);
+        m_dlCtrlPathlossBinaryFile->Add(streamId);
+        m_dlCtrlPathlossBinaryFile->Add(ueNodeId);
+        m_dlCtrlPathlossBinaryFile->Add(lossDb);
+        return;
+    }
+
     if (!m_dlCtrlPathlossFile.is_open())
     {
         std::ostringstream oss;
@@ -1130,7 +1510,7 @@ NrPhyRxTrace::ReportDlCtrlPathloss([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                              << "\t"
                              << "ueNodeId"
                              << "\t"
-                             << "pathLoss(dB)" << std::endl;
+                             << "pathLoss(dB)" << "\n";
 
         if (!m_dlCtrlPathlossFile.is_open())
         {
@@ -1139,7 +1519,7 @@ NrPhyRxTrace::ReportDlCtrlPathloss([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     }
 
     m_dlCtrlPathlossFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << +bwpId
-                         << "\t" << +streamId << "\t" << ueNodeId << "\t" << lossDb << std::endl;
+                         << "\t" << +streamId << "\t" << ueNodeId << "\t" << lossDb << "\n";
 }
 
 void
@@ -1155,6 +1535,30 @@ NrPhyRxTrace::ReportDlDataPathloss([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     NS_LOG_INFO("UE node id:" << ueNodeId << "of " << cellId << " over bwp ID " << bwpId
                               << "->Generate DL DATA pathloss record: " << lossDb);
 
+    if (m_binaryFormat)
+    {
+        if (!m_dlDataPathlossBinaryFile)
+        {
+            m_dlDataPathlossBinaryFile =
+                OpenBinaryFile("DlDataPathlossTrace",
+                               {{"Time(sec)", NrBinaryTraceFile::TIME, {}},
+                                {"CellId", NrBinaryTraceFile::UINT16, {}},
+                                {"BwpId", NrBinaryTraceFile::UINT8, {}},
+                                {"streamId", NrBinaryTraceFile::UINT8, {}},
+                                {"ueNodeId", NrBinaryTraceFile::UINT32, {}},
+                                {"pathLoss(dB)", NrBinaryTraceFile::DOUBLE, {}},
+                                {"CQI", NrBinaryTraceFile::UINT8, {}}});
+        }
+        m_dlDataPathlossBinaryFile->AddTime(Simulator::Now().GetNanoSeconds());
+        m_dlDataPathlossBinaryFile->Add(cellId);
+        m_dlDataPathlossBinaryFile->Add(bwpId);
+        m_dlDataPathlossBinaryFile->Add(streamId);
+        m_dlDataPathlossBinaryFile->Add(ueNodeId);
+        m_dlDataPathlossBinaryFile->Add(lossDb);
+        m_dlDataPathlossBinaryFile->Add(cqi);
+        return;
+    }
+
     if (!m_dlDataPathlossFile.is_open())
     {
         std::ostringstream oss;
@@ -1174,7 +1578,7 @@ NrPhyRxTrace::ReportDlDataPathloss([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                              << "\t"
                              << "pathLoss(dB)"
                              << "\t"
-                             << "CQI" << std::endl;
+                             << "CQI" << "\n";
 
         if (!m_dlDataPathlossFile.is_open())
         {
@@ -1184,7 +1588,7 @@ NrPhyRxTrace::ReportDlDataPathloss([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
 
     m_dlDataPathlossFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << +bwpId
                          << "\t" << +streamId << "\t" << ueNodeId << "\t" << lossDb << "\t" << +cqi
-                         << std::endl;
+                         << "\n";
 }
 
 } /* namespace ns3 */
@@ -8,6 +8,8 @@
 #ifndef SRC_NR_HELPER_NR_PHY_RX_TRACE_H_
 #define SRC_NR_HELPER_NR_PHY_RX_TRACE_H_
 
+#include "nr-binary-trace-file.h"
+
 #include <ns3/nr-control-messages.h>
 #include <ns3/nr-phy-mac-common.h>
 #include <ns3/nr-spectrum-phy.h>
@@ -17,6 +19,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 
 namespace ns3
 {
@@ -41,6 +44,27 @@ class NrPhyRxTrace : public Object
      */
     void SetResultsFolder(const std::string& resultsFolder);
 
+    /**
+     * \brief Set the format of the trace files
+     *
+     * The binary files of NrBinaryTraceFile have the extension .bin instead
+     * of .txt, and are converted to CSV by the program nr-binary-trace-to-csv.
+     * \param binaryFormat true for the binary format, false for text
+     */
+    void SetBinaryFormat(bool binaryFormat);
+
+    /**
+     * \brief Set the buffer size of the binary trace files
+     * \param bufferSize the size of the buffer of each file in bytes
+     */
+    void SetBinaryBufferSize(uint32_t bufferSize);
+
+    /**
+     * \brief Set whether the binary trace files are written by a thread
+     * \param asyncWrite true to write the full buffers with a thread
+     */
+    void SetBinaryAsyncWrite(bool asyncWrite);
+
     /**
      * \brief Trace sink for DL Average SINR of DATA (in dB).
      * \param [in] phyStats NrPhyRxTrace object
@@ -296,8 +320,67 @@ class NrPhyRxTrace : public Object
                               Ptr<NrSpectrumPhy> rxNrSpectrumPhy,
                               double lossDb);
 
+    /**
+     * \brief Open a trace file in the binary format
+     * \param name the name of the trace, completed with the results folder,
+     * the simulation tag and the extension .bin
+     * \param fields the fields of the records
+     * \return the trace file
+     */
+    static std::unique_ptr<NrBinaryTraceFile> OpenBinaryFile(
+        const std::string& name,
+        const std::vector<NrBinaryTraceFile::Field>& fields);
+
+    /**
+     * \brief Write a record of a control message trace in the binary format
+     * \param file the trace file, opened if needed
+     * \param name the name of the trace
+     * \param entity the entity of the trace
+     * \param sfn the SfnSf
+     * \param nodeId the node ID
+     * \param rnti the RNTI
+     * \param bwpId the BWP ID
+     * \param msg the message
+     */
+    static void WriteBinaryCtrlMsg(std::unique_ptr<NrBinaryTraceFile>& file,
+                                   const std::string& name,
+                                   const std::string& entity,
+                                   SfnSf sfn,
+                                   uint16_t nodeId,
+                                   uint16_t rnti,
+                                   uint8_t bwpId,
+                                   Ptr<const NrControlMessage> msg);
+
+    /**
+     * \brief Write a record of the DL DCI trace in the binary format
+     * \param entity 0 for a received DL DCI, 1 for a transmitted HARQ feedback
+     * \param sfn the SfnSf
+     * \param nodeId the node ID
+     * \param rnti the RNTI
+     * \param bwpId the BWP ID
+     * \param harqId the HARQ process ID
+     * \param k1Delay the K1 delay
+     */
+    static void WriteBinaryDlDci(uint8_t entity,
+                                 SfnSf sfn,
+                                 uint16_t nodeId,
+                                 uint16_t rnti,
+                                 uint8_t bwpId,
+                                 uint8_t harqId,
+                                 uint32_t k1Delay);
+
+    /**
+     * \brief Write a record of the RX packet trace in the binary format
+     * \param downlink true for a DL reception at the UE, false for an UL one
+     * \param params the parameters of the reception
+     */
+    static void WriteBinaryRxPacketTrace(bool downlink, const RxPacketTraceParams& params);
+
     static std::string m_simTag;        //!< The `SimTag` attribute.
     static std::string m_resultsFolder; //!< The results folder path
+    static bool m_binaryFormat;         //!< The `BinaryFormat` attribute.
+    static uint32_t m_binaryBufferSize; //!< The `BinaryBufferSize` attribute.
+    static bool m_binaryAsyncWrite;     //!< The `BinaryAsyncWrite` attribute.
 
     static std::ofstream m_dlDataSinrFile;
     static std::string m_dlDataSinrFileName;
@@ -328,6 +411,19 @@ class NrPhyRxTrace : public Object
     static std::string m_dlCtrlPathlossFileName;
     static std::ofstream m_dlDataPathlossFile;
     static std::string m_dlDataPathlossFileName;
+
+    static std::unique_ptr<NrBinaryTraceFile> m_dlDataSinrBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_dlCtrlSinrBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_rxPacketTraceBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_rxedGnbPhyCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_txedGnbPhyCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_rxedUePhyCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_txedUePhyCtrlMsgsBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_rxedUePhyDlDciBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_dlPathlossBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_ulPathlossBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_dlCtrlPathlossBinaryFile;
+    static std::unique_ptr<NrBinaryTraceFile> m_dlDataPathlossBinaryFile;
 };
 
 } /* namespace ns3 */
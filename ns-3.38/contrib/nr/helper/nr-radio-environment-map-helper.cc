@@ -24,11 +24,17 @@
 #include <ns3/pointer.h>
 #include <ns3/simulator.h>
 #include <ns3/spectrum-converter.h>
+#include <ns3/rng-seed-manager.h>
 #include <ns3/string.h>
+#include <ns3/thread-pool.h>
+#include <ns3/trace-source-accessor.h>
 #include <ns3/uinteger.h>
 
+#include <cstdio>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <limits>
 
 namespace ns3
@@ -38,6 +44,27 @@ NS_LOG_COMPONENT_DEFINE("NrRadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED(NrRadioEnvironmentMapHelper);
 
+namespace
+{
+
+/**
+ * \param values the values of a PSD
+ * \param numBands the number of bands
+ * \return the sum of the values, as Sum of a SpectrumValue
+ */
+double
+SumBands(const double* values, std::size_t numBands)
+{
+    double s = 0;
+    for (std::size_t band = 0; band < numBands; ++band)
+    {
+        s += values[band];
+    }
+    return s;
+}
+
+} // namespace
+
 NrRadioEnvironmentMapHelper::NrRadioEnvironmentMapHelper()
 {
     NS_LOG_FUNCTION(this);
@@ -155,7 +182,44 @@ NrRadioEnvironmentMapHelper::GetTypeId()
                 "depends on RRC message timing.",
                 TimeValue(MilliSeconds(100)),
                 MakeTimeAccessor(&NrRadioEnvironmentMapHelper::SetInstallationDelay),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("NumThreads",
+                          "Number of threads computing the REM points of a tile, each with its "
+                          "own copies of the REM devices. The propagation models of a point are "
+                          "created in the simulation thread with the random streams of the "
+                          "point, so the map does not depend on this value. With buildings, the "
+                          "points are computed in the simulation thread.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetNumThreads),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("TileSize",
+                          "Number of consecutive REM points computed, and appended to the output "
+                          "file, at once.",
+                          UintegerValue(256),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::m_tileSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Checkpoint",
+                          "If true, the number of REM points done is saved after each tile in "
+                          "nr-rem-${SimTag}.checkpoint, and a run with the same map and seed "
+                          "resumes from there. The checkpoint is removed when the map is done.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrRadioEnvironmentMapHelper::m_checkpoint),
+                          MakeBooleanChecker())
+            .AddAttribute("StreamBase",
+                          "First random stream of the propagation models of the REM. Each REM "
+                          "point uses its own block of streams after this one, so that its "
+                          "values do not depend on the tiles, the threads or a resume. The "
+                          "channels of the REM are therefore not the ones drawn by the versions "
+                          "of this helper which took the streams from the global stream counter: "
+                          "for the same seed and run, the REM output differs from theirs.",
+                          IntegerValue(1000000000),
+                          MakeIntegerAccessor(&NrRadioEnvironmentMapHelper::m_streamBase),
+                          MakeIntegerChecker<int64_t>(0))
+            .AddTraceSource("TileDone",
+                            "The REM points of a tile have been appended to the output file, "
+                            "and the checkpoint saved.",
+                            MakeTraceSourceAccessor(&NrRadioEnvironmentMapHelper::m_tileDoneTrace),
+                            "ns3::NrRadioEnvironmentMapHelper::TileDoneTracedCallback");
     return tid;
 }
 
@@ -165,6 +229,13 @@ NrRadioEnvironmentMapHelper::SetRemMode(enum RemMode remMode)
     m_remMode = remMode;
 }
 
+void
+NrRadioEnvironmentMapHelper::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_threadPool.reset(numThreads > 1 ? new ThreadPool(numThreads) : nullptr);
+}
+
 void
 NrRadioEnvironmentMapHelper::SetSimTag(const std::string& simTag)
 {
@@ -318,6 +389,16 @@ NrRadioEnvironmentMapHelper::ConfigureRrd(const Ptr<NetDevice>& rrdDevice)
 
     m_noisePsd = NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(m_rrdPhy->GetNoiseFigure(),
                                                                         m_rrd.spectrumModel);
+    // plain copies for the computation of the values of the REM points
+    m_numBands = m_rrd.spectrumModel->GetNumBands();
+    m_noiseValues.assign(m_noisePsd->ConstValuesBegin(), m_noisePsd->ConstValuesEnd());
+    m_bandWidths.clear();
+    for (Bands::const_iterator band = m_rrd.spectrumModel->Begin();
+         band != m_rrd.spectrumModel->End();
+         ++band)
+    {
+        m_bandWidths.push_back(band->fh - band->fl);
+    }
 
     ConfigurePropagationModelsFactories(
         m_rrdPhy); // we can call only once configuration of prop.models
@@ -389,9 +470,14 @@ NrRadioEnvironmentMapHelper::ConfigurePropagationModelsFactories(const Ptr<const
 
     /***** configure pathloss model factory *****/
     m_propagationLossModel = txSpectrumChannel->GetPropagationLossModel();
+    m_propagationLossModelFactory = ConfigureObjectFactory(m_propagationLossModel);
     /***** configure spectrum model factory *****/
     m_phasedArraySpectrumLossModel =
         txSpectrumChannel->GetPhasedArraySpectrumPropagationLossModel();
+    if (m_phasedArraySpectrumLossModel)
+    {
+        m_spectrumLossModelFactory = ConfigureObjectFactory(m_phasedArraySpectrumLossModel);
+    }
 
     /***** configure ChannelConditionModel factory if ThreeGppPropagationLossModel propagation model
      * is being used ****/
@@ -600,23 +686,9 @@ NrRadioEnvironmentMapHelper::DelayedInstall(const NetDeviceContainer& rtdNetDev,
     ConfigureRrd(rrdDevice);
     ConfigureRtdList(rtdNetDev);
     CreateListOfRemPoints();
-    if (m_remMode == COVERAGE_AREA)
-    {
-        CalcCoverageAreaRemMap();
-    }
-    else if (m_remMode == BEAM_SHAPE)
-    {
-        CalcBeamShapeRemMap();
-    }
-    else if (m_remMode == UE_COVERAGE)
-    {
-        CalcUeCoverageRemMap();
-    }
-    else
-    {
-        NS_FATAL_ERROR("Unknown REM mode");
-    }
-    PrintRemToFile();
+    CalcRemMap();
+    CreateCustomGnuplotFile();
+    Finalize();
 
     std::ostringstream ossGnbs;
     ossGnbs << "nr-rem-" << m_simTag.c_str() << "-gnbs.txt";
@@ -672,7 +744,7 @@ NrRadioEnvironmentMapHelper::CreateListOfRemPoints()
 }
 
 void
-NrRadioEnvironmentMapHelper::ConfigureQuasiOmniBfv(RemDevice& device)
+NrRadioEnvironmentMapHelper::ConfigureQuasiOmniBfv(RemDevice& device) const
 {
     NS_LOG_FUNCTION(this);
     // configure beam on rrd antenna to be quasi-omni
@@ -685,19 +757,20 @@ NrRadioEnvironmentMapHelper::ConfigureQuasiOmniBfv(RemDevice& device)
 }
 
 void
-NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(RemDevice& device,
-                                                    const RemDevice& otherDevice,
-                                                    const Ptr<const UniformPlanarArray>& antenna)
+NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(
+    RemDevice& device,
+    const RemDevice& otherDevice,
+    const Ptr<const UniformPlanarArray>& antenna) const
 {
     NS_LOG_FUNCTION(this);
     device.antenna->SetBeamformingVector(CreateDirectPathBfv(device.mob, otherDevice.mob, antenna));
 }
 
 Ptr<SpectrumValue>
-NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const
+NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device,
+                                            RemDevice& otherDevice,
+                                            const PropagationModels& tempPropModels) const
 {
-    PropagationModels tempPropModels = CreateTemporalPropagationModels();
-
     std::vector<int> activeRbs;
     for (size_t rbId = 0; rbId < device.spectrumModel->GetNumBands(); rbId++)
     {
@@ -757,20 +830,26 @@ NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherD
     return rxPsd;
 }
 
-Ptr<SpectrumValue>
-NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& values) const
+void
+NrRadioEnvironmentMapHelper::SaveRxPsd(const Ptr<const SpectrumValue>& rxPsd,
+                                       std::vector<double>* rxPsds) const
 {
-    // TODO add this abort, if necessary add include for abort.h
-    NS_ABORT_MSG_IF(values.size() == 0, "Must provide a list of values.");
+    NS_ASSERT_MSG(rxPsd->GetSpectrumModel()->GetNumBands() == m_numBands,
+                  "The received PSD is not in the spectrum model of the RRD");
+    rxPsds->insert(rxPsds->end(), rxPsd->ConstValuesBegin(), rxPsd->ConstValuesEnd());
+}
 
-    Ptr<SpectrumValue> maxValue = Create<SpectrumValue>(m_rrd.spectrumModel);
-    *maxValue = **(values.begin());
+const double*
+NrRadioEnvironmentMapHelper::GetMaxValue(const std::vector<const double*>& values) const
+{
+    NS_ABORT_MSG_IF(values.size() == 0, "Must provide a list of values.");
 
+    const double* maxValue = values.front();
     for (const auto& value : values)
     {
-        if (Sum(*(value)) > Sum(*(maxValue)))
+        if (SumBands(value, m_numBands) > SumBands(maxValue, m_numBands))
         {
-            *maxValue = *value;
+            maxValue = value;
         }
     }
     return maxValue;
@@ -778,213 +857,124 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& va
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSnr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::vector<const double*>& receivedPowerList) const
 {
-    Ptr<SpectrumValue> maxSnr = GetMaxValue(receivedPowerList);
-    SpectrumValue snr = (*maxSnr) / (*m_noisePsd);
-    return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
+    return CalculateSnr(GetMaxValue(receivedPowerList));
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const
+NrRadioEnvironmentMapHelper::CalculateSnr(const double* usefulSignal) const
 {
-    SpectrumValue snr = (*usefulSignal) / (*m_noisePsd);
-
-    return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
+    double snr = 0;
+    for (std::size_t band = 0; band < m_numBands; ++band)
+    {
+        snr += usefulSignal[band] / m_noiseValues[band];
+    }
+    return RatioToDb(snr / m_numBands);
 }
 
 double
 NrRadioEnvironmentMapHelper::CalculateSinr(
-    const Ptr<SpectrumValue>& usefulSignal,
-    const std::list<Ptr<SpectrumValue>>& interferenceSignals) const
+    const double* usefulSignal,
+    const std::vector<const double*>& interferenceSignals) const
 {
-    Ptr<SpectrumValue> interferencePsd = nullptr;
-
     if (interferenceSignals.size() == 0)
     {
         return CalculateSnr(usefulSignal);
     }
-    else
-    {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
-    }
 
-    // sum all interfering signals
-    for (auto rxInterfPower : interferenceSignals)
+    // sum all interfering signals, and calculate the sinr of each RB
+    double sinr = 0;
+    for (std::size_t band = 0; band < m_numBands; ++band)
     {
-        *interferencePsd += (*rxInterfPower);
+        double interference = 0;
+        for (const auto& rxInterfPower : interferenceSignals)
+        {
+            interference += rxInterfPower[band];
+        }
+        sinr += usefulSignal[band] / (interference + m_noiseValues[band]);
     }
-    // calculate sinr
-
-    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *m_noisePsd);
 
     // calculate average sinr over RBs, convert it from linear to dB units, and return it
-    return RatioToDb(Sum(sinr) / sinr.GetSpectrumModel()->GetNumBands());
+    return RatioToDb(sinr / m_numBands);
 }
 
 double
 NrRadioEnvironmentMapHelper::CalculateSir(
-    const Ptr<SpectrumValue>& usefulSignal,
-    const std::list<Ptr<SpectrumValue>>& interferenceSignals) const
+    const double* usefulSignal,
+    const std::vector<const double*>& interferenceSignals) const
 {
-    Ptr<SpectrumValue> interferencePsd = nullptr;
-
     if (interferenceSignals.size() == 0)
     {
-        // return CalculateSnr (usefulSignal);
-        SpectrumValue signal = (*usefulSignal);
-        return RatioToDb(Sum(signal) / signal.GetSpectrumModel()->GetNumBands());
-    }
-    else
-    {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        return RatioToDb(SumBands(usefulSignal, m_numBands) / m_numBands);
     }
 
-    // sum all interfering signals
-    for (auto rxInterfPower : interferenceSignals)
+    // sum all interfering signals, and calculate the sir of each RB
+    double sir = 0;
+    for (std::size_t band = 0; band < m_numBands; ++band)
     {
-        *interferencePsd += (*rxInterfPower);
+        double interference = 0;
+        for (const auto& rxInterfPower : interferenceSignals)
+        {
+            interference += rxInterfPower[band];
+        }
+        sir += usefulSignal[band] / interference;
     }
-    // calculate sinr
-
-    SpectrumValue sir = (*usefulSignal) / (*interferencePsd);
 
     // calculate average sir over RBs, convert it from linear to dB units, and return it
-    return RatioToDb(Sum(sir) / sir.GetSpectrumModel()->GetNumBands());
+    return RatioToDb(sir / m_numBands);
 }
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSinr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::vector<const double*>& receivedPowerList) const
 {
     // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
     // interferers
     std::list<double> sinrList;
+    std::vector<const double*> interferenceSignals;
 
-    for (std::list<Ptr<SpectrumValue>>::const_iterator it = receivedPowerList.begin();
-         it != receivedPowerList.end();
-         it++)
+    for (std::size_t i = 0; i < receivedPowerList.size(); ++i)
     {
         // all signals - rxPower = interference
-        std::list<Ptr<SpectrumValue>> interferenceSignals;
-        std::list<Ptr<SpectrumValue>>::const_iterator tempit = it;
-
-        if (it != receivedPowerList.begin())
+        interferenceSignals.clear();
+        for (std::size_t j = 0; j < receivedPowerList.size(); ++j)
         {
-            interferenceSignals.insert(interferenceSignals.begin(), receivedPowerList.begin(), it);
+            if (j != i)
+            {
+                interferenceSignals.push_back(receivedPowerList[j]);
+            }
         }
-
-        interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
-        NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sinrList.push_back(CalculateSinr(*it, interferenceSignals));
+        sinrList.push_back(CalculateSinr(receivedPowerList[i], interferenceSignals));
     }
     return GetMaxValue(sinrList);
 }
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSir(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::vector<const double*>& receivedPowerList) const
 {
-    // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
+    // we calculate sir considering for each RTD as if it would be TX device, and the rest of RTDs
     // interferers
     std::list<double> sirList;
+    std::vector<const double*> interferenceSignals;
 
-    for (std::list<Ptr<SpectrumValue>>::const_iterator it = receivedPowerList.begin();
-         it != receivedPowerList.end();
-         it++)
+    for (std::size_t i = 0; i < receivedPowerList.size(); ++i)
     {
         // all signals - rxPower = interference
-        std::list<Ptr<SpectrumValue>> interferenceSignals;
-        std::list<Ptr<SpectrumValue>>::const_iterator tempit = it;
-
-        if (it != receivedPowerList.begin())
+        interferenceSignals.clear();
+        for (std::size_t j = 0; j < receivedPowerList.size(); ++j)
         {
-            interferenceSignals.insert(interferenceSignals.begin(), receivedPowerList.begin(), it);
+            if (j != i)
+            {
+                interferenceSignals.push_back(receivedPowerList[j]);
+            }
         }
-
-        interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
-        NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sirList.push_back(CalculateSir(*it, interferenceSignals));
+        sirList.push_back(CalculateSir(receivedPowerList[i], interferenceSignals));
     }
     return GetMaxValue(sirList);
 }
 
-void
-NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
-{
-    NS_LOG_FUNCTION(this);
-    uint16_t calcRxPsdCounter = 0;
-
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
-
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
-    {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        double sumSir = 0.0;
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
-        m_rrd.mob->SetPosition(itRemPoint->pos);
-
-        Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
-        buildingInfo->MakeConsistent(m_rrd.mob);
-        NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
-
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
-        {
-            std::list<Ptr<SpectrumValue>>
-                receivedPowerList; // RTD node id, rxPsd of the singal coming from that node
-
-            for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end();
-                 ++itRtd)
-            {
-                calcRxPsdCounter++;
-
-                // calculate received power from the current RTD device
-                receivedPowerList.push_back(CalcRxPsdValue(*itRtd, m_rrd));
-            } // end for std::list<RemDev>::iterator  (RTDs)
-
-            sumSnr += CalculateMaxSnr(receivedPowerList);
-            sumSinr += CalculateMaxSinr(receivedPowerList);
-            sumSir += CalculateMaxSir(receivedPowerList);
-
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
-
-            receivedPowerList.clear();
-        } // end for m_numOfIterationsToAverage  (Average)
-
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
-
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
-
-        NS_LOG_INFO("Avg snr value saved:" << itRemPoint->avgSnrDb);
-        NS_LOG_INFO("Avg sinr value saved:" << itRemPoint->avgSinrDb);
-        NS_LOG_INFO("Avg ipsd value saved (dBm):" << itRemPoint->avRxPowerDbm);
-
-        if (++remPointCounter == remSizeNextReport)
-        {
-            PrintProgressReport(&remSizeNextReport);
-        }
-
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
-
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
-}
-
 double
 NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<double>& listOfValues) const
 {
@@ -1006,24 +996,24 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<double>& listOfValues)
 
 double
 NrRadioEnvironmentMapHelper::CalculateAggregatedIpsd(
-    const std::list<Ptr<SpectrumValue>>& receivedSignals)
+    const std::vector<const double*>& receivedSignals) const
 {
-    Ptr<SpectrumValue> sumRxPowers = nullptr;
-    sumRxPowers = Create<SpectrumValue>(m_rrd.spectrumModel);
-
-    // sum the received power of all the rtds
-    for (auto rxPowersIt : receivedSignals)
+    // sum the received power of all the rtds, and integrate it over the RBs
+    double integral = 0;
+    for (std::size_t band = 0; band < m_numBands; ++band)
     {
-        *sumRxPowers += (*rxPowersIt);
+        double sumRxPowers = 0;
+        for (const auto& rxPowers : receivedSignals)
+        {
+            sumRxPowers += rxPowers[band];
+        }
+        integral += sumRxPowers * m_bandWidths[band];
     }
-
-    SpectrumValue sumRxPowersSv = (*sumRxPowers);
-
-    return (Integral(sumRxPowersSv));
+    return integral;
 }
 
 double
-NrRadioEnvironmentMapHelper::SumListElements(const std::list<double>& listOfValues)
+NrRadioEnvironmentMapHelper::SumListElements(const std::list<double>& listOfValues) const
 {
     NS_ABORT_MSG_IF(listOfValues.size() == 0,
                     "SumListElements should not be called "
@@ -1038,131 +1028,203 @@ NrRadioEnvironmentMapHelper::SumListElements(const std::list<double>& listOfValu
     return sum;
 }
 
-void
-NrRadioEnvironmentMapHelper::CalcCoverageAreaRemMap()
+uint32_t
+NrRadioEnvironmentMapHelper::GetNumRxPsdsPerPoint() const
 {
-    NS_LOG_FUNCTION(this);
-    uint16_t calcRxPsdCounter = 0;
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
-
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+    const auto numRtds = static_cast<uint32_t>(m_remDev.size());
+    switch (m_remMode)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
+    case BEAM_SHAPE:
+        return m_numOfIterationsToAverage * numRtds;
+    case COVERAGE_AREA:
+        return m_numOfIterationsToAverage * numRtds * (numRtds + 1);
+    case UE_COVERAGE:
+        return m_numOfIterationsToAverage * numRtds * numRtds;
+    default:
+        NS_FATAL_ERROR("Unknown REM mode");
+    }
+    return 0;
+}
 
-        // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
-        // worst-case scenario
-        for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end();
-             ++itRtd)
+void
+NrRadioEnvironmentMapHelper::CreateThreadDevices(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_threadDevices.clear();
+    for (uint32_t thread = 0; thread < numThreads; ++thread)
+    {
+        // the devices of a thread share their spectrum models, but not with the other threads
+        std::map<Ptr<const SpectrumModel>, Ptr<const SpectrumModel>> spectrumModels;
+        RemDevices devices{CopyRemDevice(m_rrd, &spectrumModels), {}};
+        for (const auto& rtd : m_remDev)
         {
-            ConfigureDirectPathBfv(*itRtd, m_rrd, itRtd->antenna);
+            devices.rtds.push_back(CopyRemDevice(rtd, &spectrumModels));
         }
+        m_threadDevices.push_back(devices);
+    }
+}
 
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
+NrRadioEnvironmentMapHelper::RemDevice
+NrRadioEnvironmentMapHelper::CopyRemDevice(
+    const RemDevice& device,
+    std::map<Ptr<const SpectrumModel>, Ptr<const SpectrumModel>>* spectrumModels) const
+{
+    RemDevice copy;
+    copy.mob->SetPosition(device.mob->GetPosition());
+    copy.mob->AggregateObject(CreateObject<MobilityBuildingInfo>());
+    copy.antenna = Copy(device.antenna);
+    copy.txPower = device.txPower;
+    copy.bandwidth = device.bandwidth;
+    copy.frequency = device.frequency;
+    copy.numerology = device.numerology;
+    // the copy keeps the UID of the spectrum model
+    Ptr<const SpectrumModel>& spectrumModel = (*spectrumModels)[device.spectrumModel];
+    if (!spectrumModel)
+    {
+        spectrumModel = Create<SpectrumModel>(*device.spectrumModel);
+    }
+    copy.spectrumModel = spectrumModel;
+    return copy;
+}
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
-        {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+void
+NrRadioEnvironmentMapHelper::CalcRemMap()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_numOfIterationsToAverage == 0, "The number of iterations must be positive");
 
-            std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
-                                                      // rxPowers per remPoint (linear)
+    // each REM point uses the same number of random streams
+    const uint32_t numRxPsds = GetNumRxPsdsPerPoint();
+    int64_t streamsPerRxPsd = 0;
+    CreateTemporalPropagationModels(&streamsPerRxPsd);
+    const int64_t streamsPerPoint = numRxPsds * streamsPerRxPsd;
 
-            // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
-            // many beam configurations at RemPoint as many RTDs
-            for (std::list<RemDevice>::iterator itRtdBeam = m_remDev.begin();
-                 itRtdBeam != m_remDev.end();
-                 ++itRtdBeam)
-            {
-                // configure RRD beam toward RTD
-                ConfigureDirectPathBfv(m_rrd, *itRtdBeam, m_rrd.antenna);
-
-                // Calculate the received power from this RTD for this RemPoint
-                Ptr<SpectrumValue> receivedPowerFromRtd = CalcRxPsdValue(*itRtdBeam, m_rrd);
-                // and put it to the list of the received powers for this RemPoint (to sum all
-                // later)
-                rxPsdsList.push_back(receivedPowerFromRtd);
-
-                NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
-                                           << " is Rxed in RemPoint with Rx Power in W: "
-                                           << (Integral(*receivedPowerFromRtd)));
-                NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
-
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
-
-                // For this configuration of beam at RRD, we need to calculate RX PSD,
-                // and in order to be able to calculate SINR for that beam,
-                // we need to calculate received PSD for each RTD using this beam at RRD
-                for (std::list<RemDevice>::iterator itRtdCalc = m_remDev.begin();
-                     itRtdCalc != m_remDev.end();
-                     ++itRtdCalc)
-                {
-                    // increase counter de calcRXPsd calls
-                    calcRxPsdCounter++;
-                    // calculate received power from the current RTD device
-                    Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(*itRtdCalc, m_rrd);
-
-                    // is this received power useful signal (from RTD for which I configured my
-                    // beam) or is interference signal
-
-                    if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc->dev->GetNode()->GetId())
-                    {
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
-                    else
-                    {
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
-                    }
-
-                } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
-
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
-
-                NS_LOG_INFO("Done:" << (double)calcRxPsdCounter /
-                                           (m_rem.size() * m_numOfIterationsToAverage *
-                                            m_remDev.size() * m_remDev.size()) *
-                                           100
-                                    << " %."); // how many times will be called CalcRxPsdValues
-
-            } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
-
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+    std::ostringstream oss;
+    oss << "nr-rem-" << m_simTag.c_str() << ".out";
+    std::string outputFile = oss.str();
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
+    uint32_t firstPoint = 0;
+    uintmax_t outSize = 0;
+    if (m_checkpoint)
+    {
+        firstPoint = ReadCheckpoint(outputFile, &outSize);
+    }
 
-        } // end for m_numOfIterationsToAverage  (Average)
+    std::ofstream outFile;
+    if (firstPoint > 0)
+    {
+        // drop the points written after the checkpoint
+        std::filesystem::resize_file(outputFile, outSize);
+        outFile.open(outputFile.c_str(), std::ios_base::out | std::ios_base::app);
+        std::cout << "\n REM resumed at point " << firstPoint << " of " << m_rem.size() << ".";
+    }
+    else
+    {
+        outFile.open(outputFile.c_str(), std::ios_base::out | std::ios_base::trunc);
+    }
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+    if (!outFile.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << (outputFile));
+        return;
+    }
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+    uint32_t remSizeNextReport = m_rem.size() / 100;
+    uint32_t remPointCounter = firstPoint;
+    while (remSizeNextReport != 0 && remSizeNextReport <= firstPoint)
+    {
+        remSizeNextReport = remSizeNextReport < m_rem.size() / 10
+                                ? m_rem.size() / 10
+                                : remSizeNextReport + m_rem.size() / 10;
+    }
+
+    // the building list is shared by all the devices, and read when their position changes
+    m_useBuildings = BuildingList::GetNBuildings() > 0;
+    if (m_channelConditionModelFactory.IsTypeIdSet())
+    {
+        TypeId tid = m_channelConditionModelFactory.GetTypeId();
+        m_useBuildings |= tid == BuildingsChannelConditionModel::GetTypeId() ||
+                          tid.IsChildOf(BuildingsChannelConditionModel::GetTypeId());
+    }
+    const bool parallel = m_threadPool && !m_useBuildings;
+    if (m_threadPool && m_useBuildings)
+    {
+        NS_LOG_WARN("The REM points are computed in the simulation thread with buildings");
+    }
+    CreateThreadDevices(parallel ? m_threadPool->GetNThreads() : 1);
+    const auto numThreads = static_cast<uint32_t>(m_threadDevices.size());
+
+    std::vector<std::vector<PropagationModels>> models(numThreads);
+    std::vector<std::vector<double>> rxPsds(numThreads);
+    for (uint32_t tileStart = firstPoint; tileStart < m_rem.size(); tileStart += m_tileSize)
+    {
+        const auto tileEnd =
+            static_cast<uint32_t>(std::min<std::size_t>(tileStart + m_tileSize, m_rem.size()));
 
-        if (++remPointCounter == remSizeNextReport)
+        for (uint32_t roundStart = tileStart; roundStart < tileEnd; roundStart += numThreads)
         {
-            PrintProgressReport(&remSizeNextReport);
+            const uint32_t roundEnd = std::min(roundStart + numThreads, tileEnd);
+
+            // the models of a point use its own streams, and are created in the simulation
+            // thread, in the order in which the point uses them
+            for (uint32_t point = roundStart; point < roundEnd; ++point)
+            {
+                std::vector<PropagationModels>& pointModels = models[point - roundStart];
+                pointModels.clear();
+                int64_t stream = m_streamBase + point * streamsPerPoint;
+                for (uint32_t i = 0; i < numRxPsds; ++i)
+                {
+                    pointModels.push_back(CreateTemporalPropagationModels(&stream));
+                }
+                NS_ASSERT(stream == m_streamBase + (point + 1) * streamsPerPoint);
+            }
+
+            // at most one point per thread, computed with the devices of the thread
+            auto calcPoints = [this, roundStart, &models, &rxPsds](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    rxPsds[i].clear();
+                    CalcRxPsds(m_threadDevices[i], m_rem[roundStart + i], models[i], &rxPsds[i]);
+                    CalcRemPointValues(rxPsds[i], &m_rem[roundStart + i]);
+                }
+            };
+            if (parallel)
+            {
+                m_threadPool->ParallelFor(roundEnd - roundStart, calcPoints);
+            }
+            else
+            {
+                calcPoints(0, roundEnd - roundStart);
+            }
         }
 
-        NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << itRemPoint->avRxPowerDbm);
+        for (uint32_t point = tileStart; point < tileEnd; ++point)
+        {
+            NS_LOG_INFO("Avg snr value saved:" << m_rem[point].avgSnrDb);
+            NS_LOG_INFO("Avg sinr value saved:" << m_rem[point].avgSinrDb);
+            NS_LOG_INFO("Avg ipsd value saved (dBm):" << m_rem[point].avRxPowerDbm);
+            PrintRemPointToFile(outFile, m_rem[point]);
+
+            if (++remPointCounter == remSizeNextReport)
+            {
+                PrintProgressReport(&remSizeNextReport);
+            }
+        }
+        outFile.flush();
+        if (m_checkpoint)
+        {
+            WriteCheckpoint(tileEnd, std::filesystem::file_size(outputFile));
+        }
+        m_tileDoneTrace(tileEnd, m_rem.size());
+    }
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    outFile.close();
+    models.clear();
+    m_threadDevices.clear();
+    if (m_checkpoint)
+    {
+        std::remove(("nr-rem-" + m_simTag + ".checkpoint").c_str());
+    }
 
     auto remEndTime = std::chrono::system_clock::now();
     std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
@@ -1171,121 +1233,278 @@ NrRadioEnvironmentMapHelper::CalcCoverageAreaRemMap()
 }
 
 void
-NrRadioEnvironmentMapHelper::PrintProgressReport(uint32_t* remSizeNextReport)
+NrRadioEnvironmentMapHelper::CalcRxPsds(RemDevices& devices,
+                                        const RemPoint& remPoint,
+                                        const std::vector<PropagationModels>& models,
+                                        std::vector<double>* rxPsds) const
 {
-    auto remTimeUpToNow = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSecondsUpToNow = remTimeUpToNow - m_remStartTime;
-    double minutesUpToNow = ((double)remElapsedSecondsUpToNow.count()) / 60;
-    double minutesLeftEstimated =
-        ((double)(minutesUpToNow) / *remSizeNextReport) * ((m_rem.size() - *remSizeNextReport));
-    std::cout << "\n REM done:" << ceil(((double)*remSizeNextReport / m_rem.size()) * 100) << " %."
-              << " Minutes up to now: " << minutesUpToNow
-              << ". Minutes left estimated:" << minutesLeftEstimated
-              << "."; // how many times will be called CalcRxPsdValues
-    // we want progress report for 1%, 10%, 20%, 30%, and so on
-    if (*remSizeNextReport < m_rem.size() / 10)
+    if (m_remMode == BEAM_SHAPE)
     {
-        *remSizeNextReport = m_rem.size() / 10;
+        CalcBeamShapeRxPsds(devices, remPoint, models, rxPsds);
+    }
+    else if (m_remMode == COVERAGE_AREA)
+    {
+        CalcCoverageAreaRxPsds(devices, remPoint, models, rxPsds);
     }
     else
     {
-        *remSizeNextReport += m_rem.size() / 10;
+        CalcUeCoverageRxPsds(devices, remPoint, models, rxPsds);
     }
+    NS_ASSERT(rxPsds->size() == models.size() * m_numBands);
 }
 
 void
-NrRadioEnvironmentMapHelper::CalcUeCoverageRemMap()
+NrRadioEnvironmentMapHelper::CalcBeamShapeRxPsds(RemDevices& devices,
+                                                 const RemPoint& remPoint,
+                                                 const std::vector<PropagationModels>& models,
+                                                 std::vector<double>* rxPsds) const
 {
     NS_LOG_FUNCTION(this);
+    RemDevice& rrd = devices.rrd;
+    rrd.mob->SetPosition(remPoint.pos);
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+    if (m_useBuildings)
+    {
+        Ptr<MobilityBuildingInfo> buildingInfo = rrd.mob->GetObject<MobilityBuildingInfo>();
+        NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+        buildingInfo->MakeConsistent(rrd.mob);
+    }
+
+    auto nextModels = models.cbegin();
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        for (std::list<RemDevice>::iterator itRtd = devices.rtds.begin();
+             itRtd != devices.rtds.end();
+             ++itRtd)
+        {
+            // calculate received power from the current RTD device
+            SaveRxPsd(CalcRxPsdValue(*itRtd, rrd, *nextModels++), rxPsds);
+        } // end for std::list<RemDev>::iterator  (RTDs)
+    }     // end for m_numOfIterationsToAverage  (Average)
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcCoverageAreaRxPsds(RemDevices& devices,
+                                                    const RemPoint& remPoint,
+                                                    const std::vector<PropagationModels>& models,
+                                                    std::vector<double>* rxPsds) const
+{
+    NS_LOG_FUNCTION(this);
+    RemDevice& rrd = devices.rrd;
+    rrd.mob->SetPosition(remPoint.pos);
 
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+    // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
+    // worst-case scenario
+    for (std::list<RemDevice>::iterator itRtd = devices.rtds.begin(); itRtd != devices.rtds.end();
+         ++itRtd)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
+        ConfigureDirectPathBfv(*itRtd, rrd, itRtd->antenna);
+    }
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    auto nextModels = models.cbegin();
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
+        // many beam configurations at RemPoint as many RTDs
+        for (std::list<RemDevice>::iterator itRtdBeam = devices.rtds.begin();
+             itRtdBeam != devices.rtds.end();
+             ++itRtdBeam)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            // configure RRD beam toward RTD
+            ConfigureDirectPathBfv(rrd, *itRtdBeam, rrd.antenna);
+
+            // Calculate the received power from this RTD for this RemPoint, to sum all later
+            Ptr<SpectrumValue> receivedPowerFromRtd =
+                CalcRxPsdValue(*itRtdBeam, rrd, *nextModels++);
+            SaveRxPsd(receivedPowerFromRtd, rxPsds);
+
+            NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
+                                       << " is Rxed in RemPoint with Rx Power in W: "
+                                       << (Integral(*receivedPowerFromRtd)));
+            NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
+
+            // For this configuration of beam at RRD, we need to calculate RX PSD,
+            // and in order to be able to calculate SINR for that beam,
+            // we need to calculate received PSD for each RTD using this beam at RRD
+            for (std::list<RemDevice>::iterator itRtdCalc = devices.rtds.begin();
+                 itRtdCalc != devices.rtds.end();
+                 ++itRtdCalc)
+            {
+                // calculate received power from the current RTD device
+                SaveRxPsd(CalcRxPsdValue(*itRtdCalc, rrd, *nextModels++), rxPsds);
+            } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
+        }     // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
+    }         // end for m_numOfIterationsToAverage  (Average)
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcUeCoverageRxPsds(RemDevices& devices,
+                                                  const RemPoint& remPoint,
+                                                  const std::vector<PropagationModels>& models,
+                                                  std::vector<double>* rxPsds) const
+{
+    NS_LOG_FUNCTION(this);
+    RemDevice& rrd = devices.rrd;
+    rrd.mob->SetPosition(remPoint.pos);
 
-            //"Associate" UE (RemPoint) with this RTD
-            for (std::list<RemDevice>::iterator itRtdAssociated = m_remDev.begin();
-                 itRtdAssociated != m_remDev.end();
-                 ++itRtdAssociated)
+    auto nextModels = models.cbegin();
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        //"Associate" UE (RemPoint) with this RTD
+        for (std::list<RemDevice>::iterator itRtdAssociated = devices.rtds.begin();
+             itRtdAssociated != devices.rtds.end();
+             ++itRtdAssociated)
+        {
+            // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
+            ConfigureDirectPathBfv(rrd, *itRtdAssociated, rrd.antenna);
+            // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
+            ConfigureDirectPathBfv(*itRtdAssociated, rrd, itRtdAssociated->antenna);
+
+            for (std::list<RemDevice>::iterator itRtdInterferer = devices.rtds.begin();
+                 itRtdInterferer != devices.rtds.end();
+                 ++itRtdInterferer)
             {
-                // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
-                ConfigureDirectPathBfv(m_rrd, *itRtdAssociated, m_rrd.antenna);
-                // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
-                ConfigureDirectPathBfv(*itRtdAssociated, m_rrd, itRtdAssociated->antenna);
+                if (itRtdAssociated->dev->GetNode()->GetId() !=
+                    itRtdInterferer->dev->GetNode()->GetId())
+                {
+                    // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
+                    ConfigureDirectPathBfv(*itRtdInterferer,
+                                           *itRtdAssociated,
+                                           itRtdInterferer->antenna);
+
+                    // calculate received power (interference) from the current RTD device
+                    SaveRxPsd(CalcRxPsdValue(*itRtdInterferer, *itRtdAssociated, *nextModels++),
+                              rxPsds);
+                }
+                else
+                {
+                    // calculate received power (useful Signal) from the current RRD device
+                    SaveRxPsd(CalcRxPsdValue(rrd, *itRtdAssociated, *nextModels++), rxPsds);
+                }
+            } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
+        }     // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
+    }         // end for m_numOfIterationsToAverage  (Average)
+}
 
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
+void
+NrRadioEnvironmentMapHelper::CalcRemPointValues(const std::vector<double>& rxPsds,
+                                                RemPoint* remPoint) const
+{
+    // the received PSDs, in the order in which they were drawn
+    std::size_t nextRxPsd = 0;
+    auto takeRxPsd = [this, &rxPsds, &nextRxPsd]() {
+        const double* rxPsd = rxPsds.data() + nextRxPsd * m_numBands;
+        nextRxPsd++;
+        return rxPsd;
+    };
+
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    double sumSir = 0.0;
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        if (m_remMode == BEAM_SHAPE)
+        {
+            std::vector<const double*> receivedPowerList;
+            for (std::size_t rtd = 0; rtd < m_remDev.size(); ++rtd)
+            {
+                receivedPowerList.push_back(takeRxPsd());
+            }
 
-                for (std::list<RemDevice>::iterator itRtdInterferer = m_remDev.begin();
-                     itRtdInterferer != m_remDev.end();
-                     ++itRtdInterferer)
+            sumSnr += CalculateMaxSnr(receivedPowerList);
+            sumSinr += CalculateMaxSinr(receivedPowerList);
+            sumSir += CalculateMaxSir(receivedPowerList);
+
+            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+            // Iteration (linear)
+            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
+            continue;
+        }
+
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+        std::vector<const double*> rxPsdsList; // vector in which we will save the rxPowers
+                                               // per remPoint (linear)
+
+        // for COVERAGE_AREA, the beam of the RRD toward each RTD; for UE_COVERAGE, the
+        // association of the UE (RemPoint) with each RTD
+        for (std::size_t beam = 0; beam < m_remDev.size(); ++beam)
+        {
+            if (m_remMode == COVERAGE_AREA)
+            {
+                rxPsdsList.push_back(takeRxPsd());
+            }
+
+            std::vector<const double*> interferenceSignalsRxPsds;
+            const double* usefulSignalRxPsd = nullptr;
+            for (std::size_t rtd = 0; rtd < m_remDev.size(); ++rtd)
+            {
+                if (rtd == beam)
+                {
+                    usefulSignalRxPsd = takeRxPsd();
+                }
+                else
                 {
-                    if (itRtdAssociated->dev->GetNode()->GetId() !=
-                        itRtdInterferer->dev->GetNode()->GetId())
-                    {
-                        // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
-                        ConfigureDirectPathBfv(*itRtdInterferer,
-                                               *itRtdAssociated,
-                                               itRtdInterferer->antenna);
-
-                        // calculate received power (interference) from the current RTD device
-                        Ptr<SpectrumValue> receivedPower =
-                            CalcRxPsdValue(*itRtdInterferer, *itRtdAssociated);
-
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
-                    }
-                    else
-                    {
-                        // calculate received power (useful Signal) from the current RRD device
-                        Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(m_rrd, *itRtdAssociated);
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
-
-                } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
-
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
-
-            } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
-
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
-
-        } // end for m_numOfIterationsToAverage  (Average)
-
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-
-        if (++remPointCounter == remSizeNextReport)
+                    interferenceSignalsRxPsds.push_back(takeRxPsd()); // interference
+                }
+            }
+
+            sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+        }
+
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
+        if (m_remMode == COVERAGE_AREA)
         {
-            PrintProgressReport(&remSizeNextReport);
+            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
         }
+    } // end for m_numOfIterationsToAverage  (Average)
+    NS_ASSERT(nextRxPsd * m_numBands == rxPsds.size());
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    remPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    if (m_remMode == BEAM_SHAPE)
+    {
+        remPoint->avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
+    }
+    if (m_remMode != UE_COVERAGE)
+    {
+        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+        remPoint->avRxPowerDbm = WToDbm(SumListElements(rxPsdsListPerIt) /
+                                        static_cast<double>(m_numOfIterationsToAverage));
+    }
+}
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+void
+NrRadioEnvironmentMapHelper::PrintProgressReport(uint32_t* remSizeNextReport)
+{
+    auto remTimeUpToNow = std::chrono::system_clock::now();
+    std::chrono::duration<double> remElapsedSecondsUpToNow = remTimeUpToNow - m_remStartTime;
+    double minutesUpToNow = ((double)remElapsedSecondsUpToNow.count()) / 60;
+    double minutesLeftEstimated =
+        ((double)(minutesUpToNow) / *remSizeNextReport) * ((m_rem.size() - *remSizeNextReport));
+    std::cout << "\n REM done:" << ceil(((double)*remSizeNextReport / m_rem.size()) * 100) << " %."
+              << " Minutes up to now: " << minutesUpToNow
+              << ". Minutes left estimated:" << minutesLeftEstimated
+              << "."; // how many times will be called CalcRxPsdValues
+    // we want progress report for 1%, 10%, 20%, 30%, and so on
+    if (*remSizeNextReport < m_rem.size() / 10)
+    {
+        *remSizeNextReport = m_rem.size() / 10;
+    }
+    else
+    {
+        *remSizeNextReport += m_rem.size() / 10;
+    }
 }
 
 NrRadioEnvironmentMapHelper::PropagationModels
-NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
+NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels(int64_t* stream) const
 {
     NS_LOG_FUNCTION(this);
 
@@ -1293,20 +1512,27 @@ NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
     // create rem copy of channel condition
     Ptr<ChannelConditionModel> condModelCopy =
         m_channelConditionModelFactory.Create<ChannelConditionModel>();
+    *stream += condModelCopy->AssignStreams(*stream);
 
     // create rem copy of propagation model
-    ObjectFactory propLossModelFactory = ConfigureObjectFactory(m_propagationLossModel);
     propModels.remPropagationLossModelCopy =
-        propLossModelFactory.Create<ThreeGppPropagationLossModel>();
+        m_propagationLossModelFactory.Create<ThreeGppPropagationLossModel>();
     propModels.remPropagationLossModelCopy->SetChannelConditionModel(condModelCopy);
+    *stream += propModels.remPropagationLossModelCopy->AssignStreams(*stream);
 
     // create rem copy of spectrum loss model
-    ObjectFactory spectrumLossModelFactory = ConfigureObjectFactory(m_phasedArraySpectrumLossModel);
-    if (spectrumLossModelFactory.IsTypeIdSet())
+    if (m_spectrumLossModelFactory.IsTypeIdSet())
     {
         Ptr<MatrixBasedChannelModel> channelModelCopy =
             m_matrixBasedChannelModelFactory.Create<MatrixBasedChannelModel>();
         channelModelCopy->SetAttribute("ChannelConditionModel", PointerValue(condModelCopy));
+        Ptr<ThreeGppChannelModel> threeGppChannelModel =
+            DynamicCast<ThreeGppChannelModel>(channelModelCopy);
+        if (threeGppChannelModel)
+        {
+            *stream += threeGppChannelModel->AssignStreams(*stream);
+        }
+        ObjectFactory spectrumLossModelFactory = m_spectrumLossModelFactory;
         spectrumLossModelFactory.Set("ChannelModel", PointerValue(channelModelCopy));
         propModels.remSpectrumLossModelCopy =
             spectrumLossModelFactory.Create<ThreeGppSpectrumPropagationLossModel>();
@@ -1390,34 +1616,68 @@ NrRadioEnvironmentMapHelper::PrintGnuplottableBuildingListToFile(const std::stri
 }
 
 void
-NrRadioEnvironmentMapHelper::PrintRemToFile()
+NrRadioEnvironmentMapHelper::PrintRemPointToFile(std::ofstream& outFile,
+                                                 const RemPoint& remPoint) const
 {
-    NS_LOG_FUNCTION(this);
+    outFile << remPoint.pos.x << "\t" << remPoint.pos.y << "\t" << remPoint.pos.z << "\t"
+            << remPoint.avgSnrDb << "\t" << remPoint.avgSinrDb << "\t" << remPoint.avRxPowerDbm
+            << "\t" << remPoint.avgSirDb << "\t"
+            << "\n";
+}
 
+std::string
+NrRadioEnvironmentMapHelper::GetCheckpointFingerprint() const
+{
     std::ostringstream oss;
-    oss << "nr-rem-" << m_simTag.c_str() << ".out";
-
-    std::ofstream outFile;
-    std::string outputFile = oss.str();
-    outFile.open(outputFile.c_str());
+    oss << std::setprecision(17) << "mode " << m_remMode << " x " << m_xMin << " " << m_xMax
+        << " " << m_xRes << " y " << m_yMin << " " << m_yMax << " " << m_yRes << " z " << m_z
+        << " iterations " << m_numOfIterationsToAverage << " rtds " << m_remDev.size()
+        << " points " << m_rem.size() << " streams " << m_streamBase << " seed "
+        << RngSeedManager::GetSeed() << " run " << RngSeedManager::GetRun();
+    return oss.str();
+}
 
-    if (!outFile.is_open())
+uint32_t
+NrRadioEnvironmentMapHelper::ReadCheckpoint(const std::string& outputFile,
+                                            uintmax_t* outSize) const
+{
+    NS_LOG_FUNCTION(this);
+    std::ifstream inFile(("nr-rem-" + m_simTag + ".checkpoint").c_str());
+    if (!inFile.is_open())
     {
-        NS_FATAL_ERROR("Can't open file " << (outputFile));
-        return;
+        return 0;
     }
 
-    for (std::list<RemPoint>::iterator it = m_rem.begin(); it != m_rem.end(); ++it)
+    std::string fingerprint;
+    uint32_t numDone = 0;
+    std::getline(inFile, fingerprint);
+    inFile >> numDone >> *outSize;
+    std::error_code error;
+    if (!inFile || fingerprint != GetCheckpointFingerprint() || numDone > m_rem.size() ||
+        std::filesystem::file_size(outputFile, error) < *outSize || error)
     {
-        outFile << it->pos.x << "\t" << it->pos.y << "\t" << it->pos.z << "\t" << it->avgSnrDb
-                << "\t" << it->avgSinrDb << "\t" << it->avRxPowerDbm << "\t" << it->avgSirDb << "\t"
-                << std::endl;
+        NS_LOG_WARN("The REM checkpoint is not the one of this map, the map is started again");
+        return 0;
     }
+    return numDone;
+}
 
+void
+NrRadioEnvironmentMapHelper::WriteCheckpoint(uint32_t numDone, uintmax_t outSize) const
+{
+    NS_LOG_FUNCTION(this << numDone << outSize);
+    // replace the previous checkpoint only once the new one is complete
+    std::string checkpointFile = "nr-rem-" + m_simTag + ".checkpoint";
+    std::string tmpFile = checkpointFile + ".tmp";
+    std::ofstream outFile(tmpFile.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!outFile.is_open())
+    {
+        NS_LOG_ERROR("Can't open file " << tmpFile);
+        return;
+    }
+    outFile << GetCheckpointFingerprint() << "\n" << numDone << " " << outSize << "\n";
     outFile.close();
-
-    CreateCustomGnuplotFile();
-    Finalize();
+    std::rename(tmpFile.c_str(), checkpointFile.c_str());
 }
 
 void
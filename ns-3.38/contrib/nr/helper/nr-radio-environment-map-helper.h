@@ -16,9 +16,13 @@
 #include <ns3/three-gpp-channel-model.h>
 #include <ns3/three-gpp-propagation-loss-model.h>
 #include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/traced-callback.h>
 
 #include <chrono>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace ns3
 {
@@ -30,6 +34,7 @@ class MobilityModel;
 class MobilityHelper;
 class ChannelConditionModel;
 class UniformPlanarArray;
+class ThreadPool;
 
 /**
  * \brief Generate a radio environment map
@@ -62,6 +67,19 @@ class UniformPlanarArray;
  * N iterations (specified by the user) in order to consider the randomness of
  * the channel
  *
+ * The map is computed in tiles of TileSize consecutive REM points, which are
+ * appended to the output file one after the other. The points of a tile are
+ * computed NumThreads at a time, each thread with its own copies of the RRD and
+ * of the RTDs. The propagation models of a point are created in the simulation
+ * thread, with its own block of random streams after StreamBase, and the
+ * thread of the point draws its channels and computes its SNR/SINR/SIR/IPSD
+ * values with them. The values of a point therefore do not depend on the
+ * other points, the tiles or the threads. With buildings, the points are
+ * computed in the simulation thread, as the building list is shared by all the
+ * devices. With the Checkpoint attribute, the number of points done is saved
+ * after each tile, and a new run with the same configuration resumes the map
+ * from there.
+ *
  * For the CoverageArea REM generation the user can include the following code
  * in the desired example script:
  *
@@ -119,6 +137,13 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     static TypeId GetTypeId();
 
+    /**
+     * TracedCallback signature for the end of a tile.
+     * \param [in] numDone the number of REM points done, in the output file
+     * \param [in] numPoints the number of REM points of the map
+     */
+    typedef void (*TileDoneTracedCallback)(uint32_t numDone, uint32_t numPoints);
+
     /**
      * \brief Set the type of REM Map to be generated
      * \param remType the desired type (BeamShape/CoverageArea/UeCoverage)
@@ -314,6 +339,16 @@ class NrRadioEnvironmentMapHelper : public Object
         }
     };
 
+    /**
+     * \brief The copies of the RRD and of the RTDs used by one thread, so that
+     * the threads do not share any reference counted object
+     */
+    struct RemDevices
+    {
+        RemDevice rrd;
+        std::list<RemDevice> rtds;
+    };
+
     /**
      * \brief This struct includes the pointers that copy the propagation
      * Loss Model and Spectrum Propagation Loss model (from the example used
@@ -331,6 +366,12 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void CreateListOfRemPoints();
 
+    /**
+     * \brief Set the number of threads computing the REM points
+     * \param numThreads the number of threads, 1 computes them in the simulation thread
+     */
+    void SetNumThreads(uint32_t numThreads);
+
     /**
      * \brief Configures the REM Receiving Device (RRD)
      */
@@ -361,92 +402,177 @@ class NrRadioEnvironmentMapHelper : public Object
                                           const Ptr<NetDevice>& rrdDevice);
 
     /**
-     * \brief This function generates a BeamShape map. Using the configuration
-     * of antennas as have been set in the user scenario script, it calculates
-     * the SNR/SINR/IPSD.
+     * \brief This function generates the map, tile by tile: it computes the
+     * points of a tile, possibly in parallel, and appends them to the output
+     * file.
+     */
+    void CalcRemMap();
+
+    /**
+     * \return the number of received PSDs drawn for each REM point
+     */
+    uint32_t GetNumRxPsdsPerPoint() const;
+
+    /**
+     * \brief Create the copies of the RRD and of the RTDs of each thread
+     * \param numThreads the number of threads
+     */
+    void CreateThreadDevices(uint32_t numThreads);
+
+    /**
+     * \brief Copy a REM device, with a new node and mobility model, and copies
+     * of its antenna and of its spectrum model
+     * \param device the REM device
+     * \param spectrumModels the copies of the spectrum models already made
+     * for the same thread, by original spectrum model
+     * \return the copy
+     */
+    RemDevice CopyRemDevice(
+        const RemDevice& device,
+        std::map<Ptr<const SpectrumModel>, Ptr<const SpectrumModel>>* spectrumModels) const;
+
+    /**
+     * \brief Draw the received PSDs of a REM point, according to the REM mode
+     * \param devices the devices of the thread
+     * \param remPoint the REM point
+     * \param models the propagation models of each received PSD of the point
+     * \param rxPsds the values of the received PSDs, appended one after the other
+     */
+    void CalcRxPsds(RemDevices& devices,
+                    const RemPoint& remPoint,
+                    const std::vector<PropagationModels>& models,
+                    std::vector<double>* rxPsds) const;
+
+    /**
+     * \brief This function draws the received PSDs of a point of a BeamShape
+     * map. Using the configuration of antennas as have been set in the user
+     * scenario script, it calculates the PSD received from each RTD.
+     * \param devices the devices of the thread
+     * \param remPoint the REM point
+     * \param models the propagation models of each received PSD of the point
+     * \param rxPsds the values of the received PSDs, appended one after the other
      */
-    void CalcBeamShapeRemMap();
+    void CalcBeamShapeRxPsds(RemDevices& devices,
+                             const RemPoint& remPoint,
+                             const std::vector<PropagationModels>& models,
+                             std::vector<double>* rxPsds) const;
 
     /**
-     * \brief This function generates a CoverageArea map. In this case, all the
-     * antennas of the rtds are set to point towards the rem point and the antenna
-     * of the rem point towards each rtd device.
+     * \brief This function draws the received PSDs of a point of a
+     * CoverageArea map. In this case, all the antennas of the rtds are set to
+     * point towards the rem point and the antenna of the rem point towards each
+     * rtd device.
+     * \param devices the devices of the thread
+     * \param remPoint the REM point
+     * \param models the propagation models of each received PSD of the point
+     * \param rxPsds the values of the received PSDs, appended one after the other
      */
-    void CalcCoverageAreaRemMap();
+    void CalcCoverageAreaRxPsds(RemDevices& devices,
+                                const RemPoint& remPoint,
+                                const std::vector<PropagationModels>& models,
+                                std::vector<double>* rxPsds) const;
 
     /**
-     * \brief This function generates a Ue Coverage map that depicts the SNR of
-     * this UE with respect to its UL transmission towards the gNB form various
-     * points on the map.
+     * \brief This function draws the received PSDs of a point of a Ue
+     * Coverage map, which depicts the SNR of this UE with respect to its UL
+     * transmission towards the gNB form various points on the map.
      * An additional SINR map is also generated that can be used in mixed TDD/FDD
      * scenarios considering interference from neighbor gNBs that transmit in DL.
+     * \param devices the devices of the thread
+     * \param remPoint the REM point
+     * \param models the propagation models of each received PSD of the point
+     * \param rxPsds the values of the received PSDs, appended one after the other
+     */
+    void CalcUeCoverageRxPsds(RemDevices& devices,
+                              const RemPoint& remPoint,
+                              const std::vector<PropagationModels>& models,
+                              std::vector<double>* rxPsds) const;
+
+    /**
+     * \brief Append the values of a received PSD to the ones of a REM point
+     * \param rxPsd the received PSD
+     * \param rxPsds the values of the received PSDs of the REM point
+     */
+    void SaveRxPsd(const Ptr<const SpectrumValue>& rxPsd, std::vector<double>* rxPsds) const;
+
+    /**
+     * \brief This function calculates the average SNR/SINR/SIR/IPSD of a REM
+     * point from its received PSDs. It only uses plain values, and can be
+     * called from any thread.
+     * \param rxPsds the values of the received PSDs of the REM point
+     * \param remPoint the REM point
      */
-    void CalcUeCoverageRemMap();
+    void CalcRemPointValues(const std::vector<double>& rxPsds, RemPoint* remPoint) const;
 
     /**
      * \brief This method calculates the PSD
+     * \param device the transmitting device
+     * \param otherDevice the receiving device
+     * \param tempPropModels the propagation models of this PSD
      * \return The PSD (spectrumValue)
      */
-    Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const;
+    Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device,
+                                      RemDevice& otherDevice,
+                                      const PropagationModels& tempPropModels) const;
 
     /**
      * \brief This function calculates the SNR.
-     * \param usefulSignal The useful Signal
+     * \param usefulSignal The values of the useful Signal
      * \return The snr
      */
-    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const;
+    double CalculateSnr(const double* usefulSignal) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
-     * \param values The list of spectrumValues for which we want to find the max
-     * \return The max spectrumValue
+     * \param values The list of PSD values for which we want to find the max
+     * \return The max PSD values
      */
-    Ptr<SpectrumValue> GetMaxValue(const std::list<Ptr<SpectrumValue>>& values) const;
+    const double* GetMaxValue(const std::vector<const double*>& values) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
-     * \param values The list of spectrumValues for which we want to find the max
+     * \param receivedPowerList The list of PSD values for which we want to find the max
      * \return The max value (snr)
      */
-    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSnr(const std::vector<const double*>& receivedPowerList) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
-     * \param values The list of spectrumValues for which we want to find the max
+     * \param receivedPowerList The list of PSD values for which we want to find the max
      * \return The max value (sinr)
      */
-    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSinr(const std::vector<const double*>& receivedPowerList) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
-     * \param values The list of spectrumValues for which we want to find the max
-     * \return The max value (sinr)
+     * \param receivedPowerList The list of PSD values for which we want to find the max
+     * \return The max value (sir)
      */
-    double CalculateMaxSir(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSir(const std::vector<const double*>& receivedPowerList) const;
 
     /**
      * \brief This function calculates the SINR for a given space of frequency-dependent
      * values (such as PSD).
-     * \param usefulSignal The spectrumValue considered as useful signal
-     * \param interferenceSignals The list of spectrumValues considered as interference
+     * \param usefulSignal The PSD values considered as useful signal
+     * \param interferenceSignals The list of PSD values considered as interference
      * \return The max value (sinr)
      */
-    double CalculateSinr(const Ptr<SpectrumValue>& usefulSignal,
-                         const std::list<Ptr<SpectrumValue>>& interferenceSignals) const;
+    double CalculateSinr(const double* usefulSignal,
+                         const std::vector<const double*>& interferenceSignals) const;
 
     /**
      * \brief This function calculates the SIR for a given space of frequency-dependent
      * values (such as PSD).
-     * \param usefulSignal The spectrumValue considered as useful signal
-     * \param interferenceSignals The list of spectrumValues considered as interference
+     * \param usefulSignal The PSD values considered as useful signal
+     * \param interferenceSignals The list of PSD values considered as interference
      * \return The max value (sir)
      */
-    double CalculateSir(const Ptr<SpectrumValue>& usefulSignal,
-                        const std::list<Ptr<SpectrumValue>>& interferenceSignals) const;
+    double CalculateSir(const double* usefulSignal,
+                        const std::vector<const double*>& interferenceSignals) const;
 
     /**
      * \brief This function finds the max value in a list of double values.
@@ -457,16 +583,16 @@ class NrRadioEnvironmentMapHelper : public Object
 
     /**
      * \brief This function returns the integral of the sum of the elements of a
-     * list of SpectrumValues
+     * list of PSD values
      * \return The integral of the sum of the elements of the list
      */
-    double CalculateAggregatedIpsd(const std::list<Ptr<SpectrumValue>>& interferenceSignals);
+    double CalculateAggregatedIpsd(const std::vector<const double*>& interferenceSignals) const;
 
     /**
      * \brief This function returns the sum of the elements of a list of double values
      * \return The sum of the elements of the list
      */
-    double SumListElements(const std::list<double>& listOfValues);
+    double SumListElements(const std::list<double>& listOfValues) const;
 
     /**
      * \brief Configures propagation loss model factories
@@ -482,10 +608,12 @@ class NrRadioEnvironmentMapHelper : public Object
 
     /**
      * \brief This method creates the temporal Propagation Models
+     * \param [in,out] stream the first random stream of the models, advanced
+     * past the streams that they use
      * \return The struct with the temporal propagation models (created for each
      * rem point)
      */
-    PropagationModels CreateTemporalPropagationModels() const;
+    PropagationModels CreateTemporalPropagationModels(int64_t* stream) const;
 
     /**
      * \brief Prints REM generation progress report
@@ -508,10 +636,31 @@ class NrRadioEnvironmentMapHelper : public Object
     void PrintGnuplottableBuildingListToFile(const std::string& filename);
 
     /**
-     * \brief this method goes through every Rem Point and prints the
-     * calculated SNR/SINR/IPSD values.
+     * \brief this method prints the calculated SNR/SINR/IPSD values of a Rem Point.
+     * \param outFile the REM output file
+     * \param remPoint the REM point
+     */
+    void PrintRemPointToFile(std::ofstream& outFile, const RemPoint& remPoint) const;
+
+    /**
+     * \return the configuration of the map, as saved in the checkpoint
+     */
+    std::string GetCheckpointFingerprint() const;
+
+    /**
+     * \brief Read the checkpoint of a previous run of the same map
+     * \param outputFile the REM output file
+     * \param [out] outSize the size of the output file at the checkpoint
+     * \return the number of REM points done, 0 if there is no checkpoint of this map
+     */
+    uint32_t ReadCheckpoint(const std::string& outputFile, uintmax_t* outSize) const;
+
+    /**
+     * \brief Save the checkpoint of the map
+     * \param numDone the number of REM points done
+     * \param outSize the size of the output file with these points
      */
-    void PrintRemToFile();
+    void WriteCheckpoint(uint32_t numDone, uintmax_t outSize) const;
 
     /*
      * Creates rem_plot${SimTag}.gnuplot file
@@ -527,7 +676,7 @@ class NrRadioEnvironmentMapHelper : public Object
      * \brief Configures quasi-omni beamforming vector on antenna of the device
      * \param device which antenna array will be configured to quasi-omni beamforming vector
      */
-    void ConfigureQuasiOmniBfv(RemDevice& device);
+    void ConfigureQuasiOmniBfv(RemDevice& device) const;
 
     /**
      * \brief Configures direct-path beamforming vector of "device" toward "otherDevice"
@@ -537,10 +686,10 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void ConfigureDirectPathBfv(RemDevice& device,
                                 const RemDevice& otherDevice,
-                                const Ptr<const UniformPlanarArray>& antenna);
+                                const Ptr<const UniformPlanarArray>& antenna) const;
 
     std::list<RemDevice> m_remDev; ///< List of REM Transmiting Devices (RTDs).
-    std::list<RemPoint> m_rem;     ///< List of REM points.
+    std::vector<RemPoint> m_rem;   ///< List of REM points.
 
     std::chrono::system_clock::time_point
         m_remStartTime; //!< Time at which REM generation has started
@@ -574,6 +723,19 @@ class NrRadioEnvironmentMapHelper : public Object
     ObjectFactory m_matrixBasedChannelModelFactory;
 
     Ptr<SpectrumValue> m_noisePsd; // noise figure PSD that will be used for calculations
+    std::size_t m_numBands{0};          ///< number of bands of the RRD spectrum model
+    std::vector<double> m_noiseValues;  ///< values of m_noisePsd
+    std::vector<double> m_bandWidths;   ///< width of each band of the RRD spectrum model
+    ObjectFactory m_propagationLossModelFactory; ///< copies of m_propagationLossModel
+    ObjectFactory m_spectrumLossModelFactory;    ///< copies of m_phasedArraySpectrumLossModel
+
+    uint32_t m_tileSize{256};    ///< The `TileSize` attribute.
+    bool m_checkpoint{false};    ///< The `Checkpoint` attribute.
+    int64_t m_streamBase{0};     ///< The `StreamBase` attribute.
+    bool m_useBuildings{false};  ///< true if the propagation depends on the buildings
+    std::vector<RemDevices> m_threadDevices;  ///< the devices of each thread
+    std::unique_ptr<ThreadPool> m_threadPool; ///< workers, if more than one thread is used
+    TracedCallback<uint32_t, uint32_t> m_tileDoneTrace; ///< The `TileDone` trace source.
 
     std::string m_simTag; ///< The `SimTag` attribute.
 
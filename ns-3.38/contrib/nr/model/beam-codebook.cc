@@ -0,0 +1,209 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "beam-codebook.h"
+
+#include "beamforming-vector.h"
+
+#include <ns3/log.h>
+#include <ns3/uinteger.h>
+
+#include <map>
+#include <mutex>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BeamCodebook");
+
+namespace
+{
+
+/// the configuration of an antenna and its elevations: the number of rows,
+/// the elevations and the location of each element
+typedef std::vector<double> CodebookKey;
+
+/// the codebooks of the configurations met so far
+std::map<CodebookKey, Ptr<const BeamCodebook>> g_codebooks;
+
+/// the lock of g_codebooks
+std::mutex g_codebooksMutex;
+
+/**
+ * \param antenna the antenna
+ * \return the NumRows attribute of the antenna
+ */
+uint32_t
+GetNumRows(const Ptr<const UniformPlanarArray>& antenna)
+{
+    UintegerValue uintValue;
+    antenna->GetAttribute("NumRows", uintValue);
+    return static_cast<uint32_t>(uintValue.Get());
+}
+
+} // namespace
+
+BeamCodebook::BeamCodebook(const Ptr<const UniformPlanarArray>& antenna,
+                           const std::vector<double>& elevations)
+{
+    const uint32_t numRows = GetNumRows(antenna);
+    const auto numElements = static_cast<uint16_t>(antenna->GetNumberOfElements());
+    const auto numBeams = static_cast<uint16_t>(elevations.size() * (numRows + 1));
+
+    m_beamIds.reserve(numBeams);
+    m_matrix = ComplexMatrixArray(numElements, numBeams);
+    uint16_t beam = 0;
+    for (double elevation : elevations)
+    {
+        for (uint16_t sector = 0; sector <= numRows; ++sector)
+        {
+            PhasedArrayModel::ComplexVector w = CreateDirectionalBfv(antenna, sector, elevation);
+            for (uint16_t element = 0; element < numElements; ++element)
+            {
+                m_matrix(element, beam) = w[element];
+            }
+            m_beamIds.emplace_back(sector, elevation);
+            beam++;
+        }
+    }
+    m_transposedMatrix = m_matrix.Transpose();
+    NS_LOG_INFO("Codebook of " << numBeams << " beams for " << numElements << " elements");
+}
+
+Ptr<const BeamCodebook>
+BeamCodebook::Get(const Ptr<const UniformPlanarArray>& antenna,
+                  const std::vector<double>& elevations)
+{
+    CodebookKey key;
+    key.reserve(2 + elevations.size() + 3 * antenna->GetNumberOfElements());
+    key.push_back(GetNumRows(antenna));
+    key.push_back(elevations.size());
+    key.insert(key.end(), elevations.begin(), elevations.end());
+    for (uint64_t element = 0; element < antenna->GetNumberOfElements(); ++element)
+    {
+        Vector loc = antenna->GetElementLocation(element);
+        key.push_back(loc.x);
+        key.push_back(loc.y);
+        key.push_back(loc.z);
+    }
+
+    std::lock_guard<std::mutex> lock(g_codebooksMutex);
+    auto it = g_codebooks.find(key);
+    if (it == g_codebooks.end())
+    {
+        it = g_codebooks.emplace(std::move(key), Create<BeamCodebook>(antenna, elevations)).first;
+    }
+    return it->second;
+}
+
+void
+BeamCodebook::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(g_codebooksMutex);
+    g_codebooks.clear();
+}
+
+std::size_t
+BeamCodebook::GetCacheSize()
+{
+    std::lock_guard<std::mutex> lock(g_codebooksMutex);
+    return g_codebooks.size();
+}
+
+std::size_t
+BeamCodebook::GetNumBeams() const
+{
+    return m_beamIds.size();
+}
+
+BeamId
+BeamCodebook::GetBeamId(std::size_t beam) const
+{
+    return m_beamIds.at(beam);
+}
+
+PhasedArrayModel::ComplexVector
+BeamCodebook::GetBeamformingVector(std::size_t beam) const
+{
+    NS_ASSERT(beam < m_beamIds.size());
+    const uint16_t numElements = m_matrix.GetNumRows();
+    const std::complex<double>* column = m_matrix.GetPagePtr(0) + beam * numElements;
+    return PhasedArrayModel::ComplexVector(
+        std::valarray<std::complex<double>>(column, numElements));
+}
+
+const ComplexMatrixArray&
+BeamCodebook::GetMatrix() const
+{
+    return m_matrix;
+}
+
+double
+BeamCodebook::SearchBestBeamPair(const MatrixBasedChannelModel::Complex3DVector& channel,
+                                 const BeamCodebook& sCodebook,
+                                 const BeamCodebook& uCodebook,
+                                 bool sFirst,
+                                 std::size_t* sBeam,
+                                 std::size_t* uBeam)
+{
+    NS_ASSERT_MSG(channel.GetNumRows() == uCodebook.m_matrix.GetNumRows() &&
+                      channel.GetNumCols() == sCodebook.m_matrix.GetNumRows(),
+                  "The codebooks do not match the antennas of the channel");
+
+    // the long term components of all the pairs, [uBeam][sBeam][cluster]
+    ComplexMatrixArray longTerms =
+        channel.MultiplyByLeftAndRightMatrix(uCodebook.m_transposedMatrix, sCodebook.m_matrix);
+
+    const std::size_t numUBeams = uCodebook.GetNumBeams();
+    const std::size_t numSBeams = sCodebook.GetNumBeams();
+    const std::size_t numPairs = numUBeams * numSBeams;
+    std::vector<double> gains(numPairs, 0.0);
+    for (uint16_t cluster = 0; cluster < longTerms.GetNumPages(); ++cluster)
+    {
+        const std::complex<double>* page = longTerms.GetPagePtr(cluster);
+        for (std::size_t pair = 0; pair < numPairs; ++pair)
+        {
+            gains[pair] += std::norm(page[pair]);
+        }
+    }
+
+    // the pair of the beams s and u is at s * numUBeams + u
+    double max = 0;
+    *sBeam = 0;
+    *uBeam = 0;
+    const std::size_t numOuter = sFirst ? numSBeams : numUBeams;
+    const std::size_t numInner = sFirst ? numUBeams : numSBeams;
+    for (std::size_t outer = 0; outer < numOuter; ++outer)
+    {
+        for (std::size_t inner = 0; inner < numInner; ++inner)
+        {
+            const std::size_t s = sFirst ? outer : inner;
+            const std::size_t u = sFirst ? inner : outer;
+            const double gain = gains[s * numUBeams + u];
+            if (max < gain)
+            {
+                max = gain;
+                *sBeam = s;
+                *uBeam = u;
+            }
+        }
+    }
+    return max;
+}
+
+} // namespace ns3
@@ -0,0 +1,132 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BEAM_CODEBOOK_H
+#define BEAM_CODEBOOK_H
+
+#include "beam-id.h"
+
+#include <ns3/matrix-based-channel-model.h>
+#include <ns3/simple-ref-count.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup utils
+ * \brief The directional beams of a cell scan, for one antenna configuration
+ *
+ * The codebook holds the beamforming vectors of CreateDirectionalBfv for all
+ * the sectors 0..NumRows of each elevation, elevation first, as the columns
+ * of a dense matrix (one row per antenna element). The beams of all the
+ * antennas with the same elements (number of rows, location of the
+ * elements in the GCS, i.e. the same size, spacing and orientation) and the
+ * same elevations are the same: Get builds the codebook of a configuration
+ * once and then returns it from a cache.
+ *
+ * With the codebooks of the two ends of a link, SearchBestBeamPair computes
+ * the long term components of all the beam pairs in one matrix product
+ * against the channel matrix (vectorised by Eigen, when it is enabled).
+ */
+class BeamCodebook : public SimpleRefCount<BeamCodebook>
+{
+  public:
+    /**
+     * \brief Build the codebook of an antenna; use Get to share it
+     * \param antenna the antenna
+     * \param elevations the elevations of the beams, in degrees
+     */
+    BeamCodebook(const Ptr<const UniformPlanarArray>& antenna,
+                 const std::vector<double>& elevations);
+
+    /**
+     * \brief Get the codebook of an antenna
+     * \param antenna the antenna
+     * \param elevations the elevations of the beams, in degrees
+     * \return the codebook, shared by the antennas of the same configuration
+     */
+    static Ptr<const BeamCodebook> Get(const Ptr<const UniformPlanarArray>& antenna,
+                                       const std::vector<double>& elevations);
+
+    /**
+     * \brief Remove all the codebooks from the cache
+     */
+    static void ClearCache();
+
+    /**
+     * \return the number of codebooks in the cache
+     */
+    static std::size_t GetCacheSize();
+
+    /**
+     * \return the number of beams
+     */
+    std::size_t GetNumBeams() const;
+
+    /**
+     * \param beam the index of the beam
+     * \return the id (sector and elevation) of the beam
+     */
+    BeamId GetBeamId(std::size_t beam) const;
+
+    /**
+     * \param beam the index of the beam
+     * \return the beamforming vector of the beam
+     */
+    PhasedArrayModel::ComplexVector GetBeamformingVector(std::size_t beam) const;
+
+    /**
+     * \return the matrix of the beamforming vectors, one column per beam
+     */
+    const ComplexMatrixArray& GetMatrix() const;
+
+    /**
+     * \brief Find the beam pair of a channel with the highest gain
+     *
+     * The gain of a pair is the sum over the clusters of the squared norm of
+     * its long term component uW^T H_n sW, as the metric of the
+     * RealisticBeamformingAlgorithm. Among the pairs with the same gain, the
+     * first one in the order of the cell scan, the beams of sFirst ? s : u
+     * in the outer loop, is kept.
+     * \param channel the channel matrix H[u][s][n]
+     * \param sCodebook the codebook of the s end of the channel
+     * \param uCodebook the codebook of the u end of the channel
+     * \param sFirst true to scan the s beams in the outer loop
+     * \param [out] sBeam the index of the s beam of the best pair
+     * \param [out] uBeam the index of the u beam of the best pair
+     * \return the gain of the best pair
+     */
+    static double SearchBestBeamPair(const MatrixBasedChannelModel::Complex3DVector& channel,
+                                     const BeamCodebook& sCodebook,
+                                     const BeamCodebook& uCodebook,
+                                     bool sFirst,
+                                     std::size_t* sBeam,
+                                     std::size_t* uBeam);
+
+  private:
+    std::vector<BeamId> m_beamIds;         //!< the id of each beam
+    ComplexMatrixArray m_matrix;           //!< the beams, one per column
+    ComplexMatrixArray m_transposedMatrix; //!< the beams, one per row
+};
+
+} // namespace ns3
+
+#endif /* BEAM_CODEBOOK_H */
@@ -6,6 +6,7 @@
 
 #include "ideal-beamforming-algorithm.h"
 
+#include "beam-codebook.h"
 #include "beam-manager.h"
 #include "nr-gnb-net-device.h"
 #include "nr-gnb-phy.h"
@@ -19,6 +20,7 @@
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/node.h>
 #include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
 #include <ns3/uinteger.h>
 #include <ns3/uniform-planar-array.h>
 
@@ -32,6 +34,113 @@ NS_OBJECT_ENSURE_REGISTERED(DirectPathBeamforming);
 NS_OBJECT_ENSURE_REGISTERED(QuasiOmniDirectPathBeamforming);
 NS_OBJECT_ENSURE_REGISTERED(OptimalCovMatrixBeamforming);
 
+namespace
+{
+
+/**
+ * \brief The task of a search already done
+ */
+class FinishedBeamSearchTask : public BeamSearchTask
+{
+  public:
+    /**
+     * \param bfPair the result of the search
+     */
+    explicit FinishedBeamSearchTask(BeamformingVectorPair bfPair)
+        : m_bfPair(std::move(bfPair))
+    {
+    }
+
+    BeamformingVectorPair Run() const override
+    {
+        return m_bfPair;
+    }
+
+  private:
+    BeamformingVectorPair m_bfPair; //!< the result of the search
+};
+
+/**
+ * \param gnbCodebook the codebook of the gNB
+ * \param ueCodebook the codebook of the UE
+ * \param gnbBeam the index of the beam of the gNB
+ * \param ueBeam the index of the beam of the UE
+ * \return the beamforming vectors of the beams
+ */
+BeamformingVectorPair
+MakeCellScanBeamformingVectors(const BeamCodebook& gnbCodebook,
+                               const BeamCodebook& ueCodebook,
+                               std::size_t gnbBeam,
+                               std::size_t ueBeam)
+{
+    BeamformingVector gnbBfv = BeamformingVector(
+        std::make_pair(gnbCodebook.GetBeamformingVector(gnbBeam), gnbCodebook.GetBeamId(gnbBeam)));
+    BeamformingVector ueBfv = BeamformingVector(
+        std::make_pair(ueCodebook.GetBeamformingVector(ueBeam), ueCodebook.GetBeamId(ueBeam)));
+    return BeamformingVectorPair(std::make_pair(gnbBfv, ueBfv));
+}
+
+/**
+ * \brief The cell scan of a pair against its channel matrix
+ *
+ * The task holds the channel matrix and the codebooks, taken in the
+ * simulation thread, and releases them when it is destroyed there.
+ */
+class CellScanBeamSearchTask : public BeamSearchTask
+{
+  public:
+    /**
+     * \param channelMatrix the channel matrix between the gNB and the UE
+     * \param gnbCodebook the codebook of the gNB
+     * \param ueCodebook the codebook of the UE
+     * \param reverse true if the gNB is the u end of the channel matrix
+     */
+    CellScanBeamSearchTask(Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                           Ptr<const BeamCodebook> gnbCodebook,
+                           Ptr<const BeamCodebook> ueCodebook,
+                           bool reverse)
+        : m_channelMatrix(channelMatrix),
+          m_gnbCodebook(gnbCodebook),
+          m_ueCodebook(ueCodebook),
+          m_reverse(reverse)
+    {
+    }
+
+    BeamformingVectorPair Run() const override
+    {
+        // the beams of the gNB are in the outer loop, as in the sweep
+        std::size_t gnbBeam = 0;
+        std::size_t ueBeam = 0;
+        if (!m_reverse)
+        {
+            BeamCodebook::SearchBestBeamPair(m_channelMatrix->m_channel,
+                                             *m_gnbCodebook,
+                                             *m_ueCodebook,
+                                             true,
+                                             &gnbBeam,
+                                             &ueBeam);
+        }
+        else
+        {
+            BeamCodebook::SearchBestBeamPair(m_channelMatrix->m_channel,
+                                             *m_ueCodebook,
+                                             *m_gnbCodebook,
+                                             false,
+                                             &ueBeam,
+                                             &gnbBeam);
+        }
+        return MakeCellScanBeamformingVectors(*m_gnbCodebook, *m_ueCodebook, gnbBeam, ueBeam);
+    }
+
+  private:
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channelMatrix; //!< the channel
+    Ptr<const BeamCodebook> m_gnbCodebook;                             //!< codebook of the gNB
+    Ptr<const BeamCodebook> m_ueCodebook;                              //!< codebook of the UE
+    bool m_reverse;                                                    //!< gNB at the u end
+};
+
+} // namespace
+
 TypeId
 IdealBeamformingAlgorithm::GetTypeId()
 {
@@ -39,6 +148,20 @@ IdealBeamformingAlgorithm::GetTypeId()
     return tid;
 }
 
+std::unique_ptr<BeamSearchTask>
+IdealBeamformingAlgorithm::PrepareBeamSearch(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                             const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    return std::make_unique<FinishedBeamSearchTask>(
+        GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy));
+}
+
+bool
+IdealBeamformingAlgorithm::DependsOnChannel() const
+{
+    return true;
+}
+
 TypeId
 CellScanBeamforming::GetTypeId()
 {
@@ -71,6 +194,24 @@ CellScanBeamforming::GetBeamSearchAngleStep() const
 BeamformingVectorPair
 CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
                                            const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    BeamformingVectorPair bfPair = PrepareBeamSearch(gnbSpectrumPhy, ueSpectrumPhy)->Run();
+
+    NS_LOG_DEBUG("Beamforming vectors for gNB with node id: "
+                 << gnbSpectrumPhy->GetMobility()->GetObject<Node>()->GetId()
+                 << " and UE with node id: "
+                 << ueSpectrumPhy->GetMobility()->GetObject<Node>()->GetId() << " are txTheta "
+                 << bfPair.first.second.GetElevation() << " rxTheta "
+                 << bfPair.second.second.GetElevation() << " tx sector "
+                 << bfPair.first.second.GetSector() << " rx sector "
+                 << bfPair.second.second.GetSector());
+
+    return bfPair;
+}
+
+std::unique_ptr<BeamSearchTask>
+CellScanBeamforming::PrepareBeamSearch(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                       const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
 {
     NS_ABORT_MSG_IF(gnbSpectrumPhy == nullptr || ueSpectrumPhy == nullptr,
                     "Something went wrong, gnb or UE PHY layer not set.");
@@ -78,6 +219,7 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     NS_ABORT_MSG_IF(distance == 0,
                     "Beamforming method cannot be performed between two devices that are placed in "
                     "the same position.");
+    NS_ABORT_MSG_IF(m_beamSearchAngleStep < 1, "The beam search angle step is below 1 degree");
 
     Ptr<SpectrumChannel> gnbSpectrumChannel =
         gnbSpectrumPhy
@@ -91,6 +233,63 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     NS_ASSERT_MSG(gnbThreeGppSpectrumPropModel == ueThreeGppSpectrumPropModel,
                   "Devices should be connected on the same spectrum channel");
 
+    Ptr<const UniformPlanarArray> gnbAntenna =
+        gnbSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+    Ptr<const UniformPlanarArray> ueAntenna =
+        ueSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
+    NS_ASSERT(gnbAntenna->GetNumberOfElements() && ueAntenna->GetNumberOfElements());
+
+    // the elevations of the scan; the ones of the UE are truncated to whole degrees
+    std::vector<double> txThetas;
+    for (double txTheta = 60; txTheta < 121; txTheta = txTheta + m_beamSearchAngleStep)
+    {
+        txThetas.push_back(txTheta);
+    }
+    std::vector<double> rxThetas;
+    for (double rxTheta = 60; rxTheta < 121;
+         rxTheta = static_cast<uint16_t>(rxTheta + m_beamSearchAngleStep))
+    {
+        rxThetas.push_back(rxTheta);
+    }
+
+    Ptr<const BeamCodebook> gnbCodebook = BeamCodebook::Get(gnbAntenna, txThetas);
+    Ptr<const BeamCodebook> ueCodebook = BeamCodebook::Get(ueAntenna, rxThetas);
+
+    Ptr<const ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<const ThreeGppSpectrumPropagationLossModel>(gnbThreeGppSpectrumPropModel);
+    if (threeGppSplm != nullptr)
+    {
+        // all the beam pairs at once, against the channel matrix, in the task
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+            threeGppSplm->GetChannelModel()->GetChannel(gnbSpectrumPhy->GetMobility(),
+                                                        ueSpectrumPhy->GetMobility(),
+                                                        gnbAntenna,
+                                                        ueAntenna);
+        return std::make_unique<CellScanBeamSearchTask>(
+            channelMatrix,
+            gnbCodebook,
+            ueCodebook,
+            channelMatrix->IsReverse(gnbAntenna->GetId(), ueAntenna->GetId()));
+    }
+
+    std::size_t gnbBeam = 0;
+    std::size_t ueBeam = 0;
+    SweepBeamPairs(gnbSpectrumPhy, ueSpectrumPhy, *gnbCodebook, *ueCodebook, &gnbBeam, &ueBeam);
+    return std::make_unique<FinishedBeamSearchTask>(
+        MakeCellScanBeamformingVectors(*gnbCodebook, *ueCodebook, gnbBeam, ueBeam));
+}
+
+double
+CellScanBeamforming::SweepBeamPairs(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                    const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                    const BeamCodebook& gnbCodebook,
+                                    const BeamCodebook& ueCodebook,
+                                    std::size_t* gnbBeam,
+                                    std::size_t* ueBeam) const
+{
+    Ptr<const PhasedArraySpectrumPropagationLossModel> spectrumPropModel =
+        gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel();
+
     std::vector<int> activeRbs;
     for (size_t rbId = 0; rbId < gnbSpectrumPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
     {
@@ -105,116 +304,41 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
     fakeParams->psd = fakePsd->Copy();
 
-    double max = 0;
-    double maxTxTheta = 0;
-    double maxRxTheta = 0;
-    uint16_t maxTxSector = 0;
-    uint16_t maxRxSector = 0;
-    PhasedArrayModel::ComplexVector maxTxW;
-    PhasedArrayModel::ComplexVector maxRxW;
-
-    UintegerValue uintValue;
-    gnbSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
-    uint32_t txNumRows = static_cast<uint32_t>(uintValue.Get());
-    ueSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
-    uint32_t rxNumRows = static_cast<uint32_t>(uintValue.Get());
+    Ptr<PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
 
-    NS_ASSERT(gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumberOfElements() &&
-              ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumberOfElements());
-
-    uint16_t numRowsTx = static_cast<uint16_t>(txNumRows);
-    uint16_t numRowsRx = static_cast<uint16_t>(rxNumRows);
-    for (double txTheta = 60; txTheta < 121; txTheta = txTheta + m_beamSearchAngleStep)
+    double max = 0;
+    *gnbBeam = 0;
+    *ueBeam = 0;
+    for (std::size_t txBeam = 0; txBeam < gnbCodebook.GetNumBeams(); txBeam++)
     {
-        for (uint16_t txSector = 0; txSector <= numRowsTx; txSector++)
+        gnbAntenna->SetBeamformingVector(gnbCodebook.GetBeamformingVector(txBeam));
+        for (std::size_t rxBeam = 0; rxBeam < ueCodebook.GetNumBeams(); rxBeam++)
         {
-            NS_ASSERT(txSector < UINT16_MAX);
-
-            gnbSpectrumPhy->GetBeamManager()->SetSector(txSector, txTheta);
-            PhasedArrayModel::ComplexVector txW =
-                gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-            if (maxTxW.GetSize() == 0)
-            {
-                maxTxW = txW; // initialize maxTxW
-            }
-
-            for (double rxTheta = 60; rxTheta < 121;
-                 rxTheta = static_cast<uint16_t>(rxTheta + m_beamSearchAngleStep))
-            {
-                for (uint16_t rxSector = 0; rxSector <= numRowsRx; rxSector++)
-                {
-                    NS_ASSERT(rxSector < UINT16_MAX);
-
-                    ueSpectrumPhy->GetBeamManager()->SetSector(rxSector, rxTheta);
-                    PhasedArrayModel::ComplexVector rxW =
-                        ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-                    if (maxRxW.GetSize() == 0)
-                    {
-                        maxRxW = rxW; // initialize maxRxW
-                    }
+            ueAntenna->SetBeamformingVector(ueCodebook.GetBeamformingVector(rxBeam));
 
-                    NS_ABORT_MSG_IF(txW.GetSize() == 0 || rxW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
+            Ptr<SpectrumValue> rxPsd =
+                spectrumPropModel->CalcRxPowerSpectralDensity(fakeParams,
+                                                              gnbSpectrumPhy->GetMobility(),
+                                                              ueSpectrumPhy->GetMobility(),
+                                                              gnbAntenna,
+                                                              ueAntenna);
 
-                    Ptr<SpectrumValue> rxPsd =
-                        gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
-                            fakeParams,
-                            gnbSpectrumPhy->GetMobility(),
-                            ueSpectrumPhy->GetMobility(),
-                            gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    size_t nbands = rxPsd->GetSpectrumModel()->GetNumBands();
-                    double power = Sum(*rxPsd) / nbands;
+            size_t nbands = rxPsd->GetSpectrumModel()->GetNumBands();
+            double power = Sum(*rxPsd) / nbands;
 
-                    NS_LOG_LOGIC(
-                        " Rx power: "
-                        << power << "txTheta " << txTheta << " rxTheta " << rxTheta << " tx sector "
-                        << (M_PI * static_cast<double>(txSector) / static_cast<double>(txNumRows) -
-                            0.5 * M_PI) /
-                               (M_PI)*180
-                        << " rx sector "
-                        << (M_PI * static_cast<double>(rxSector) / static_cast<double>(rxNumRows) -
-                            0.5 * M_PI) /
-                               (M_PI)*180);
+            NS_LOG_LOGIC(" Rx power: " << power << " tx beam " << gnbCodebook.GetBeamId(txBeam)
+                                       << " rx beam " << ueCodebook.GetBeamId(rxBeam));
 
-                    if (max < power)
-                    {
-                        max = power;
-                        maxTxSector = txSector;
-                        maxRxSector = rxSector;
-                        maxTxTheta = txTheta;
-                        maxRxTheta = rxTheta;
-                        maxTxW = txW;
-                        maxRxW = rxW;
-                    }
-                }
+            if (max < power)
+            {
+                max = power;
+                *gnbBeam = txBeam;
+                *ueBeam = rxBeam;
             }
         }
     }
-
-    BeamformingVector gnbBfv =
-        BeamformingVector(std::make_pair(maxTxW, BeamId(maxTxSector, maxTxTheta)));
-    BeamformingVector ueBfv =
-        BeamformingVector(std::make_pair(maxRxW, BeamId(maxRxSector, maxRxTheta)));
-
-    NS_LOG_DEBUG(
-        "Beamforming vectors for gNB with node id: "
-        << gnbSpectrumPhy->GetMobility()->GetObject<Node>()->GetId()
-        << " and UE with node id: " << ueSpectrumPhy->GetMobility()->GetObject<Node>()->GetId()
-        << " are txTheta " << maxTxTheta << " rxTheta " << maxRxTheta << " tx sector "
-        << (M_PI * static_cast<double>(maxTxSector) / static_cast<double>(txNumRows) - 0.5 * M_PI) /
-               (M_PI)*180
-        << " rx sector "
-        << (M_PI * static_cast<double>(maxRxSector) / static_cast<double>(rxNumRows) - 0.5 * M_PI) /
-               (M_PI)*180);
-
-    NS_ASSERT(maxTxW.GetSize() && maxRxW.GetSize());
-
-    return BeamformingVectorPair(std::make_pair(gnbBfv, ueBfv));
+    return max;
 }
 
 TypeId
@@ -533,6 +657,12 @@ DirectPathBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectr
     return BeamformingVectorPair(std::make_pair(gnbBfv, ueBfv));
 }
 
+bool
+DirectPathBeamforming::DependsOnChannel() const
+{
+    return false;
+}
+
 TypeId
 QuasiOmniDirectPathBeamforming::GetTypeId()
 {
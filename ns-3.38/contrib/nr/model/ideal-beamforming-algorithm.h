@@ -12,15 +12,42 @@
 
 #include <ns3/object.h>
 
+#include <memory>
+
 namespace ns3
 {
 
+class BeamCodebook;
 class SpectrumModel;
 class SpectrumValue;
 class NrGnbNetDevice;
 class NrUeNetDevice;
 class NrSpectrumPhy;
 
+/**
+ * \ingroup gnb-phy
+ * \brief A beam search prepared by an IdealBeamformingAlgorithm
+ *
+ * The preparation runs in the simulation thread and takes from the devices
+ * and the channel everything that the search needs. Run may then be called
+ * from any thread: it neither touches the simulator nor copies or releases
+ * reference counted objects.
+ */
+class BeamSearchTask
+{
+  public:
+    /**
+     * \brief destructor
+     */
+    virtual ~BeamSearchTask() = default;
+
+    /**
+     * \brief Search the beams
+     * \return the beamforming vector pair of the gNB and the UE
+     */
+    virtual BeamformingVectorPair Run() const = 0;
+};
+
 /**
  * \ingroup gnb-phy
  * \brief Generate "Ideal" beamforming vectors
@@ -48,11 +75,38 @@ class IdealBeamformingAlgorithm : public Object
     virtual BeamformingVectorPair GetBeamformingVectors(
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const = 0;
+
+    /**
+     * \brief Prepare the search of the beamforming vectors of a pair of
+     * communicating devices, to run it later, possibly in another thread
+     *
+     * By default, the search is done by GetBeamformingVectors right away, and
+     * the task only returns its result.
+     * \param [in] gnbSpectrumPhy gNb spectrum phy instance
+     * \param [in] ueSpectrumPhy UE spectrum phy instance
+     * \return the task of the search
+     */
+    virtual std::unique_ptr<BeamSearchTask> PrepareBeamSearch(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const;
+
+    /**
+     * \return true if the beams depend on the channel between the devices,
+     * false if they depend only on their positions
+     */
+    virtual bool DependsOnChannel() const;
 };
 
 /**
  * \ingroup gnb-phy
  * \brief The CellScanBeamforming class
+ *
+ * The gNB and the UE scan the sectors 0..NumRows of their antenna for each
+ * elevation between 60 and 120 degrees, by steps of BeamSearchAngleStep, and
+ * the pair of beams with the highest gain is chosen. The beams are taken from
+ * the BeamCodebook of each antenna. With a ThreeGppSpectrumPropagationLossModel,
+ * the gains of all the pairs are computed at once from the channel matrix;
+ * with another model, each pair is evaluated by its received power.
  */
 class CellScanBeamforming : public IdealBeamformingAlgorithm
 {
@@ -94,7 +148,39 @@ class CellScanBeamforming : public IdealBeamformingAlgorithm
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
 
+    /**
+     * \brief Prepare the cell scan of a pair of communicating devices
+     *
+     * With a ThreeGppSpectrumPropagationLossModel, the channel matrix and the
+     * codebooks are taken here, and the task computes the gains of all the
+     * pairs. With another model, the sweep is done here.
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE device
+     * \return the task of the search
+     */
+    std::unique_ptr<BeamSearchTask> PrepareBeamSearch(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
+
   private:
+    /**
+     * \brief Evaluate each pair of beams by its received power, with the
+     * spectrum propagation loss model of the channel
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE device
+     * \param [in] gnbCodebook the beams of the gNB
+     * \param [in] ueCodebook the beams of the UE
+     * \param [out] gnbBeam the beam of the gNB of the best pair
+     * \param [out] ueBeam the beam of the UE of the best pair
+     * \return the received power of the best pair
+     */
+    double SweepBeamPairs(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                          const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                          const BeamCodebook& gnbCodebook,
+                          const BeamCodebook& ueCodebook,
+                          std::size_t* gnbBeam,
+                          std::size_t* ueBeam) const;
+
     double m_beamSearchAngleStep{30}; //!< the beam search angle step attribute
 };
 
@@ -207,6 +293,11 @@ class DirectPathBeamforming : public IdealBeamformingAlgorithm
     BeamformingVectorPair GetBeamformingVectors(
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
+
+    /**
+     * \return false: the direct path depends only on the positions
+     */
+    bool DependsOnChannel() const override;
 };
 
 /**
@@ -12,11 +12,16 @@
 
 #include <ns3/double.h>
 #include <ns3/enum.h>
+#include <ns3/hash.h>
 #include <ns3/log.h>
 #include <ns3/math.h>
 #include <ns3/nr-spectrum-value-helper.h>
 #include <ns3/uinteger.h>
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 namespace ns3
 {
 
@@ -37,6 +42,7 @@ NrAmc::SetDlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = NrErrorModel::DL;
+    m_cqiCache.clear();
 }
 
 void
@@ -44,6 +50,7 @@ NrAmc::SetUlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = NrErrorModel::UL;
+    m_cqiCache.clear();
 }
 
 TypeId
@@ -72,6 +79,19 @@ NrAmc::GetTypeId()
                           TypeIdValue(NrLteMiErrorModel::GetTypeId()),
                           MakeTypeIdAccessor(&NrAmc::SetErrorModelType, &NrAmc::GetErrorModelType),
                           MakeTypeIdChecker())
+            .AddAttribute("CqiCacheSize",
+                          "Number of SINR vectors whose CQI and MCS are kept when AmcModel is "
+                          "set to ErrorModel. A SINR vector which quantises to a kept one gets "
+                          "its CQI and MCS without calling the error model. 0 disables the cache.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrAmc::SetCqiCacheSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CqiCacheResolution",
+                          "Quantisation step in dB of the SINR vectors in the CQI cache. With 0 "
+                          "only exactly equal SINR vectors share a cache entry.",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&NrAmc::m_cqiCacheResolutionDb),
+                          MakeDoubleChecker<double>(0.0))
             .AddConstructor<NrAmc>();
     return tid;
 }
@@ -114,6 +134,15 @@ NrAmc::SetNumRefScPerRb(uint8_t nref)
 {
     NS_LOG_FUNCTION(this);
     m_numRefScPerRb = nref;
+    m_cqiCache.clear();
+}
+
+void
+NrAmc::SetCqiCacheSize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_cqiCacheSize = size;
+    m_cqiCache.clear();
 }
 
 uint32_t
@@ -218,57 +247,112 @@ NrAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) const
     }
     else if (m_amcModel == ErrorModel)
     {
-        std::vector<int> rbMap;
-        int rbId = 0;
+        if (m_cqiCacheSize == 0)
+        {
+            return SearchMcs(sinr, mcs);
+        }
+
+        CqiCacheEntry entry;
+        entry.m_key.reserve(sinr.GetValuesN());
         for (it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); it++)
         {
-            if (*it != 0.0)
+            int64_t value = 0;
+            if (m_cqiCacheResolutionDb == 0.0)
+            {
+                std::memcpy(&value, &(*it), sizeof(value));
+            }
+            else if (*it != 0.0)
             {
-                rbMap.push_back(rbId);
+                value = std::llround(10 * std::log10(*it) / m_cqiCacheResolutionDb);
             }
-            rbId += 1;
+            else
+            {
+                value = std::numeric_limits<int64_t>::min(); // no signal in this RB
+            }
+            entry.m_key.push_back(value);
         }
+        entry.m_hash = Hash64(reinterpret_cast<const char*>(entry.m_key.data()),
+                              entry.m_key.size() * sizeof(int64_t));
 
-        mcs = 0;
-        Ptr<NrErrorModelOutput> output;
-        while (mcs <= m_errorModel->GetMaxMcs())
+        for (auto cached = m_cqiCache.begin(); cached != m_cqiCache.end(); ++cached)
         {
-            output = m_errorModel->GetTbDecodificationStats(sinr,
-                                                            rbMap,
-                                                            CalculateTbSize(mcs, rbMap.size()),
-                                                            mcs,
-                                                            NrErrorModel::NrErrorModelHistory());
-            if (output->m_tbler > 0.1)
+            if (cached->m_hash == entry.m_hash && cached->m_key == entry.m_key)
             {
-                break;
+                NS_LOG_LOGIC("CQI cache hit");
+                m_cqiCache.splice(m_cqiCache.begin(), m_cqiCache, cached);
+                mcs = cached->m_mcs;
+                return cached->m_cqi;
             }
-            mcs++;
         }
 
-        if (mcs > 0)
+        cqi = SearchMcs(sinr, mcs);
+        entry.m_mcs = mcs;
+        entry.m_cqi = cqi;
+        m_cqiCache.push_front(std::move(entry));
+        if (m_cqiCache.size() > m_cqiCacheSize)
         {
-            mcs--;
+            m_cqiCache.pop_back();
         }
+    }
+    return cqi;
+}
+
+uint8_t
+NrAmc::SearchMcs(const SpectrumValue& sinr, uint8_t& mcs) const
+{
+    NS_LOG_FUNCTION(this);
 
-        if ((output->m_tbler > 0.1) && (mcs == 0))
+    std::vector<int> rbMap;
+    rbMap.reserve(sinr.GetValuesN());
+    int rbId = 0;
+    for (auto it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); it++)
+    {
+        if (*it != 0.0)
         {
-            cqi = 0;
+            rbMap.push_back(rbId);
         }
-        else if (mcs == m_errorModel->GetMaxMcs())
+        rbId += 1;
+    }
+
+    mcs = 0;
+    Ptr<NrErrorModelOutput> output;
+    while (mcs <= m_errorModel->GetMaxMcs())
+    {
+        output = m_errorModel->GetTbDecodificationStats(sinr,
+                                                        rbMap,
+                                                        CalculateTbSize(mcs, rbMap.size()),
+                                                        mcs,
+                                                        NrErrorModel::NrErrorModelHistory());
+        if (output->m_tbler > 0.1)
         {
-            cqi = 15; // all MCSs can guarantee the 10 % of BER
+            break;
         }
-        else
+        mcs++;
+    }
+
+    if (mcs > 0)
+    {
+        mcs--;
+    }
+
+    uint8_t cqi = 0;
+    if ((output->m_tbler > 0.1) && (mcs == 0))
+    {
+        cqi = 0;
+    }
+    else if (mcs == m_errorModel->GetMaxMcs())
+    {
+        cqi = 15; // all MCSs can guarantee the 10 % of BER
+    }
+    else
+    {
+        double s = m_errorModel->GetSpectralEfficiencyForMcs(mcs);
+        while ((cqi < 15) && (m_errorModel->GetSpectralEfficiencyForCqi(cqi + 1) <= s))
         {
-            double s = m_errorModel->GetSpectralEfficiencyForMcs(mcs);
-            cqi = 0;
-            while ((cqi < 15) && (m_errorModel->GetSpectralEfficiencyForCqi(cqi + 1) <= s))
-            {
-                ++cqi;
-            }
+            ++cqi;
         }
-        NS_LOG_DEBUG(this << "\t MCS " << (uint16_t)mcs << "-> CQI " << cqi);
     }
+    NS_LOG_DEBUG(this << "\t MCS " << (uint16_t)mcs << "-> CQI " << +cqi);
     return cqi;
 }
 
@@ -328,6 +412,7 @@ NrAmc::SetErrorModelType(const TypeId& type)
     NS_LOG_FUNCTION(this);
     ObjectFactory factory;
     m_errorModelType = type;
+    m_cqiCache.clear();
 
     factory.SetTypeId(m_errorModelType);
     m_errorModel = DynamicCast<NrErrorModel>(factory.Create());
@@ -10,6 +10,8 @@
 #include <ns3/nr-error-model.h>
 #include <ns3/nr-phy-mac-common.h>
 
+#include <list>
+
 namespace ns3
 {
 
@@ -25,6 +27,13 @@ namespace ns3
  * configure the ErrorModel type, which must be the same as the one set in the
  * NrSpectrumPhy class.
  *
+ * With the ErrorModel model, the MCSs are tried from 0 upwards until the first
+ * one whose TBLER exceeds 0.1. The TBLER of the error models is not monotone in
+ * the MCS with small allocations (the TBS of an MCS can be smaller than the one
+ * of the MCS below), so the search cannot skip any MCS. If the attribute
+ * CqiCacheSize is not zero, the CQI and MCS of the last SINR vectors are kept,
+ * so that static UEs with an unchanged SINR do not call the error model at all.
+ *
  * \section nr_amc_conf Configuration
  *
  * The attributes of this class can be configured through the helper methods
@@ -194,6 +203,31 @@ class NrAmc : public Object
      */
     double GetBer() const;
 
+    /**
+     * \brief Find the MCS below the first one whose TBLER exceeds 0.1 with the error model
+     * \param sinr the sinr values
+     * \param mcs The calculated MCS
+     * \return The calculated CQI
+     */
+    uint8_t SearchMcs(const SpectrumValue& sinr, uint8_t& mcs) const;
+
+    /**
+     * \brief Set the number of SINR vectors kept in the CQI cache
+     * \param size the number of entries, 0 disables the cache
+     */
+    void SetCqiCacheSize(uint32_t size);
+
+    /**
+     * \brief Entry of the CQI cache
+     */
+    struct CqiCacheEntry
+    {
+        uint64_t m_hash;             //!< hash of m_key
+        std::vector<int64_t> m_key;  //!< quantised SINR of every RB
+        uint8_t m_mcs;               //!< the MCS for this SINR
+        uint8_t m_cqi;               //!< the CQI for this SINR
+    };
+
   private:
     AmcModel m_amcModel;                           //!< Type of the CQI feedback model
     Ptr<NrErrorModel> m_errorModel;                //!< Pointer to an instance of ErrorModel
@@ -201,6 +235,9 @@ class NrAmc : public Object
     uint8_t m_numRefScPerRb{1};                    //!< number of reference subcarriers per RB
     NrErrorModel::Mode m_emMode{NrErrorModel::DL}; //!< Error model mode
     static const unsigned int m_crcLen = 24 / 8;   //!< CRC length (in bytes)
+    uint32_t m_cqiCacheSize{0};                    //!< maximum number of cached SINR vectors
+    double m_cqiCacheResolutionDb{0.1};            //!< quantisation of the cached SINR vectors
+    mutable std::list<CqiCacheEntry> m_cqiCache;   //!< cached SINR vectors, most recent first
 };
 
 } // end namespace ns3
@@ -7,6 +7,7 @@
 #ifndef SRC_NR_MODEL_NR_CONTROL_MESSAGES_H_
 #define SRC_NR_MODEL_NR_CONTROL_MESSAGES_H_
 
+#include "nr-memory-pool.h"
 #include "nr-phy-mac-common.h"
 
 #include <ns3/ff-mac-common.h>
@@ -88,6 +89,26 @@ class NrControlMessage : public SimpleRefCount<NrControlMessage>
      */
     uint16_t GetSourceBwp() const;
 
+    /**
+     * \brief Allocate a message in the NrMemoryPool
+     * \param size the size of the message
+     * \return the storage of the message
+     */
+    static void* operator new(std::size_t size)
+    {
+        return NrMemoryPool::Allocate(size);
+    }
+
+    /**
+     * \brief Give a message back to the NrMemoryPool
+     * \param p the storage of the message
+     * \param size the size of the message, of its dynamic type
+     */
+    static void operator delete(void* p, std::size_t size)
+    {
+        NrMemoryPool::Deallocate(p, size);
+    }
+
   protected:
     /**
      * \brief Set the MessageType
@@ -7,6 +7,7 @@
 
 #include "nr-eesm-error-model.h"
 
+#include "nr-error-model-kernels.h"
 #include "nr-phy-mac-common.h"
 
 #include "ns3/enum.h"
@@ -83,32 +84,8 @@ NrEesmErrorModel::SinrExp(const SpectrumValue& sinr, const std::vector<int>& map
     NS_ABORT_MSG_IF(map.size() == 0,
                     " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
-    double SINRexp = 0.0;
-    double SINRsum = 0.0;
     double beta = GetBetaTable()->at(mcs);
-    for (uint32_t i = 0; i < map.size(); i++)
-    {
-        double sinrLin = sinr[map.at(i)];
-        SINRexp = exp(-sinrLin / beta);
-        SINRsum += SINRexp;
-    }
-    return SINRsum;
-}
-
-const std::vector<double>&
-NrEesmErrorModel::GetSinrDbVectorFromSimulatedValues(NrEesmErrorModel::GraphType graphType,
-                                                     uint8_t mcs,
-                                                     uint32_t cbSizeIndex) const
-{
-    return std::get<0>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
-}
-
-const std::vector<double>&
-NrEesmErrorModel::GetBLERVectorFromSimulatedValues(NrEesmErrorModel::GraphType graphType,
-                                                   uint8_t mcs,
-                                                   uint32_t cbSizeIndex) const
-{
-    return std::get<1>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
+    return NrErrorModelKernels::SumExp(&(*sinr.ConstValuesBegin()), map.data(), map.size(), beta);
 }
 
 double
@@ -128,39 +105,40 @@ NrEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeBit)
     // Get the index of CBSIZE in the map
     NS_LOG_INFO("For sinr " << sinr << " and mcs " << +mcs << " CbSizebit " << cbSizeBit
                             << " we got bg type " << m_bgTypeName[bg_type]);
-    auto cbMap = GetSimulatedBlerFromSINR()->at(bg_type).at(mcs);
-    auto cbIt = cbMap.upper_bound(cbSizeBit);
+    const SimulatedBlerFromSINR* table = GetSimulatedBlerFromSINR();
+    uint32_t curves = bg_type * table->m_numMcs + mcs;
+    const uint32_t* cbBegin = table->m_cbSizes + table->m_curveOffsets[curves];
+    const uint32_t* cbEnd = table->m_cbSizes + table->m_curveOffsets[curves + 1];
+    const uint32_t* cbIt = std::upper_bound(cbBegin, cbEnd, cbSizeBit);
 
-    if (cbIt != cbMap.begin())
+    if (cbIt != cbBegin)
     {
         cbIt--;
     }
 
-    if (sinr_db < GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).front())
+    uint32_t curve = cbIt - table->m_cbSizes;
+    const double* sinrBegin = table->m_sinrDb + table->m_pointOffsets[curve];
+    const double* sinrEnd = table->m_sinrDb + table->m_pointOffsets[curve + 1];
+
+    if (sinr_db < *sinrBegin)
     {
         bler = 1.0;
     }
-    else if (sinr_db > GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).back())
+    else if (sinr_db > *(sinrEnd - 1))
     {
         bler = 0.0;
     }
     else
     {
-        // Get the index of SINR in the vector
-        auto sinrIt =
-            std::upper_bound(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                             GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).end(),
-                             sinr_db);
+        // Get the index of SINR in the curve
+        auto sinrIt = std::upper_bound(sinrBegin, sinrEnd, sinr_db);
 
-        if (sinrIt != GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin())
+        if (sinrIt != sinrBegin)
         {
             sinrIt--;
         }
 
-        auto sinr_index =
-            std::distance(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                          sinrIt);
-        bler = GetBLERVectorFromSimulatedValues(bg_type, mcs, cbIt->first).at(sinr_index);
+        bler = table->m_bler[sinrIt - table->m_sinrDb];
     }
 
     NS_LOG_LOGIC("SINR effective: " << sinr << " BLER:" << bler);
@@ -289,9 +267,10 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     NS_LOG_FUNCTION(this);
     NS_ABORT_IF(mcs > GetMaxMcs());
 
-    double tbSinr = SinrEff(sinr, map, mcs, 0, map.size()); // effective SINR for this tx
-    double SINR = tbSinr;
     double sinrExpSum = SinrExp(sinr, map, mcs); // exponential sum of SINRs for this tx
+    // effective SINR for this tx, as in SinrEff (sinr, map, mcs, 0, map.size ())
+    double tbSinr = -GetBetaTable()->at(mcs) * log((0.0 + sinrExpSum) / map.size());
+    double SINR = tbSinr;
 
     NS_LOG_DEBUG(" mcs " << +mcs << " TBSize in bit " << sizeBit << " history elements: "
                          << sinrHistory.size() << " SINR of the tx: " << tbSinr << std::endl
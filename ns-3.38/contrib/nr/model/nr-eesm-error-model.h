@@ -9,8 +9,6 @@
 
 #include "nr-error-model.h"
 
-#include <map>
-
 namespace ns3
 {
 
@@ -157,9 +155,25 @@ class NrEesmErrorModel : public NrErrorModel
      */
     uint8_t GetMaxMcs() const override;
 
-    typedef std::vector<double> DoubleVector;
-    typedef std::tuple<DoubleVector, DoubleVector> DoubleTuple;
-    typedef std::vector<std::vector<std::map<uint32_t, DoubleTuple>>> SimulatedBlerFromSINR;
+    /**
+     * \brief Simulated SINR-BLER curves of an MCS table
+     *
+     * There are curves for every LDPC base graph type, MCS and some CB sizes.
+     * They are stored in contiguous constant arrays, which are initialized at
+     * compile time: the curves of base graph type g and MCS m are the ones from
+     * m_curveOffsets[g * m_numMcs + m] up to the next offset, sorted by CB
+     * size, and the points of curve c are the ones from m_pointOffsets[c] up to
+     * m_pointOffsets[c + 1].
+     */
+    struct SimulatedBlerFromSINR
+    {
+        uint8_t m_numMcs;               //!< number of MCSs of every base graph type
+        const uint16_t* m_curveOffsets; //!< first curve of every base graph type and MCS
+        const uint32_t* m_cbSizes;      //!< CB size of every curve
+        const uint32_t* m_pointOffsets; //!< first point of every curve
+        const double* m_sinrDb;         //!< SINR (dB) of every point, increasing in a curve
+        const double* m_bler;           //!< BLER of every point
+    };
 
   protected:
     /**
@@ -326,27 +340,6 @@ class NrEesmErrorModel : public NrErrorModel
      * the number of code blocks
      */
     std::pair<uint32_t, uint32_t> CodeBlockSegmentation(uint32_t B, GraphType bg_type) const;
-
-    /**
-     * \brief Get SinrDb Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
-     */
-    const std::vector<double>& GetSinrDbVectorFromSimulatedValues(GraphType graphType,
-                                                                  uint8_t mcs,
-                                                                  uint32_t cbSizeIndex) const;
-    /**
-     * \brief Get BLER Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
-     */
-    const std::vector<double>& GetBLERVectorFromSimulatedValues(GraphType graphType,
-                                                                uint8_t mcs,
-                                                                uint32_t cbSizeIndex) const;
 };
 
 } // namespace ns3
@@ -20,7 +20,10 @@
 
 
 #include "nr-energy-model.h"
+#include <algorithm>
 #include <fstream>
+#include <map>
+#include <sstream>
 namespace ns3{
 
 NS_OBJECT_ENSURE_REGISTERED (NrEnergyModel);
@@ -90,27 +93,174 @@ void NrChip::SetEnergyParameterFromCentralFrequency(double centralFrequency,doub
     std::cout<<m_uplinkPower<<std::endl;
 }
 NrEnergyModel::NrEnergyModel(NrChip module,uint32_t startTime):
-m_module(module),m_lastState(PowerState::OFF), m_lastStateChange(Time(0))
+m_module(module),m_lastState(PowerState::OFF), m_savedInactiveState(PowerState::OFF), m_lastStateChange(Time(0))
 {
    m_battery = CreateObject<LiIonEnergySource>();
    m_battery->SetInitialEnergy(37000.0);
+   // the power of the module does not change, so it is looked up once per state
+   m_powerInState[uint(PowerState::RRC_Connected)] = m_module.GetConnectedPower();
+   m_powerInState[uint(PowerState::RRC_RECEIVING_PDSCH)] = m_module.GetDownlinkPower();
+   m_powerInState[uint(PowerState::RRC_SENDING_PRACH)] = m_module.GetUplinkPower();
+   m_powerInState[uint(PowerState::RRC_SENDING_PUSCH)] = m_module.GetUplinkPower();
+   m_powerInState[uint(PowerState::RRC_IDLE_EDRX)] = m_module.GetEdrxPower();
+   m_powerInState[uint(PowerState::RRC_IDLE_DRX)] = m_module.GetDrxPower();
+   //TODO has to be changed?
+   m_powerInState[uint(PowerState::RRC_IDLE)] = m_module.m_useEdrx ? m_module.GetEdrxPower() : m_module.GetDrxPower();
    Simulator::Schedule(MilliSeconds(startTime),&NrEnergyModel::ActivateEnergyModel, this);
 };
 
 NrEnergyModel::~NrEnergyModel(){
+    Simulator::Cancel(m_projectionEvent);
+    if(!m_logWriter)
+    {
+        m_logWriter = NrEnergyLogWriter::Get(m_outputDir, m_binaryLog);
+    }
+    if(m_isActive && !m_projectionInterval.IsZero())
+    {
+        m_logWriter->WriteProjection(m_imsi, GetProjection());
+    }
     DoNotifyStateChange(PowerState::OFF);
-    std::string logfile_path = m_outputDir+"Energystates.log";
-    std::ofstream logfile;
-    logfile.open(logfile_path, std::ios_base::app);
-    for( auto  const& state : m_timeSpendInState)
+    m_logWriter->Write(m_imsi, m_visitedStates, m_timeSpendInState, m_energySpendInState);
+}
+
+static Time
+LifetimeFromEnergy(double energy, double power){
+    if(power <= 0 || energy / power >= Time::Max().GetSeconds())
     {
-        logfile << Simulator::Now().GetNanoSeconds() <<" imsi; " <<m_imsi<<", Time in state " << PowerStateNames[uint(state.first)]<< ":" << (state.second/1e6)  <<"ms"<<"\n";
+        return Time::Max();
     }
-    for( auto  const& state : m_energySpendInState)
+    return Seconds(std::max(energy, 0.0) / power);
+}
+
+void NrEnergyModel::SetProjectionInterval(Time interval){
+    Simulator::Cancel(m_projectionEvent);
+    m_projectionInterval = interval;
+    if(m_isActive && !m_projectionInterval.IsZero())
     {
-        logfile << Simulator::Now().GetNanoSeconds() <<" imsi; " <<m_imsi<< ", Energy in state " << PowerStateNames[uint(state.first)]<< ":" << state.second<<"\n";
+        StartProjection();
     }
-    logfile.close();
+}
+
+void NrEnergyModel::StartProjection(){
+    m_projectionStart = Simulator::Now();
+    GetCurrentTotals(m_projectionTimeStart, m_projectionEnergyStart);
+    m_lastSampleEnergy = m_projectionEnergyStart;
+    m_samples = 0;
+    m_powerMean = 0;
+    m_powerM2 = 0;
+    m_projectionEvent = Simulator::Schedule(m_projectionInterval, &NrEnergyModel::SampleProjection, this);
+}
+
+void NrEnergyModel::SampleProjection(){
+    std::array<uint64_t, NUM_POWER_STATES> timeInState;
+    double energy;
+    GetCurrentTotals(timeInState, energy);
+    double power = (energy - m_lastSampleEnergy) / m_projectionInterval.GetSeconds();
+    m_lastSampleEnergy = energy;
+    // Welford's running mean and variance
+    m_samples++;
+    double delta = power - m_powerMean;
+    m_powerMean += delta / m_samples;
+    m_powerM2 += delta * (power - m_powerMean);
+    m_projectionEvent = Simulator::Schedule(m_projectionInterval, &NrEnergyModel::SampleProjection, this);
+}
+
+void NrEnergyModel::GetCurrentTotals(std::array<uint64_t, NUM_POWER_STATES>& timeInState, double& energy) const{
+    timeInState = m_timeSpendInState;
+    Time stateTime = Simulator::Now() - m_lastStateChange;
+    timeInState[uint(m_lastState)] += stateTime.GetNanoSeconds();
+    energy = m_consumedEnergy + m_powerInState[uint(m_lastState)]*stateTime.GetMicroSeconds()/1e6;
+}
+
+double NrEnergyModel::GetCurrentRemainingEnergy() const{
+    Time stateTime = Simulator::Now() - m_lastStateChange;
+    return m_battery->GetRemainingEnergy() - m_powerInState[uint(m_lastState)]*stateTime.GetMicroSeconds()/1e6;
+}
+
+NrEnergyModel::EnergyProjection
+NrEnergyModel::GetProjection() const{
+    NS_ABORT_MSG_IF(m_projectionInterval.IsZero(), "The projection mode is not enabled");
+    EnergyProjection projection;
+    projection.window = Simulator::Now() - m_projectionStart;
+    projection.intervals = m_samples;
+    if(!projection.window.IsStrictlyPositive())
+    {
+        projection.lifetime = projection.lifetimeLower = projection.lifetimeUpper = Time::Max();
+        return projection;
+    }
+
+    std::array<uint64_t, NUM_POWER_STATES> timeInState;
+    double energy;
+    GetCurrentTotals(timeInState, energy);
+    for(uint state = 0; state < NUM_POWER_STATES; state++)
+    {
+        projection.dutyCycle[state] = double(timeInState[state] - m_projectionTimeStart[state]) / projection.window.GetNanoSeconds();
+    }
+    projection.averagePower = (energy - m_projectionEnergyStart) / projection.window.GetSeconds();
+    projection.averagePowerLower = projection.averagePower;
+    projection.averagePowerUpper = projection.averagePower;
+    if(m_samples >= 2)
+    {
+        // 95 % confidence interval of the mean power of the intervals
+        double halfWidth = 1.96 * std::sqrt(m_powerM2 / (m_samples - 1) / m_samples);
+        projection.averagePowerLower = std::max(projection.averagePower - halfWidth, 0.0);
+        projection.averagePowerUpper = projection.averagePower + halfWidth;
+    }
+
+    double remaining = GetCurrentRemainingEnergy();
+    projection.lifetime = LifetimeFromEnergy(remaining, projection.averagePower);
+    projection.lifetimeLower = LifetimeFromEnergy(remaining, projection.averagePowerUpper);
+    projection.lifetimeUpper = LifetimeFromEnergy(remaining, projection.averagePowerLower);
+    return projection;
+}
+
+double NrEnergyModel::GetEnergyRemainingFraction(Time at, double& lower, double& upper) const{
+    NS_ABORT_MSG_IF(at < Simulator::Now(), "Can not project into the past");
+    EnergyProjection projection = GetProjection();
+    double remaining = GetCurrentRemainingEnergy();
+    double initial = m_battery->GetInitialEnergy();
+    double seconds = (at - Simulator::Now()).GetSeconds();
+    lower = std::max(remaining - projection.averagePowerUpper * seconds, 0.0) / initial;
+    upper = std::max(remaining - projection.averagePowerLower * seconds, 0.0) / initial;
+    return std::max(remaining - projection.averagePower * seconds, 0.0) / initial;
+}
+
+void NrEnergyModel::SetOutputDir(const std::string& outputDir, bool binary){
+    m_outputDir = outputDir;
+    m_binaryLog = binary;
+    m_logWriter = NrEnergyLogWriter::Get(m_outputDir, m_binaryLog);
+}
+
+void NrEnergyModel::SetStateHistorySize(uint32_t size){
+    m_states.assign(size, std::pair<PowerState,uint32_t>(PowerState::OFF, 0));
+    m_statesHead = 0;
+    m_statesCount = 0;
+}
+
+std::vector<std::pair<NrEnergyModel::PowerState,uint32_t>>
+NrEnergyModel::GetStateHistory() const{
+    std::vector<std::pair<PowerState,uint32_t>> history;
+    if(m_states.empty())
+    {
+        return history;
+    }
+    history.reserve(m_statesCount);
+    uint32_t first = (m_statesHead + m_states.size() - m_statesCount) % m_states.size();
+    for(uint32_t i = 0; i < m_statesCount; i++)
+    {
+        history.push_back(m_states[(first + i) % m_states.size()]);
+    }
+    return history;
+}
+
+uint64_t
+NrEnergyModel::GetTimeInState(PowerState state) const{
+    return m_timeSpendInState[uint(state)];
+}
+
+double
+NrEnergyModel::GetEnergyInState(PowerState state) const{
+    return m_energySpendInState[uint(state)];
 }
 
 NrEnergyModel::PowerState 
@@ -122,6 +272,10 @@ void NrEnergyModel::ActivateEnergyModel(){
     m_isActive = true;
     m_lastStateChange= Simulator::Now();
     m_lastState = m_savedInactiveState;
+    if(!m_projectionInterval.IsZero())
+    {
+        StartProjection();
+    }
 }
 
 
@@ -162,43 +316,20 @@ void NrEnergyModel::DoNotifyStateChange(PowerState newState){
         }
 
     }
-    double lostEnergy = 0; // Energy in [Ws] or [J]
-    m_states.push_back(std::pair<PowerState,uint32_t>(newState,Simulator::Now().GetMilliSeconds()));
-    switch (m_lastState)
-    {
-    case PowerState::RRC_Connected:
-        lostEnergy = m_module.GetConnectedPower()*stateTime.GetMicroSeconds()/1e6; // Energy in [Ws] or [J]
-        break;
-    case PowerState::RRC_RECEIVING_PDSCH:
-        lostEnergy = m_module.GetDownlinkPower()*stateTime.GetMicroSeconds()/1e6;
-        break;
-    case PowerState::RRC_SENDING_PRACH:
-    case PowerState::RRC_SENDING_PUSCH:
-        lostEnergy = m_module.GetUplinkPower()*stateTime.GetMicroSeconds()/1e6;
-        break;
-    case PowerState::RRC_IDLE_EDRX:
-        lostEnergy = m_module.GetEdrxPower()*stateTime.GetMicroSeconds()/1e6;
-        break;
-    case PowerState::RRC_IDLE_DRX:
-        lostEnergy = m_module.GetDrxPower()*stateTime.GetMicroSeconds()/1e6;
-        break;
-    case PowerState::RRC_IDLE:
-        //TODO has to be changed?
-        if(m_module.m_useEdrx)
-        {
-            lostEnergy = m_module.GetEdrxPower()*stateTime.GetMicroSeconds()/1e6;
-        }
-        else{
-            lostEnergy = m_module.GetDrxPower()*stateTime.GetMicroSeconds()/1e6;
-        }
-        break;
-    default:
-        break;
+    if(!m_states.empty())
+    {
+        m_states[m_statesHead] = std::pair<PowerState,uint32_t>(newState,Simulator::Now().GetMilliSeconds());
+        m_statesHead = (m_statesHead + 1) % m_states.size();
+        m_statesCount = std::min<uint32_t>(m_statesCount + 1, m_states.size());
     }
+    uint last = uint(m_lastState);
+    double lostEnergy = m_powerInState[last]*stateTime.GetMicroSeconds()/1e6; // Energy in [Ws] or [J]
     m_lastStateChange = Simulator::Now();
     m_battery->DecreaseRemainingEnergy(lostEnergy);
-    m_timeSpendInState[m_lastState] += stateTime.GetNanoSeconds();
-    m_energySpendInState[m_lastState] += lostEnergy;
+    m_timeSpendInState[last] += stateTime.GetNanoSeconds();
+    m_energySpendInState[last] += lostEnergy;
+    m_consumedEnergy += lostEnergy;
+    m_visitedStates |= 1u << last;
     m_lastState = newState;
 
 }
@@ -213,5 +344,101 @@ double NrEnergyModel::GetEnergyRemainingFraction(){
     return m_battery->GetEnergyFraction();
 }
 
+NrEnergyLogWriter::NrEnergyLogWriter(const std::string& filename, bool binary):
+m_binary(binary)
+{
+    m_file.open(filename, binary ? std::ios_base::app | std::ios_base::binary : std::ios_base::app);
+    m_buffer.reserve(FLUSH_SIZE);
+}
+
+NrEnergyLogWriter::~NrEnergyLogWriter(){
+    Flush();
+    m_file.close();
+}
+
+std::shared_ptr<NrEnergyLogWriter>
+NrEnergyLogWriter::Get(const std::string& outputDir, bool binary){
+    // the writer lives as long as one model of the directory holds it
+    static std::map<std::string, std::weak_ptr<NrEnergyLogWriter>> writers;
+    std::string filename = outputDir + (binary ? "Energystates.bin" : "Energystates.log");
+    std::shared_ptr<NrEnergyLogWriter> writer = writers[filename].lock();
+    if(!writer)
+    {
+        writer.reset(new NrEnergyLogWriter(filename, binary));
+        writers[filename] = writer;
+    }
+    return writer;
+}
+
+void
+NrEnergyLogWriter::Write(uint64_t imsi,
+                         uint32_t visitedStates,
+                         const std::array<uint64_t, NrEnergyModel::NUM_POWER_STATES>& timeInState,
+                         const std::array<double, NrEnergyModel::NUM_POWER_STATES>& energyInState){
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    if(m_binary)
+    {
+        for(uint state = 0; state < NrEnergyModel::NUM_POWER_STATES; state++)
+        {
+            if(!(visitedStates & (1u << state)))
+            {
+                continue;
+            }
+            uint8_t stateId = state;
+            m_buffer.append(reinterpret_cast<const char*>(&now), sizeof(now));
+            m_buffer.append(reinterpret_cast<const char*>(&imsi), sizeof(imsi));
+            m_buffer.append(reinterpret_cast<const char*>(&stateId), sizeof(stateId));
+            m_buffer.append(reinterpret_cast<const char*>(&timeInState[state]), sizeof(uint64_t));
+            m_buffer.append(reinterpret_cast<const char*>(&energyInState[state]), sizeof(double));
+        }
+    }
+    else
+    {
+        std::ostringstream lines;
+        for(uint state = 0; state < NrEnergyModel::NUM_POWER_STATES; state++)
+        {
+            if(visitedStates & (1u << state))
+            {
+                lines << now <<" imsi; " <<imsi<<", Time in state " << NrEnergyModel::PowerStateNames[state]<< ":" << (timeInState[state]/1e6)  <<"ms"<<"\n";
+            }
+        }
+        for(uint state = 0; state < NrEnergyModel::NUM_POWER_STATES; state++)
+        {
+            if(visitedStates & (1u << state))
+            {
+                lines << now <<" imsi; " <<imsi<< ", Energy in state " << NrEnergyModel::PowerStateNames[state]<< ":" << energyInState[state]<<"\n";
+            }
+        }
+        m_buffer += lines.str();
+    }
+    if(m_buffer.size() >= FLUSH_SIZE)
+    {
+        Flush();
+    }
+}
+
+void
+NrEnergyLogWriter::WriteProjection(uint64_t imsi, const NrEnergyModel::EnergyProjection& projection){
+    if(m_binary)
+    {
+        return;
+    }
+    std::ostringstream lines;
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    lines << now <<" imsi; " <<imsi<< ", Projected average power:" << projection.averagePower
+          << " [" << projection.averagePowerLower << "," << projection.averagePowerUpper << "]W"
+          << " over " << projection.intervals << " intervals\n";
+    lines << now <<" imsi; " <<imsi<< ", Projected lifetime:" << projection.lifetime.GetSeconds()
+          << " [" << projection.lifetimeLower.GetSeconds() << "," << projection.lifetimeUpper.GetSeconds() << "]s\n";
+    m_buffer += lines.str();
+}
+
+void
+NrEnergyLogWriter::Flush(){
+    m_file.write(m_buffer.data(), m_buffer.size());
+    m_file.flush();
+    m_buffer.clear();
+}
+
 
 }
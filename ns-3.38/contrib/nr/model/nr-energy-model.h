@@ -25,7 +25,10 @@
 #include <ns3/object.h>
 #include <ns3/simulator.h>
 #include <ns3/li-ion-energy-source.h>
+#include <array>
 #include <cmath>
+#include <fstream>
+#include <memory>
 #include "ns3/string.h" // Für StringValue
 #include "ns3/attribute.h" // Für MakeStringAccessor und MakeStringChecker
 
@@ -283,6 +286,8 @@ private:
 };
 
 
+class NrEnergyLogWriter;
+
 class NrEnergyModel : public Object
 {
 
@@ -301,6 +306,26 @@ public:
 
     static constexpr std::array<const char*, uint(PowerState::NUM_STATES)> PowerStateNames = {"RRC_IDLE", "RRC_IDLE_DRX", "RRC_IDLE_EDRX","RRC_Connected", "RRC_SENDING_PRACH", "RRC_SENDING_PUSCH","RRC_RECEIVING_PDSCH","OFF"};
 
+    static constexpr uint NUM_POWER_STATES = uint(PowerState::NUM_STATES);
+
+    /**
+     * \brief Battery lifetime extrapolated from the observed steady-state window
+     *
+     * The bounds are the 95 % confidence interval of the mean power, estimated from
+     * the energy consumed in the projection intervals of the window.
+     */
+    struct EnergyProjection{
+        Time window; // Observed window
+        uint32_t intervals {0}; // Completed projection intervals of the window
+        std::array<double, NUM_POWER_STATES> dutyCycle {}; // Share of the window spend in each state
+        double averagePower {0}; // Mean power over the window in [W]
+        double averagePowerLower {0}; // Lower confidence bound of the mean power in [W]
+        double averagePowerUpper {0}; // Upper confidence bound of the mean power in [W]
+        Time lifetime; // Remaining lifetime of the battery from now on
+        Time lifetimeLower; // Lower confidence bound of the lifetime
+        Time lifetimeUpper; // Upper confidence bound of the lifetime
+    };
+
     NrEnergyModel(){};
     NrEnergyModel(NrChip module,uint numerology);
    
@@ -313,7 +338,57 @@ public:
     double GetEnergyRemaining();
     double GetEnergyRemainingFraction();
 
+    /**
+     * \brief Enable the projection mode
+     *
+     * From the activation of the model on, the consumed energy is sampled every interval.
+     * The interval should be a multiple of the (e)DRX cycle, so that every interval holds
+     * the same share of the periodic states.
+     * \param interval the projection interval, 0 disables the projection
+     */
+    void SetProjectionInterval(Time interval);
+    /**
+     * \brief Extrapolate the battery lifetime from the window observed since the activation
+     * \return the projection
+     */
+    EnergyProjection GetProjection() const;
+    /**
+     * \brief Project the remaining energy fraction to a time in the future
+     * \param at the time, at least now
+     * \param lower set to the lower confidence bound of the fraction
+     * \param upper set to the upper confidence bound of the fraction
+     * \return the projected remaining energy fraction
+     */
+    double GetEnergyRemainingFraction(Time at, double& lower, double& upper) const;
+
+    /**
+     * \brief Keep the last state changes in a ring buffer
+     * \param size number of state changes to keep, 0 disables the history
+     */
+    void SetStateHistorySize(uint32_t size);
+    /**
+     * \return the kept state changes (new state, time in ms), oldest first
+     */
+    std::vector<std::pair<PowerState,uint32_t>> GetStateHistory() const;
+
+    /**
+     * \return the time in ns spend in a state up to the last state change
+     */
+    uint64_t GetTimeInState(PowerState state) const;
+    /**
+     * \return the energy in J spend in a state up to the last state change
+     */
+    double GetEnergyInState(PowerState state) const;
+
+    /**
+     * \brief Set the directory of the energy log and attach to its shared writer
+     * \param outputDir the output directory
+     * \param binary write Energystates.bin instead of Energystates.log
+     */
+    void SetOutputDir(const std::string& outputDir, bool binary);
+
     std::string m_outputDir;
+    bool m_binaryLog {false}; // write the statistics into Energystates.bin instead of Energystates.log
 
 private:
     Ptr<LiIonEnergySource> m_battery; // Battery model
@@ -321,13 +396,103 @@ private:
     PowerState m_lastState; // Current Powerstate
     PowerState m_savedInactiveState; // Current Powerstate
     Time m_lastStateChange;
-    std::map<PowerState, uint64_t> m_timeSpendInState; // Statistics
-    std::map<PowerState, double> m_energySpendInState; // Statistics
-    std::vector<std::pair<PowerState,uint32_t>> m_states;
+    std::array<double, NUM_POWER_STATES> m_powerInState {}; // Power of the module in each state in [W]
+    std::array<uint64_t, NUM_POWER_STATES> m_timeSpendInState {}; // Statistics
+    std::array<double, NUM_POWER_STATES> m_energySpendInState {}; // Statistics
+    uint32_t m_visitedStates {0}; // Bit mask of the states with statistics
+    std::vector<std::pair<PowerState,uint32_t>> m_states; // Ring buffer of the last state changes
+    uint32_t m_statesHead {0}; // Next entry of m_states to write
+    uint32_t m_statesCount {0}; // Number of valid entries of m_states
+    std::shared_ptr<NrEnergyLogWriter> m_logWriter; // Shared writer of m_outputDir
+
+    /**
+     * \brief Get the time in each state and the consumed energy including the current state
+     */
+    void GetCurrentTotals(std::array<uint64_t, NUM_POWER_STATES>& timeInState, double& energy) const;
+    /**
+     * \brief Start the observed window and the sampling of the projection intervals
+     */
+    void StartProjection();
+    /**
+     * \brief Add the power of the last projection interval to the statistics
+     */
+    void SampleProjection();
+    /**
+     * \brief Get the remaining energy of the battery without the energy of the current state
+     */
+    double GetCurrentRemainingEnergy() const;
+
+    Time m_projectionInterval {0}; // Projection interval, 0 if disabled
+    EventId m_projectionEvent; // Next sample of the projection
+    Time m_projectionStart; // Start of the observed window
+    std::array<uint64_t, NUM_POWER_STATES> m_projectionTimeStart {}; // Time in state at the start of the window
+    double m_projectionEnergyStart {0}; // Consumed energy at the start of the window
+    double m_lastSampleEnergy {0}; // Consumed energy at the last sample
+    uint32_t m_samples {0}; // Number of sampled intervals
+    double m_powerMean {0}; // Running mean of the power of the intervals
+    double m_powerM2 {0}; // Running sum of the squared deviations of the power of the intervals
+    double m_consumedEnergy {0}; // Energy consumed up to the last state change
     uint64_t m_imsi;
     bool m_isActive {false};
     
 };
 
+/**
+ * \brief Buffered writer of the energy statistics of all UEs sharing an output directory
+ *
+ * Every NrEnergyModel writes its statistics once, when it is destroyed. Instead of
+ * opening the log file for every UE, the models of an output directory share one
+ * writer, which collects the lines (or binary records) in memory and writes them
+ * in batches. The file is closed when the last model of the directory is destroyed.
+ *
+ * The binary file Energystates.bin consists of one record per UE and state:
+ * int64 time [ns], uint64 imsi, uint8 state, uint64 time in state [ns], double energy [J].
+ */
+class NrEnergyLogWriter
+{
+public:
+    ~NrEnergyLogWriter();
+
+    /**
+     * \brief Get the writer of an output directory, it is created if necessary
+     * \param outputDir the output directory
+     * \param binary write Energystates.bin instead of Energystates.log
+     * \return the writer
+     */
+    static std::shared_ptr<NrEnergyLogWriter> Get(const std::string& outputDir, bool binary);
+
+    /**
+     * \brief Add the statistics of one UE
+     * \param imsi the IMSI of the UE
+     * \param visitedStates bit mask of the states to write
+     * \param timeInState time in ns spend in each state
+     * \param energyInState energy in J spend in each state
+     */
+    void Write(uint64_t imsi,
+               uint32_t visitedStates,
+               const std::array<uint64_t, NrEnergyModel::NUM_POWER_STATES>& timeInState,
+               const std::array<double, NrEnergyModel::NUM_POWER_STATES>& energyInState);
+
+    /**
+     * \brief Add the projected lifetime of one UE (text log only)
+     * \param imsi the IMSI of the UE
+     * \param projection the projection
+     */
+    void WriteProjection(uint64_t imsi, const NrEnergyModel::EnergyProjection& projection);
+
+    /**
+     * \brief Write the buffered data into the file
+     */
+    void Flush();
+
+private:
+    NrEnergyLogWriter(const std::string& filename, bool binary);
+
+    static constexpr size_t FLUSH_SIZE = 1 << 20; // Write the buffer when it exceeds 1 MiB
+    std::ofstream m_file;
+    std::string m_buffer;
+    bool m_binary;
+};
+
 }
 #endif 
\ No newline at end of file
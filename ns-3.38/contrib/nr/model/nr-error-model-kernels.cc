@@ -0,0 +1,505 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nr-error-model-kernels.h"
+
+#include <ns3/assert.h>
+#include <ns3/enum.h>
+#include <ns3/fatal-error.h>
+#include <ns3/global-value.h>
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NR_ERROR_MODEL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrErrorModelKernels");
+
+/**
+ * \brief The instruction set of the kernels at the first use
+ */
+static GlobalValue g_nrErrorModelKernelsIsa =
+    GlobalValue("NrErrorModelKernelsIsa",
+                "The instruction set of the sums of the EESM and MIESM error models, "
+                "read at their first use. With AUTO, AVX2 or AVX512 the results of the "
+                "EESM error models depend on the CPU of the host.",
+                EnumValue(NrErrorModelKernels::SCALAR),
+                MakeEnumChecker(NrErrorModelKernels::SCALAR,
+                                "SCALAR",
+                                NrErrorModelKernels::AUTO,
+                                "AUTO",
+                                NrErrorModelKernels::AVX2,
+                                "AVX2",
+                                NrErrorModelKernels::AVX512,
+                                "AVX512"));
+
+namespace
+{
+
+double
+SumExpScalar(const double* sinr, const int* rbs, uint32_t numRbs, double beta)
+{
+    double sum = 0.0;
+    for (uint32_t i = 0; i < numRbs; ++i)
+    {
+        sum += std::exp(-sinr[rbs[i]] / beta);
+    }
+    return sum;
+}
+
+double
+SumMiScalar(const double* sinr,
+            const int* rbs,
+            uint32_t numRbs,
+            const NrErrorModelKernels::MiTable& table)
+{
+    double sum = 0.0;
+    for (uint32_t i = 0; i < numRbs; ++i)
+    {
+        double sinrLin = sinr[rbs[i]];
+        if (sinrLin > table.m_lastSinr)
+        {
+            sum += 1;
+        }
+        else
+        {
+            double sinrIndexDouble = (sinrLin - table.m_firstSinr) * table.m_scaling + 1;
+            uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
+            NS_ASSERT_MSG(sinrIndex < table.m_size, "MI map out of data");
+            // without asserts, the last MI, as in the vector kernels
+            sum += table.m_mi[std::min(sinrIndex, table.m_size - 1)];
+        }
+    }
+    return sum;
+}
+
+#ifdef NR_ERROR_MODEL_KERNELS_X86
+
+// exp (x) = 2^n * exp (r), with n = round (x / ln 2) and |r| <= ln (2) / 2. The
+// split of ln 2 is the one of fdlibm: n * LN2_HI is exact for |n| < 2^11.
+const double LN2_HI = 6.93147180369123816490e-01;
+const double LN2_LO = 1.90821492927058770002e-10;
+const double LOG2_E = 1.44269504088896338700e+00;
+// adding it rounds to an integer, which is then found in the low bits
+const double ROUND_MAGIC = 6755399441055744.0; // 1.5 * 2^52
+// below it 2^n is not a normal number anymore; exp is returned as 0
+const double EXP_MIN = -708.0;
+const double EXP_MAX = 709.0;
+// Taylor series of exp (r) up to r^13, the error is below 1e-17 for |r| <= ln (2) / 2
+const double EXP_COEFF[] = {1.0 / 6227020800.0,
+                            1.0 / 479001600.0,
+                            1.0 / 39916800.0,
+                            1.0 / 3628800.0,
+                            1.0 / 362880.0,
+                            1.0 / 40320.0,
+                            1.0 / 5040.0,
+                            1.0 / 720.0,
+                            1.0 / 120.0,
+                            1.0 / 24.0,
+                            1.0 / 6.0,
+                            1.0 / 2.0,
+                            1.0,
+                            1.0};
+const uint32_t EXP_COEFF_SIZE = sizeof(EXP_COEFF) / sizeof(EXP_COEFF[0]);
+
+__attribute__((target("avx2,fma"))) inline __m256d
+ExpAvx2(__m256d x)
+{
+    __m256d normal = _mm256_cmp_pd(x, _mm256_set1_pd(EXP_MIN), _CMP_GE_OQ);
+    x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(EXP_MIN)), _mm256_set1_pd(EXP_MAX));
+
+    __m256d t = _mm256_fmadd_pd(x, _mm256_set1_pd(LOG2_E), _mm256_set1_pd(ROUND_MAGIC));
+    __m256d n = _mm256_sub_pd(t, _mm256_set1_pd(ROUND_MAGIC));
+    __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(LN2_HI), x);
+    r = _mm256_fnmadd_pd(n, _mm256_set1_pd(LN2_LO), r);
+
+    __m256d p = _mm256_set1_pd(EXP_COEFF[0]);
+#pragma GCC unroll 13
+    for (uint32_t k = 1; k < EXP_COEFF_SIZE; ++k)
+    {
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_COEFF[k]));
+    }
+
+    // 2^n, from the integer n in the low bits of t
+    __m256i exponent = _mm256_add_epi64(_mm256_castpd_si256(t), _mm256_set1_epi64x(1023));
+    __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(exponent, 52));
+    return _mm256_and_pd(_mm256_mul_pd(p, scale), normal);
+}
+
+// The AVX2 gather instructions are slower than single loads on many CPUs, so
+// the kernels load the RBs one by one
+__attribute__((target("avx2"))) inline __m256d
+LoadAvx2(const double* values, const int* indexes)
+{
+    __m128d low = _mm_loadh_pd(_mm_load_sd(values + indexes[0]), values + indexes[1]);
+    __m128d high = _mm_loadh_pd(_mm_load_sd(values + indexes[2]), values + indexes[3]);
+    return _mm256_insertf128_pd(_mm256_castpd128_pd256(low), high, 1);
+}
+
+__attribute__((target("avx2,fma"))) double
+SumExpAvx2(const double* sinr, const int* rbs, uint32_t numRbs, double beta)
+{
+    const __m256d minusBeta = _mm256_set1_pd(-beta);
+    __m256d sum = _mm256_setzero_pd();
+    uint32_t i = 0;
+    for (; i + 4 <= numRbs; i += 4)
+    {
+        __m256d x = _mm256_div_pd(LoadAvx2(sinr, rbs + i), minusBeta);
+        sum = _mm256_add_pd(sum, ExpAvx2(x));
+    }
+    if (i < numRbs)
+    {
+        // the missing lanes are -inf, whose exp is 0
+        alignas(32) double tail[4];
+        for (uint32_t lane = 0; lane < 4; ++lane)
+        {
+            tail[lane] = i + lane < numRbs ? -sinr[rbs[i + lane]] / beta
+                                           : -std::numeric_limits<double>::infinity();
+        }
+        sum = _mm256_add_pd(sum, ExpAvx2(_mm256_load_pd(tail)));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// no FMA in the target, so that the index is computed with the same roundings
+// as in SumMiScalar
+__attribute__((target("avx2"))) double
+SumMiAvx2(const double* sinr,
+          const int* rbs,
+          uint32_t numRbs,
+          const NrErrorModelKernels::MiTable& table)
+{
+    const __m256d first = _mm256_set1_pd(table.m_firstSinr);
+    const __m256d last = _mm256_set1_pd(table.m_lastSinr);
+    const __m256d scaling = _mm256_set1_pd(table.m_scaling);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d maxIndex = _mm256_set1_pd(table.m_size - 1);
+    double sum = 0.0;
+    alignas(32) double mi[4];
+    for (uint32_t i = 0; i < numRbs; i += 4)
+    {
+        uint32_t numLanes = std::min(4u, numRbs - i);
+        __m256d x;
+        if (numLanes == 4)
+        {
+            x = LoadAvx2(sinr, rbs + i);
+        }
+        else
+        {
+            int tail[4] = {rbs[i], rbs[i], rbs[i], rbs[i]};
+            std::copy(rbs + i, rbs + numRbs, tail);
+            x = LoadAvx2(sinr, tail);
+        }
+        __m256d index = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(x, first), scaling), one);
+        index = _mm256_max_pd(_mm256_setzero_pd(), _mm256_floor_pd(index));
+        __m256d aboveLast = _mm256_cmp_pd(x, last, _CMP_GT_OQ);
+        NS_ASSERT_MSG(_mm256_movemask_pd(_mm256_andnot_pd(
+                          aboveLast,
+                          _mm256_cmp_pd(index, maxIndex, _CMP_GT_OQ))) == 0,
+                      "MI map out of data");
+        // above the last SINR the index would be out of the table, and the MI is 1 anyway
+        index = _mm256_min_pd(index, maxIndex);
+        alignas(16) int tableIndex[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(tableIndex), _mm256_cvttpd_epi32(index));
+        __m256d value = LoadAvx2(table.m_mi, tableIndex);
+        value = _mm256_blendv_pd(value, one, aboveLast);
+        _mm256_store_pd(mi, value);
+        // added in the order of the RBs, as in SumMiScalar
+        for (uint32_t lane = 0; lane < numLanes; ++lane)
+        {
+            sum += mi[lane];
+        }
+    }
+    return sum;
+}
+
+// the AVX-512 intrinsics of GCC 12 trigger false -Wmaybe-uninitialized warnings
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f"))) inline __m512d
+ExpAvx512(__m512d x)
+{
+    __mmask8 normal = _mm512_cmp_pd_mask(x, _mm512_set1_pd(EXP_MIN), _CMP_GE_OQ);
+    x = _mm512_min_pd(_mm512_max_pd(x, _mm512_set1_pd(EXP_MIN)), _mm512_set1_pd(EXP_MAX));
+
+    __m512d t = _mm512_fmadd_pd(x, _mm512_set1_pd(LOG2_E), _mm512_set1_pd(ROUND_MAGIC));
+    __m512d n = _mm512_sub_pd(t, _mm512_set1_pd(ROUND_MAGIC));
+    __m512d r = _mm512_fnmadd_pd(n, _mm512_set1_pd(LN2_HI), x);
+    r = _mm512_fnmadd_pd(n, _mm512_set1_pd(LN2_LO), r);
+
+    __m512d p = _mm512_set1_pd(EXP_COEFF[0]);
+#pragma GCC unroll 13
+    for (uint32_t k = 1; k < EXP_COEFF_SIZE; ++k)
+    {
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_COEFF[k]));
+    }
+
+    __m512i exponent = _mm512_add_epi64(_mm512_castpd_si512(t), _mm512_set1_epi64(1023));
+    __m512d scale = _mm512_castsi512_pd(_mm512_slli_epi64(exponent, 52));
+    return _mm512_maskz_mov_pd(normal, _mm512_mul_pd(p, scale));
+}
+
+/**
+ * \return up to 8 RB indexes, the missing ones are 0
+ */
+__attribute__((target("avx512f"))) inline __m256i
+LoadIndexesAvx512(const int* rbs, uint32_t numLanes)
+{
+    if (numLanes >= 8)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rbs));
+    }
+    alignas(32) int tail[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    std::copy(rbs, rbs + numLanes, tail);
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+}
+
+__attribute__((target("avx512f"))) double
+SumExpAvx512(const double* sinr, const int* rbs, uint32_t numRbs, double beta)
+{
+    const __m512d minusBeta = _mm512_set1_pd(-beta);
+    __m512d sum = _mm512_setzero_pd();
+    uint32_t i = 0;
+    for (; i + 8 <= numRbs; i += 8)
+    {
+        __m256i idx = LoadIndexesAvx512(rbs + i, 8);
+        __m512d x = _mm512_div_pd(_mm512_i32gather_pd(idx, sinr, 8), minusBeta);
+        sum = _mm512_add_pd(sum, ExpAvx512(x));
+    }
+    if (i < numRbs)
+    {
+        __mmask8 valid = (1u << (numRbs - i)) - 1;
+        __m256i idx = LoadIndexesAvx512(rbs + i, numRbs - i);
+        __m512d x = _mm512_div_pd(_mm512_mask_i32gather_pd(_mm512_setzero_pd(), valid, idx, sinr, 8),
+                                  minusBeta);
+        sum = _mm512_add_pd(sum, _mm512_maskz_mov_pd(valid, ExpAvx512(x)));
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, sum);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+// AVX-512F implies FMA: the index is computed with the explicitly rounded
+// operations, which the compiler does not contract
+__attribute__((target("avx512f"))) double
+SumMiAvx512(const double* sinr,
+            const int* rbs,
+            uint32_t numRbs,
+            const NrErrorModelKernels::MiTable& table)
+{
+    const int rounding = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+    const __m512d first = _mm512_set1_pd(table.m_firstSinr);
+    const __m512d last = _mm512_set1_pd(table.m_lastSinr);
+    const __m512d scaling = _mm512_set1_pd(table.m_scaling);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d maxIndex = _mm512_set1_pd(table.m_size - 1);
+    double sum = 0.0;
+    alignas(64) double mi[8];
+    for (uint32_t i = 0; i < numRbs; i += 8)
+    {
+        uint32_t numLanes = std::min(8u, numRbs - i);
+        __mmask8 valid = (1u << numLanes) - 1;
+        __m256i idx = LoadIndexesAvx512(rbs + i, numLanes);
+        __m512d x = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), valid, idx, sinr, 8);
+        __m512d index = _mm512_sub_round_pd(x, first, rounding);
+        index = _mm512_mul_round_pd(index, scaling, rounding);
+        index = _mm512_add_round_pd(index, one, rounding);
+        index = _mm512_roundscale_pd(index, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        index = _mm512_max_pd(_mm512_setzero_pd(), index);
+        __mmask8 aboveLast = _mm512_cmp_pd_mask(x, last, _CMP_GT_OQ);
+        NS_ASSERT_MSG((_mm512_mask_cmp_pd_mask(valid & ~aboveLast, index, maxIndex, _CMP_GT_OQ)) ==
+                          0,
+                      "MI map out of data");
+        index = _mm512_min_pd(index, maxIndex);
+        __m512d value = _mm512_i32gather_pd(_mm512_cvttpd_epi32(index), table.m_mi, 8);
+        value = _mm512_mask_blend_pd(aboveLast, value, one);
+        _mm512_store_pd(mi, value);
+        for (uint32_t lane = 0; lane < numLanes; ++lane)
+        {
+            sum += mi[lane];
+        }
+    }
+    return sum;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif /* NR_ERROR_MODEL_KERNELS_X86 */
+
+/**
+ * The kernels of the selected instruction set
+ */
+struct Kernels
+{
+    NrErrorModelKernels::Isa m_isa;                                  //!< instruction set
+    double (*m_sumExp)(const double*, const int*, uint32_t, double); //!< SumExp kernel
+    double (*m_sumMi)(const double*,
+                      const int*,
+                      uint32_t,
+                      const NrErrorModelKernels::MiTable&); //!< SumMi kernel
+};
+
+Kernels
+GetKernels(NrErrorModelKernels::Isa isa)
+{
+    switch (isa)
+    {
+#ifdef NR_ERROR_MODEL_KERNELS_X86
+    case NrErrorModelKernels::AVX512:
+        return {isa, &SumExpAvx512, &SumMiAvx512};
+    case NrErrorModelKernels::AVX2:
+        return {isa, &SumExpAvx2, &SumMiAvx2};
+#endif
+    default:
+        return {NrErrorModelKernels::SCALAR, &SumExpScalar, &SumMiScalar};
+    }
+}
+
+NrErrorModelKernels::Isa
+GetWidestIsa()
+{
+    if (NrErrorModelKernels::IsSupported(NrErrorModelKernels::AVX512))
+    {
+        return NrErrorModelKernels::AVX512;
+    }
+    if (NrErrorModelKernels::IsSupported(NrErrorModelKernels::AVX2))
+    {
+        return NrErrorModelKernels::AVX2;
+    }
+    return NrErrorModelKernels::SCALAR;
+}
+
+/**
+ * \param isa an instruction set
+ * \return the kernels of the instruction set, of the widest one for AUTO
+ */
+Kernels
+GetSupportedKernels(NrErrorModelKernels::Isa isa)
+{
+    if (isa == NrErrorModelKernels::AUTO)
+    {
+        isa = GetWidestIsa();
+    }
+    if (!NrErrorModelKernels::IsSupported(isa))
+    {
+        NS_FATAL_ERROR("The instruction set " << NrErrorModelKernels::GetIsaName(isa)
+                                              << " is not supported");
+    }
+    return GetKernels(isa);
+}
+
+/**
+ * \return the kernels in use, initially the ones of NrErrorModelKernelsIsa
+ */
+Kernels&
+GetSelectedKernels()
+{
+    static Kernels kernels = [] {
+        EnumValue isa;
+        g_nrErrorModelKernelsIsa.GetValue(isa);
+        return GetSupportedKernels(static_cast<NrErrorModelKernels::Isa>(isa.Get()));
+    }();
+    return kernels;
+}
+
+} // unnamed namespace
+
+void
+NrErrorModelKernels::SetIsa(Isa isa)
+{
+    NS_LOG_FUNCTION(GetIsaName(isa));
+    GetSelectedKernels() = GetSupportedKernels(isa);
+}
+
+NrErrorModelKernels::Isa
+NrErrorModelKernels::GetIsa()
+{
+    return GetSelectedKernels().m_isa;
+}
+
+bool
+NrErrorModelKernels::IsSupported(Isa isa)
+{
+    switch (isa)
+    {
+    case AUTO:
+    case SCALAR:
+        return true;
+#ifdef NR_ERROR_MODEL_KERNELS_X86
+    case AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case AVX512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+std::string
+NrErrorModelKernels::GetIsaName(Isa isa)
+{
+    switch (isa)
+    {
+    case AUTO:
+        return "AUTO";
+    case SCALAR:
+        return "SCALAR";
+    case AVX2:
+        return "AVX2";
+    case AVX512:
+        return "AVX512";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+double
+NrErrorModelKernels::SumExp(const double* sinr, const int* rbs, uint32_t numRbs, double beta)
+{
+    return GetSelectedKernels().m_sumExp(sinr, rbs, numRbs, beta);
+}
+
+double
+NrErrorModelKernels::SumMi(const double* sinr,
+                           const int* rbs,
+                           uint32_t numRbs,
+                           const MiTable& table)
+{
+    return GetSelectedKernels().m_sumMi(sinr, rbs, numRbs, table);
+}
+
+} // namespace ns3
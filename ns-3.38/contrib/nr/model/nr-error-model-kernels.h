@@ -0,0 +1,126 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_ERROR_MODEL_KERNELS_H
+#define NR_ERROR_MODEL_KERNELS_H
+
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup error-models
+ * \brief Per-RB sums of the EESM and MIESM error models
+ *
+ * The effective SINR of a TB is computed from a sum over its RBs, for every
+ * reception and every MCS tried by the AMC. This class computes these sums
+ * with one of these instruction sets:
+ *
+ * - SCALAR: the plain loop, with the same results as before;
+ * - AVX2: 4 RBs at once;
+ * - AVX512: 8 RBs at once.
+ *
+ * The instruction set is the one of the global value NrErrorModelKernelsIsa
+ * at the first use of the kernels, SCALAR by default, so that the results are
+ * the same on every machine; AUTO selects the widest one supported by the CPU.
+ * SetIsa changes it afterwards.
+ *
+ * The mutual information sums of SumMi are the same with every instruction
+ * set: an SINR beyond the MI table is an assert with every instruction set,
+ * and takes the last MI of the table when the asserts are disabled. The
+ * exponential sums of SumExp use a polynomial approximation of exp with the
+ * vector instruction sets, and differ from the scalar ones in the last bits:
+ * their relative difference is below 1e-13.
+ */
+class NrErrorModelKernels
+{
+  public:
+    /**
+     * \brief Instruction set of the kernels
+     */
+    enum Isa
+    {
+        AUTO,   //!< the widest one supported by the CPU
+        SCALAR, //!< no vector instructions
+        AVX2,   //!< AVX2 and FMA
+        AVX512  //!< AVX-512F
+    };
+
+    /**
+     * \brief Lookup table of the mutual information over uniformly spaced SINRs
+     */
+    struct MiTable
+    {
+        const double* m_mi{nullptr}; //!< mutual information of every SINR
+        uint32_t m_size{0};          //!< number of SINRs
+        double m_firstSinr{0.0};     //!< the first (linear) SINR
+        double m_lastSinr{0.0};      //!< the last (linear) SINR, above it the MI is 1
+        double m_scaling{0.0};       //!< (m_size - 1) / (m_lastSinr - m_firstSinr)
+    };
+
+    /**
+     * \brief Select the instruction set of the kernels
+     *
+     * It is a fatal error to select an instruction set not supported by the CPU.
+     * \param isa the instruction set, AUTO for the widest supported one
+     */
+    static void SetIsa(Isa isa);
+
+    /**
+     * \return the instruction set of the kernels, never AUTO
+     */
+    static Isa GetIsa();
+
+    /**
+     * \param isa an instruction set
+     * \return true if the CPU, and the compiler, support the instruction set
+     */
+    static bool IsSupported(Isa isa);
+
+    /**
+     * \param isa an instruction set
+     * \return the name of the instruction set
+     */
+    static std::string GetIsaName(Isa isa);
+
+    /**
+     * \brief Sum of exp (-sinr / beta) over the given RBs
+     * \param sinr the linear SINR of every RB
+     * \param rbs the indexes of the RBs in sinr
+     * \param numRbs the number of RBs
+     * \param beta the EESM calibration factor
+     * \return the sum
+     */
+    static double SumExp(const double* sinr, const int* rbs, uint32_t numRbs, double beta);
+
+    /**
+     * \brief Sum of the mutual information of the given RBs
+     * \param sinr the linear SINR of every RB
+     * \param rbs the indexes of the RBs in sinr
+     * \param numRbs the number of RBs
+     * \param table the mutual information of the modulation
+     * \return the sum
+     */
+    static double SumMi(const double* sinr, const int* rbs, uint32_t numRbs, const MiTable& table);
+};
+
+} // namespace ns3
+
+#endif /* NR_ERROR_MODEL_KERNELS_H */
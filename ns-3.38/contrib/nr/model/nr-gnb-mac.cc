@@ -460,6 +460,15 @@ NrGnbMac::GetTypeId()
                 BooleanValue (false),
                 MakeBooleanAccessor (&NrGnbMac::EarlyReleaseEnabled),
                 MakeBooleanChecker ())
+            .AddAttribute("PagingInPagingFrames",
+                          "Send the paging of a UE in its paging frame of TS 38.304, for the "
+                          "paging cycle given by the RRC release. It has to be enabled together "
+                          "with NrUePhy::SleepWhenIdle, so that the sleeping UEs listen when the "
+                          "paging is sent. Otherwise the paging of a UE is sent in the frames "
+                          "that are a multiple of 32 plus its RNTI modulo 20.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrGnbMac::m_pagingInPagingFrames),
+                          MakeBooleanChecker())
             .AddTraceSource("DlScheduling",
                             "Information regarding DL scheduling.",
                             MakeTraceSourceAccessor(&NrGnbMac::m_dlScheduling),
@@ -483,7 +492,11 @@ NrGnbMac::GetTypeId()
             .AddTraceSource("DlHarqFeedback",
                             "Harq feedback.",
                             MakeTraceSourceAccessor(&NrGnbMac::m_dlHarqFeedback),
-                     "ns3::NrGnbMac::DlHarqFeedbackTracedCallback");
+                     "ns3::NrGnbMac::DlHarqFeedbackTracedCallback")
+            .AddTraceSource("RachOccasion",
+                            "Received and collided RACH preambles per PRACH occasion.",
+                            MakeTraceSourceAccessor(&NrGnbMac::m_rachOccasionTrace),
+                            "ns3::NrGnbMac::RachOccasionTracedCallback");
     return tid;
 }
 
@@ -567,8 +580,8 @@ NrGnbMac::ReceiveRachPreamble(uint32_t raId, uint8_t occasion, uint16_t imsi, ui
     rachMsg->SetSourceBwp(GetBwpId());
     m_macRxedCtrlMsgsTrace(m_currentSlot, GetCellId(), raId, GetBwpId(), rachMsg);
 
-    std::string key = std::to_string(prachNumber) +";" + std::to_string(occasion) +";" +std::to_string(raId);
-    ++m_receivedRachPreambleCount[key];
+    NS_ASSERT_MSG(raId <= 0xFFFF, "Preamble id " << raId << " does not fit into the key");
+    m_receivedRachPreambles.push_back(GetRachPreambleKey(prachNumber, occasion, raId));
     m_raId_ImsiMap[raId] = imsi;
 }
 
@@ -643,26 +656,27 @@ NrGnbMac::DoSlotDlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
         }
     }
     //std::unordered_map<std::uint32_t,uint16_t> m_PrachUtilization;
-    if (!m_receivedRachPreambleCount.empty())
+    if (!m_receivedRachPreambles.empty())
     {
-        // process received RACH preambles and notify the scheduler
+        // process received RACH preambles and notify the scheduler.
+        // After sorting, the preambles of one occasion and the copies of one preamble are adjacent
+        std::sort(m_receivedRachPreambles.begin(), m_receivedRachPreambles.end());
         NrMacSchedSapProvider::SchedDlRachInfoReqParameters rachInfoReqParams;
-        for(auto mapIt= m_receivedRachPreambleCount.begin(); mapIt != m_receivedRachPreambleCount.end();++mapIt)
-        {        
-            char* key = new char[mapIt->first.length() + 1];
-            
-            strcpy(key,mapIt->first.c_str());
-            
-            char* value = strtok(key, ";"); 
-            uint32_t prachNumber = std::stoi(value);
-           
-            value = strtok(NULL, ";");
-            uint8_t occasion = std::stoi(value);
+        uint16_t attempts = 0;
+        uint16_t preambles = 0;
+        uint16_t collidedPreambles = 0;
+        for (auto it = m_receivedRachPreambles.begin(); it != m_receivedRachPreambles.end();)
+        {
+            uint64_t key = *it;
+            auto runEnd = std::upper_bound(it, m_receivedRachPreambles.end(), key);
+            uint16_t count = static_cast<uint16_t>(runEnd - it);
+            it = runEnd;
 
-            value = strtok(NULL, ";");
-            uint16_t preamble = std::stoi(value);
+            uint32_t prachNumber = static_cast<uint32_t>(key >> 32);
+            uint8_t occasion = static_cast<uint8_t>(key >> 16);
+            uint16_t preamble = static_cast<uint16_t>(key);
 
-            if(mapIt->second ==1)
+            if(count ==1)
             {
                 m_prachOccasionUsedCallback(prachNumber,occasion,false);
                 uint16_t rnti = m_cmacSapUser->AllocateTemporaryCellRnti();
@@ -685,17 +699,26 @@ NrGnbMac::DoSlotDlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
                 std::cout <<"collision" << std::endl;
                 m_prachOccasionUsedCallback(prachNumber,occasion,true);
                 NS_LOG_INFO("Collision:Received RACH preamble"
-                        << static_cast<uint16_t>(preamble) << static_cast<uint16_t>(mapIt->second)
+                        << static_cast<uint16_t>(preamble) << static_cast<uint16_t>(count)
                         << "times in slot " << sfnSf<< "at occasion" << occasion);
-               
+                ++collidedPreambles;
             }
-            delete[] key;
 
+            attempts += count;
+            ++preambles;
+            // last preamble of this occasion
+            if (it == m_receivedRachPreambles.end() || (*it >> 16) != (key >> 16))
+            {
+                m_rachOccasionTrace(prachNumber, occasion, attempts, preambles, collidedPreambles);
+                attempts = 0;
+                preambles = 0;
+                collidedPreambles = 0;
+            }
         }
         //logPrachUtilization(m_PrachUtilization);
 
 
-        m_receivedRachPreambleCount.clear();
+        m_receivedRachPreambles.clear();
         m_macSchedSapProvider->SchedDlRachInfoReq(rachInfoReqParams);
     }
     
@@ -1354,7 +1377,24 @@ NrGnbMac::SendPaging()
         std::list<uint16_t>::iterator i = m_pagingList.begin();
         while (i != m_pagingList.end())
         {
-            if(m_currentSlot.GetFrame()%(m_edrxMap[*i]+(*i%20))== 0 && m_currentSlot.GetSubframe()==1 )
+            bool send;
+            if (m_pagingInPagingFrames)
+            {
+                // sent in the paging frame of the UE (TS 38.304 7.1), or right away if
+                // no paging cycle is known for it
+                auto cycle = m_edrxMap.find(*i);
+                send = cycle == m_edrxMap.end() ||
+                       (NrPhySapProvider::IsPagingFrame(m_currentSlot.GetFrame(),
+                                                        *i,
+                                                        cycle->second) &&
+                        m_currentSlot.GetSubframe() == 1);
+            }
+            else
+            {
+                send = m_currentSlot.GetFrame() % (32 + (*i % 20)) == 0 &&
+                       m_currentSlot.GetSubframe() == 1;
+            }
+            if (send)
             {
                  Ptr<NrPagingMessage> pagMsg = Create<NrPagingMessage>();
 
@@ -1626,14 +1666,14 @@ NrGnbMac::GetDlCtrlDci() const
     NS_LOG_FUNCTION(this);
     auto bwInRbg = m_phySapProvider->GetRbNum() / GetNumRbPerRbg();
     NS_ASSERT(bwInRbg > 0);
-    std::vector<uint8_t> rbgBitmask(bwInRbg, 1);
+    RbgBitmask rbgBitmask(bwInRbg, 1);
 
 
-    return std::make_shared<DciInfoElementTdma>(0,
-                                                m_macSchedSapProvider->GetDlCtrlSyms(),
-                                                DciInfoElementTdma::DL,
-                                                DciInfoElementTdma::CTRL,
-                                                rbgBitmask);
+    return NrMemoryPool::MakeShared<DciInfoElementTdma>(0,
+                                                        m_macSchedSapProvider->GetDlCtrlSyms(),
+                                                        DciInfoElementTdma::DL,
+                                                        DciInfoElementTdma::CTRL,
+                                                        rbgBitmask);
         
 }
 
@@ -1643,13 +1683,13 @@ NrGnbMac::GetUlCtrlDci() const
     NS_LOG_FUNCTION(this);
 
     NS_ASSERT(m_bandwidthInRbg > 0);
-    std::vector<uint8_t> rbgBitmask(m_bandwidthInRbg, 1);
+    RbgBitmask rbgBitmask(m_bandwidthInRbg, 1);
 
-    return std::make_shared<DciInfoElementTdma>(0,
-                                                m_macSchedSapProvider->GetUlCtrlSyms(),
-                                                DciInfoElementTdma::UL,
-                                                DciInfoElementTdma::CTRL,
-                                                rbgBitmask);
+    return NrMemoryPool::MakeShared<DciInfoElementTdma>(0,
+                                                        m_macSchedSapProvider->GetUlCtrlSyms(),
+                                                        DciInfoElementTdma::UL,
+                                                        DciInfoElementTdma::CTRL,
+                                                        rbgBitmask);
 }
 
 void 
@@ -252,6 +252,21 @@ class NrGnbMac : public Object
                                                      const uint8_t bwpId,
                                                      Ptr<NrControlMessage>);
 
+    /**
+     *  TracedCallback signature for the RACH preambles received in one PRACH occasion.
+     *
+     * \param [in] prachNumber number of the PRACH slot
+     * \param [in] occasion PRACH occasion inside the slot
+     * \param [in] attempts number of received preambles
+     * \param [in] preambles number of different preamble ids
+     * \param [in] collidedPreambles number of preamble ids sent by more than one UE
+     */
+    typedef void (*RachOccasionTracedCallback)(const uint32_t prachNumber,
+                                               const uint8_t occasion,
+                                               const uint16_t attempts,
+                                               const uint16_t preambles,
+                                               const uint16_t collidedPreambles);
+
  
   void DoScheduleAckDci(uint16_t rnti);
   void DoAddPaging(uint16_t pRnti);
@@ -304,6 +319,18 @@ class NrGnbMac : public Object
 
   private:
     void ReceiveRachPreamble(uint32_t raId, uint8_t occasion, uint16_t imsi, uint32_t prachNumber);
+    /**
+     * \brief Pack a received RACH preamble into one key
+     * \param prachNumber number of the PRACH slot
+     * \param occasion PRACH occasion inside the slot
+     * \param raId the preamble id
+     * \return the key, ordered by PRACH slot, occasion and preamble id
+     */
+    static uint64_t GetRachPreambleKey(uint32_t prachNumber, uint8_t occasion, uint32_t raId)
+    {
+        return (static_cast<uint64_t>(prachNumber) << 32) | (static_cast<uint64_t>(occasion) << 16) |
+               (raId & 0xFFFF);
+    }
     void DoReceiveRachPreamble(uint32_t raId, uint8_t occasion, uint16_t imsi, uint32_t prachNumber);
     void ReceiveBsrMessage(MacCeElement bsr);
     void DoReportMacCeToScheduler(MacCeListElement_s bsr);
@@ -436,7 +463,11 @@ class NrGnbMac : public Object
     std::vector<NrMacSchedSapProvider::SchedUlCqiInfoReqParameters> m_ulCqiReceived;
     std::vector<MacCeElement> m_ulCeReceived; // CE received (BSR up to now)
 
-    std::unordered_map<std::string,uint8_t> m_receivedRachPreambleCount;
+    /**
+     * Received RACH preambles of the current slot, one key (see GetRachPreambleKey)
+     * per received preamble. The vector keeps its capacity between the slots.
+     */
+    std::vector<uint64_t> m_receivedRachPreambles;
     std::unordered_map<uint16_t,uint32_t> m_raId_ImsiMap;
 
     std::unordered_map<uint16_t, std::unordered_map<uint8_t, LteMacSapUser*>> m_rlcAttached;
@@ -480,6 +511,11 @@ class NrGnbMac : public Object
      */
     TracedCallback<const DlHarqInfo&> m_dlHarqFeedback;
 
+    /**
+     * Trace the received and collided RACH preambles per PRACH occasion.
+     */
+    TracedCallback<uint32_t, uint8_t, uint16_t, uint16_t, uint16_t> m_rachOccasionTrace;
+
   std::list<std::tuple<SfnSf,std::tuple<SfnSf,uint16_t>>> m_RrcMsgList; 
   std::list<uint16_t> m_scheduleRrcList;
 
@@ -487,6 +523,7 @@ class NrGnbMac : public Object
   std::list<uint16_t> m_pagingList;
   std::unordered_map<uint16_t,uint32_t> m_edrxMap;
   bool EarlyReleaseEnabled{false};
+  bool m_pagingInPagingFrames{false}; //!< Send the paging in the paging frames of TS 38.304
 };
 
 }
@@ -1005,7 +1005,7 @@ NrGnbPhy::DoStartSlot()
 }
 
 void
-NrGnbPhy::PrepareRbgAllocationMap(const std::deque<VarTtiAllocInfo>& allocations)
+NrGnbPhy::PrepareRbgAllocationMap(const VarTtiAllocInfoList& allocations)
 {
     NS_LOG_FUNCTION(this);
 
@@ -1081,7 +1081,7 @@ NrGnbPhy::FillTheEvent()
 }
 
 void
-NrGnbPhy::StoreRBGAllocation(std::unordered_map<uint8_t, std::vector<uint8_t>>* map,
+NrGnbPhy::StoreRBGAllocation(std::unordered_map<uint8_t, RbgBitmask>* map,
                              const std::shared_ptr<DciInfoElementTdma>& dci) const
 {
     NS_LOG_FUNCTION(this);
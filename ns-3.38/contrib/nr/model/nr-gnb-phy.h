@@ -615,7 +615,7 @@ class NrGnbPhy : public NrPhy
      * \param dci DCI
      *
      */
-    void StoreRBGAllocation(std::unordered_map<uint8_t, std::vector<uint8_t>>* map,
+    void StoreRBGAllocation(std::unordered_map<uint8_t, RbgBitmask>* map,
                             const std::shared_ptr<DciInfoElementTdma>& dci) const;
 
     /**
@@ -710,7 +710,7 @@ class NrGnbPhy : public NrPhy
      *
      * \param allocations scheduler allocation for this slot.
      */
-    void PrepareRbgAllocationMap(const std::deque<VarTtiAllocInfo>& allocations);
+    void PrepareRbgAllocationMap(const VarTtiAllocInfoList& allocations);
 
     /**
      * \brief Prepare and schedule all the events needed for the current slot.
@@ -734,9 +734,9 @@ class NrGnbPhy : public NrPhy
     LteRrcSap::SystemInformationBlockType1 m_sib1; //!< SIB1 message
     Time m_lastSlotStart;                          //!< Time at which the last slot started
     uint8_t m_currSymStart{0}; //!< Symbol at which the current allocation started
-    std::unordered_map<uint8_t, std::vector<uint8_t>>
+    std::unordered_map<uint8_t, RbgBitmask>
         m_rbgAllocationPerSym; //!< RBG allocation in each sym
-    std::unordered_map<uint8_t, std::vector<uint8_t>>
+    std::unordered_map<uint8_t, RbgBitmask>
         m_rbgAllocationPerSymDataStat; //!< RBG allocation in each sym, for statistics (UL and DL
                                        //!< included, only data)
 
@@ -1206,7 +1206,10 @@ UeManagerNr::SendRrcRelease()
         msg.rrcRelease.suspendConfig = BuildSuspendConfig();
         //TODO
         //m_rrc->m_cmacSapProvider.at(0)->addEdrx(msg.rrcRelease.suspendConfig.ran_ExtendedPagingCycle_r17,m_rnti);
-        m_rrc->m_cmacSapProvider.at(0)->addEdrx(32,m_rnti);
+        // the paging cycle T of the UE in frames, which is its eDRX cycle: rf256, rf512 or rf1024
+        m_rrc->m_cmacSapProvider.at(0)->addEdrx(
+            256 << msg.rrcRelease.suspendConfig.ran_ExtendedPagingCycle_r17,
+            m_rnti);
         //m_sdtConfigured = true;
         m_sdtConfigured = false;
         SwitchToState(INACTIVE);
@@ -6,6 +6,8 @@
 
 #include "nr-lte-mi-error-model.h"
 
+#include "nr-error-model-kernels.h"
+
 #include <ns3/log.h>
 
 #include <algorithm>
@@ -925,98 +927,59 @@ NrLteMiErrorModel::GetInstanceTypeId() const
     return NrLteMiErrorModel::GetTypeId();
 }
 
+/**
+ * \param mi the MI of the modulation
+ * \param axis the uniformly spaced SINRs of the MIs
+ * \param size the number of SINRs
+ * \return the lookup table of the MI, for the NrErrorModelKernels
+ */
+static NrErrorModelKernels::MiTable
+MakeMiTable(const double* mi, const double* axis, uint16_t size)
+{
+    NrErrorModelKernels::MiTable table;
+    table.m_mi = mi;
+    table.m_size = size;
+    table.m_firstSinr = axis[0];
+    table.m_lastSinr = axis[size - 1];
+    // since the values in the axis are uniformly spaced, we have
+    // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+    // the scaling coefficient is always the same, so it is computed once
+    table.m_scaling = (size - 1) / (axis[size - 1] - axis[0]);
+    return table;
+}
+
 double
 NrLteMiErrorModel::Mib(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
     NS_LOG_FUNCTION(sinr << &map << (uint32_t)mcs);
 
-    double MI;
-    double MIsum = 0.0;
+    static const NrErrorModelKernels::MiTable qpskTable =
+        MakeMiTable(MI_map_qpsk, MI_map_qpsk_axis, MI_MAP_QPSK_SIZE);
+    static const NrErrorModelKernels::MiTable qam16Table =
+        MakeMiTable(MI_map_16qam, MI_map_16qam_axis, MI_MAP_16QAM_SIZE);
+    static const NrErrorModelKernels::MiTable qam64Table =
+        MakeMiTable(MI_map_64qam, MI_map_64qam_axis, MI_MAP_64QAM_SIZE);
 
-    for (uint32_t i = 0; i < map.size(); i++)
+    if (map.size() == 0)
     {
-        double sinrLin = sinr[map.at(i)];
-        if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
-            if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1])
-            {
-                MI = 1;
-            }
-            else
-            {
-                // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-                // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                // the scaling coefficient is always the same, so we use a static const
-                // to speed up the calculation
-                static const double scalingCoeffQpsk =
-                    (MI_MAP_QPSK_SIZE - 1) /
-                    (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0]);
-                double sinrIndexDouble = (sinrLin - MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-                uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
-                NS_ASSERT_MSG(sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-                MI = MI_map_qpsk[sinrIndex];
-            }
-        }
-        else
-        {
-            if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID) // 16-QAM
-            {
-                if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1])
-                {
-                    MI = 1;
-                }
-                else
-                {
-                    // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                    // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                    // the scaling coefficient is always the same, so we use a static const
-                    // to speed up the calculation
-                    static const double scalingCoeff16qam =
-                        (MI_MAP_16QAM_SIZE - 1) /
-                        (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0]);
-                    double sinrIndexDouble =
-                        (sinrLin - MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                    uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
-                    NS_ASSERT_MSG(sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                    MI = MI_map_16qam[sinrIndex];
-                }
-            }
-            else // 64-QAM
-            {
-                if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1])
-                {
-                    MI = 1;
-                }
-                else
-                {
-                    // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                    // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                    // the scaling coefficient is always the same, so we use a static const
-                    // to speed up the calculation
-                    static const double scalingCoeff64qam =
-                        (MI_MAP_64QAM_SIZE - 1) /
-                        (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0]);
-                    double sinrIndexDouble =
-                        (sinrLin - MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                    uint32_t sinrIndex = std::max(0.0, std::floor(sinrIndexDouble));
-                    NS_ASSERT_MSG(sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                    MI = MI_map_64qam[sinrIndex];
-                }
-            }
-        }
-        NS_LOG_LOGIC(" RB " << map.at(i) << "Minimum SNR = " << 10 * std::log10(sinrLin) << " dB, "
-                            << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
-        MIsum += MI;
+        NS_LOG_LOGIC(" MI = 0");
+        return 0;
     }
-    if (map.size() == 0)
+
+    const NrErrorModelKernels::MiTable* table = &qam64Table;
+    if (mcs <= MI_QPSK_MAX_ID) // QPSK
     {
-        MI = 0;
+        table = &qpskTable;
     }
-    else
+    else if (mcs <= MI_16QAM_MAX_ID) // 16-QAM
     {
-        MI = MIsum / map.size();
+        table = &qam16Table;
     }
 
+    double MIsum =
+        NrErrorModelKernels::SumMi(&(*sinr.ConstValuesBegin()), map.data(), map.size(), *table);
+    double MI = MIsum / map.size();
+
     NS_LOG_LOGIC(" MI = " << MI);
     return MI;
 }
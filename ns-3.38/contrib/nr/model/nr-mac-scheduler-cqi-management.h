@@ -116,7 +116,7 @@ class NrMacSchedulerCQIManagement
                          uint32_t tbs,
                          const NrMacSchedSapProvider::SchedUlCqiInfoReqParameters& params,
                          const std::shared_ptr<NrMacSchedulerUeInfo>& ueInfo,
-                         const std::vector<uint8_t>& rbgMask,
+                         const RbgBitmask& rbgMask,
                          uint32_t numRbPerRbg,
                          const Ptr<const SpectrumModel>& model) const;
 
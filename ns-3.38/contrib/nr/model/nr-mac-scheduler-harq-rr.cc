@@ -168,17 +168,17 @@ NrMacSchedulerHarqRr::ScheduleDlHarq(
                 }
             }
 
-            auto dci = std::make_shared<DciInfoElementTdma>(dciInfoReTx->m_rnti,
-                                                            dciInfoReTx->m_format,
-                                                            startingPoint->m_sym,
-                                                            symPerBeam,
-                                                            mcs,
-                                                            tbSize,
-                                                            ndi,
-                                                            rv,
-                                                            DciInfoElementTdma::DATA,
-                                                            dciInfoReTx->m_bwpIndex,
-                                                            dciInfoReTx->m_tpc);
+            auto dci = NrMemoryPool::MakeShared<DciInfoElementTdma>(dciInfoReTx->m_rnti,
+                                                                    dciInfoReTx->m_format,
+                                                                    startingPoint->m_sym,
+                                                                    symPerBeam,
+                                                                    mcs,
+                                                                    tbSize,
+                                                                    ndi,
+                                                                    rv,
+                                                                    DciInfoElementTdma::DATA,
+                                                                    dciInfoReTx->m_bwpIndex,
+                                                                    dciInfoReTx->m_tpc);
 
             dci->m_rbgBitmask = harqProcess.m_dciElement->m_rbgBitmask;
             dci->m_harqProcess = dciInfoReTx->m_harqProcess;
@@ -327,17 +327,18 @@ NrMacSchedulerHarqRr::ScheduleUlHarq(
             std::vector<uint8_t> ndi{0};
 
             auto dci =
-                std::make_shared<DciInfoElementTdma>(dciInfoReTx->m_rnti,
-                                                     dciInfoReTx->m_format,
-                                                     startingPoint->m_sym - dciInfoReTx->m_numSym,
-                                                     dciInfoReTx->m_numSym,
-                                                     dciInfoReTx->m_mcs,
-                                                     dciInfoReTx->m_tbSize,
-                                                     ndi,
-                                                     rv,
-                                                     DciInfoElementTdma::DATA,
-                                                     dciInfoReTx->m_bwpIndex,
-                                                     dciInfoReTx->m_tpc);
+                NrMemoryPool::MakeShared<DciInfoElementTdma>(
+                    dciInfoReTx->m_rnti,
+                    dciInfoReTx->m_format,
+                    startingPoint->m_sym - dciInfoReTx->m_numSym,
+                    dciInfoReTx->m_numSym,
+                    dciInfoReTx->m_mcs,
+                    dciInfoReTx->m_tbSize,
+                    ndi,
+                    rv,
+                    DciInfoElementTdma::DATA,
+                    dciInfoReTx->m_bwpIndex,
+                    dciInfoReTx->m_tpc);
             dci->m_rbgBitmask = harqProcess.m_dciElement->m_rbgBitmask;
             dci->m_harqProcess = harqId;
             harqProcess.m_dciElement = dci;
@@ -1200,9 +1200,9 @@ uint8_t
 NrMacSchedulerNs3::PrependCtrlSym(uint8_t symStart,
                                   uint8_t numSymToAllocate,
                                   DciInfoElementTdma::DciFormat mode,
-                                  std::deque<VarTtiAllocInfo>* allocations) const
+                                  VarTtiAllocInfoList* allocations) const
 {
-    std::vector<uint8_t> rbgBitmask(GetBandwidthInRbg(), 1);
+    RbgBitmask rbgBitmask(GetBandwidthInRbg(), 1);
 
     NS_ASSERT_MSG(rbgBitmask.size() == GetBandwidthInRbg(),
                   "bitmask size " << rbgBitmask.size() << " conf " << GetBandwidthInRbg());
@@ -1215,11 +1215,11 @@ NrMacSchedulerNs3::PrependCtrlSym(uint8_t symStart,
     for (uint8_t sym = symStart; sym < symStart + numSymToAllocate; ++sym)
     {
         allocations->emplace_front(
-            VarTtiAllocInfo(std::make_shared<DciInfoElementTdma>(sym,
-                                                                 1,
-                                                                 mode,
-                                                                 DciInfoElementTdma::CTRL,
-                                                                 rbgBitmask)));
+            VarTtiAllocInfo(NrMemoryPool::MakeShared<DciInfoElementTdma>(sym,
+                                                                         1,
+                                                                         mode,
+                                                                         DciInfoElementTdma::CTRL,
+                                                                         rbgBitmask)));
         NS_LOG_INFO("Allocating CTRL symbol, type"
                     << mode << " in TDMA. numSym=1, symStart=" << static_cast<uint32_t>(sym)
                     << " Remaining CTRL sym to allocate: " << sym - symStart);
@@ -1239,9 +1239,9 @@ uint8_t
 NrMacSchedulerNs3::AppendCtrlSym(uint8_t symStart,
                                  uint8_t numSymToAllocate,
                                  DciInfoElementTdma::DciFormat mode,
-                                 std::deque<VarTtiAllocInfo>* allocations) const
+                                 VarTtiAllocInfoList* allocations) const
 {
-    std::vector<uint8_t> rbgBitmask(GetBandwidthInRbg(), 1);
+    RbgBitmask rbgBitmask(GetBandwidthInRbg(), 1);
 
     NS_ASSERT(rbgBitmask.size() == GetBandwidthInRbg());
     if (mode == DciInfoElementTdma::DL)
@@ -1253,11 +1253,11 @@ NrMacSchedulerNs3::AppendCtrlSym(uint8_t symStart,
     for (uint8_t sym = symStart; sym < symStart + numSymToAllocate; ++sym)
     {
         allocations->emplace_back(
-            VarTtiAllocInfo(std::make_shared<DciInfoElementTdma>(sym,
-                                                                 1,
-                                                                 mode,
-                                                                 DciInfoElementTdma::CTRL,
-                                                                 rbgBitmask)));
+            VarTtiAllocInfo(NrMemoryPool::MakeShared<DciInfoElementTdma>(sym,
+                                                                         1,
+                                                                         mode,
+                                                                         DciInfoElementTdma::CTRL,
+                                                                         rbgBitmask)));
         NS_LOG_INFO("Allocating CTRL symbol, type"
                     << mode << " in TDMA. numSym=1, symStart=" << static_cast<uint32_t>(sym)
                     << " Remaining CTRL sym to allocate: " << sym - symStart);
@@ -2334,7 +2334,7 @@ void
 NrMacSchedulerNs3::DoScheduleMsg3( std::list<uint16_t>& rntiList,SlotAllocInfo* slotAlloc ,const SfnSf& ulSfn) const
 {
     NS_LOG_FUNCTION(this);
-    std::vector<std::vector<int>> slotRessources = m_manager->getSlotRessources(GetBwpId(),ulSfn,LteNrTddSlotType::UL);
+    NrMacSchedulerSlotView slotRessources = m_manager->getSlotRessources(GetBwpId(),ulSfn,LteNrTddSlotType::UL);
     
     for( auto& rnti: rntiList)
     {
@@ -2345,7 +2345,7 @@ NrMacSchedulerNs3::DoScheduleMsg3( std::list<uint16_t>& rntiList,SlotAllocInfo*
         std::vector<uint8_t> mcs;
         uint8_t harq =0;
         uint8_t tpc =1;
-        std::vector<uint8_t> rbgmask;
+        RbgBitmask rbgmask;
         //std::cout<<"rnti:"<<rnti<<",NumRb: "<<NumRB<<",startRb:"<<startRb<<",symNum:"<<uint(symNum)<<",StartSymbol:"<<uint(StartSymbol)<<std::endl;
         uint bwpIndex = 0;
         uint NumRB =0;
@@ -2363,13 +2363,14 @@ NrMacSchedulerNs3::DoScheduleMsg3( std::list<uint16_t>& rntiList,SlotAllocInfo*
                     StartSymbol = i;
                     startRb = rb;
                     uint count = 0;
-                    while(slotRessources[i][rb+count] == rnti)
+                    //the rows of the view are contiguous in the grid, stop at the end of the row and of the slot
+                    while(rb+count < slotRessources.GetNumRb() && slotRessources[i][rb+count] == rnti)
                     {
                         NumRB++;
                         count++;
                     }
                     count = 0;
-                    while(slotRessources[i+count][rb] == rnti)
+                    while(i+count < slotRessources.size() && slotRessources[i+count][rb] == rnti)
                     {
                        symNum++;
                        count++; 
@@ -2395,7 +2396,7 @@ NrMacSchedulerNs3::DoScheduleMsg3( std::list<uint16_t>& rntiList,SlotAllocInfo*
     
             std::vector<uint32_t> m_tbs = {tbs};
 
-            std::shared_ptr<DciInfoElementTdma> dci = std::make_shared<DciInfoElementTdma>(rnti,
+            std::shared_ptr<DciInfoElementTdma> dci = NrMemoryPool::MakeShared<DciInfoElementTdma>(rnti,
                 dciFormat,
                 StartSymbol,
                 symNum,
@@ -2646,7 +2647,7 @@ NrMacSchedulerNs3::ScheduleDLWithResManager(const NrMacSchedSapProvider::SchedDl
             newRar.m_grant.m_Slotnumber = ulRes->Slotnumber;
             newRar.m_grant.m_StartSymbol = ulRes->StartSymbol;
             newRar.m_grant.m_NumberSymbols = ulRes->NumberSymbols;
-            newRar.m_grant.m_rbgBitmask = ulRes->rbgmask;
+            newRar.m_grant.m_rbgBitmask.assign(ulRes->rbgmask.begin(), ulRes->rbgmask.end());
             dlSlot.m_buildRarList.push_back(newRar);
             
 
@@ -3332,7 +3333,7 @@ NrMacSchedulerNs3::DoScheduleSrs(PointInFTPlane* spoint, SlotAllocInfo* allocInf
 
         NS_LOG_INFO("UE " << rnti << " assigned symbol " << +spoint->m_sym << " for SRS tx");
 
-        std::vector<uint8_t> rbgBitmask(GetBandwidthInRbg(), 1);
+        RbgBitmask rbgBitmask(GetBandwidthInRbg(), 1);
 
         spoint->m_sym--;
 
@@ -3342,17 +3343,17 @@ NrMacSchedulerNs3::DoScheduleSrs(PointInFTPlane* spoint, SlotAllocInfo* allocInf
         std::vector<uint8_t> ndi = {1};
         std::vector<uint8_t> rv = {0};
 
-        auto dci = std::make_shared<DciInfoElementTdma>(rnti,
-                                                        DciInfoElementTdma::UL,
-                                                        spoint->m_sym,
-                                                        1,
-                                                        mcs,
-                                                        tbs,
-                                                        ndi,
-                                                        rv,
-                                                        DciInfoElementTdma::SRS,
-                                                        GetBwpId(),
-                                                        GetTpc());
+        auto dci = NrMemoryPool::MakeShared<DciInfoElementTdma>(rnti,
+                                                                DciInfoElementTdma::UL,
+                                                                spoint->m_sym,
+                                                                1,
+                                                                mcs,
+                                                                tbs,
+                                                                ndi,
+                                                                rv,
+                                                                DciInfoElementTdma::SRS,
+                                                                GetBwpId(),
+                                                                GetTpc());
         dci->m_rbgBitmask = rbgBitmask;
 
         allocInfo->m_numSymAlloc += 1;
@@ -796,7 +796,7 @@ class NrMacSchedulerNs3 : public NrMacScheduler
                   uint8_t symStart,
                   uint8_t numSym,
                   uint8_t mcs,
-                  const std::vector<uint8_t>& rbgMask)
+                  const RbgBitmask& rbgMask)
             : m_rnti(rnti),
               m_tbs(tbs),
               m_symStart(symStart),
@@ -811,7 +811,7 @@ class NrMacSchedulerNs3 : public NrMacScheduler
                   uint8_t symStart,
                   uint8_t numSym,
                   uint8_t mcs,
-                  const std::vector<uint8_t>& rbgMask,
+                  const RbgBitmask& rbgMask,
                   bool isMsg3)
             : m_rnti(rnti),
               m_tbs(tbs),
@@ -828,7 +828,7 @@ class NrMacSchedulerNs3 : public NrMacScheduler
         uint8_t m_symStart{0};          //!< Sym start
         uint8_t m_numSym{0};            //!< Allocated symbols
         uint8_t m_mcs{0};               //!< MCS of the transmission
-        std::vector<uint8_t> m_rbgMask; //!< RBG Mask
+        RbgBitmask m_rbgMask;           //!< RBG Mask
         bool m_isMsg3;
     };
 
@@ -891,11 +891,11 @@ class NrMacSchedulerNs3 : public NrMacScheduler
     uint8_t AppendCtrlSym(uint8_t symStart,
                           uint8_t numSymToAllocate,
                           DciInfoElementTdma::DciFormat mode,
-                          std::deque<VarTtiAllocInfo>* allocations) const;
+                          VarTtiAllocInfoList* allocations) const;
     uint8_t PrependCtrlSym(uint8_t symStart,
                            uint8_t numSymToAllocate,
                            DciInfoElementTdma::DciFormat mode,
-                           std::deque<VarTtiAllocInfo>* allocations) const;
+                           VarTtiAllocInfoList* allocations) const;
 
     void ComputeActiveUe(ActiveUeMap* activeDlUe,
                          const NrMacSchedulerUeInfo::GetLCGFn& GetLCGFn,
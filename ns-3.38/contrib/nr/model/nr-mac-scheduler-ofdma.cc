@@ -484,7 +484,7 @@ NrMacSchedulerOfdma::AssignDLRBG_manager(uint32_t symAvail, const ActiveUeMap& a
           }
           
 
-        std::vector<std::vector<int>> slotRessources = m_manager->getSlotRessources(GetBwpId(),dlSfnSf,LteNrTddSlotType::DL);
+        NrMacSchedulerSlotView slotRessources = m_manager->getSlotRessources(GetBwpId(),dlSfnSf,LteNrTddSlotType::DL);
       //update ue paraeters
       
       //uint8_t rbgAssignable = GetBandwidthInRbg(); //We can assign a full symbol at once
@@ -805,19 +805,19 @@ NrMacSchedulerOfdma::CreateDlDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
                       << oss.str() << " for " << static_cast<uint32_t>(maxSym) << " SYM.");
 
     std::shared_ptr<DciInfoElementTdma> dci =
-        std::make_shared<DciInfoElementTdma>(ueInfo->m_rnti,
-                                             DciInfoElementTdma::DL,
-                                             spoint->m_sym,
-                                             maxSym,
-                                             ueInfo->m_dlMcs,
-                                             ueInfo->m_dlTbSize,
-                                             ndi,
-                                             rv,
-                                             DciInfoElementTdma::DATA,
-                                             GetBwpId(),
-                                             GetTpc());
-
-    dci->m_rbgBitmask = std::move(rbgBitmask);
+        NrMemoryPool::MakeShared<DciInfoElementTdma>(ueInfo->m_rnti,
+                                                     DciInfoElementTdma::DL,
+                                                     spoint->m_sym,
+                                                     maxSym,
+                                                     ueInfo->m_dlMcs,
+                                                     ueInfo->m_dlTbSize,
+                                                     ndi,
+                                                     rv,
+                                                     DciInfoElementTdma::DATA,
+                                                     GetBwpId(),
+                                                     GetTpc());
+
+    dci->m_rbgBitmask.assign(rbgBitmask.begin(), rbgBitmask.end());
       
     NS_ASSERT(std::count(dci->m_rbgBitmask.begin(), dci->m_rbgBitmask.end(), 0) !=
               GetBandwidthInRbg());
@@ -895,19 +895,19 @@ NrMacSchedulerOfdma::CreateUlDci(PointInFTPlane* spoint,
 
     NS_ASSERT(spoint->m_sym >= maxSym);
     std::shared_ptr<DciInfoElementTdma> dci =
-        std::make_shared<DciInfoElementTdma>(ueInfo->m_rnti,
-                                             DciInfoElementTdma::UL,
-                                             spoint->m_sym - maxSym,
-                                             maxSym,
-                                             ulMcs,
-                                             ulTbs,
-                                             ndi,
-                                             rv,
-                                             DciInfoElementTdma::DATA,
-                                             GetBwpId(),
-                                             GetTpc());
-
-    dci->m_rbgBitmask = std::move(rbgBitmask);
+        NrMemoryPool::MakeShared<DciInfoElementTdma>(ueInfo->m_rnti,
+                                                     DciInfoElementTdma::UL,
+                                                     spoint->m_sym - maxSym,
+                                                     maxSym,
+                                                     ulMcs,
+                                                     ulTbs,
+                                                     ndi,
+                                                     rv,
+                                                     DciInfoElementTdma::DATA,
+                                                     GetBwpId(),
+                                                     GetTpc());
+
+    dci->m_rbgBitmask.assign(rbgBitmask.begin(), rbgBitmask.end());
 
     std::ostringstream oss;
     for (auto x : dci->m_rbgBitmask)
@@ -1715,7 +1715,7 @@ NrMacSchedulerOfdma::AssignULRBG_manager (uint32_t symAvail, const ActiveUeMap &
  
   //assign Ressources for this slot
 
-  std::vector<std::vector<int>> slotRessources = m_manager->getSlotRessources(GetBwpId(),ulSfn,LteNrTddSlotType::UL);
+  NrMacSchedulerSlotView slotRessources = m_manager->getSlotRessources(GetBwpId(),ulSfn,LteNrTddSlotType::UL);
   
   //update ue paraeters
   int32_t resNum = 0;
@@ -1910,7 +1910,7 @@ NrMacSchedulerOfdma::CreateUlDci (PointInFTPlane *spoint,
 
    spoint->m_rbg = lastRbg + 1;
 
-   std::shared_ptr<DciInfoElementTdma> dci = std::make_shared<DciInfoElementTdma>
+   std::shared_ptr<DciInfoElementTdma> dci = NrMemoryPool::MakeShared<DciInfoElementTdma>
       (ueInfo->m_rnti, DciInfoElementTdma::UL, spoint->m_sym, (ueInfo->m_ulSym), ulMcs,
        ulTbs, ndi, rv, DciInfoElementTdma::DATA, GetBwpId (), GetTpc());
 
@@ -1921,7 +1921,7 @@ NrMacSchedulerOfdma::CreateUlDci (PointInFTPlane *spoint,
        spoint->m_rbg = 0;
      }
 
-  dci->m_rbgBitmask = std::move (rbgBitmask);
+  dci->m_rbgBitmask.assign (rbgBitmask.begin (), rbgBitmask.end ());
 
   std::ostringstream oss;
   for (auto x: dci->m_rbgBitmask)
@@ -0,0 +1,210 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nr-mac-scheduler-ressource-grid.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+void
+NrMacSchedulerRessourceGrid::Resize(uint64_t numRows, uint16_t numRb)
+{
+    m_numRows = numRows;
+    m_numRb = numRb;
+    m_wordsPerRow = (numRb + 63) / 64;
+    m_owner.assign(m_numRows * m_numRb, 0);
+    m_occupied.assign(m_numRows * m_wordsPerRow, 0);
+}
+
+void
+NrMacSchedulerRessourceGrid::SetRange(uint64_t row,
+                                      uint16_t startRb,
+                                      uint16_t numRb,
+                                      int32_t owner)
+{
+    for (uint16_t rb = startRb; rb < startRb + numRb; ++rb)
+    {
+        Set(row, rb, owner);
+    }
+}
+
+uint16_t
+NrMacSchedulerRessourceGrid::NextBit(uint64_t row,
+                                     uint16_t rb,
+                                     uint16_t highRb,
+                                     bool occupied) const
+{
+    const uint64_t* words = &m_occupied[row * m_wordsPerRow];
+    uint32_t wordIndex = rb / 64;
+    uint64_t word = occupied ? words[wordIndex] : ~words[wordIndex];
+    word &= ~uint64_t(0) << (rb % 64); // ignore the bits before rb
+    while (word == 0)
+    {
+        ++wordIndex;
+        if (wordIndex * 64 > highRb)
+        {
+            return highRb + 1;
+        }
+        word = occupied ? words[wordIndex] : ~words[wordIndex];
+    }
+    uint32_t found = wordIndex * 64 + __builtin_ctzll(word);
+    return found > highRb ? highRb + 1 : static_cast<uint16_t>(found);
+}
+
+bool
+NrMacSchedulerRessourceGrid::IsRangeFree(uint64_t row, uint16_t startRb, uint16_t numRb) const
+{
+    if (numRb == 0)
+    {
+        return true;
+    }
+    NS_ASSERT(row < m_numRows && startRb + numRb <= m_numRb);
+    uint16_t highRb = startRb + numRb - 1;
+    return NextBit(row, startRb, highRb, true) > highRb;
+}
+
+uint16_t
+NrMacSchedulerRessourceGrid::CountFree(uint64_t row, uint16_t lowRb, uint16_t highRb) const
+{
+    NS_ASSERT(row < m_numRows && lowRb <= highRb && highRb < m_numRb);
+    const uint64_t* words = &m_occupied[row * m_wordsPerRow];
+    uint16_t occupied = 0;
+    for (uint32_t wordIndex = lowRb / 64; wordIndex <= highRb / 64u; ++wordIndex)
+    {
+        uint64_t word = words[wordIndex];
+        if (wordIndex == lowRb / 64u)
+        {
+            word &= ~uint64_t(0) << (lowRb % 64);
+        }
+        if (wordIndex == highRb / 64u && highRb % 64 != 63)
+        {
+            word &= (uint64_t(1) << (highRb % 64 + 1)) - 1;
+        }
+        occupied += __builtin_popcountll(word);
+    }
+    return highRb - lowRb + 1 - occupied;
+}
+
+uint16_t
+NrMacSchedulerRessourceGrid::FindFreeRun(uint64_t row,
+                                         uint16_t lowRb,
+                                         uint16_t highRb,
+                                         uint16_t minLength) const
+{
+    NS_ASSERT(row < m_numRows && lowRb <= highRb && highRb < m_numRb);
+    uint32_t rb = lowRb;
+    while (rb <= highRb)
+    {
+        uint16_t start = NextBit(row, rb, highRb, false);
+        if (start > highRb || highRb - start + 1 < minLength)
+        {
+            return NO_RUN;
+        }
+        uint16_t end = NextBit(row, start, highRb, true);
+        if (end - start >= minLength)
+        {
+            return start;
+        }
+        rb = end;
+    }
+    return NO_RUN;
+}
+
+void
+NrMacSchedulerFreeSymbolIndex::Resize(uint16_t numBwp, uint8_t freeSymbols)
+{
+    m_numBwp = numBwp;
+    m_leafOffset = 1;
+    while (m_leafOffset < numBwp)
+    {
+        m_leafOffset *= 2;
+    }
+    m_tree.assign(2 * m_leafOffset, 0);
+    for (uint16_t bwp = 0; bwp < numBwp; ++bwp)
+    {
+        Set(bwp, freeSymbols);
+    }
+}
+
+void
+NrMacSchedulerFreeSymbolIndex::Set(uint16_t bwp, uint8_t freeSymbols)
+{
+    NS_ASSERT(bwp < m_numBwp);
+    uint32_t node = m_leafOffset + bwp;
+    m_tree[node] = freeSymbols;
+    while (node > 1)
+    {
+        node /= 2;
+        m_tree[node] = std::max(m_tree[2 * node], m_tree[2 * node + 1]);
+    }
+}
+
+uint16_t
+NrMacSchedulerFreeSymbolIndex::GetMaxBwp(uint16_t firstBwp, uint16_t endBwp) const
+{
+    NS_ASSERT(endBwp <= m_numBwp);
+    if (firstBwp >= endBwp)
+    {
+        return endBwp;
+    }
+    return Query(1, 0, m_leafOffset, firstBwp, endBwp);
+}
+
+uint16_t
+NrMacSchedulerFreeSymbolIndex::Query(uint32_t node,
+                                     uint16_t nodeFirst,
+                                     uint16_t nodeEnd,
+                                     uint16_t firstBwp,
+                                     uint16_t endBwp) const
+{
+    if (nodeEnd - nodeFirst == 1)
+    {
+        return nodeFirst;
+    }
+    uint16_t middle = nodeFirst + (nodeEnd - nodeFirst) / 2;
+    if (firstBwp <= nodeFirst && nodeEnd <= endBwp)
+    {
+        // the node is completely inside the range: descend to the first leaf holding the maximum
+        return m_tree[2 * node] >= m_tree[2 * node + 1]
+                   ? Query(2 * node, nodeFirst, middle, firstBwp, endBwp)
+                   : Query(2 * node + 1, middle, nodeEnd, firstBwp, endBwp);
+    }
+    uint16_t left = endBwp;
+    uint16_t right = endBwp;
+    if (firstBwp < middle)
+    {
+        left = Query(2 * node, nodeFirst, middle, firstBwp, endBwp);
+    }
+    if (endBwp > middle)
+    {
+        right = Query(2 * node + 1, middle, nodeEnd, firstBwp, endBwp);
+    }
+    if (left == endBwp)
+    {
+        return right;
+    }
+    if (right == endBwp)
+    {
+        return left;
+    }
+    return Get(left) >= Get(right) ? left : right;
+}
+
+} // namespace ns3
@@ -0,0 +1,330 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_MAC_SCHEDULER_RESSOURCE_GRID_H
+#define NR_MAC_SCHEDULER_RESSOURCE_GRID_H
+
+#include <ns3/assert.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief Flat symbol x RB grid used by the NrMacSchedulerRessourceManager
+ *
+ * Every row of the grid is one OFDM symbol, every column one RB of the
+ * (RedCap) carrier. The owner of each cell is stored in a single contiguous
+ * array of 32-bit values: positive values are RNTIs, negative values are
+ * the reserved states of RessourceAllocationStatus and 0 is a free cell.
+ * The RNTIs go up to 65535, so they do not fit into 16-bit owners.
+ *
+ * Next to the owners the grid keeps an occupancy bitmap with one bit per
+ * cell (bit set = cell is not free), so that the search for free RBs inside
+ * a symbol can be done 64 RBs at a time.
+ */
+class NrMacSchedulerRessourceGrid
+{
+  public:
+    /**
+     * \brief Value returned by FindFreeRun when no run has been found
+     */
+    static constexpr uint16_t NO_RUN = std::numeric_limits<uint16_t>::max();
+
+    NrMacSchedulerRessourceGrid() = default;
+
+    /**
+     * \brief Allocate the grid. All cells are free afterwards.
+     * \param numRows number of symbols
+     * \param numRb number of RB per symbol
+     */
+    void Resize(uint64_t numRows, uint16_t numRb);
+
+    /**
+     * \return the number of rows (symbols) of the grid
+     */
+    uint64_t GetNumRows() const
+    {
+        return m_numRows;
+    }
+
+    /**
+     * \return the number of RB per row
+     */
+    uint16_t GetNumRb() const
+    {
+        return m_numRb;
+    }
+
+    /**
+     * \brief Get the owner of a cell
+     * \param row the symbol
+     * \param rb the RB
+     * \return the RNTI, a RessourceAllocationStatus or 0 if free
+     */
+    int32_t Get(uint64_t row, uint16_t rb) const
+    {
+        NS_ASSERT(row < m_numRows && rb < m_numRb);
+        return m_owner[row * m_numRb + rb];
+    }
+
+    /**
+     * \brief Set the owner of a cell and update the occupancy bitmap
+     * \param row the symbol
+     * \param rb the RB
+     * \param owner the RNTI or a RessourceAllocationStatus
+     */
+    void Set(uint64_t row, uint16_t rb, int32_t owner)
+    {
+        NS_ASSERT(row < m_numRows && rb < m_numRb);
+        m_owner[row * m_numRb + rb] = owner;
+        uint64_t& word = m_occupied[row * m_wordsPerRow + rb / 64];
+        uint64_t mask = uint64_t(1) << (rb % 64);
+        if (owner == 0)
+        {
+            word &= ~mask;
+        }
+        else
+        {
+            word |= mask;
+        }
+    }
+
+    /**
+     * \brief Set the owner of numRb consecutive cells of a row
+     * \param row the symbol
+     * \param startRb the first RB
+     * \param numRb the number of RB
+     * \param owner the RNTI or a RessourceAllocationStatus
+     */
+    void SetRange(uint64_t row, uint16_t startRb, uint16_t numRb, int32_t owner);
+
+    /**
+     * \param row the symbol
+     * \param rb the RB
+     * \return true if the cell is free
+     */
+    bool IsFree(uint64_t row, uint16_t rb) const
+    {
+        NS_ASSERT(row < m_numRows && rb < m_numRb);
+        return (m_occupied[row * m_wordsPerRow + rb / 64] & (uint64_t(1) << (rb % 64))) == 0;
+    }
+
+    /**
+     * \brief Check if numRb consecutive cells of a row are all free
+     * \param row the symbol
+     * \param startRb the first RB
+     * \param numRb the number of RB
+     * \return true if all cells are free
+     */
+    bool IsRangeFree(uint64_t row, uint16_t startRb, uint16_t numRb) const;
+
+    /**
+     * \brief Count the free cells of a row in [lowRb, highRb]
+     * \param row the symbol
+     * \param lowRb the first RB (inclusive)
+     * \param highRb the last RB (inclusive)
+     * \return the number of free cells
+     */
+    uint16_t CountFree(uint64_t row, uint16_t lowRb, uint16_t highRb) const;
+
+    /**
+     * \brief Find the first run of at least minLength free cells of a row in [lowRb, highRb]
+     * \param row the symbol
+     * \param lowRb the first RB (inclusive)
+     * \param highRb the last RB (inclusive)
+     * \param minLength the minimum length of the run
+     * \return the first RB of the run or NO_RUN
+     */
+    uint16_t FindFreeRun(uint64_t row, uint16_t lowRb, uint16_t highRb, uint16_t minLength) const;
+
+    /**
+     * \param row the symbol
+     * \return a pointer to the owner of the first RB of the row
+     */
+    const int32_t* GetRowData(uint64_t row) const
+    {
+        NS_ASSERT(row < m_numRows);
+        return &m_owner[row * m_numRb];
+    }
+
+  private:
+    /**
+     * \brief Get the next set (occupied) or cleared (free) bit of a row, starting at rb
+     * \return the RB of that bit, or highRb + 1 if there is none up to highRb
+     */
+    uint16_t NextBit(uint64_t row, uint16_t rb, uint16_t highRb, bool occupied) const;
+
+    uint64_t m_numRows{0};
+    uint16_t m_numRb{0};
+    uint16_t m_wordsPerRow{0};
+    std::vector<int32_t> m_owner;     //!< owners, row-major (numRows x numRb)
+    std::vector<uint64_t> m_occupied; //!< occupancy bitmap, row-major (numRows x wordsPerRow)
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Non-owning view on the symbols of one slot and one BWP of the ressource grid
+ *
+ * The view only stores a pointer into the grid, the row stride and the BWP
+ * borders, so handing it out does not copy anything. view[sym][rb] returns
+ * the owner of the rb-th RB of the BWP (counted from its lower border) in the
+ * symbol sym. The view is valid as long as the grid is not resized; it always
+ * shows the current state of the grid.
+ */
+class NrMacSchedulerSlotView
+{
+  public:
+    NrMacSchedulerSlotView() = default;
+
+    /**
+     * \brief Create a view
+     * \param firstRb pointer to the owner of the lower BWP border in the first symbol
+     * \param stride number of RB of one grid row
+     * \param numSym number of symbols of the slot
+     * \param numRb number of RB of the BWP
+     */
+    NrMacSchedulerSlotView(const int32_t* firstRb, uint16_t stride, uint8_t numSym, uint16_t numRb)
+        : m_firstRb(firstRb),
+          m_stride(stride),
+          m_numSym(numSym),
+          m_numRb(numRb)
+    {
+    }
+
+    /**
+     * \return the number of symbols
+     */
+    size_t size() const
+    {
+        return m_numSym;
+    }
+
+    /**
+     * \return the number of RB of the BWP
+     */
+    uint16_t GetNumRb() const
+    {
+        return m_numRb;
+    }
+
+    /**
+     * \param sym the symbol
+     * \return a pointer to the owners of the BWP in this symbol
+     */
+    const int32_t* operator[](size_t sym) const
+    {
+        return m_firstRb + sym * m_stride;
+    }
+
+    /**
+     * \param sym the symbol
+     * \param rb the RB inside the BWP
+     * \return the owner of the RB
+     */
+    int32_t operator()(size_t sym, uint16_t rb) const
+    {
+        NS_ASSERT(sym < m_numSym && rb < m_numRb);
+        return m_firstRb[sym * m_stride + rb];
+    }
+
+  private:
+    const int32_t* m_firstRb{nullptr};
+    uint16_t m_stride{0};
+    uint8_t m_numSym{0};
+    uint16_t m_numRb{0};
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Index over the free symbols of the RedCap BWPs of a slot
+ *
+ * For every BWP the number of free symbols at the end of the slot is stored
+ * (a skyline of the slot). The values are kept in a segment tree, so that the
+ * BWP with the most free symbols inside a range of BWPs can be found in
+ * O(log n) while the values are updated after every allocation.
+ */
+class NrMacSchedulerFreeSymbolIndex
+{
+  public:
+    NrMacSchedulerFreeSymbolIndex() = default;
+
+    /**
+     * \brief Set the number of BWPs. All BWPs get the same number of free symbols.
+     * \param numBwp number of BWPs
+     * \param freeSymbols initial number of free symbols
+     */
+    void Resize(uint16_t numBwp, uint8_t freeSymbols);
+
+    /**
+     * \return the number of BWPs
+     */
+    uint16_t GetSize() const
+    {
+        return m_numBwp;
+    }
+
+    /**
+     * \param bwp the BWP
+     * \return the number of free symbols of the BWP
+     */
+    uint8_t Get(uint16_t bwp) const
+    {
+        NS_ASSERT(bwp < m_numBwp);
+        return m_tree[m_leafOffset + bwp];
+    }
+
+    /**
+     * \brief Update the number of free symbols of a BWP
+     * \param bwp the BWP
+     * \param freeSymbols the number of free symbols
+     */
+    void Set(uint16_t bwp, uint8_t freeSymbols);
+
+    /**
+     * \brief Get the first BWP with the highest number of free symbols in [firstBwp, endBwp)
+     * \param firstBwp first BWP of the range
+     * \param endBwp BWP after the last BWP of the range
+     * \return the BWP, or endBwp if the range is empty
+     */
+    uint16_t GetMaxBwp(uint16_t firstBwp, uint16_t endBwp) const;
+
+  private:
+    /**
+     * \brief Recursive range query on the node covering [nodeFirst, nodeEnd)
+     * \return the first leaf with the maximum value inside [firstBwp, endBwp), or endBwp
+     */
+    uint16_t Query(uint32_t node,
+                   uint16_t nodeFirst,
+                   uint16_t nodeEnd,
+                   uint16_t firstBwp,
+                   uint16_t endBwp) const;
+
+    uint16_t m_numBwp{0};
+    uint16_t m_leafOffset{0};
+    std::vector<uint8_t> m_tree; //!< implicit binary tree, the leaves start at m_leafOffset
+};
+
+} // namespace ns3
+
+#endif // NR_MAC_SCHEDULER_RESSOURCE_GRID_H
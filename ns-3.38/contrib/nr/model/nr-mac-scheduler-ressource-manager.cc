@@ -1,6 +1,7 @@
 #include <ns3/integer.h>
 #include <ns3/log.h>
 #include <ns3/pointer.h>
+#include <ns3/trace-source-accessor.h>
 #include <ns3/uinteger.h>
 #include <ns3/nr-mac-scheduler-ressource-manager.h>
 
@@ -14,6 +15,29 @@ namespace ns3
     
     NS_LOG_COMPONENT_DEFINE("NrMacSchedulerRessourceManager");
 
+    NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerRessourceManager);
+
+    TypeId
+    NrMacSchedulerRessourceManager::GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::NrMacSchedulerRessourceManager")
+                .SetParent<Object>()
+                .SetGroupName("nr")
+                .AddTraceSource("FrameRessourceUsage",
+                                "Ressource usage of every 10ms frame, reported after the frame has ended",
+                                MakeTraceSourceAccessor(&NrMacSchedulerRessourceManager::m_frameUsageTrace),
+                                "ns3::NrMacSchedulerRessourceManager::FrameUsageTracedCallback");
+        return tid;
+    }
+
+    TypeId
+    NrMacSchedulerRessourceManager::GetInstanceTypeId() const
+    {
+        //the manager is not created with CreateObject, so the TypeId of the Object base would be returned
+        return GetTypeId();
+    }
+
     NrMacSchedulerRessourceManager::NrMacSchedulerRessourceManager(std::string pattern, uint8_t numerology , uint16_t simTime,uint32_t initTime, std::string logDir,uint8_t  bwpCount, bool use5MHz)
     {
         //all bwps are assumed to have 20MHz to support RedCap and therefore have 51RB per bwp
@@ -29,31 +53,28 @@ namespace ns3
         m_use5MHz= use5MHz;
 
 
-        m_ressourceWindowSize = 9600; //9600 milliseconds to limit the memory space needed for bigger Simulations. Should be a multiple of 160ms for every PRACH-configuration to be at the same place
-        //m_resBufferSize = 400; //400 millieconds additional buffer to avoid outOfBounce errors 
+        //The grid is a ring buffer which only has to cover the scheduling look-ahead. Every half window the past half is evaluated and cleared 
+        //while the scheduler writes into the other half. The window has to be a multiple of 160ms for every PRACH-configuration to be at the same place 
+        //and a multiple of the TDD pattern to keep the slot types of the ring positions constant.
+        m_ressourceWindowSize = 160;
+        while((uint64_t(m_ressourceWindowSize)*m_numSlots/10) % m_pattern.size() != 0)
+        {
+            m_ressourceWindowSize += 160;
+        }
         NS_ABORT_MSG_IF(m_ressourceWindowSize%160 != 0, "m_ressourceWindowSize has to be a multiple of 160ms to ensure correct positioning of control channels");
         
-       // m_ressourceWindowElements = (m_ressourceWindowSize) *m_numSlots * m_numSym/10;
         m_ressourceWindowElements = (m_ressourceWindowSize) *m_numSlots * m_numSym/10;
 
-
-        m_ressourcen.resize(m_ressourceWindowElements, std::vector<int32_t>()); 
-        //m_ressourcen.resize((simTime_seconds+0.01) * 100 *m_numSlots * m_numSym, std::vector<int>()); // +0.01 (10ms) for a few more resources in case the scheduler wants 
         m_numBwp = bwpCount;
+        m_numRb = 51*(bwpCount-2); //TODO Hardcoded Size in Frequency span
         m_lastPrachNo =0;
-        for (int i = 0; i < bwpCount-2; ++i)
-        {
-           freeSymbolsMap.insert({i, 13}); //PUCCH symbol subtracted
-        }
-        
-
+        m_freeSymbols.Resize(bwpCount-2, 13); //PUCCH symbol subtracted
 
-        for (size_t i = 0; i < m_ressourcen.size (); ++i)
-        {
-           m_ressourcen[i].resize (51*(bwpCount-2), RessourceAllocationStatus::FREE); //TODO Hardcoded Size in Frequency span
-        }
+        m_ressourcen.Resize(m_ressourceWindowElements, m_numRb);
+        m_symPerFrame = m_numSlots*m_numSym;
+        initUsageCounters();
         reserveSystemInformations(bwpCount);
-        Simulator::Schedule(MilliSeconds(m_ressourceWindowSize/2),&NrMacSchedulerRessourceManager::changeRessourceWindow,this);
+        Simulator::Schedule(MilliSeconds(10),&NrMacSchedulerRessourceManager::endOfFrame,this);
     }
 
 
@@ -69,7 +90,7 @@ namespace ns3
         size_t i =0;
         size_t peridicity = 10; //ms
         size_t k=1;
-        while(i < m_ressourcen.size())
+        while(i < m_ressourcen.GetNumRows())
         {      
 
             //int startRb = 51*(bwpCount-2)/2;
@@ -79,7 +100,7 @@ namespace ns3
             {
                 for(uint j = 2; j<m_numSym;++j )
                 {
-                    m_ressourcen[i+j][rb] = RessourceAllocationStatus::PBCH;
+                    setRessource(i+j, rb, RessourceAllocationStatus::PBCH);
                 }
             }
 
@@ -96,7 +117,7 @@ namespace ns3
             //     {
             //         for(int rb = startRb+4; rb< startRb+20-4;++rb)
             //         {
-            //             m_ressourcen[i+j][rb] = RessourceAllocationStatus::PBCH;
+            //             setRessource(i+j, rb, RessourceAllocationStatus::PBCH);
             //         }
             //     }
 
@@ -104,7 +125,7 @@ namespace ns3
             //     else{
             //         for(int rb = startRb; rb< startRb+20;++rb)
             //         {
-            //             m_ressourcen[i+j][rb] = RessourceAllocationStatus::PBCH;
+            //             setRessource(i+j, rb, RessourceAllocationStatus::PBCH);
             //         }
             //     }
             //}
@@ -117,7 +138,7 @@ namespace ns3
             //     {
             //         for(int rb = startRb+4; rb< startRb+20-4;++rb)
             //         {
-            //             m_ressourcen[i+j][rb] = RessourceAllocationStatus::PBCH;
+            //             setRessource(i+j, rb, RessourceAllocationStatus::PBCH);
             //         }
             //     }
 
@@ -125,7 +146,7 @@ namespace ns3
             //          //PBCH in the middle of the bandwitdh for 20 rb
             //         for(int rb = startRb; rb< startRb+20;++rb)
             //         {
-            //             m_ressourcen[i+j][rb] = RessourceAllocationStatus::PBCH;
+            //             setRessource(i+j, rb, RessourceAllocationStatus::PBCH);
             //         }
             //     }
             // }
@@ -145,7 +166,7 @@ namespace ns3
             size_t subframeNumber = 0;
             size_t frameNumber =0;
             size_t symbolNumber =0;
-            while(i < m_ressourcen.size())
+            while(i < m_ressourcen.GetNumRows())
             {
                 symbolNumber = i%m_numSym;
                 slotNumber = i/m_numSym; 
@@ -164,7 +185,7 @@ namespace ns3
                             {
                                 for(size_t rb = 0; rb <= bwpRessourceMap.at(0).getUpperBorder(); ++rb)
                                 {
-                                    m_ressourcen[i][rb] = RessourceAllocationStatus::PRACH;
+                                    setRessource(i, rb, RessourceAllocationStatus::PRACH);
                                 }
                             }   
                         }    
@@ -177,184 +198,239 @@ namespace ns3
         }
     }
 
+    void
+    NrMacSchedulerRessourceManager::endOfFrame()
+    {
+        //nothing is scheduled into the past, so the counters of the frame which has just ended are final
+        uint64_t frame = Simulator::Now().GetMilliSeconds()/10;
+        RessourceUsageStats frameStats = getFrameStats((frame-1)%m_frameUsage.size());
+        m_frameUsageTrace(frame-1, frameStats);
+
+        //the snapshot at index frame holds the usage of all frames before it
+        RessourceUsageStats cumulative = m_cumulativeUsage.back();
+        cumulative.PdcchRessources += frameStats.PdcchRessources;
+        cumulative.PdcchUsed += frameStats.PdcchUsed;
+        cumulative.PucchRessources += frameStats.PucchRessources;
+        cumulative.freeRessources_DL += frameStats.freeRessources_DL;
+        cumulative.freeRessources_UL += frameStats.freeRessources_UL;
+        cumulative.usedRessources_UL += frameStats.usedRessources_UL;
+        cumulative.usedRessources_DL += frameStats.usedRessources_DL;
+        cumulative.PrachRessources += frameStats.PrachRessources;
+        cumulative.ControlRessources += frameStats.ControlRessources;
+        m_cumulativeUsage.push_back(cumulative);
+
+        if(Simulator::Now().GetMilliSeconds()%(m_ressourceWindowSize/2) == 0)
+        {
+            changeRessourceWindow();
+        }
+        Simulator::Schedule(MilliSeconds(10),&NrMacSchedulerRessourceManager::endOfFrame,this);
+    }
+
     void
     NrMacSchedulerRessourceManager::changeRessourceWindow()
     {
         collectResUsage();
         resetRessourceGrid();
        //moveRessourceBufferValues();
-
-        Simulator::Schedule(MilliSeconds(m_ressourceWindowSize/2),&NrMacSchedulerRessourceManager::changeRessourceWindow,this);
     }
 
     void
-    NrMacSchedulerRessourceManager::collectResUsage()
+    NrMacSchedulerRessourceManager::setRessource(uint64_t index, uint16_t rb, int32_t owner)
     {
-        uint64_t slotNumber =0;
-        //add saved tmpRessources from last window to UeStats
-        std::map<uint32_t, uint64_t>::iterator it;
-        for (it = m_ueStats.tmpResMap.begin(); it != m_ueStats.tmpResMap.end(); it++)
+        int32_t oldOwner = m_ressourcen.Get(index, rb);
+        if(oldOwner == owner)
         {
-            m_ueStats.ueResMap[m_rntiMap.at(it->first)]+= it->second; 
+            return;
         }
-        m_ueStats.tmpResMap.clear();
+        countRessource(index, oldOwner, -1);
+        countRessource(index, owner, 1);
+        m_ressourcen.Set(index, rb, owner);
+    }
 
-        uint64_t i = Simulator::Now().GetMilliSeconds()*m_numSlots/10*m_numSym % m_ressourceWindowElements == 0 ? (m_ressourceWindowElements/2) : 0;
-        uint64_t endIndex = i+ m_ressourceWindowElements/2;
+    void
+    NrMacSchedulerRessourceManager::setRessourceRange(uint64_t index, uint16_t startRb, uint16_t numRb, int32_t owner)
+    {
+        if(m_ressourcen.IsRangeFree(index, startRb, numRb))
+        {
+            countRessource(index, FREE, -int64_t(numRb));
+            countRessource(index, owner, numRb);
+            m_ressourcen.SetRange(index, startRb, numRb, owner);
+            return;
+        }
+        for(uint16_t rb = startRb; rb < startRb+numRb; ++rb)
+        {
+            setRessource(index, rb, owner);
+        }
+    }
 
-        for (; i < endIndex; ++i)
+    void
+    NrMacSchedulerRessourceManager::countRessource(uint64_t index, int32_t owner, int64_t count)
+    {
+        FrameRessourceUsage& usage = m_frameUsage[index/m_symPerFrame];
+        LteNrTddSlotType slotType = m_pattern[(index/m_numSym)%m_pattern.size()];
+        bool ulSlot = slotType == ns3::UL || slotType == ns3::F;
+        switch(owner)
         {
-            slotNumber = i/m_numSym; 
-            for (int64_t rb = 0; rb <51*(m_numBwp-2);++rb)
-            {
-                switch(m_ressourcen[i][rb])
+            case FREE: 
+                if(ulSlot){
+                    usage.stats.freeRessources_UL += count;
+                }
+                else{
+                    usage.stats.freeRessources_DL += count;
+                }
+                break;
+            case PRACH: usage.stats.PrachRessources += count;
+                break;
+            case RESERVED: usage.stats.ControlRessources += count;
+                break;
+            case CORESET: usage.stats.PdcchRessources += count;
+                break;
+            case SCH_CORESET: usage.stats.PdcchUsed += count;
+                break;
+            case PUCCH: usage.stats.PucchRessources += count;
+                break;
+            case SCH_MSG3: usage.stats.usedRessources_UL += count;
+                break;
+            case PBCH: usage.stats.ControlRessources += count;
+                break;
+            default:
+                //no reserved ressources -> schedueled Data
+                if(owner > 0) //sanity check
                 {
-                    case FREE: if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-                        m_ueStats.freeRessources++;
-                        m_ressourceStats.freeRessources_UL++;
+                    if(ulSlot){
+                        if(uint32_t(owner) >= usage.ulRntiUsage.size())
+                        {
+                            usage.ulRntiUsage.resize(owner+1, 0);
+                        }
+                        usage.ulRntiUsage[owner] += count;
+                        usage.ulDataRessources += count;
                     }
                     else{
-                        //stats.freeRessources_DL++;
-                        m_ressourceStats.freeRessources_DL++;
+                        usage.stats.usedRessources_DL += count;
                     }
-                        break;
-                    case PRACH: m_ressourceStats.PrachRessources++;
-                        break;
-                    case RESERVED: m_ressourceStats.ControlRessources++;
-                        break;
-                    case CORESET: m_ressourceStats.PdcchRessources++;
-                        break;
-                    case SCH_CORESET: m_ressourceStats.PdcchUsed++;
-                        break;
-                    case PUCCH: m_ressourceStats.PucchRessources++;
-                        break;
-                    case SCH_MSG3: m_ressourceStats.usedRessources_UL++;
-                        break;
-                    
-                    case PBCH: m_ressourceStats.ControlRessources++;
-                        break;
-                    default:
-                        //no reserved ressources -> schedueled Data
-                        if(m_ressourcen[i][rb] > 0) //sanity check
-                        {
-                            if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-                            //m_ueStats.UlUsageArr[m_rntiMap.at(m_ressourcen[i][rb])]++;
-                                if(m_rntiMap.count(m_ressourcen[i][rb]) != 0)
-                                {
-                                    m_ueStats.ueResMap[m_rntiMap.at(m_ressourcen[i][rb])]++;
-                                    m_ressourceStats.usedRessources_UL++;
-                                }
-                                else{
-                                    m_ueStats.tmpResMap[m_ressourcen[i][rb]]++;
-                                    std::cout<<"Rnti "<< uint(m_ressourcen[i][rb]) << " nicht gefunden."<< std::endl; //abspeichern um die ressourcennutzung richtig zu bestimmen?
-                                }
-;
-                            }
-                            else{
-                            //stats.usedRessources_DL++;
-                            m_ressourceStats.usedRessources_DL++;
-                            }
-                        }
+                }
+        }
+    }
+
+    void
+    NrMacSchedulerRessourceManager::initUsageCounters()
+    {
+        //all ressources of the grid are free at the beginning
+        m_frameUsage.assign(m_ressourceWindowElements/m_symPerFrame, FrameRessourceUsage());
+        m_cumulativeUsage.assign(1, RessourceUsageStats());
+        for(uint64_t i = 0; i < m_ressourcen.GetNumRows(); i += m_numSym)
+        {
+            countRessource(i, FREE, int64_t(m_numSym)*m_numRb);
+        }
+    }
+
+    RessourceUsageStats
+    NrMacSchedulerRessourceManager::getFrameStats(uint32_t frame) const
+    {
+        RessourceUsageStats stats = m_frameUsage[frame].stats;
+        stats.usedRessources_UL += m_frameUsage[frame].ulDataRessources;
+        return stats;
+    }
+
+    void
+    NrMacSchedulerRessourceManager::addFrameUsage(uint32_t firstFrame, uint32_t endFrame)
+    {
+        for(uint32_t frame = firstFrame; frame < endFrame; ++frame)
+        {
+            const FrameRessourceUsage& usage = m_frameUsage[frame%m_frameUsage.size()];
+            m_ressourceStats.PdcchRessources += usage.stats.PdcchRessources;
+            m_ressourceStats.PdcchUsed += usage.stats.PdcchUsed;
+            m_ressourceStats.PucchRessources += usage.stats.PucchRessources;
+            m_ressourceStats.freeRessources_DL += usage.stats.freeRessources_DL;
+            m_ressourceStats.freeRessources_UL += usage.stats.freeRessources_UL;
+            m_ressourceStats.usedRessources_UL += usage.stats.usedRessources_UL;
+            m_ressourceStats.usedRessources_DL += usage.stats.usedRessources_DL;
+            m_ressourceStats.PrachRessources += usage.stats.PrachRessources;
+            m_ressourceStats.ControlRessources += usage.stats.ControlRessources;
+            m_ueStats.freeRessources += usage.stats.freeRessources_UL;
+
+            for(uint32_t rnti = 1; rnti < usage.ulRntiUsage.size(); ++rnti)
+            {
+                if(usage.ulRntiUsage[rnti] == 0)
+                {
+                    continue;
+                }
+                if(m_rntiMap.count(rnti) != 0)
+                {
+                    m_ueStats.AddUlUsage(m_rntiMap.at(rnti), usage.ulRntiUsage[rnti]);
+                    m_ressourceStats.usedRessources_UL += usage.ulRntiUsage[rnti];
+                }
+                else{
+                    m_ueStats.tmpResMap[rnti] += usage.ulRntiUsage[rnti];
+                    std::cout<<"Rnti "<< rnti << " nicht gefunden."<< std::endl; //abspeichern um die ressourcennutzung richtig zu bestimmen?
                 }
             }
         }
     }
 
     void
-    NrMacSchedulerRessourceManager::collectFinalResUsage()
+    NrMacSchedulerRessourceManager::collectResUsage()
     {
-        uint64_t slotNumber =0;
         //add saved tmpRessources from last window to UeStats
         std::map<uint32_t, uint64_t>::iterator it;
         for (it = m_ueStats.tmpResMap.begin(); it != m_ueStats.tmpResMap.end(); it++)
         {
-            m_ueStats.ueResMap[m_rntiMap.at(it->first)]+= it->second; 
+            m_ueStats.AddUlUsage(m_rntiMap.at(it->first), it->second);
         }
         m_ueStats.tmpResMap.clear();
 
-        uint64_t timeIndex = Simulator::Now().GetMilliSeconds()*m_numSlots/10*m_numSym;
-        uint64_t remaining = timeIndex%(m_ressourceWindowElements/2);
-        uint64_t startIndex = timeIndex > m_ressourceWindowElements/2 ? m_ressourceWindowElements/2 : 0;
-        for (uint i = startIndex; i < remaining; ++i)
+        //the half of the ring buffer which has just ended
+        uint32_t halfFrames = m_frameUsage.size()/2;
+        uint32_t firstFrame = (Simulator::Now().GetMilliSeconds()/10)%m_frameUsage.size() == 0 ? halfFrames : 0;
+        addFrameUsage(firstFrame, firstFrame+halfFrames);
+    }
+
+    void
+    NrMacSchedulerRessourceManager::collectFinalResUsage()
+    {
+        //add saved tmpRessources from last window to UeStats
+        std::map<uint32_t, uint64_t>::iterator it;
+        for (it = m_ueStats.tmpResMap.begin(); it != m_ueStats.tmpResMap.end(); it++)
         {
-            slotNumber = i/m_numSym; 
-            for (int64_t rb = 0; rb <51*(m_numBwp-2);++rb)
-            {
-                switch(m_ressourcen[i][rb])
-                {
-                    case FREE: if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-                        m_ueStats.freeRessources++;
-                        m_ressourceStats.freeRessources_UL++;
-                    }
-                    else{
-                        //stats.freeRessources_DL++;
-                        m_ressourceStats.freeRessources_DL++;
-                    }
-                        break;
-                    case PRACH: m_ressourceStats.PrachRessources++;
-                        break;
-                    case RESERVED: m_ressourceStats.ControlRessources++;
-                        break;
-                    case CORESET: m_ressourceStats.PdcchRessources++;
-                        break;
-                    case SCH_CORESET: m_ressourceStats.PdcchUsed++;
-                        break;
-                    case PUCCH: m_ressourceStats.PucchRessources++;
-                        break;
-                    case SCH_MSG3: m_ressourceStats.usedRessources_UL++;
-                        break;
-                    
-                    case PBCH: m_ressourceStats.ControlRessources++;
-                        break;
-                    default:
-                        //no reserved ressources -> schedueled Data
-                        if(m_ressourcen[i][rb] > 0) //sanity check
-                        {
-                            if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-                            //m_ueStats.UlUsageArr[m_rntiMap.at(m_ressourcen[i][rb])]++;
-                                if(m_rntiMap.count(m_ressourcen[i][rb]) != 0)
-                                {
-                                    m_ueStats.ueResMap[m_rntiMap.at(m_ressourcen[i][rb])]++;
-                                    m_ressourceStats.usedRessources_UL++;
-                                }
-                                else{
-                                    m_ueStats.tmpResMap[m_ressourcen[i][rb]]++;
-                                    std::cout<<"Rnti "<< uint(m_ressourcen[i][rb]) << " nicht gefunden."<< std::endl; //abspeichern um die ressourcennutzung richtig zu bestimmen?
-                                }
-;
-                            }
-                            else{
-                            //stats.usedRessources_DL++;
-                            m_ressourceStats.usedRessources_DL++;
-                            }
-                        }
-                }
-            }
+            m_ueStats.AddUlUsage(m_rntiMap.at(it->first), it->second);
         }
+        m_ueStats.tmpResMap.clear();
+
+        //the frames of the current half which have already ended
+        uint64_t nowFrame = Simulator::Now().GetMilliSeconds()/10;
+        uint64_t elapsedFrames = nowFrame%(m_frameUsage.size()/2);
+        uint32_t firstFrame = (nowFrame-elapsedFrames)%m_frameUsage.size();
+        addFrameUsage(firstFrame, firstFrame+elapsedFrames);
     }
 
     void
     NrMacSchedulerRessourceManager::resetRessourceGrid()
     {
-        
         size_t i =  (Simulator::Now().GetMilliSeconds()*m_numSlots/10*m_numSym +m_ressourceWindowElements/2) %m_ressourceWindowElements;
         
         size_t endIndex = i+ m_ressourceWindowElements/2;
-        while(i < endIndex)
+        for(; i < endIndex; i += m_symPerFrame)
         {
-                                          
-            for(uint16_t rb = 0; rb< m_ressourcen[0].size();rb++)
-            {   
-                if(m_ressourcen[i][rb]>0 ||m_ressourcen[i][rb] == SCH_MSG3 )
-                {
-                        m_ressourcen[i][rb] =0;
-                }
-                else if(m_ressourcen[i][rb] == SCH_CORESET )
-                {
-                        m_ressourcen[i][rb] = CORESET;
-                }
-            } 
-            ++i;
+            //frames without scheduled ressources do not have to be touched
+            const FrameRessourceUsage& usage = m_frameUsage[i/m_symPerFrame];
+            if(usage.ulDataRessources == 0 && usage.stats.usedRessources_DL == 0 && usage.stats.usedRessources_UL == 0 && usage.stats.PdcchUsed == 0)
+            {
+                continue;
+            }
+            for(size_t sym = i; sym < i+m_symPerFrame; ++sym)
+            {
+                for(uint16_t rb = 0; rb< m_ressourcen.GetNumRb();rb++)
+                {   
+                    if(m_ressourcen.Get(sym, rb)>0 ||m_ressourcen.Get(sym, rb) == SCH_MSG3 )
+                    {
+                            setRessource(sym, rb, 0);
+                    }
+                    else if(m_ressourcen.Get(sym, rb) == SCH_CORESET )
+                    {
+                            setRessource(sym, rb, CORESET);
+                    }
+                } 
+            }
         }
       
     }
@@ -366,18 +442,18 @@ namespace ns3
         size_t bufferOffset = m_ressourceWindowSize *m_numSlots * m_numSym/10;
         while(i < m_resBufferSize  *m_numSlots * m_numSym/10)
         {
-            for(uint16_t rb = 0; rb< m_ressourcen[0].size();++rb)
+            for(uint16_t rb = 0; rb< m_ressourcen.GetNumRb();++rb)
             {   
 
-                if(m_ressourcen[i+bufferOffset][rb]>0 ||m_ressourcen[i+bufferOffset][rb] == SCH_MSG3 )
+                if(m_ressourcen.Get(i+bufferOffset, rb)>0 ||m_ressourcen.Get(i+bufferOffset, rb) == SCH_MSG3 )
                 {
-                    m_ressourcen[i][rb] = m_ressourcen[i+bufferOffset][rb];
-                    m_ressourcen[i+bufferOffset][rb] = 0;
+                    setRessource(i, rb, m_ressourcen.Get(i+bufferOffset, rb));
+                    setRessource(i+bufferOffset, rb, 0);
                 }
-                else if(m_ressourcen[i+bufferOffset][rb] == SCH_CORESET )
+                else if(m_ressourcen.Get(i+bufferOffset, rb) == SCH_CORESET )
                 {
-                    m_ressourcen[i][rb] = SCH_CORESET;
-                    m_ressourcen[i+bufferOffset][rb] = CORESET;
+                    setRessource(i, rb, SCH_CORESET);
+                    setRessource(i+bufferOffset, rb, CORESET);
                 }
             } 
             ++i;
@@ -395,7 +471,7 @@ namespace ns3
 
         size_t i =0; //i zeit, j frequenzen
         size_t slotNumber= 0;
-        while(i < m_ressourcen.size())
+        while(i < m_ressourcen.GetNumRows())
         {
             slotNumber = i/m_numSym;  
             if(m_pattern[slotNumber%m_pattern.size()] == ns3::DL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F ||m_pattern[slotNumber%m_pattern.size()] == ns3::S)
@@ -404,7 +480,7 @@ namespace ns3
                 {   
                     for(uint8_t symNum = 0; symNum < coresetSymbols; ++symNum )
                     {
-                        m_ressourcen[i+symNum][rb] = CORESET;
+                        setRessource(i+symNum, rb, CORESET);
                     }     
                 } 
             }
@@ -415,7 +491,7 @@ namespace ns3
                 {   
                     for(uint8_t symNum = 13; symNum < m_numSym; ++symNum )
                     {
-                        m_ressourcen[i+symNum][rb] = PUCCH;
+                        setRessource(i+symNum, rb, PUCCH);
                     }
                 }  
             }
@@ -450,11 +526,11 @@ namespace ns3
 
         if(!Msg3 &&bwpIndex<m_numBwp-2)
         {
-            if(m_numSym -1 - (res->StartSymbol + res->NumberSymbols) < freeSymbolsMap.at(bwpIndex) )
+            if(m_numSym -1 - (res->StartSymbol + res->NumberSymbols) < m_freeSymbols.Get(bwpIndex) )
             {
-                //std::cout<<"freeSymbolsMap at "<< uint(bwpIndex) << " reduced to " <<uint(m_numSym -1 - (res->StartSymbol + res->NumberSymbols))<<"from "<<uint(freeSymbolsMap.at(bwpIndex))<<"|"<<sfnSf<<std::endl;
-                freeSymbolsMap.at(bwpIndex) = m_numSym -1 - (res->StartSymbol + res->NumberSymbols);
-                NS_ASSERT(freeSymbolsMap.at(bwpIndex) >=0&&freeSymbolsMap.at(bwpIndex)<=14);
+                //std::cout<<"m_freeSymbols at "<< uint(bwpIndex) << " reduced to " <<uint(m_numSym -1 - (res->StartSymbol + res->NumberSymbols))<<"from "<<uint(m_freeSymbols.Get(bwpIndex))<<"|"<<sfnSf<<std::endl;
+                m_freeSymbols.Set(bwpIndex, m_numSym -1 - (res->StartSymbol + res->NumberSymbols));
+                NS_ASSERT(m_freeSymbols.Get(bwpIndex)<=14);
             }
 
         }
@@ -530,12 +606,7 @@ namespace ns3
 
         if(advanced_scheduling)
         {   
-            std::vector<uint8_t> consideredBwps(m_numBwp-2);
-            for(size_t i = 0; i<consideredBwps.size();++i)
-            {
-                consideredBwps[i]=i;
-            }
-            findOptimalScheduling(numRB,consideredBwps,res,bwpIndex,slotType);
+            findOptimalScheduling(numRB,0,m_numBwp-2,res,bwpIndex,slotType);
             if(res->NumberRB>0&&res->NumberSymbols>0)
             {   
                 markRessources(res,ue,slotnumber);
@@ -583,11 +654,19 @@ namespace ns3
                     else{
                         counter =0;
                     }
+                    //a symbol without free rb in this bwp only resets the counters. Skip it with the occupancy bitmap instead of scanning it
+                    if(numRB >0 && !(counter> 0 && uint(usedSymbols) == 0)
+                        && m_ressourcen.CountFree(i+symNum, bwpRessourceMap.at(bwpIndex).getLowerBorder(), bwpRessourceMap.at(bwpIndex).getUpperBorder()) == 0)
+                    {
+                        counter=0;
+                        usedSymbols=0;
+                        continue;
+                    }
                     for(uint16_t rb = bwpRessourceMap.at(bwpIndex).getLowerBorder(); rb<= bwpRessourceMap.at(bwpIndex).getUpperBorder();rb++ )
                     {
                         //NS_LOG_DEBUG(rb);
                         //find free ressources
-                        if( m_ressourcen[i+symNum][rb] == 0)
+                        if( m_ressourcen.Get(i+symNum, rb) == 0)
                         {
                             ++counter;
                         }
@@ -598,7 +677,7 @@ namespace ns3
                                 ++usedSymbols;
                                 uint16_t endRB;
                                 uint16_t startSym;
-                                if(rb == 0)
+                                if(rb == bwpRessourceMap.at(bwpIndex).getLowerBorder())
                                 {
                                     endRB= bwpRessourceMap.at(bwpIndex).getUpperBorder();
                                     startSym = symNum-1;
@@ -610,15 +689,7 @@ namespace ns3
 
                                 while(startSym + uint(usedSymbols)<m_numSym && usedSymbols*counter < numRB)
                                 {
-                                    bool SymbolFree = true;
-                                    for(uint index = 0; index < counter ; ++index)
-                                    {
-                                        if(m_ressourcen[i+startSym+usedSymbols][endRB-index] != 0 )
-                                        {
-                                            SymbolFree =false;
-                                        }
-
-                                    }
+                                    bool SymbolFree = m_ressourcen.IsRangeFree(i+startSym+usedSymbols, endRB-counter+1, counter);
                                     if(SymbolFree) {usedSymbols++;}
                                     else{
                                         break; //schedule all free ressources. Ressources might be occupied by PBCH
@@ -629,7 +700,7 @@ namespace ns3
                                 {
                                     for( uint8_t i_schedSymbol= 0;i_schedSymbol<usedSymbols; ++i_schedSymbol)
                                     {
-                                        m_ressourcen[i+startSym+i_schedSymbol][endRB-markCounter] = ue;
+                                        setRessource(i+startSym+i_schedSymbol, endRB-markCounter, ue);
                                     }
                                 }
                                 
@@ -637,7 +708,7 @@ namespace ns3
                                 uint8_t resSubframenumber = (int)(slotnumber/pow(2,m_numerology))%10;
                                 uint8_t resSlotNumber = slotnumber%(int)(pow(2,m_numerology));
 
-                                std::vector<uint8_t> rbgmask;
+                                RbgBitmask rbgmask;
                         
                         
                                 rbgmask = createRBGmask(bwpIndex,counter,endRB-counter+1,usedSymbols,startSym);
@@ -669,16 +740,7 @@ namespace ns3
                                 while(uint(symNum) + usedSymbols<m_numSym && usedSymbols*rbToSchedule < numRB)
                                 {
 
-                                    bool SymbolFree = true;
-                                    
-                                    for(uint index = 0; index < rbToSchedule ; ++index)
-                                    {
-                                        if(m_ressourcen[i+symNum+usedSymbols][rb-index] != 0 )
-                                        {
-                                            SymbolFree =false;
-                                        }
-
-                                    }
+                                    bool SymbolFree = m_ressourcen.IsRangeFree(i+symNum+usedSymbols, rb-rbToSchedule+1, rbToSchedule);
                                     if(SymbolFree) {usedSymbols++;}
                                     else{
                                         break; //schedule all free ressources. Ressources might be occupied by PBCH
@@ -690,7 +752,7 @@ namespace ns3
                                 {
                                     for( uint8_t i_schedSymbol= 0;i_schedSymbol<usedSymbols; ++i_schedSymbol)
                                     {
-                                        m_ressourcen[i+symNum+i_schedSymbol][rb-markCounter] = ue;
+                                        setRessource(i+symNum+i_schedSymbol, rb-markCounter, ue);
                                     }
                                 }
                                 
@@ -699,7 +761,7 @@ namespace ns3
                                 uint8_t resSubframenumber = (int)(slotnumber/pow(2,m_numerology))%10;
                                 uint8_t resSlotNumber = slotnumber%(int)(pow(2,m_numerology));
 
-                                std::vector<uint8_t> rbgmask;
+                                RbgBitmask rbgmask;
                         
                                 rbgmask = createRBGmask(bwpIndex,rbToSchedule,rb-rbToSchedule+1,usedSymbols,symNum);
                                 res->Framenumber = resFramenumber;
@@ -746,7 +808,7 @@ namespace ns3
                                 {
                                     for( uint8_t i_schedSymbol= 0;i_schedSymbol<usedSymbols; ++i_schedSymbol)
                                     {
-                                        m_ressourcen[i+symNum-i_schedSymbol][bwpRessourceMap.at(bwpIndex).getLowerBorder()+markCounter] = ue;
+                                        setRessource(i+symNum-i_schedSymbol, bwpRessourceMap.at(bwpIndex).getLowerBorder()+markCounter, ue);
                                     }
                                 }
 
@@ -756,7 +818,7 @@ namespace ns3
                                 for(uint markCounter = 0;markCounter < numRB; ++markCounter )
                                 {
 
-                                 m_ressourcen[i+symNum][rb-numRB+markCounter+1] = ue;
+                                 setRessource(i+symNum, rb-numRB+markCounter+1, ue);
                                 
                                 }
                             }
@@ -765,7 +827,7 @@ namespace ns3
                             uint8_t resSubframenumber = (int)(slotnumber/pow(2,m_numerology))%10;
                             uint8_t resSlotNumber = slotnumber%(int)(pow(2,m_numerology));
 
-                            std::vector<uint8_t> rbgmask;
+                            RbgBitmask rbgmask;
                             if(schSymbols ==1){
                                 rbgmask = createRBGmask(bwpIndex,numRB,rb-numRB+1,schSymbols,symNum);
                                 NS_ASSERT(rb-numRB+1 >= 0);
@@ -878,14 +940,14 @@ namespace ns3
                             {
                                 for( int i_schedSymbol= 0;i_schedSymbol<usedSymbols; ++i_schedSymbol)
                                 {
-                                    m_ressourcen[i+symNum-i_schedSymbol][bwpRessourceMap.at(bwpIndex).getLowerBorder()+markCounter] = ue;
+                                    setRessource(i+symNum-i_schedSymbol, bwpRessourceMap.at(bwpIndex).getLowerBorder()+markCounter, ue);
                                 }
                             }
                             uint32_t resFramenumber = slotnumber/pow(2,m_numerology)/10;
                             uint8_t resSubframenumber = (int)(slotnumber/pow(2,m_numerology))%10;
                             uint8_t resSlotNumber = slotnumber%(int)(pow(2,m_numerology));
 
-                            std::vector<uint8_t> rbgmask;
+                            RbgBitmask rbgmask;
                             rbgmask = createRBGmask(bwpIndex,bwInRBG,bwpRessourceMap.at(bwpIndex).getLowerBorder(),usedSymbols,symNum);
                             res->Framenumber = resFramenumber;
                             res->Subframenumber = resSubframenumber;
@@ -915,7 +977,7 @@ namespace ns3
                     {
                         //NS_LOG_DEBUG(rb);
                         //find free ressources
-                        if( m_ressourcen[i+symNum][rb] == 0)
+                        if( m_ressourcen.Get(i+symNum, rb) == 0)
                         {
                             ++counter;
                         }
@@ -940,14 +1002,14 @@ namespace ns3
                                 {
                                     for( int i_schedSymbol= 0;i_schedSymbol<usedSymbols; ++i_schedSymbol)
                                     {
-                                        m_ressourcen[i+symNum-i_schedSymbol-1][bwpRessourceMap.at(bwpIndex).getLowerBorder()+markCounter] = ue;
+                                        setRessource(i+symNum-i_schedSymbol-1, bwpRessourceMap.at(bwpIndex).getLowerBorder()+markCounter, ue);
                                     }
                                 }
                                 uint32_t resFramenumber = slotnumber/pow(2,m_numerology)/10;
                                 uint8_t resSubframenumber = (int)(slotnumber/pow(2,m_numerology))%10;
                                 uint8_t resSlotNumber = slotnumber%(int)(pow(2,m_numerology));
 
-                                std::vector<uint8_t> rbgmask;
+                                RbgBitmask rbgmask;
                                 rbgmask = createRBGmask(bwpIndex,bwInRBG,bwpRessourceMap.at(bwpIndex).getLowerBorder(),usedSymbols-1,symNum);
                                 res->Framenumber = resFramenumber;
                                 res->Subframenumber = resSubframenumber;
@@ -980,24 +1042,15 @@ namespace ns3
     }
 
     void 
-    NrMacSchedulerRessourceManager::findOptimalScheduling(uint32_t numRB, std::vector<uint8_t> consideredBwps, RessourceSet* maxRes, uint16_t bwpIndex, LteNrTddSlotType slotType )
+    NrMacSchedulerRessourceManager::findOptimalScheduling(uint32_t numRB, uint8_t firstBwp, uint8_t endBwp, RessourceSet* maxRes, uint16_t bwpIndex, LteNrTddSlotType slotType )
     {
-        if(consideredBwps.size()>0)
+        //considered are the bwps in [firstBwp, endBwp). The range is split at the bwp with the most free symbols without copying it
+        if(firstBwp < endBwp)
         {
             //std::cout<<"startMax: "<<uint(maxRes->StartRB)<<","<<uint(maxRes->NumberRB)<<","<<uint(maxRes->StartSymbol)<<","<<uint(maxRes->NumberSymbols)<<std::endl;
-            uint8_t maxSym = 0;
-            uint8_t maxIndex = 0;
-
             //get index of bwp with highes number of free symbols
-            for(std::vector<uint8_t>::iterator it = consideredBwps.begin(); it != consideredBwps.end(); ++it)
-            {
-                //std::cout<<"maxSymtest:"<<uint(freeSymbolsMap.at(*it))<<std::endl;
-                if(freeSymbolsMap.at(*it)>maxSym)
-                {
-                    maxSym=freeSymbolsMap.at(*it);
-                    maxIndex = std::distance(consideredBwps.begin(),it);
-                }
-            }
+            uint8_t maxBwp = m_freeSymbols.GetMaxBwp(firstBwp,endBwp);
+            uint8_t maxSym = m_freeSymbols.Get(maxBwp);
 
             if(maxSym == 0)
             {
@@ -1005,9 +1058,9 @@ namespace ns3
             }
 
             //calculate amount of connected ressources. 
-            uint8_t index = maxIndex+1;
+            uint8_t index = maxBwp+1;
             uint16_t rb= maxSym*51; //length of bwp(51) hardcoded for now 
-            while(index<consideredBwps.size() &&freeSymbolsMap.at(consideredBwps[index]) ==maxSym)
+            while(index<endBwp &&m_freeSymbols.Get(index) ==maxSym)
             {
                 rb +=maxSym*51; //length of bwp(51) hardcoded for now 
                 ++index;
@@ -1016,15 +1069,15 @@ namespace ns3
             if(maxRes == nullptr || rb > (maxRes->NumberRB *  maxRes->NumberSymbols) )
             {
                 //maxRes
-                maxRes->StartRB=bwpRessourceMap.at(consideredBwps[maxIndex]).getLowerBorder();
+                maxRes->StartRB=bwpRessourceMap.at(maxBwp).getLowerBorder();
                 maxRes->NumberRB = rb/maxSym; //length of bwp(51) hardcoded for now 
-                NS_ASSERT_MSG(m_numSym>=freeSymbolsMap.at(consideredBwps[maxIndex])+uint(1),"Not enough free symbols available. There is something wrong with maxRes.");
+                NS_ASSERT_MSG(m_numSym>=m_freeSymbols.Get(maxBwp)+uint(1),"Not enough free symbols available. There is something wrong with maxRes.");
                 if(slotType == LteNrTddSlotType::DL) 
                 {
-                    maxRes->StartSymbol=m_numSym -freeSymbolsMap.at(consideredBwps[maxIndex]);
+                    maxRes->StartSymbol=m_numSym -m_freeSymbols.Get(maxBwp);
                 }
                 else{
-                    maxRes->StartSymbol=m_numSym -freeSymbolsMap.at(consideredBwps[maxIndex])-1;
+                    maxRes->StartSymbol=m_numSym -m_freeSymbols.Get(maxBwp)-1;
                 }
                 maxRes->NumberSymbols = maxSym;
                 maxRes->rbgmask = createRBGmask(bwpIndex, maxRes->NumberRB,maxRes->StartRB,maxRes->NumberSymbols,maxRes->StartSymbol);
@@ -1048,17 +1101,12 @@ namespace ns3
                 
             }
             else{
-                std::vector<uint8_t> consideredBwpsLeft(consideredBwps.begin(),consideredBwps.begin()+maxIndex);
-                if(consideredBwps.begin()+maxIndex !=consideredBwps.end() )
-                {
-                    std::vector<uint8_t> consideredBwpsRight(consideredBwps.begin()+maxIndex+1,consideredBwps.end());
-                    findOptimalScheduling(numRB,consideredBwpsRight,maxRes, bwpIndex,slotType);
-                }
-
+                //search right of the bwp first, then left of it
+                findOptimalScheduling(numRB,maxBwp+1,endBwp,maxRes, bwpIndex,slotType);
                     
                 if(maxRes->NumberRB *  maxRes->NumberSymbols < numRB)
                 {
-                    findOptimalScheduling(numRB,consideredBwpsLeft,maxRes, bwpIndex,slotType);
+                    findOptimalScheduling(numRB,firstBwp,maxBwp,maxRes, bwpIndex,slotType);
                 }
             }    
         }
@@ -1070,20 +1118,25 @@ namespace ns3
         uint64_t slotIndex = slotNumber*m_numSym%m_ressourceWindowElements;
         for(uint8_t sym = res->StartSymbol; sym <res->NumberSymbols+res->StartSymbol; ++sym)
         {
+            if(m_ressourcen.IsRangeFree(slotIndex+sym, res->StartRB, res->NumberRB))
+            {
+                setRessourceRange(slotIndex+sym, res->StartRB, res->NumberRB, ue);
+                continue;
+            }
             for(uint16_t rb = res->StartRB ;rb < res->StartRB+res->NumberRB; ++rb )
             {
 
-                if(m_ressourcen[slotIndex+sym][rb] == 0)
+                if(m_ressourcen.Get(slotIndex+sym, rb) == 0)
                 {
-                    m_ressourcen[slotIndex+sym][rb] = ue;
+                    setRessource(slotIndex+sym, rb, ue);
                 }
                 else{
                     std::cout<<"Something is wrong with the advanced scheduling"<<std::endl;
                     std::cout<<"slotNumber: "<<slotNumber<<std::endl;
                     std::cout<<"sym: "<<uint(sym)<<std::endl;
                     std::cout<<"rb: "<<uint(rb)<<std::endl;
-                    std::cout<<"inSlot: "<<uint(m_ressourcen[slotIndex+sym][rb])<<std::endl;
-                    //std::cout<<m_ressourcen[slotIndex+sym][rb]<<std::endl;
+                    std::cout<<"inSlot: "<<uint(m_ressourcen.Get(slotIndex+sym, rb))<<std::endl;
+                    //std::cout<<m_ressourcen.Get(slotIndex+sym, rb)<<std::endl;
                 }
             }
 
@@ -1098,8 +1151,8 @@ namespace ns3
         uint8_t numBwp  = ceil(float(res->NumberRB)/51);
         for(uint8_t index = 0; index < numBwp; ++index)
         {
-            freeSymbolsMap.at(startBwp+index)-=res->NumberSymbols;
-            NS_ASSERT(freeSymbolsMap.at(startBwp+index) >=0&&freeSymbolsMap.at(startBwp+index)<=14);
+            m_freeSymbols.Set(startBwp+index, m_freeSymbols.Get(startBwp+index)-res->NumberSymbols);
+            NS_ASSERT(m_freeSymbols.Get(startBwp+index)<=14);
         }
     }
 
@@ -1113,29 +1166,27 @@ namespace ns3
 
         if(m_pattern[slotnumber%m_pattern.size()] == ns3::DL ||m_pattern[slotnumber%m_pattern.size()] == ns3::F ||m_pattern[slotnumber%m_pattern.size()] == ns3::S)
         {
-            for(uint index= 0; index<freeSymbolsMap.size();++index )
+            for(uint index= 0; index<m_freeSymbols.GetSize();++index )
             {
-                freeSymbolsMap.at(index)=m_numSym-coresetMap.at(index);
                 uint symIndex = coresetMap.at(index);
-                while(symIndex<uint(m_numSym) && m_ressourcen[(slotnumber*m_numSym+symIndex)%m_ressourceWindowElements][51*index] != 0 )
+                while(symIndex<uint(m_numSym) && !m_ressourcen.IsFree((slotnumber*m_numSym+symIndex)%m_ressourceWindowElements, 51*index) )
                 {
-                    --freeSymbolsMap.at(index);
                     ++symIndex;
                 }
+                m_freeSymbols.Set(index, m_numSym-symIndex);
             }
 
 
         }
         else{
-            for(uint index= 0; index<freeSymbolsMap.size();++index )
+            for(uint index= 0; index<m_freeSymbols.GetSize();++index )
             {
-                freeSymbolsMap.at(index)=13;
                 uint symIndex = 0;
-                while(symIndex<uint(m_numSym-1) && m_ressourcen[(slotnumber*m_numSym+symIndex)%m_ressourceWindowElements][51*index] != 0 )
+                while(symIndex<uint(m_numSym-1) && !m_ressourcen.IsFree((slotnumber*m_numSym+symIndex)%m_ressourceWindowElements, 51*index) )
                 {
-                    --freeSymbolsMap.at(index);
                     ++symIndex;
                 }
+                m_freeSymbols.Set(index, 13-symIndex);
             }
 
         }
@@ -1143,7 +1194,7 @@ namespace ns3
     }
 
 
-    std::vector<uint8_t>
+    RbgBitmask
     NrMacSchedulerRessourceManager::createRBGmask(uint8_t bwpIndex, uint16_t NumberRB,  uint16_t StartRB, uint8_t NumberSymbols, uint8_t StartSymbol)
     {
         NS_LOG_FUNCTION(this);
@@ -1153,7 +1204,7 @@ namespace ns3
 
         NS_ASSERT_MSG(lowerBorder <= StartRB &&  upperBorder >= StartRB+NumberRB-1, "BwpIndex:"<<uint(bwpIndex)<<",StartRB:"<<int(StartRB)<<"NumberRB:"<<uint(NumberRB)<<",StartSymbol:"<<uint(StartSymbol)<<",NumberSymbols:"<<uint(NumberSymbols));
 
-        std::vector<uint8_t> rbgBitmask = std::vector<uint8_t> (upperBorder-lowerBorder+1, 0);
+        RbgBitmask rbgBitmask(upperBorder-lowerBorder+1, 0);
 
          for (int32_t i = StartRB-lowerBorder; i < StartRB-lowerBorder+NumberRB; ++i)
         {
@@ -1164,33 +1215,15 @@ namespace ns3
 
     }
 
-    std::vector<std::vector<int>>
+    NrMacSchedulerSlotView
     NrMacSchedulerRessourceManager::getSlotRessources(uint8_t bwpIndex, const SfnSf sfn, LteNrTddSlotType type )
     {
         NS_LOG_FUNCTION(this);
-        std::vector<std::vector<int>> slotRes;
-        slotRes.resize(m_numSym, std::vector<int>());
         uint16_t rbSize = bwpRessourceMap.at(bwpIndex).getUpperBorder() -  bwpRessourceMap.at(bwpIndex).getLowerBorder() +1;
-        for (size_t i = 0; i < slotRes.size (); ++i)
-        {
-           slotRes[i].resize (rbSize, 0); 
-        }
         uint8_t slotsInSf = pow(2,m_numerology); 
-        //uint64_t index = (sfn.GetFrame()*slotsInSf*10 + sfn.GetSubframe()* slotsInSf + sfn.GetSlot()) *(m_numSym)%m_ressourceWindowElements;
         uint64_t index = ((sfn.GetFrame()*slotsInSf*10 + sfn.GetSubframe()* slotsInSf + sfn.GetSlot() )* m_numSym)%m_ressourceWindowElements;
-        // uint64_t index = Simulator::Now().GetMilliSeconds()%(m_ressourceWindowSize+m_resBufferSize) < m_ressourceWindowSize ?  
-        //     (sfn.GetFrame()*slotsInSf*10 + sfn.GetSubframe()* slotsInSf + sfn.GetSlot()) * m_numSym%m_ressourceWindowElements :  
-        //     (sfn.GetFrame()*slotsInSf*10 + sfn.GetSubframe()* slotsInSf + sfn.GetSlot()) * m_numSym%m_ressourceWindowElements+m_ressourceWindowElements ;
-        for(size_t i = 0; i < slotRes.size (); ++i)
-        {
-            for(size_t rb = 0; rb <rbSize; ++rb)
-            {
-                 slotRes[i][rb] = m_ressourcen[index+i][bwpRessourceMap.at(bwpIndex).getLowerBorder()+rb];
-            }
-        }
-        
-        //std::cout<<"got slot ressources"<<std::endl;
-        return slotRes;
+        //the symbols of a slot are consecutive rows of the grid, because the window is a multiple of a slot
+        return NrMacSchedulerSlotView(m_ressourcen.GetRowData(index) + bwpRessourceMap.at(bwpIndex).getLowerBorder(), m_ressourcen.GetNumRb(), m_numSym, rbSize);
     }
 
 
@@ -1213,7 +1246,7 @@ namespace ns3
         //     index = index+m_ressourceWindowElements;
         //     m_ressourceWindowElements TODO::
         // } 
-        int16_t ue = 0;
+        int32_t ue = 0;
         size_t bwpLowerBorder = bwpRessourceMap.at(bwpIndex).getLowerBorder(); 
         uint8_t dciSym =1;
         uint16_t startRb =0;
@@ -1222,12 +1255,12 @@ namespace ns3
         {
             for(size_t rb = 0; rb <rbSize; ++rb)
             {
-                if((m_ressourcen[index+symbol][bwpLowerBorder+rb] >0 || ue >0)  )
+                if((m_ressourcen.Get(index+symbol, bwpLowerBorder+rb) >0 || ue >0)  )
                 {
                     std::list<uint16_t>::iterator findIter = std::find(scheduledRntiList.begin(), scheduledRntiList.end(), ue);
 
                     bool alreadySchedueled = findIter != scheduledRntiList.end();
-                    if(m_ressourcen[index+symbol][bwpLowerBorder+rb] == ue&& !alreadySchedueled)
+                    if(m_ressourcen.Get(index+symbol, bwpLowerBorder+rb) == ue&& !alreadySchedueled)
                     {
                         ++numRB;
                         if(uint16_t(rb) == rbSize-1)
@@ -1247,7 +1280,7 @@ namespace ns3
 
                             dciSym = 1;
                             //count symbols for DCI
-                            while(m_ressourcen[index+symbol+dciSym][bwpLowerBorder+rb-1] ==ue && symbol+dciSym <m_numSym)
+                            while(symbol+dciSym <m_numSym && m_ressourcen.Get(index+symbol+dciSym, bwpLowerBorder+rb-1) ==ue)
                             {
                                 ++dciSym;                                
                             }
@@ -1282,7 +1315,7 @@ namespace ns3
                                     //mark used msg3Allocations as used -> This prevents the scheduler to create another dci for a regular transmission.
                                     for(uint8_t iRB =0; iRB<=rb;++iRB )
                                     {
-                                        m_ressourcen[index+symbol][rb-iRB] = RessourceAllocationStatus::SCH_MSG3;
+                                        setRessource(index+symbol, rb-iRB, RessourceAllocationStatus::SCH_MSG3);
                                     }
                                 }
                                 dciVector.emplace_back(dci);
@@ -1308,8 +1341,11 @@ namespace ns3
                             NS_LOG_DEBUG("UE "<<ue<<" found:"<<foundUe);
 
                             dciSym = 1;
+                            //a run which ended with the last rb of the bwp is only closed in the next symbol
+                            uint8_t runSymbol = rb > 0 ? symbol : symbol-1;
+                            size_t runEndRb = rb > 0 ? bwpLowerBorder+rb-1 : bwpLowerBorder+rbSize-1;
                             //count symbols for DCI
-                            while(m_ressourcen[index+symbol+dciSym][bwpLowerBorder+rb-1] ==ue && symbol+dciSym <m_numSym)
+                            while(runSymbol+dciSym <m_numSym && m_ressourcen.Get(index+runSymbol+dciSym, runEndRb) ==ue)
                             {
                                 ++dciSym;
                             }
@@ -1335,7 +1371,7 @@ namespace ns3
                                     }
                                     NS_FATAL_ERROR("Scheduled RNTI "<<ue<<" twice in a slot.");
                                 }
-                                dci = createSingleDCI(ue,symbol,dciSym,startRb,numRB,bwpIndex, m_Amc ,ueInfo, type);
+                                dci = createSingleDCI(ue,runSymbol,dciSym,startRb,numRB,bwpIndex, m_Amc ,ueInfo, type);
                                 // std::cout<<"DcI tbsize: "<<dci->m_tbSize[0] << std::endl;
                                 // std::cout<<uint(dci->m_numSym)<<std::endl;
                                 if(ueInfo->transmitMsg3)
@@ -1343,7 +1379,7 @@ namespace ns3
                                     //mark used msg3Allocations as used -> This prevents the scheduler to create another dci for a regular transmission.
                                     for(uint8_t iRB =1; iRB<=rb;++iRB )
                                     {
-                                        m_ressourcen[index+symbol][rb-iRB] = RessourceAllocationStatus::SCH_MSG3;
+                                        setRessource(index+symbol, rb-iRB, RessourceAllocationStatus::SCH_MSG3);
                                     }
                                 }
                                 dciVector.emplace_back(dci);
@@ -1352,7 +1388,7 @@ namespace ns3
                             }
 
                         }
-                        ue = m_ressourcen[index+symbol][bwpLowerBorder+rb];
+                        ue = m_ressourcen.Get(index+symbol, bwpLowerBorder+rb);
                         startRb = bwpLowerBorder+rb;
                         numRB =1;
                     }
@@ -1377,7 +1413,7 @@ namespace ns3
         uint8_t harq =0;
         uint8_t tpc =1;
         std::vector<uint32_t> m_tbs;
-        std::vector<uint8_t> rbgmask;
+        RbgBitmask rbgmask;
         //std::cout<<"rnti:"<<rnti<<",NumRb: "<<NumRB<<",startRb:"<<startRb<<",symNum:"<<uint(symNum)<<",StartSymbol:"<<uint(StartSymbol)<<std::endl;
         NS_ASSERT(StartSymbol+symNum<=14);
 
@@ -1410,7 +1446,7 @@ namespace ns3
         }
     
     
-        std::shared_ptr<DciInfoElementTdma> dci = std::make_shared<DciInfoElementTdma>(rnti,
+        std::shared_ptr<DciInfoElementTdma> dci = NrMemoryPool::MakeShared<DciInfoElementTdma>(rnti,
             dciFormat,
             StartSymbol,
             symNum,
@@ -1475,8 +1511,13 @@ namespace ns3
 
         for(uint i = bwpRessourceMap.at(bwpID).getLowerBorder(); i<bwpRessourceMap.at(bwpID).getUpperBorder();++i )
         {
-            if(m_ressourcen[indexSlot][i]== RessourceAllocationStatus::CORESET)
+            if(m_ressourcen.Get(indexSlot, i)== RessourceAllocationStatus::CORESET)
             {
+                if(i+numRB > m_ressourcen.GetNumRb())
+                {
+                    //the CCE would end behind the carrier
+                    break;
+                }
                 //we know that the whole CCE of the Coreset is usable from the implementation
                 //mark used Coreset ressource
                 if(!reserve)
@@ -1488,7 +1529,7 @@ namespace ns3
                     for(uint8_t symNum =0; symNum <coresetMap.at(bwpID);++symNum)
                     {
 
-                        m_ressourcen[indexSlot+symNum][i+rb] = SCH_CORESET;
+                        setRessource(indexSlot+symNum, i+rb, SCH_CORESET);
                     }
 
                 }
@@ -1595,7 +1636,7 @@ namespace ns3
         {   
             for(uint16_t rb = bwpRessourceMap.at(bwpID).getLowerBorder(); rb<= bwpRessourceMap.at(bwpID).getUpperBorder();rb++ )
             {
-                if( m_ressourcen[i+symNum][rb] == rnti)
+                if( m_ressourcen.Get(i+symNum, rb) == rnti)
                 {
                     std::cout<<"RNTI "<<rnti<<" got already ressources in Slot "<<slotnumber<<std::endl;
                     return true;
@@ -1663,7 +1704,9 @@ namespace ns3
         std::ofstream logfile;
         logfile.open (logfile_path, std::ios::out | std::ios::trunc);
         uint8_t slotsInSF = pow(2,m_numerology);
-        for (uint64_t i = 0; i < (Simulator::Now().GetMilliSeconds ())*m_numSym*slotsInSF; ++i)
+        uint64_t nowIndex = (Simulator::Now().GetMilliSeconds ())*m_numSym*slotsInSF;
+        //only the symbols since the last change of the ressource window are still in the grid
+        for (uint64_t i = nowIndex - nowIndex%(m_ressourceWindowElements/2); i < nowIndex; ++i)
         {
             //add slotnumber to log
             if(i%m_numSym ==0 )
@@ -1674,7 +1717,7 @@ namespace ns3
             }
              for (int64_t rb = 0; rb <51*(m_numBwp-2);++rb)
             {
-                logfile << " "<< m_ressourcen[i][rb];     
+                logfile << " "<< m_ressourcen.Get(i%m_ressourceWindowElements, rb);     
             }
     
              logfile << "\r\n";
@@ -1694,7 +1737,7 @@ namespace ns3
         //PDCCH capacity
         logfile_path = m_logDir +"_PDCCH_Usage.log";
         logfile.open (logfile_path, std::ios::out | std::ios::trunc);
-        for (uint64_t slot = 0; slot < uint64_t((Simulator::Now().GetMilliSeconds ())*slotsInSF); ++slot)
+        for (uint64_t slot = (nowIndex - nowIndex%(m_ressourceWindowElements/2))/m_numSym; slot < uint64_t((Simulator::Now().GetMilliSeconds ())*slotsInSF); ++slot)
         {
             if(m_pattern[slot%m_pattern.size()] == ns3::DL)
             {
@@ -1707,7 +1750,7 @@ namespace ns3
                     
                     for (int64_t rb = 51*bwpId; rb <51*(bwpId+1);rb+=dciRb)
                     {
-                        switch(m_ressourcen[slot*m_numSym][rb])
+                        switch(m_ressourcen.Get(slot*m_numSym%m_ressourceWindowElements, rb))
                         {
                             case SCH_CORESET: ++counterPdcchUsed;
                                 break;
@@ -1735,53 +1778,31 @@ namespace ns3
     {
         NS_LOG_FUNCTION(this);
         RessourceUsageStats stats;
-        uint8_t slotsInSF = pow(2,m_numerology);
-        uint64_t startIndex = endInitialization * m_numSym * slotsInSF;
-        uint64_t slotNumber =0;
-        for (uint64_t i = startIndex; i < (Simulator::Now().GetMilliSeconds ()-followUpTime)*m_numSym*slotsInSF; ++i)
+        uint64_t nowMs = Simulator::Now().GetMilliSeconds();
+        if(nowMs < followUpTime)
         {
-            slotNumber = i/m_numSym; 
-            for (int64_t rb = 0; rb <51*(m_numBwp-2);++rb)
-            {
-                switch(m_ressourcen[i][rb])
-                {
-                    case FREE: if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-                        stats.freeRessources_UL++;
-                    }
-                    else{
-                        stats.freeRessources_DL++;
-                    }
-                        break;
-                    case PRACH: stats.PrachRessources++;
-                        break;
-                    case RESERVED: stats.ControlRessources++;
-                        break;
-                    case CORESET: stats.PdcchRessources++;
-                        break;
-                    case SCH_CORESET: stats.PdcchUsed++;
-                        break;
-                    case PUCCH: stats.PucchRessources++;
-                        break;
-                    case SCH_MSG3: stats.usedRessources_UL++;
-                        break;
-                    
-                    case PBCH: stats.ControlRessources++;
-                        break;
-                    
-                    default:
-                        //no reserved ressources -> schedueled Data
-                        if(m_ressourcen[i][rb] > 0) //sanity check
-                        {
-                            if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-                                stats.usedRessources_UL++;
-                            }
-                            else{
-                                stats.usedRessources_DL++;
-                            }
-                        }
-                }
-            }
+            return stats;
+        }
+        //the ring buffer only holds the frames since the last change of the ressource window,
+        //so the interval is taken from the snapshots of the cumulative counters
+        uint64_t lastFrame = m_cumulativeUsage.size()-1;
+        uint64_t firstFrame = std::min<uint64_t>((endInitialization+9)/10, lastFrame);
+        uint64_t endFrame = std::min<uint64_t>((nowMs-followUpTime)/10, lastFrame);
+        if(endFrame <= firstFrame)
+        {
+            return stats;
         }
+        const RessourceUsageStats& first = m_cumulativeUsage[firstFrame];
+        const RessourceUsageStats& end = m_cumulativeUsage[endFrame];
+        stats.PdcchRessources = end.PdcchRessources - first.PdcchRessources;
+        stats.PdcchUsed = end.PdcchUsed - first.PdcchUsed;
+        stats.PucchRessources = end.PucchRessources - first.PucchRessources;
+        stats.freeRessources_DL = end.freeRessources_DL - first.freeRessources_DL;
+        stats.freeRessources_UL = end.freeRessources_UL - first.freeRessources_UL;
+        stats.usedRessources_UL = end.usedRessources_UL - first.usedRessources_UL;
+        stats.usedRessources_DL = end.usedRessources_DL - first.usedRessources_DL;
+        stats.PrachRessources = end.PrachRessources - first.PrachRessources;
+        stats.ControlRessources = end.ControlRessources - first.ControlRessources;
         return stats;
     }
     
@@ -1807,7 +1828,7 @@ namespace ns3
         //     slotNumber = i/m_numSym; 
         //     for (int64_t rb = 0; rb <51*(m_numBwp-2);++rb)
         //     {
-        //         switch(m_ressourcen[i][rb])
+        //         switch(m_ressourcen.Get(i, rb))
         //         {
         //             case FREE: if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
         //                 UeStats.freeRessources++;
@@ -1819,10 +1840,10 @@ namespace ns3
                     
         //             default:
         //                 //no reserved ressources -> schedueled Data
-        //                 if(m_ressourcen[i][rb] > 0) //sanity check
+        //                 if(m_ressourcen.Get(i, rb) > 0) //sanity check
         //                 {
         //                     if(m_pattern[slotNumber%m_pattern.size()] == ns3::UL ||m_pattern[slotNumber%m_pattern.size()] == ns3::F){
-        //                     UeStats.UlUsageArr[m_rntiMap.at(m_ressourcen[i][rb])]++;
+        //                     UeStats.UlUsageArr[m_rntiMap.at(m_ressourcen.Get(i, rb))]++;
         //                     }
         //                     else{
         //                     //stats.usedRessources_DL++;
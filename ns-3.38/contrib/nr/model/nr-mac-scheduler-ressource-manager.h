@@ -1,10 +1,12 @@
 #include <ns3/object.h>
+#include <ns3/traced-callback.h>
 #include <string> 
 #include <functional>
 #include <memory>
 #include <vector>
 #include <ns3/nr-control-messages.h>
 #include "nr-mac-scheduler-ns3.h"
+#include "nr-mac-scheduler-ressource-grid.h"
 #include "nr-phy-sap.h"
 
 #ifndef HEADER_RessourceManagaer
@@ -36,7 +38,7 @@ namespace ns3 {
         uint8_t NumberSymbols;
         uint32_t StartRB;
         uint16_t NumberRB;
-        std::vector<uint8_t> rbgmask;
+        RbgBitmask rbgmask;
 
     };
 
@@ -79,28 +81,38 @@ namespace ns3 {
         uint64_t ControlRessources{0};
     };
 
+    //usage counters of one 10ms frame of the ressource grid. usedRessources_UL only holds the Msg3 ressources,
+    //the UL data is counted per rnti because the rnti might not be assigned to a ue yet
+    struct FrameRessourceUsage
+    {
+        RessourceUsageStats stats;
+        uint64_t ulDataRessources{0};
+        std::vector<uint64_t> ulRntiUsage; //UL data ressources indexed by rnti
+    };
+
     struct UeRessourceUsage
     {
-        uint64_t* UlUsageArr;  // Zeiger auf ein dynamisches Array
-        uint64_t ArrSize;    // Größe des Arrays
+        std::vector<uint64_t> UlUsageArr; //UL data ressources indexed by imsi
         uint64_t freeRessources{0};
-        std::map<uint32_t,uint64_t> ueResMap;
         std::map<uint32_t,uint64_t> tmpResMap; //used for exceptional cases where the rnti is not assigned to a ue
-    
 
-    // Konstruktor zum Initialisieren
-    UeRessourceUsage(uint64_t numDevices) : ArrSize(numDevices) {
-        UlUsageArr = new uint64_t[ArrSize](); // Dynamisches Array der angegebenen Größe
-    }
+        UeRessourceUsage() = default;
+
+        UeRessourceUsage(uint64_t numDevices) : UlUsageArr(numDevices, 0) {}
 
-    UeRessourceUsage() {
-        //UlUsageArr = new uint64_t[ArrSize](); // Dynamisches Array der angegebenen Größe
-    }
+        uint64_t GetUlUsage(uint64_t imsi) const
+        {
+            return imsi < UlUsageArr.size() ? UlUsageArr[imsi] : 0;
+        }
 
-    // // Destruktor zum Freigeben des Speichers
-    ~UeRessourceUsage() {
-        //delete[] UlUsageArr;
-    }
+        void AddUlUsage(uint64_t imsi, uint64_t ressources)
+        {
+            if(imsi >= UlUsageArr.size())
+            {
+                UlUsageArr.resize(imsi+1, 0);
+            }
+            UlUsageArr[imsi] += ressources;
+        }
     };
 
     class NrMacSchedulerRessourceManager : public Object
@@ -108,9 +120,21 @@ namespace ns3 {
         
         public:
 
+        static TypeId GetTypeId();
+        TypeId GetInstanceTypeId() const override;
+
+        /**
+         * TracedCallback signature for the ressource usage of a frame.
+         *
+         * \param [in] frameNumber number of the frame since the start of the simulation
+         * \param [in] stats ressource usage of the frame
+         */
+        typedef void (*FrameUsageTracedCallback)(uint64_t frameNumber, const RessourceUsageStats& stats);
+
         NrMacSchedulerRessourceManager( std::string pattern, uint8_t numerology, uint16_t simTime,uint32_t initTime, std::string logDir,uint8_t  bwpCount, bool use5Mhz);
         void reserveSystemInformations(uint8_t  bwpCount);
         void reservePrachRessources(NrPhySapProvider::PrachConfig);
+        void endOfFrame();
         void changeRessourceWindow();
         void resetRessourceGrid();
         void collectResUsage();
@@ -128,12 +152,12 @@ namespace ns3 {
         RessourceSet* scheduleData(uint16_t, uint16_t, uint32_t,LteNrTddSlotType,bool , const SfnSf& sfnSf, RessourceSet* res );
         RessourceSet* scheduleCompleteSlot(uint16_t bwpIndex,uint16_t ue,uint32_t numRB, LteNrTddSlotType slotType, bool Msg3,RessourceSet* res,uint64_t slotnumber);
         RessourceSet* schedulePartPacket(uint16_t bwpIndex,uint16_t ue,uint32_t numRB, LteNrTddSlotType slotType, bool Msg3,RessourceSet* res,uint64_t slotnumber);
-        void findOptimalScheduling(uint32_t numRB, std::vector<uint8_t> consideredBwps, RessourceSet* maxRes , uint16_t bwpIndex, LteNrTddSlotType slotType );
+        void findOptimalScheduling(uint32_t numRB, uint8_t firstBwp, uint8_t endBwp, RessourceSet* maxRes , uint16_t bwpIndex, LteNrTddSlotType slotType );
         void markRessources(RessourceSet* res, uint16_t ue,uint64_t slotNumber);
         void reduceFreeSymbols(RessourceSet* res);
         void resetFreeRessources(SfnSf sf);
-        std::vector<uint8_t> createRBGmask(uint8_t bwpIndex, uint16_t NumberRB,  uint16_t StartRB, uint8_t NumberSymbols, uint8_t StartSymbol);
-        std::vector<std::vector<int>> getSlotRessources(uint8_t bwpIndex,const SfnSf sfn, LteNrTddSlotType type);
+        RbgBitmask createRBGmask(uint8_t bwpIndex, uint16_t NumberRB,  uint16_t StartRB, uint8_t NumberSymbols, uint8_t StartSymbol);
+        NrMacSchedulerSlotView getSlotRessources(uint8_t bwpIndex,const SfnSf sfn, LteNrTddSlotType type);
         std::vector<std::shared_ptr<DciInfoElementTdma>> createDCI(std::vector<std::shared_ptr<ns3::NrMacSchedulerUeInfo>> &ueInfoVec,
                                                         uint8_t bwpIndex, const SfnSf& sfnSf, Ptr<NrAmc> m_Amc, LteNrTddSlotType type );
         std::shared_ptr<DciInfoElementTdma> createSingleDCI(uint16_t rnti,uint8_t startSymbol,uint8_t symNum,size_t rb,int counter,uint16_t bwpIndex, ns3::Ptr<NrAmc> m_Amc,std::shared_ptr<ns3::NrMacSchedulerUeInfo> ueInfo, LteNrTddSlotType type);
@@ -146,10 +170,11 @@ namespace ns3 {
         bool m_use5MHz;
 
         protected:
-        std::vector<std::vector<int>> m_ressourcen;
+        NrMacSchedulerRessourceGrid m_ressourcen; //ring buffer of m_ressourceWindowElements symbols x m_numRb
         std::vector<LteNrTddSlotType>  m_pattern;
         uint64_t m_numSlots;
         uint64_t m_numSym;
+        uint16_t m_numRb;
         uint8_t m_numerology;
         uint16_t m_ressourceWindowSize; 
         uint16_t m_resBufferSize;
@@ -157,7 +182,7 @@ namespace ns3 {
         std::map<int,BwpBorders> bwpRessourceMap;
         std::map<int,uint8_t> coresetMap;
         std::map<uint16_t,int8_t> msg3SlotMap;
-        std::map<uint8_t,uint8_t> freeSymbolsMap;
+        NrMacSchedulerFreeSymbolIndex m_freeSymbols; //free symbols at the end of the current slot per RedCap bwp
         bool doPrintRessourcen{true};
         std::map<uint16_t, SearchSpaceSet> m_searchSpaces;
         bool m_prachConfigured{false};
@@ -169,7 +194,18 @@ namespace ns3 {
         std::map<uint16_t,uint64_t> m_rntiMap;
         UeRessourceUsage m_ueStats;
         RessourceUsageStats m_ressourceStats;
-        
+
+        //the usage of the grid is counted while the ressources are marked, so the grid never has to be scanned for the stats
+        void setRessource(uint64_t index, uint16_t rb, int32_t owner);
+        void setRessourceRange(uint64_t index, uint16_t startRb, uint16_t numRb, int32_t owner);
+        void countRessource(uint64_t index, int32_t owner, int64_t count);
+        void initUsageCounters();
+        void addFrameUsage(uint32_t firstFrame, uint32_t endFrame);
+        RessourceUsageStats getFrameStats(uint32_t frame) const;
+        std::vector<FrameRessourceUsage> m_frameUsage; //usage counters per frame of the ring buffer
+        uint64_t m_symPerFrame;
+        TracedCallback<uint64_t, const RessourceUsageStats&> m_frameUsageTrace; //usage of every frame after it has ended
+        std::vector<RessourceUsageStats> m_cumulativeUsage; //usage of all ended frames before the frame at the index
 
     };
 
@@ -552,17 +552,17 @@ NrMacSchedulerTdma::CreateDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
     NS_ASSERT(numSym > 0);
 
     std::shared_ptr<DciInfoElementTdma> dci =
-        std::make_shared<DciInfoElementTdma>(ueInfo->m_rnti,
-                                             fmt,
-                                             spoint->m_sym,
-                                             numSym,
-                                             mcs,
-                                             tbs,
-                                             ndi,
-                                             rv,
-                                             DciInfoElementTdma::DATA,
-                                             GetBwpId(),
-                                             GetTpc());
+        NrMemoryPool::MakeShared<DciInfoElementTdma>(ueInfo->m_rnti,
+                                                     fmt,
+                                                     spoint->m_sym,
+                                                     numSym,
+                                                     mcs,
+                                                     tbs,
+                                                     ndi,
+                                                     rv,
+                                                     DciInfoElementTdma::DATA,
+                                                     GetBwpId(),
+                                                     GetTpc());
 
     std::vector<uint8_t> rbgAssigned =
         fmt == DciInfoElementTdma::DL ? GetDlNotchedRbgMask() : GetUlNotchedRbgMask();
@@ -574,7 +574,7 @@ NrMacSchedulerTdma::CreateDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
 
     NS_ASSERT(rbgAssigned.size() == GetBandwidthInRbg());
 
-    dci->m_rbgBitmask = std::move(rbgAssigned);
+    dci->m_rbgBitmask.assign(rbgAssigned.begin(), rbgAssigned.end());
 
     std::ostringstream oss;
     for (auto& x : dci->m_rbgBitmask)
@@ -0,0 +1,150 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nr-memory-pool.h"
+
+#include <atomic>
+#include <new>
+
+namespace ns3
+{
+
+namespace
+{
+
+const std::size_t NUM_CLASSES = NrMemoryPool::MAX_SIZE / NrMemoryPool::GRANULARITY;
+
+std::atomic<uint64_t> g_hits{0};   //!< allocations served by a free list
+std::atomic<uint64_t> g_misses{0}; //!< allocations of the size classes served by malloc
+
+/**
+ * \brief A free block, linked to the next one of its class
+ */
+struct FreeBlock
+{
+    FreeBlock* m_next; //!< the next free block
+};
+
+/**
+ * \brief The free lists of a thread
+ */
+struct FreeLists
+{
+    FreeBlock* m_head[NUM_CLASSES]{}; //!< first free block of each class
+    uint32_t m_count[NUM_CLASSES]{};  //!< number of free blocks of each class
+
+    ~FreeLists();
+};
+
+/// true once the free lists of the thread are destroyed, at the thread exit;
+/// the blocks freed afterwards by other destructors go back to malloc
+thread_local bool t_freeListsDestroyed = false;
+
+FreeLists::~FreeLists()
+{
+    for (std::size_t i = 0; i < NUM_CLASSES; ++i)
+    {
+        while (m_head[i] != nullptr)
+        {
+            FreeBlock* block = m_head[i];
+            m_head[i] = block->m_next;
+            ::operator delete(block);
+        }
+    }
+    t_freeListsDestroyed = true;
+}
+
+FreeLists&
+GetFreeLists()
+{
+    thread_local FreeLists freeLists;
+    return freeLists;
+}
+
+} // namespace
+
+double
+NrMemoryPool::Stats::GetHitRate() const
+{
+    return m_hits + m_misses == 0 ? 0.0 : static_cast<double>(m_hits) / (m_hits + m_misses);
+}
+
+void*
+NrMemoryPool::Allocate(std::size_t size)
+{
+    if (size == 0 || size > MAX_SIZE || t_freeListsDestroyed)
+    {
+        return ::operator new(size);
+    }
+    const std::size_t sizeClass = (size - 1) / GRANULARITY;
+    FreeLists& freeLists = GetFreeLists();
+    FreeBlock* block = freeLists.m_head[sizeClass];
+    if (block != nullptr)
+    {
+        freeLists.m_head[sizeClass] = block->m_next;
+        freeLists.m_count[sizeClass]--;
+        g_hits.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+    g_misses.fetch_add(1, std::memory_order_relaxed);
+    // the whole class size, so that the block can serve any size of the class
+    return ::operator new((sizeClass + 1) * GRANULARITY);
+}
+
+void
+NrMemoryPool::Deallocate(void* p, std::size_t size) noexcept
+{
+    if (p == nullptr)
+    {
+        return;
+    }
+    if (size == 0 || size > MAX_SIZE || t_freeListsDestroyed)
+    {
+        ::operator delete(p);
+        return;
+    }
+    const std::size_t sizeClass = (size - 1) / GRANULARITY;
+    FreeLists& freeLists = GetFreeLists();
+    if (freeLists.m_count[sizeClass] >= MAX_FREE_BLOCKS)
+    {
+        ::operator delete(p);
+        return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->m_next = freeLists.m_head[sizeClass];
+    freeLists.m_head[sizeClass] = block;
+    freeLists.m_count[sizeClass]++;
+}
+
+NrMemoryPool::Stats
+NrMemoryPool::GetStats()
+{
+    Stats stats;
+    stats.m_hits = g_hits.load(std::memory_order_relaxed);
+    stats.m_misses = g_misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void
+NrMemoryPool::ResetStats()
+{
+    g_hits.store(0, std::memory_order_relaxed);
+    g_misses.store(0, std::memory_order_relaxed);
+}
+
+} // namespace ns3
@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_MEMORY_POOL_H
+#define NR_MEMORY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace ns3
+{
+
+/**
+ * \ingroup utils
+ * \brief Pool of the small blocks of the per-slot objects of the MAC and PHY
+ *
+ * The schedulers, the MAC and the PHY create DCIs, control messages and slot
+ * allocations in every slot, and destroy them a few slots later. The pool
+ * keeps the freed blocks in free lists, one per size class of 16 bytes up to
+ * 512 bytes, and gives them back to the next allocations of the same class
+ * instead of going through malloc and free.
+ *
+ * The free lists are per thread, so that the schedulers of the BWPs can run
+ * concurrently without locks. A block may be freed by another thread than
+ * the one which allocated it; it then goes to the free list of that thread.
+ * Each free list keeps at most MAX_FREE_BLOCKS blocks, the other ones are
+ * freed.
+ *
+ * The pool is used by:
+ * - the NrControlMessage classes, through their operator new and delete,
+ *   so that every Create<> of a message uses it;
+ * - the DCIs, created with MakeShared instead of std::make_shared;
+ * - the allocations of a slot, SlotAllocInfo::m_varTtiAllocInfo, and the
+ *   RBG masks of the DCIs, DciInfoElementTdma::m_rbgBitmask, through
+ *   NrPoolAllocator.
+ *
+ * GetStats reports how many allocations were served by the free lists.
+ */
+class NrMemoryPool
+{
+  public:
+    /**
+     * \brief Allocations served by the pool
+     */
+    struct Stats
+    {
+        uint64_t m_hits{0};   //!< allocations served by a free list
+        uint64_t m_misses{0}; //!< allocations of the size classes served by malloc
+
+        /**
+         * \return the fraction of the allocations served by a free list
+         */
+        double GetHitRate() const;
+    };
+
+    /**
+     * \brief Allocate a block
+     * \param size the size of the block in bytes
+     * \return the block, aligned as with operator new
+     */
+    static void* Allocate(std::size_t size);
+
+    /**
+     * \brief Free a block of Allocate
+     * \param p the block
+     * \param size the size given to Allocate
+     */
+    static void Deallocate(void* p, std::size_t size) noexcept;
+
+    /**
+     * \return the allocations of all the threads since the start or the
+     * last ResetStats
+     */
+    static Stats GetStats();
+
+    /**
+     * \brief Reset the statistics of GetStats
+     */
+    static void ResetStats();
+
+    /**
+     * \brief Create an object owned by a std::shared_ptr, with the object
+     * and its reference counts in one block of the pool
+     * \param args the arguments of the constructor
+     * \return the object
+     */
+    template <class T, class... Args>
+    static std::shared_ptr<T> MakeShared(Args&&... args);
+
+    static constexpr std::size_t GRANULARITY = 16;    //!< step of the size classes
+    static constexpr std::size_t MAX_SIZE = 512;      //!< largest block of the pool
+    static constexpr uint32_t MAX_FREE_BLOCKS = 4096; //!< free blocks per class and thread
+};
+
+/**
+ * \ingroup utils
+ * \brief Standard allocator on top of NrMemoryPool
+ */
+template <class T>
+class NrPoolAllocator
+{
+  public:
+    typedef T value_type; //!< type of the allocated objects
+
+    NrPoolAllocator() noexcept = default;
+
+    /**
+     * \brief Copy an allocator of another type
+     */
+    template <class U>
+    NrPoolAllocator(const NrPoolAllocator<U>&) noexcept
+    {
+    }
+
+    /**
+     * \param n the number of objects
+     * \return the storage of n objects
+     */
+    T* allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned type");
+        return static_cast<T*>(NrMemoryPool::Allocate(n * sizeof(T)));
+    }
+
+    /**
+     * \param p the storage of allocate
+     * \param n the number of objects
+     */
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        NrMemoryPool::Deallocate(p, n * sizeof(T));
+    }
+};
+
+/**
+ * \return true: the allocators are interchangeable
+ */
+template <class T, class U>
+bool
+operator==(const NrPoolAllocator<T>&, const NrPoolAllocator<U>&)
+{
+    return true;
+}
+
+/**
+ * \return false: the allocators are interchangeable
+ */
+template <class T, class U>
+bool
+operator!=(const NrPoolAllocator<T>&, const NrPoolAllocator<U>&)
+{
+    return false;
+}
+
+template <class T, class... Args>
+std::shared_ptr<T>
+NrMemoryPool::MakeShared(Args&&... args)
+{
+    return std::allocate_shared<T>(NrPoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace ns3
+
+#endif /* NR_MEMORY_POOL_H */
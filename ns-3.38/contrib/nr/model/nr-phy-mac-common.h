@@ -9,6 +9,7 @@
 #ifndef SRC_NR_MODEL_NR_PHY_MAC_COMMON_H
 #define SRC_NR_MODEL_NR_PHY_MAC_COMMON_H
 
+#include "nr-memory-pool.h"
 #include "sfnsf.h"
 
 #include <ns3/component-carrier.h>
@@ -135,6 +136,12 @@ struct TbInfoElement
     uint8_t m_harqProcess;
 };
 
+/**
+ * \ingroup utils
+ * \brief RBG mask of a DCI, in a block of the NrMemoryPool
+ */
+typedef std::vector<uint8_t, NrPoolAllocator<uint8_t>> RbgBitmask;
+
 /**
  * \ingroup utils
  * \brief Scheduling information. Despite the name, it is not TDMA.
@@ -170,7 +177,7 @@ struct DciInfoElementTdma
                        uint8_t numSym,
                        DciFormat format,
                        VarTtiType type,
-                       const std::vector<uint8_t>& rbgBitmask)
+                       const RbgBitmask& rbgBitmask)
         : m_format(format),
           m_symStart(symStart),
           m_numSym(numSym),
@@ -249,7 +256,7 @@ struct DciInfoElementTdma
   
   DciInfoElementTdma (uint16_t rnti, DciFormat format, uint8_t symStart,
                       uint8_t numSym, std::vector<uint8_t> mcs, std::vector<uint32_t> tbs, std::vector<uint8_t> ndi,
-                      std::vector<uint8_t> rv, VarTtiType type, uint8_t bwpIndex, uint8_t m_harqProcess, const std::vector<uint8_t> &rbgBitmask, uint8_t tpc)
+                      std::vector<uint8_t> rv, VarTtiType type, uint8_t bwpIndex, uint8_t m_harqProcess, const RbgBitmask &rbgBitmask, uint8_t tpc)
     : m_rnti (rnti), m_format (format), m_symStart (symStart),
     m_numSym (numSym), m_mcs (mcs), m_tbSize (tbs), m_ndi (ndi), m_rv (rv), m_type (type),
     m_bwpIndex (bwpIndex), m_harqProcess(0) ,m_rbgBitmask(rbgBitmask),m_tpc(tpc)
@@ -269,7 +276,7 @@ struct DciInfoElementTdma
     const VarTtiType m_type{SRS};     //!< Var TTI type
     const uint8_t m_bwpIndex{0};      //!< BWP Index to identify to which BWP this DCI applies to.
     uint8_t m_harqProcess{0};         //!< HARQ process id
-    std::vector<uint8_t> m_rbgBitmask{}; //!< RBG mask: 0 if the RBG is not used, 1 otherwise
+    RbgBitmask m_rbgBitmask{}; //!< RBG mask: 0 if the RBG is not used, 1 otherwise
     const uint8_t m_tpc{0};              //!< Tx power control command
 };
 
@@ -336,6 +343,12 @@ struct VarTtiAllocInfo
     }
 };
 
+/**
+ * \ingroup utils
+ * \brief The allocations of a slot, in blocks of the NrMemoryPool
+ */
+typedef std::deque<VarTtiAllocInfo, NrPoolAllocator<VarTtiAllocInfo>> VarTtiAllocInfoList;
+
 /**
  * \ingroup utils
  * \brief The SlotAllocInfo struct
@@ -384,7 +397,7 @@ struct SlotAllocInfo
 
     SfnSf m_sfnSf{};                               //!< SfnSf of this allocation
     uint32_t m_numSymAlloc{0};                     //!< Number of allocated symbols
-    std::deque<VarTtiAllocInfo> m_varTtiAllocInfo; //!< queue of allocations
+    VarTtiAllocInfoList m_varTtiAllocInfo;         //!< queue of allocations
     AllocationType m_type{NONE};                   //!< Allocations type
 
     /**
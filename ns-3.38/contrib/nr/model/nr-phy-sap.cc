@@ -6,6 +6,10 @@
 
 #include "nr-phy-sap.h"
 
+#include <ns3/assert.h>
+
+#include <limits>
+
 namespace ns3
 {
 
@@ -13,90 +17,333 @@ NrPhySapProvider::~NrPhySapProvider()
 {
 }
 
-std::vector<NrPhySapProvider::PrachConfig>
-NrPhySapProvider::readPrachCSV(std::istream &in)
+namespace
+{
+
+/**
+ * \brief One row of the PRACH configuration table
+ */
+struct PrachConfigRow
 {
-    std::vector<NrPhySapProvider::PrachConfig> table;
-    std::string row;
-    std::getline (in, row);
-    while (!in.eof ())
-      {
-        std::getline (in, row);
-        if (in.bad () || in.fail ())
-          {
-            break;
-          }
-        auto fields = readCSVRow (row);
-        PrachConfig tmp = PrachConfig( fields[1],stoi (fields[2]),stoi (fields[3]),stoi (fields[5]),stof (fields[6]),stof (fields[7]),stoi (fields[8]));
-        for (char c : fields[4])
+    const char* preambleFormat;
+    uint8_t nfX;
+    uint8_t nfY;
+    const char* subframes; //!< subframe numbers separated by ':'
+    uint8_t symStart;
+    float numPrachSlots;
+    float prachOccInSlot;
+    uint8_t duration;
+};
+
+constexpr float NA = std::numeric_limits<float>::quiet_NaN();
+
+/**
+ * Table 6.3.3.2-3 from TS 138 211 V17.4.0 (csv/PRACH_configurations.csv),
+ * indexed by the PRACH configuration index
+ */
+constexpr PrachConfigRow PRACH_CONFIG_TABLE[] = {
+    {"0", 16, 1, "9", 0, NA, NA, 0}, // 0
+    {"0", 8, 1, "9", 0, NA, NA, 0}, // 1
+    {"0", 4, 1, "9", 0, NA, NA, 0}, // 2
+    {"0", 2, 0, "9", 0, NA, NA, 0}, // 3
+    {"0", 2, 1, "9", 0, NA, NA, 0}, // 4
+    {"0", 2, 0, "4", 0, NA, NA, 0}, // 5
+    {"0", 2, 1, "4", 0, NA, NA, 0}, // 6
+    {"0", 1, 0, "9", 0, NA, NA, 0}, // 7
+    {"0", 1, 0, "8", 0, NA, NA, 0}, // 8
+    {"0", 1, 0, "7", 0, NA, NA, 0}, // 9
+    {"0", 1, 0, "6", 0, NA, NA, 0}, // 10
+    {"0", 1, 0, "5", 0, NA, NA, 0}, // 11
+    {"0", 1, 0, "4", 0, NA, NA, 0}, // 12
+    {"0", 1, 0, "3", 0, NA, NA, 0}, // 13
+    {"0", 1, 0, "2", 0, NA, NA, 0}, // 14
+    {"0", 1, 0, "1:6", 0, NA, NA, 0}, // 15
+    {"0", 1, 0, "1:6", 7, NA, NA, 0}, // 16
+    {"0", 1, 0, "4:9", 0, NA, NA, 0}, // 17
+    {"0", 1, 0, "3:8", 0, NA, NA, 0}, // 18
+    {"0", 1, 0, "2:7", 0, NA, NA, 0}, // 19
+    {"0", 1, 0, "8:9", 0, NA, NA, 0}, // 20
+    {"0", 1, 0, "4:8:9", 0, NA, NA, 0}, // 21
+    {"0", 1, 0, "3:4:9", 0, NA, NA, 0}, // 22
+    {"0", 1, 0, "7:8:9", 0, NA, NA, 0}, // 23
+    {"0", 1, 0, "3:4:8:9", 0, NA, NA, 0}, // 24
+    {"0", 1, 0, "6:7:8:9", 0, NA, NA, 0}, // 25
+    {"0", 1, 0, "1:4:6:9", 0, NA, NA, 0}, // 26
+    {"0", 1, 0, "1:3:5:7:9", 0, NA, NA, 0}, // 27
+    {"1", 16, 1, "7", 0, NA, NA, 0}, // 28
+    {"1", 8, 1, "7", 0, NA, NA, 0}, // 29
+    {"1", 4, 1, "7", 0, NA, NA, 0}, // 30
+    {"1", 2, 0, "7", 0, NA, NA, 0}, // 31
+    {"1", 2, 1, "7", 0, NA, NA, 0}, // 32
+    {"1", 1, 0, "7", 0, NA, NA, 0}, // 33
+    {"2", 16, 1, "6", 0, NA, NA, 0}, // 34
+    {"2", 8, 1, "6", 0, NA, NA, 0}, // 35
+    {"2", 4, 1, "6", 0, NA, NA, 0}, // 36
+    {"2", 2, 0, "6", 7, NA, NA, 0}, // 37
+    {"2", 2, 1, "6", 7, NA, NA, 0}, // 38
+    {"2", 1, 0, "6", 7, NA, NA, 0}, // 39
+    {"3", 16, 1, "9", 0, NA, NA, 0}, // 40
+    {"3", 8, 1, "9", 0, NA, NA, 0}, // 41
+    {"3", 4, 1, "9", 0, NA, NA, 0}, // 42
+    {"3", 2, 0, "9", 0, NA, NA, 0}, // 43
+    {"3", 2, 1, "9", 0, NA, NA, 0}, // 44
+    {"3", 2, 0, "4", 0, NA, NA, 0}, // 45
+    {"3", 2, 1, "4", 0, NA, NA, 0}, // 46
+    {"3", 1, 0, "9", 0, NA, NA, 0}, // 47
+    {"3", 1, 0, "8", 0, NA, NA, 0}, // 48
+    {"3", 1, 0, "7", 0, NA, NA, 0}, // 49
+    {"3", 1, 0, "6", 0, NA, NA, 0}, // 50
+    {"3", 1, 0, "5", 0, NA, NA, 0}, // 51
+    {"3", 1, 0, "4", 0, NA, NA, 0}, // 52
+    {"3", 1, 0, "3", 0, NA, NA, 0}, // 53
+    {"3", 1, 0, "2", 0, NA, NA, 0}, // 54
+    {"3", 1, 0, "1:6", 0, NA, NA, 0}, // 55
+    {"3", 1, 0, "1:6", 7, NA, NA, 0}, // 56
+    {"3", 1, 0, "4:9", 0, NA, NA, 0}, // 57
+    {"3", 1, 0, "3:8", 0, NA, NA, 0}, // 58
+    {"3", 1, 0, "2:7", 0, NA, NA, 0}, // 59
+    {"3", 1, 0, "8:9", 0, NA, NA, 0}, // 60
+    {"3", 1, 0, "4:8:9", 0, NA, NA, 0}, // 61
+    {"3", 1, 0, "3:4:9", 0, NA, NA, 0}, // 62
+    {"3", 1, 0, "7:8:9", 0, NA, NA, 0}, // 63
+    {"3", 1, 0, "3:4:8:9", 0, NA, NA, 0}, // 64
+    {"3", 1, 0, "1:4:6:9", 0, NA, NA, 0}, // 65
+    {"3", 1, 0, "1:3:5:7:9", 0, NA, NA, 0}, // 66
+    {"A1", 16, 1, "9", 0, 2, 6, 2}, // 67
+    {"A1", 8, 1, "9", 0, 2, 6, 2}, // 68
+    {"A1", 4, 1, "9", 0, 1, 6, 2}, // 69
+    {"A1", 2, 1, "9", 0, 1, 6, 2}, // 70
+    {"A1", 2, 1, "4:9", 7, 1, 3, 2}, // 71
+    {"A1", 2, 1, "7:9", 7, 1, 3, 2}, // 72
+    {"A1", 2, 1, "7:9", 0, 1, 6, 2}, // 73
+    {"A1", 2, 1, "8:9", 0, 2, 6, 2}, // 74
+    {"A1", 2, 1, "4:9", 0, 2, 6, 2}, // 75
+    {"A1", 2, 1, "2:3:4:7:8:9", 0, 1, 6, 2}, // 76
+    {"A1", 1, 0, "9", 0, 2, 6, 2}, // 77
+    {"A1", 1, 0, "9", 7, 1, 3, 2}, // 78
+    {"A1", 1, 0, "9", 0, 1, 6, 2}, // 79
+    {"A1", 1, 0, "8:9", 0, 2, 6, 2}, // 80
+    {"A1", 1, 0, "4:9", 0, 1, 6, 2}, // 81
+    {"A1", 1, 0, "7:9", 7, 1, 3, 2}, // 82
+    {"A1", 1, 0, "3:4:8:9", 0, 1, 6, 2}, // 83
+    {"A1", 1, 0, "3:4:8:9", 0, 2, 6, 2}, // 84
+    {"A1", 1, 0, "1:3:5:7:9", 0, 1, 6, 2}, // 85
+    {"A1", 1, 0, "0:1:2:3:4:5:6:7:8:9", 7, 1, 3, 2}, // 86
+    {"A2", 16, 1, "9", 0, 2, 3, 4}, // 87
+    {"A2", 8, 1, "9", 0, 2, 3, 4}, // 88
+    {"A2", 4, 1, "9", 0, 1, 3, 4}, // 89
+    {"A2", 2, 1, "7:9", 0, 1, 3, 4}, // 90
+    {"A2", 2, 1, "8:9", 0, 2, 3, 4}, // 91
+    {"A2", 2, 1, "7:9", 9, 1, 1, 4}, // 92
+    {"A2", 2, 1, "4:9", 9, 1, 1, 4}, // 93
+    {"A2", 2, 1, "4:9", 0, 2, 3, 4}, // 94
+    {"A2", 2, 1, "2:3:4:7:8:9", 0, 1, 3, 4}, // 95
+    {"A2", 1, 0, "2", 0, 1, 3, 4}, // 96
+    {"A2", 1, 0, "7", 0, 1, 3, 4}, // 97
+    {"A2", 2, 1, "9", 0, 1, 3, 4}, // 98
+    {"A2", 1, 0, "9", 0, 2, 3, 4}, // 99
+    {"A2", 1, 0, "9", 9, 1, 1, 4}, // 100
+    {"A2", 1, 0, "9", 0, 1, 3, 4}, // 101
+    {"A2", 1, 0, "2:7", 0, 1, 3, 4}, // 102
+    {"A2", 1, 0, "8:9", 0, 2, 3, 4}, // 103
+    {"A2", 1, 0, "4:9", 0, 1, 3, 4}, // 104
+    {"A2", 1, 0, "7:9", 9, 1, 1, 4}, // 105
+    {"A2", 1, 0, "3:4:8:9", 0, 1, 3, 4}, // 106
+    {"A2", 1, 0, "3:4:8:9", 0, 2, 3, 4}, // 107
+    {"A2", 1, 0, "1:3:5:7:9", 0, 1, 3, 4}, // 108
+    {"A2", 1, 0, "0:1:2:3:4:5:6:7:8:9", 9, 1, 1, 4}, // 109
+    {"A3", 16, 1, "9", 0, 2, 2, 6}, // 110
+    {"A3", 8, 1, "9", 0, 2, 2, 6}, // 111
+    {"A3", 4, 1, "9", 0, 1, 2, 6}, // 112
+    {"A3", 2, 1, "4:9", 7, 1, 1, 6}, // 113
+    {"A3", 2, 1, "7:9", 7, 1, 1, 6}, // 114
+    {"A3", 2, 1, "7:9", 0, 1, 2, 6}, // 115
+    {"A3", 2, 1, "4:9", 0, 2, 2, 6}, // 116
+    {"A3", 2, 1, "8:9", 0, 2, 2, 6}, // 117
+    {"A3", 2, 1, "2:3:4:7:8:9", 0, 1, 2, 6}, // 118
+    {"A3", 1, 0, "2", 0, 1, 2, 6}, // 119
+    {"A3", 1, 0, "7", 0, 1, 2, 6}, // 120
+    {"A3", 2, 1, "9", 0, 1, 2, 6}, // 121
+    {"A3", 1, 0, "9", 0, 2, 2, 6}, // 122
+    {"A3", 1, 0, "9", 7, 1, 1, 6}, // 123
+    {"A3", 1, 0, "9", 0, 1, 2, 6}, // 124
+    {"A3", 1, 0, "2:7", 0, 1, 2, 6}, // 125
+    {"A3", 1, 0, "8:9", 0, 2, 2, 6}, // 126
+    {"A3", 1, 0, "4:9", 0, 1, 2, 6}, // 127
+    {"A3", 1, 0, "7:9", 7, 1, 1, 6}, // 128
+    {"A3", 1, 0, "3:4:8:9", 0, 1, 2, 6}, // 129
+    {"A3", 1, 0, "3:4:8:9", 0, 2, 2, 6}, // 130
+    {"A3", 1, 0, "1:3:5:7:9", 0, 1, 2, 6}, // 131
+    {"A3", 1, 0, "0:1:2:3:4:5:6:7:8:9", 7, 1, 1, 6}, // 132
+    {"B1", 4, 1, "9", 2, 1, 6, 2}, // 133
+    {"B1", 2, 1, "9", 2, 1, 6, 2}, // 134
+    {"B1", 2, 1, "7:9", 2, 1, 6, 2}, // 135
+    {"B1", 2, 1, "4:9", 8, 1, 3, 2}, // 136
+    {"B1", 2, 1, "4:9", 2, 2, 6, 2}, // 137
+    {"B1", 1, 0, "9", 2, 2, 6, 2}, // 138
+    {"B1", 1, 0, "9", 8, 1, 3, 2}, // 139
+    {"B1", 1, 0, "9", 2, 1, 6, 2}, // 140
+    {"B1", 1, 0, "8:9", 2, 2, 6, 2}, // 141
+    {"B1", 1, 0, "4:9", 2, 1, 6, 2}, // 142
+    {"B1", 1, 0, "7:9", 8, 1, 3, 2}, // 143
+    {"B1", 1, 0, "1:3:5:7:9", 2, 1, 6, 2}, // 144
+    {"B4", 16, 1, "9", 0, 2, 1, 12}, // 145
+    {"B4", 8, 1, "9", 0, 2, 1, 12}, // 146
+    {"B4", 4, 1, "9", 2, 1, 1, 12}, // 147
+    {"B4", 2, 1, "9", 0, 1, 1, 12}, // 148
+    {"B4", 2, 1, "9", 2, 1, 1, 12}, // 149
+    {"B4", 2, 1, "7:9", 2, 1, 1, 12}, // 150
+    {"B4", 2, 1, "4:9", 2, 1, 1, 12}, // 151
+    {"B4", 2, 1, "4:9", 0, 2, 1, 12}, // 152
+    {"B4", 2, 1, "8:9", 0, 2, 1, 12}, // 153
+    {"B4", 2, 1, "2:3:4:7:8:9", 0, 1, 1, 12}, // 154
+    {"B4", 1, 0, "1", 0, 1, 1, 12}, // 155
+    {"B4", 1, 0, "2", 0, 1, 1, 12}, // 156
+    {"B4", 1, 0, "4", 0, 1, 1, 12}, // 157
+    {"B4", 1, 0, "7", 0, 1, 1, 12}, // 158
+    {"B4", 1, 0, "9", 0, 1, 1, 12}, // 159
+    {"B4", 1, 0, "9", 2, 1, 1, 12}, // 160
+    {"B4", 1, 0, "9", 0, 2, 1, 12}, // 161
+    {"B4", 1, 0, "4:9", 2, 1, 1, 12}, // 162
+    {"B4", 1, 0, "7:9", 2, 1, 1, 12}, // 163
+    {"B4", 1, 0, "8:9", 0, 2, 1, 12}, // 164
+    {"B4", 1, 0, "3:4:8:9", 2, 1, 1, 12}, // 165
+    {"B4", 1, 0, "1:3:5:7:9", 2, 1, 1, 12}, // 166
+    {"B4", 1, 0, "0:1:2:3:4:5:6:7:8:9", 0, 2, 1, 12}, // 167
+    {"B4", 1, 0, "0:1:2:3:4:5:6:7:8:9", 2, 1, 1, 12}, // 168
+    {"C0", 16, 1, "9", 2, 2, 6, 2}, // 169
+    {"C0", 8, 1, "9", 2, 2, 6, 2}, // 170
+    {"C0", 4, 1, "9", 2, 1, 6, 2}, // 171
+    {"C0", 2, 1, "9", 2, 1, 6, 2}, // 172
+    {"C0", 2, 1, "8:9", 2, 2, 6, 2}, // 173
+    {"C0", 2, 1, "7:9", 2, 1, 6, 2}, // 174
+    {"C0", 2, 1, "7:9", 8, 1, 3, 2}, // 175
+    {"C0", 2, 1, "4:9", 8, 1, 3, 2}, // 176
+    {"C0", 2, 1, "4:9", 2, 2, 6, 2}, // 177
+    {"C0", 2, 1, "2:3:4:7:8:9", 2, 1, 6, 2}, // 178
+    {"C0", 1, 0, "9", 2, 2, 6, 2}, // 179
+    {"C0", 1, 0, "9", 8, 1, 3, 2}, // 180
+    {"C0", 1, 0, "9", 2, 1, 6, 2}, // 181
+    {"C0", 1, 0, "8:9", 2, 2, 6, 2}, // 182
+    {"C0", 1, 0, "4:9", 2, 1, 6, 2}, // 183
+    {"C0", 1, 0, "7:9", 8, 1, 3, 2}, // 184
+    {"C0", 1, 0, "3:4:8:9", 2, 1, 6, 2}, // 185
+    {"C0", 1, 0, "3:4:8:9", 2, 2, 6, 2}, // 186
+    {"C0", 1, 0, "1:3:5:7:9", 2, 1, 6, 2}, // 187
+    {"C0", 1, 0, "0:1:2:3:4:5:6:7:8:9", 8, 1, 3, 2}, // 188
+    {"C2", 16, 1, "9", 2, 2, 2, 6}, // 189
+    {"C2", 8, 1, "9", 2, 2, 2, 6}, // 190
+    {"C2", 4, 1, "9", 2, 1, 2, 6}, // 191
+    {"C2", 2, 1, "9", 2, 1, 2, 6}, // 192
+    {"C2", 2, 1, "8:9", 2, 2, 2, 6}, // 193
+    {"C2", 2, 1, "7:9", 2, 1, 2, 6}, // 194
+    {"C2", 2, 1, "7:9", 8, 1, 1, 6}, // 195
+    {"C2", 2, 1, "4:9", 8, 1, 1, 6}, // 196
+    {"C2", 2, 1, "4:9", 2, 2, 2, 6}, // 197
+    {"C2", 2, 1, "2:3:4:7:8:9", 2, 1, 2, 6}, // 198
+    {"C2", 8, 1, "9", 8, 2, 1, 6}, // 199
+    {"C2", 4, 1, "9", 8, 1, 1, 6}, // 200
+    {"C2", 1, 0, "9", 2, 2, 2, 6}, // 201
+    {"C2", 1, 0, "9", 8, 1, 1, 6}, // 202
+    {"C2", 1, 0, "9", 2, 1, 2, 6}, // 203
+    {"C2", 1, 0, "8:9", 2, 2, 2, 6}, // 204
+    {"C2", 1, 0, "4:9", 2, 1, 2, 6}, // 205
+    {"C2", 1, 0, "7:9", 8, 1, 1, 6}, // 206
+    {"C2", 1, 0, "3:4:8:9", 2, 1, 2, 6}, // 207
+    {"C2", 1, 0, "3:4:8:9", 2, 2, 2, 6}, // 208
+    {"C2", 1, 0, "1:3:5:7:9", 2, 1, 2, 6}, // 209
+    {"C2", 1, 0, "0:1:2:3:4:5:6:7:8:9", 8, 1, 1, 6}, // 210
+    {"A1/B1", 2, 1, "9", 2, 1, 6, 2}, // 211
+    {"A1/B1", 2, 1, "4:9", 8, 1, 3, 2}, // 212
+    {"A1/B1", 2, 1, "7:9", 8, 1, 3, 2}, // 213
+    {"A1/B1", 2, 1, "7:9", 2, 1, 6, 2}, // 214
+    {"A1/B1", 2, 1, "4:9", 2, 2, 6, 2}, // 215
+    {"A1/B1", 2, 1, "8:9", 2, 2, 6, 2}, // 216
+    {"A1/B1", 1, 0, "9", 2, 2, 6, 2}, // 217
+    {"A1/B1", 1, 0, "9", 8, 1, 3, 2}, // 218
+    {"A1/B1", 1, 0, "9", 2, 1, 6, 2}, // 219
+    {"A1/B1", 1, 0, "8:9", 2, 2, 6, 2}, // 220
+    {"A1/B1", 1, 0, "4:9", 2, 1, 6, 2}, // 221
+    {"A1/B1", 1, 0, "7:9", 8, 1, 3, 2}, // 222
+    {"A1/B1", 1, 0, "3:4:8:9", 2, 2, 6, 2}, // 223
+    {"A1/B1", 1, 0, "1:3:5:7:9", 2, 1, 6, 2}, // 224
+    {"A1/B1", 1, 0, "0:1:2:3:4:5:6:7:8:9", 8, 1, 3, 2}, // 225
+    {"A2/B2", 2, 1, "9", 0, 1, 3, 4}, // 226
+    {"A2/B2", 2, 1, "4:9", 6, 1, 2, 4}, // 227
+    {"A2/B2", 2, 1, "7:9", 6, 1, 2, 4}, // 228
+    {"A2/B2", 2, 1, "4:9", 0, 2, 3, 4}, // 229
+    {"A2/B2", 2, 1, "8:9", 0, 2, 3, 4}, // 230
+    {"A2/B2", 1, 0, "9", 0, 2, 3, 4}, // 231
+    {"A2/B2", 1, 0, "9", 6, 1, 2, 4}, // 232
+    {"A2/B2", 1, 0, "9", 0, 1, 3, 4}, // 233
+    {"A2/B2", 1, 0, "8:9", 0, 2, 3, 4}, // 234
+    {"A2/B2", 1, 0, "4:9", 0, 1, 3, 4}, // 235
+    {"A2/B2", 1, 0, "7:9", 6, 1, 2, 4}, // 236
+    {"A2/B2", 1, 0, "3:4:8:9", 0, 1, 3, 4}, // 237
+    {"A2/B2", 1, 0, "3:4:8:9", 0, 2, 3, 4}, // 238
+    {"A2/B2", 1, 0, "1:3:5:7:9", 0, 1, 3, 4}, // 239
+    {"A2/B2", 1, 0, "0:1:2:3:4:5:6:7:8:9", 6, 1, 2, 4}, // 240
+    {"A3/B3", 2, 1, "9", 0, 1, 2, 6}, // 241
+    {"A3/B3", 2, 1, "4:9", 2, 1, 2, 6}, // 242
+    {"A3/B3", 2, 1, "7:9", 0, 1, 2, 6}, // 243
+    {"A3/B3", 2, 1, "7:9", 2, 1, 2, 6}, // 244
+    {"A3/B3", 2, 1, "4:9", 0, 2, 2, 6}, // 245
+    {"A3/B3", 2, 1, "8:9", 0, 2, 2, 6}, // 246
+    {"A3/B3", 1, 0, "9", 0, 2, 2, 6}, // 247
+    {"A3/B3", 1, 0, "9", 2, 1, 2, 6}, // 248
+    {"A3/B3", 1, 0, "9", 0, 1, 2, 6}, // 249
+    {"A3/B3", 1, 0, "8:9", 0, 2, 2, 6}, // 250
+    {"A3/B3", 1, 0, "4:9", 0, 1, 2, 6}, // 251
+    {"A3/B3", 1, 0, "7:9", 2, 1, 2, 6}, // 252
+    {"A3/B3", 1, 0, "3:4:8:9", 0, 2, 2, 6}, // 253
+    {"A3/B3", 1, 0, "1:3:5:7:9", 0, 1, 2, 6}, // 254
+    {"A3/B3", 1, 0, "0:1:2:3:4:5:6:7:8:9", 2, 1, 2, 6}, // 255
+    {"0", 16, 1, "7", 0, NA, NA, 0}, // 256
+    {"0", 8, 1, "7", 0, NA, NA, 0}, // 257
+    {"0", 4, 1, "7", 0, NA, NA, 0}, // 258
+    {"0", 2, 0, "7", 0, NA, NA, 0}, // 259
+    {"0", 2, 1, "7", 0, NA, NA, 0}, // 260
+    {"0", 2, 0, "2", 0, NA, NA, 0}, // 261
+    {"0", 2, 1, "2", 0, NA, NA, 0}, // 262
+};
+
+} // namespace
+
+const std::vector<NrPhySapProvider::PrachConfig>&
+NrPhySapProvider::GetPrachConfigTable()
+{
+    // built once and shared by the SAPs of all devices
+    static const std::vector<PrachConfig> table = [] {
+        std::vector<PrachConfig> configs;
+        configs.reserve(sizeof(PRACH_CONFIG_TABLE) / sizeof(PRACH_CONFIG_TABLE[0]));
+        for (const PrachConfigRow& row : PRACH_CONFIG_TABLE)
         {
-            if( c != ':')
+            PrachConfig config(row.preambleFormat,
+                               row.nfX,
+                               row.nfY,
+                               row.symStart,
+                               row.numPrachSlots,
+                               row.prachOccInSlot,
+                               row.duration);
+            for (const char* c = row.subframes; *c != '\0'; ++c)
             {
-                tmp.m_SfN.emplace_back((uint8_t)atoi(&c));
+                if (*c != ':')
+                {
+                    config.m_SfN.emplace_back(*c - '0');
+                }
             }
-          
+            configs.emplace_back(config);
         }
-        table.emplace_back(tmp);
-    }
+        return configs;
+    }();
     return table;
 }
 
- std::vector<std::string>
-  NrPhySapProvider::readCSVRow(const std::string &row)
-  {
-    CSVState state = CSVState::UnquotedField;
-    std::vector<std::string> fields{""};
-    size_t i = 0; // index of the current field
-    for (char c : row)
-      {
-        switch (state)
-          {
-          case CSVState::UnquotedField:
-            switch (c)
-              {
-              case ',': // end of field
-                fields.push_back ("");
-                i++;
-                break;
-              case '"':
-                state = CSVState::QuotedField;
-                break;
-              default:
-                fields[i].push_back (c);
-                break;
-              }
-            break;
-          case CSVState::QuotedField:
-            switch (c)
-              {
-              case '"':
-                state = CSVState::QuotedQuote;
-                break;
-              default:
-                fields[i].push_back (c);
-                break;
-              }
-            break;
-          case CSVState::QuotedQuote:
-            switch (c)
-              {
-              case ',': // , after closing quote
-                fields.push_back ("");
-                i++;
-                state = CSVState::UnquotedField;
-                break;
-              case '"': // "" -> "
-                fields[i].push_back ('"');
-                state = CSVState::QuotedField;
-                break;
-              default: // end of quote
-                state = CSVState::UnquotedField;
-                break;
-              }
-            break;
-          }
-      }
-    return fields;
-  }
+bool
+NrPhySapProvider::IsPagingFrame(uint32_t frame, uint32_t ueId, uint32_t pagingCycle)
+{
+    NS_ASSERT_MSG(pagingCycle > 0, "The paging cycle must be at least one frame");
+    return frame % pagingCycle == (ueId % 1024) % pagingCycle;
+}
 
 } // namespace ns3
@@ -35,8 +35,6 @@ class NrControlMessage;
  * As a general rule, no caching is allowed for the values returned by any
  * Get* method, becaue those values can change dynamically.
  */
-enum class CSVState { UnquotedField, QuotedField, QuotedQuote };
-
 class NrPhySapProvider
 {
 
@@ -85,21 +83,8 @@ class NrPhySapProvider
 
     NrPhySapProvider()
     {
-
-      //Create the table 6.3.3.2-3 from TS 138 211 V17.4.0      
-       if (all_Prachconfigs.empty())
-        {
-
-            std::string file = __FILE__;
-            std::string csv_file = file.substr(0,file.length()-18)+"csv/PRACH_configurations.csv";
-            std::ifstream prachCfgs_file (csv_file); 
-            all_Prachconfigs = readPrachCSV(prachCfgs_file);
-            
-        }      
-
     }
 
-
     /**
      * \brief ~NrPhySapProvider
      */
@@ -159,6 +144,14 @@ class NrPhySapProvider
      */
     virtual void NotifyConnectionSuccessful() = 0;
 
+    /**
+     * \brief Wake up the PHY, if it stopped starting slots because the UE is dormant
+     *
+     * The MAC calls it when it needs the slot indications again, e.g. to
+     * send a SR or a RACH preamble. Only used in the UE.
+     */
+    virtual void WakeUp() = 0;
+
     /**
      * \brief Get the beam conf ID from the RNTI specified. Not in any standard.
      * \param rnti RNTI of the user
@@ -211,13 +204,29 @@ class NrPhySapProvider
 
     virtual uint8_t GetCoresetSymbols() const =0;
 
-    std::vector<PrachConfig> all_Prachconfigs;
-
     virtual PrachConfig GetPrachConfig(u_int8_t index) const = 0;
 
+    /**
+     * \brief Get the PRACH configurations of table 6.3.3.2-3 from TS 138 211 V17.4.0
+     * \return the configurations, indexed by the PRACH configuration index
+     *
+     * The table is compiled into the module and shared by all instances.
+     */
+    static const std::vector<PrachConfig>& GetPrachConfigTable();
 
-    std::vector<PrachConfig> readPrachCSV(std::istream &in);
-    std::vector<std::string> readCSVRow(const std::string &row);
+    /**
+     * \brief Check if a frame is the paging frame of a UE, as in TS 38.304 7.1
+     * \param frame the frame number
+     * \param ueId the UE identity (the paging RNTI in the simulator); it is
+     * taken modulo 1024 as the 5G-S-TMSI of the standard
+     * \param pagingCycle the paging (DRX) cycle T, in frames
+     * \return true if the UE monitors its paging occasion in the frame
+     *
+     * There is one paging frame per cycle (N = T) with no offset, so the
+     * paging frame is SFN mod T = UE_ID mod T. The gNB and the UE use it to
+     * agree on the paging occasions.
+     */
+    static bool IsPagingFrame(uint32_t frame, uint32_t ueId, uint32_t pagingCycle);
 
   
 };
@@ -389,6 +398,21 @@ class NrUePhySapUser
 
     virtual void RecvSib1(NrSib1Message sib1, NrPhySapProvider::PrachConfig prachOccasions) = 0;
 
+    /**
+     * \brief Ask the MAC if it needs the next slot indications
+     * \return true if the MAC has nothing to do in the next slots and waits for
+     * a control message or for new data (e.g. in RRC INACTIVE with DRX configured)
+     */
+    virtual bool IsDormant() const = 0;
+
+    /**
+     * \brief Ask the MAC if the UE monitors the paging in a slot
+     * \param s the slot
+     * \return true if the slot is in a paging frame of the UE, or if the UE
+     * has no paging cycle configured
+     */
+    virtual bool IsPagingOccasion(const SfnSf& s) const = 0;
+
 };
 
 
@@ -55,6 +55,8 @@ class NrMemberPhySapProvider : public NrPhySapProvider
 
     void NotifyConnectionSuccessful() override;
 
+    void WakeUp() override;
+
     uint16_t GetBwpId() const override;
 
     uint16_t GetCellId() const override;
@@ -138,6 +140,12 @@ NrMemberPhySapProvider::NotifyConnectionSuccessful()
     m_phy->NotifyConnectionSuccessful();
 }
 
+void
+NrMemberPhySapProvider::WakeUp()
+{
+    m_phy->WakeUp();
+}
+
 uint16_t
 NrMemberPhySapProvider::GetBwpId() const
 {
@@ -191,7 +199,7 @@ NrPhy::GetTypeId()
 }
 
 std::vector<int>
-NrPhy::FromRBGBitmaskToRBAssignment(const std::vector<uint8_t> rbgBitmask) const
+NrPhy::FromRBGBitmaskToRBAssignment(const RbgBitmask& rbgBitmask) const
 {
     std::vector<int> ret;
 
@@ -228,9 +236,8 @@ void
 NrPhy::DoDispose()
 {
     NS_LOG_FUNCTION(this);
-    m_slotAllocInfo.clear();
+    m_slotAllocInfo.Clear();
     m_controlMessageQueue.clear();
-    m_packetBurstMap.clear();
     m_ctrlMsgs.clear();
     m_tddPattern.clear();
     m_netDevice = nullptr;
@@ -375,14 +382,7 @@ NrPhy::SetMacPdu(const Ptr<Packet>& p, const SfnSf& sfn, uint8_t symStart, uint8
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(sfn.GetNumerology() == GetNumerology());
-    uint64_t key = sfn.GetEncForStreamWithSymStart(streamId, symStart);
-    auto it = m_packetBurstMap.find(key);
-
-    if (it == m_packetBurstMap.end())
-    {
-        it = m_packetBurstMap.insert(std::make_pair(key, CreateObject<PacketBurst>())).first;
-    }
-    it->second->AddPacket(p);
+    m_slotAllocInfo.AddPacket(sfn, symStart, streamId, p);
     NS_LOG_INFO("Adding a packet for the Packet Burst of " << sfn << " at sym " << +symStart
                                                            << std::endl);
 }
@@ -394,25 +394,24 @@ NrPhy::NotifyConnectionSuccessful()
     NS_LOG_FUNCTION(this);
 }
 
+void
+NrPhy::WakeUp()
+{
+    NS_LOG_FUNCTION(this);
+}
+
 Ptr<PacketBurst>
 NrPhy::GetPacketBurst(SfnSf sfn, uint8_t sym, uint8_t streamId)
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(sfn.GetNumerology() == GetNumerology());
-    Ptr<PacketBurst> pburst;
-    auto it = m_packetBurstMap.find(sfn.GetEncForStreamWithSymStart(streamId, sym));
+    Ptr<PacketBurst> pburst = m_slotAllocInfo.RetrievePacketBurst(sfn, sym, streamId);
 
-    if (it == m_packetBurstMap.end())
+    if (!pburst)
     {
         // For instance, this can happen with low BW and low MCS: The MAC
         // ignores the txOpportunity.
         NS_LOG_WARN("Packet burst not found for " << sfn << " at sym " << +sym);
-        return pburst;
-    }
-    else
-    {
-        pburst = it->second;
-        m_packetBurstMap.erase(it);
     }
     return pburst;
 }
@@ -782,95 +781,17 @@ NrPhy::PushBackSlotAllocInfo(const SlotAllocInfo& slotAllocInfo)
     NS_LOG_FUNCTION(this);
 
     NS_LOG_DEBUG("setting info for slot " << slotAllocInfo.m_sfnSf);
+    NS_ASSERT(slotAllocInfo.m_sfnSf.GetNumerology() == GetNumerology());
 
-    // That's not so complex, as the list would typically be of 2 or 3 elements.
-    bool updated = false;
-    for (auto& alloc : m_slotAllocInfo)
-    {
-        if (alloc.m_sfnSf == slotAllocInfo.m_sfnSf)
-        {
-            NS_LOG_INFO("Merging inside existing allocation");
-            alloc.Merge(slotAllocInfo);
-            updated = true;
-            break;
-        }
-    }
-    if (!updated)
-    {
-        m_slotAllocInfo.push_back(slotAllocInfo);
-        m_slotAllocInfo.sort();
-        NS_LOG_INFO("Pushing allocation at the end of the list");
-    }
-
-    std::stringstream output;
-
-    for (const auto& alloc : m_slotAllocInfo)
-    {
-        output << alloc;
-    }
-    NS_LOG_INFO(output.str());
+    m_slotAllocInfo.PushAllocation(slotAllocInfo);
+    NS_LOG_INFO(m_slotAllocInfo);
 }
 
 void
 NrPhy::PushFrontSlotAllocInfo(const SfnSf& newSfnSf, const SlotAllocInfo& slotAllocInfo)
 {
     NS_LOG_FUNCTION(this);
-
-    m_slotAllocInfo.push_front(slotAllocInfo);
-    SfnSf currentSfn = newSfnSf;
-    std::unordered_map<uint64_t, Ptr<PacketBurst>>
-        newBursts;                                 // map between new sfn and the packet burst
-    std::unordered_map<uint64_t, uint64_t> sfnMap; // map between new and old sfn, for debugging
-
-    // all the slot allocations  (and their packet burst) have to be "adjusted":
-    // directly modify the sfn for the allocation, and temporarly store the
-    // burst (along with the new sfn) into newBursts.
-    for (auto it = m_slotAllocInfo.begin(); it != m_slotAllocInfo.end(); ++it)
-    {
-        auto slotSfn = it->m_sfnSf;
-        for (const auto& alloc : it->m_varTtiAllocInfo)
-        {
-            if (alloc.m_dci->m_type == DciInfoElementTdma::DATA)
-            {
-                // move the pkt burst of all the streams correctly.
-                uint8_t streams = static_cast<uint8_t>(alloc.m_dci->m_tbSize.size());
-                for (uint8_t stream = 0; stream < streams; stream++)
-                {
-                    Ptr<PacketBurst> pburst =
-                        GetPacketBurst(slotSfn, alloc.m_dci->m_symStart, stream);
-                    if (pburst && pburst->GetNPackets() > 0)
-                    {
-                        newBursts.insert(std::make_pair(
-                            currentSfn.GetEncForStreamWithSymStart(stream, alloc.m_dci->m_symStart),
-                            pburst));
-                        sfnMap.insert(std::make_pair(
-                            currentSfn.GetEncForStreamWithSymStart(stream, alloc.m_dci->m_symStart),
-                            it->m_sfnSf.GetEncForStreamWithSymStart(stream,
-                                                                    alloc.m_dci->m_symStart)));
-                    }
-                    else
-                    {
-                        NS_LOG_INFO("No packet burst found for " << slotSfn);
-                    }
-                }
-            }
-        }
-
-        NS_LOG_INFO("Set slot allocation for " << it->m_sfnSf << " to " << currentSfn);
-        it->m_sfnSf = currentSfn;
-        currentSfn.Add(1);
-    }
-
-    for (const auto& burstPair : newBursts)
-    {
-        SfnSf old;
-        SfnSf latest;
-        old.Decode(sfnMap.at(burstPair.first));
-        latest.Decode(burstPair.first);
-        m_packetBurstMap.insert(std::make_pair(burstPair.first, burstPair.second));
-        NS_LOG_INFO("PacketBurst with " << burstPair.second->GetNPackets() << "packets for SFN "
-                                        << old << " now moved to SFN " << latest);
-    }
+    m_slotAllocInfo.PushFrontAllocation(newSfnSf, slotAllocInfo);
 }
 
 bool
@@ -878,23 +799,14 @@ NrPhy::SlotAllocInfoExists(const SfnSf& retVal) const
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(retVal.GetNumerology() == GetNumerology());
-    for (const auto& alloc : m_slotAllocInfo)
-    {
-        if (alloc.m_sfnSf == retVal)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_slotAllocInfo.HasAllocation(retVal);
 }
 
 SlotAllocInfo
 NrPhy::RetrieveSlotAllocInfo()
 {
     NS_LOG_FUNCTION(this);
-    SlotAllocInfo ret = *m_slotAllocInfo.begin();
-    m_slotAllocInfo.erase(m_slotAllocInfo.begin());
-    return ret;
+    return m_slotAllocInfo.RetrieveFirstAllocation();
 }
 
 SlotAllocInfo
@@ -902,19 +814,7 @@ NrPhy::RetrieveSlotAllocInfo(const SfnSf& sfnsf)
 {
     NS_LOG_FUNCTION(" slot " << sfnsf);
     NS_ASSERT(sfnsf.GetNumerology() == GetNumerology());
-
-    for (auto allocIt = m_slotAllocInfo.begin(); allocIt != m_slotAllocInfo.end(); ++allocIt)
-    {
-        if (allocIt->m_sfnSf == sfnsf)
-        {
-            SlotAllocInfo ret = *allocIt;
-            m_slotAllocInfo.erase(allocIt);
-            return ret;
-        }
-    }
-
-    NS_FATAL_ERROR("Didn't found the slot");
-    return SlotAllocInfo(sfnsf);
+    return m_slotAllocInfo.RetrieveAllocation(sfnsf);
 }
 
 SlotAllocInfo&
@@ -922,22 +822,21 @@ NrPhy::PeekSlotAllocInfo(const SfnSf& sfnsf)
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(sfnsf.GetNumerology() == GetNumerology());
-    for (auto& alloc : m_slotAllocInfo)
-    {
-        if (alloc.m_sfnSf == sfnsf)
-        {
-            return alloc;
-        }
-    }
-
-    NS_FATAL_ERROR("Didn't found the slot");
+    return m_slotAllocInfo.PeekAllocation(sfnsf);
 }
 
 size_t
 NrPhy::SlotAllocInfoSize() const
 {
     NS_LOG_FUNCTION(this);
-    return m_slotAllocInfo.size();
+    return m_slotAllocInfo.GetNumAllocations();
+}
+
+size_t
+NrPhy::PacketBurstSize() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_slotAllocInfo.GetNumPacketBursts();
 }
 
 bool
@@ -947,6 +846,20 @@ NrPhy::IsCtrlMsgListEmpty() const
     return m_controlMessageQueue.empty() || m_controlMessageQueue.at(0).empty();
 }
 
+bool
+NrPhy::IsCtrlMsgQueueEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& msgList : m_controlMessageQueue)
+    {
+        if (!msgList.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 Ptr<const SpectrumModel>
 NrPhy::GetSpectrumModel()
 {
@@ -1001,7 +914,7 @@ NrPhy::GetTbDecodeLatency() const
 NrPhySapProvider::PrachConfig
 NrPhy::GetPrachConfig(uint8_t index) const
 {
-    return m_phySapProvider->all_Prachconfigs.at(index);
+    return NrPhySapProvider::GetPrachConfigTable().at(index);
 }
 
 bool
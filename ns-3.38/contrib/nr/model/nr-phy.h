@@ -9,6 +9,7 @@
 
 #include "nr-phy-mac-common.h"
 #include "nr-phy-sap.h"
+#include "nr-slot-alloc-ring.h"
 
 #include <ns3/nr-spectrum-value-helper.h>
 
@@ -49,13 +50,14 @@ class BeamConfId;
  * At the gNb, After the MAC does the slot allocation, it is saved in the PHY with the method
  * PushBackSlotAllocInfo(), and if an allocation for the same slot is already
  * present, the two will be merged together. The slot allocation is stored
- * inside the variable m_slotAllocInfo.
+ * inside the variable m_slotAllocInfo, a NrSlotAllocRing indexed by the slot
+ * number.
  *
  * \section phy_mac_pdu Management of the MAC PDU that waits to be transmitted
  *
  * With each allocation, will come also one (or more) MAC PDU, that are stored
- * within the method SetMacPdu(). The storage is based on the SfnSf inside the
- * variable m_packetBurstMap.
+ * within the method SetMacPdu(). They are stored with the allocation of their
+ * slot, inside the variable m_slotAllocInfo.
  *
  * \section phy_numerology Configuration of the numerology and the related settings
  *
@@ -131,6 +133,11 @@ class NrPhy : public Object
      */
     void NotifyConnectionSuccessful();
 
+    /**
+     * \brief Wake up the PHY, if it stopped starting slots. Nothing to do in the base class.
+     */
+    virtual void WakeUp();
+
     /**
      * \brief Configures TB decode latency
      * \param us decode latency
@@ -464,7 +471,7 @@ class NrPhy : public Object
      * <0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0> , and therefore the places in which there
      * is a 1 are from the 4th to the 11th, and that is reflected in the output)
      */
-    std::vector<int> FromRBGBitmaskToRBAssignment(const std::vector<uint8_t> rbgBitmask) const;
+    std::vector<int> FromRBGBitmaskToRBAssignment(const RbgBitmask& rbgBitmask) const;
 
     /**
      * \brief Protected function that is used to get the number of resource
@@ -547,12 +554,24 @@ class NrPhy : public Object
      */
     size_t SlotAllocInfoSize() const;
 
+    /**
+     * \brief Retrieve the number of packet bursts waiting to be transmitted
+     * \return the number of packet bursts
+     */
+    size_t PacketBurstSize() const;
+
     /**
      * \brief Check if there are no control messages queued for this slot
      * \return true if there are no control messages queued for this slot
      */
     bool IsCtrlMsgListEmpty() const;
 
+    /**
+     * \brief Check if there are no control messages queued for any slot
+     * \return true if all the lists of the control message queue are empty
+     */
+    bool IsCtrlMsgQueueEmpty() const;
+
     /**
      * \brief Enqueue a CTRL message without considering L1L2CtrlLatency
      * \param msg The message to enqueue
@@ -583,9 +602,6 @@ class NrPhy : public Object
     double m_txPower{0.0};     //!< Transmission power (attribute)
     double m_noiseFigure{0.0}; //!< Noise figure (attribute)
 
-    std::unordered_map<uint64_t, Ptr<PacketBurst>>
-        m_packetBurstMap; //!< Map between SfnSf and PacketBurst
-
     SlotAllocInfo m_currSlotAllocInfo; //!< Current slot allocation
 
     NrPhySapProvider* m_phySapProvider; //!< Pointer to the MAC
@@ -599,7 +615,7 @@ class NrPhy : public Object
     std::map<uint8_t, uint8_t> m_ulSchedDeviationMap; // Map used by GnB map to schedule msg3 receptions
 
   private:
-    std::list<SlotAllocInfo> m_slotAllocInfo; //!< slot allocation info list
+    NrSlotAllocRing m_slotAllocInfo; //!< slot allocations and their packet bursts
     std::vector<std::list<Ptr<NrControlMessage>>> m_controlMessageQueue; //!< CTRL message queue
 
     Time m_tbDecodeLatencyUs{MicroSeconds(100)}; //!< transport block decode latency
@@ -634,7 +650,6 @@ class NrPhy : public Object
                                                                //!< power uniformly over all RBs, or
                                                                //!< only used RBs
 
-    std::vector<NrPhySapProvider::PrachConfig> all_Prachconfigs;
     bool m_inRachProcess{false};
   
   
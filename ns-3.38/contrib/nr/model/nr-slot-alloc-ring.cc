@@ -0,0 +1,351 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nr-slot-alloc-ring.h"
+
+#include <ns3/log.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrSlotAllocRing");
+
+NrSlotAllocRing::NrSlotAllocRing(uint32_t capacity)
+{
+    uint32_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    m_entries.resize(size);
+    m_mask = size - 1;
+}
+
+NrSlotAllocRing::Entry*
+NrSlotAllocRing::FindEntry(const SfnSf& sfn)
+{
+    const uint64_t slot = sfn.Normalize();
+    Entry& entry = m_entries[slot & m_mask];
+    return (!entry.IsFree() && entry.m_slot == slot) ? &entry : nullptr;
+}
+
+const NrSlotAllocRing::Entry*
+NrSlotAllocRing::FindEntry(const SfnSf& sfn) const
+{
+    const uint64_t slot = sfn.Normalize();
+    const Entry& entry = m_entries[slot & m_mask];
+    return (!entry.IsFree() && entry.m_slot == slot) ? &entry : nullptr;
+}
+
+NrSlotAllocRing::Entry&
+NrSlotAllocRing::GetOrCreateEntry(const SfnSf& sfn)
+{
+    const uint64_t slot = sfn.Normalize();
+    while (true)
+    {
+        Entry& entry = m_entries[slot & m_mask];
+        if (entry.IsFree())
+        {
+            entry.m_slot = slot;
+            return entry;
+        }
+        if (entry.m_slot == slot)
+        {
+            return entry;
+        }
+        if (!entry.m_hasAllocation && entry.m_slot < m_lastRetrievedSlot)
+        {
+            NS_LOG_WARN("Dropping " << entry.m_bursts.size() << " packet bursts of the past slot "
+                                    << entry.m_slot);
+            m_numPacketBursts -= entry.m_bursts.size();
+            entry.m_bursts.clear();
+            entry.m_slot = slot;
+            return entry;
+        }
+        Grow();
+    }
+}
+
+void
+NrSlotAllocRing::Grow()
+{
+    uint64_t size = m_entries.size();
+    bool fits = false;
+    while (!fits)
+    {
+        size *= 2;
+        std::vector<bool> used(size, false);
+        fits = true;
+        for (const auto& entry : m_entries)
+        {
+            if (entry.IsFree())
+            {
+                continue;
+            }
+            if (used[entry.m_slot & (size - 1)])
+            {
+                fits = false;
+                break;
+            }
+            used[entry.m_slot & (size - 1)] = true;
+        }
+    }
+    NS_LOG_INFO("Growing the ring from " << m_entries.size() << " to " << size << " entries");
+
+    std::vector<Entry> entries(size);
+    for (auto& entry : m_entries)
+    {
+        if (!entry.IsFree())
+        {
+            entries[entry.m_slot & (size - 1)] = std::move(entry);
+        }
+    }
+    m_entries.swap(entries);
+    m_mask = size - 1;
+}
+
+SlotAllocInfo
+NrSlotAllocRing::TakeAllocation(Entry& entry)
+{
+    NS_ASSERT(entry.m_hasAllocation);
+    SlotAllocInfo ret = std::move(entry.m_allocation);
+    entry.m_allocation.m_varTtiAllocInfo.clear();
+    entry.m_hasAllocation = false;
+    m_numAllocations--;
+    return ret;
+}
+
+void
+NrSlotAllocRing::PushAllocation(const SlotAllocInfo& slotAllocInfo)
+{
+    Entry& entry = GetOrCreateEntry(slotAllocInfo.m_sfnSf);
+    if (entry.m_hasAllocation)
+    {
+        NS_LOG_INFO("Merging inside existing allocation");
+        entry.m_allocation.Merge(slotAllocInfo);
+    }
+    else
+    {
+        entry.m_allocation = slotAllocInfo;
+        entry.m_hasAllocation = true;
+        m_numAllocations++;
+    }
+}
+
+void
+NrSlotAllocRing::PushFrontAllocation(const SfnSf& sfn, const SlotAllocInfo& slotAllocInfo)
+{
+    std::vector<SlotAllocInfo> allocations;
+    allocations.reserve(m_numAllocations + 1);
+    allocations.push_back(slotAllocInfo);
+    for (auto& entry : m_entries)
+    {
+        if (entry.m_hasAllocation)
+        {
+            allocations.push_back(TakeAllocation(entry));
+        }
+    }
+    std::sort(allocations.begin() + 1, allocations.end());
+
+    // take the bursts of the DATA DCIs out of their old slots before any of
+    // the allocations takes its new slot
+    std::vector<std::vector<Burst>> bursts(allocations.size());
+    for (std::size_t i = 0; i < allocations.size(); ++i)
+    {
+        for (const auto& varTti : allocations[i].m_varTtiAllocInfo)
+        {
+            if (varTti.m_dci->m_type != DciInfoElementTdma::DATA)
+            {
+                continue;
+            }
+            const uint8_t symStart = varTti.m_dci->m_symStart;
+            const uint8_t streams = static_cast<uint8_t>(varTti.m_dci->m_tbSize.size());
+            for (uint8_t stream = 0; stream < streams; ++stream)
+            {
+                Ptr<PacketBurst> burst =
+                    RetrievePacketBurst(allocations[i].m_sfnSf, symStart, stream);
+                if (burst && burst->GetNPackets() > 0)
+                {
+                    bursts[i].push_back({symStart, stream, burst});
+                }
+                else
+                {
+                    NS_LOG_INFO("No packet burst found for " << allocations[i].m_sfnSf);
+                }
+            }
+        }
+    }
+
+    SfnSf currentSfn = sfn;
+    for (std::size_t i = 0; i < allocations.size(); ++i)
+    {
+        NS_LOG_INFO("Set slot allocation for " << allocations[i].m_sfnSf << " to " << currentSfn);
+        allocations[i].m_sfnSf = currentSfn;
+        Entry& entry = GetOrCreateEntry(currentSfn);
+        NS_ASSERT(!entry.m_hasAllocation);
+        entry.m_allocation = std::move(allocations[i]);
+        entry.m_hasAllocation = true;
+        m_numAllocations++;
+        for (auto& burst : bursts[i])
+        {
+            entry.m_bursts.push_back(std::move(burst));
+            m_numPacketBursts++;
+        }
+        currentSfn.Add(1);
+    }
+}
+
+bool
+NrSlotAllocRing::HasAllocation(const SfnSf& sfn) const
+{
+    const Entry* entry = FindEntry(sfn);
+    return entry != nullptr && entry->m_hasAllocation;
+}
+
+SlotAllocInfo&
+NrSlotAllocRing::PeekAllocation(const SfnSf& sfn)
+{
+    Entry* entry = FindEntry(sfn);
+    NS_ABORT_MSG_IF(entry == nullptr || !entry->m_hasAllocation, "Didn't found the slot");
+    return entry->m_allocation;
+}
+
+SlotAllocInfo
+NrSlotAllocRing::RetrieveAllocation(const SfnSf& sfn)
+{
+    Entry* entry = FindEntry(sfn);
+    NS_ABORT_MSG_IF(entry == nullptr || !entry->m_hasAllocation, "Didn't found the slot");
+    m_lastRetrievedSlot = std::max(m_lastRetrievedSlot, entry->m_slot);
+    return TakeAllocation(*entry);
+}
+
+SlotAllocInfo
+NrSlotAllocRing::RetrieveFirstAllocation()
+{
+    Entry* first = nullptr;
+    for (auto& entry : m_entries)
+    {
+        if (entry.m_hasAllocation && (first == nullptr || entry.m_slot < first->m_slot))
+        {
+            first = &entry;
+        }
+    }
+    NS_ABORT_MSG_IF(first == nullptr, "No slot allocation");
+    m_lastRetrievedSlot = std::max(m_lastRetrievedSlot, first->m_slot);
+    return TakeAllocation(*first);
+}
+
+std::size_t
+NrSlotAllocRing::GetNumAllocations() const
+{
+    return m_numAllocations;
+}
+
+void
+NrSlotAllocRing::AddPacket(const SfnSf& sfn,
+                           uint8_t symStart,
+                           uint8_t streamId,
+                           const Ptr<Packet>& p)
+{
+    Entry& entry = GetOrCreateEntry(sfn);
+    for (auto& burst : entry.m_bursts)
+    {
+        if (burst.m_symStart == symStart && burst.m_streamId == streamId)
+        {
+            burst.m_burst->AddPacket(p);
+            return;
+        }
+    }
+    entry.m_bursts.push_back({symStart, streamId, CreateObject<PacketBurst>()});
+    entry.m_bursts.back().m_burst->AddPacket(p);
+    m_numPacketBursts++;
+}
+
+Ptr<PacketBurst>
+NrSlotAllocRing::RetrievePacketBurst(const SfnSf& sfn, uint8_t symStart, uint8_t streamId)
+{
+    Entry* entry = FindEntry(sfn);
+    if (entry == nullptr)
+    {
+        return nullptr;
+    }
+    for (auto it = entry->m_bursts.begin(); it != entry->m_bursts.end(); ++it)
+    {
+        if (it->m_symStart == symStart && it->m_streamId == streamId)
+        {
+            Ptr<PacketBurst> ret = it->m_burst;
+            if (&*it != &entry->m_bursts.back())
+            {
+                *it = std::move(entry->m_bursts.back());
+            }
+            entry->m_bursts.pop_back();
+            m_numPacketBursts--;
+            return ret;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t
+NrSlotAllocRing::GetNumPacketBursts() const
+{
+    return m_numPacketBursts;
+}
+
+uint32_t
+NrSlotAllocRing::GetCapacity() const
+{
+    return static_cast<uint32_t>(m_entries.size());
+}
+
+void
+NrSlotAllocRing::Clear()
+{
+    for (auto& entry : m_entries)
+    {
+        entry.m_allocation.m_varTtiAllocInfo.clear();
+        entry.m_hasAllocation = false;
+        entry.m_bursts.clear();
+    }
+    m_numAllocations = 0;
+    m_numPacketBursts = 0;
+    m_lastRetrievedSlot = 0;
+}
+
+void
+NrSlotAllocRing::Print(std::ostream& os) const
+{
+    for (const auto& entry : m_entries)
+    {
+        if (entry.m_hasAllocation)
+        {
+            os << entry.m_allocation;
+        }
+    }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const NrSlotAllocRing& ring)
+{
+    ring.Print(os);
+    return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,228 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_SLOT_ALLOC_RING_H
+#define NR_SLOT_ALLOC_RING_H
+
+#include "nr-phy-mac-common.h"
+
+#include <ns3/packet-burst.h>
+#include <ns3/packet.h>
+
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup utils
+ * \brief The future slot allocations of a PHY, and their MAC PDUs
+ *
+ * The allocations of a PHY are at most a few slots ahead of the current one
+ * (L1L2CtrlLatency and the K delays). They are stored in a ring of entries,
+ * indexed by the slot number (SfnSf::Normalize) modulo the number of entries.
+ * An entry holds the allocation of the slot and the packet bursts to be sent
+ * in it, so that the insertion, the lookup and the retrieval of both are done
+ * in constant time, and the entries are reused without new allocations.
+ *
+ * An entry is free when its allocation has been retrieved and its bursts
+ * too. When a slot falls on an entry of another slot:
+ * - if the other slot is before the latest slot whose allocation has been
+ *   retrieved, and has no allocation, it is over and its bursts have not
+ *   been sent: they are dropped;
+ * - otherwise, the ring is doubled as many times as needed for all the
+ *   stored slots, both included, to have their own entry.
+ *
+ * The initial number of entries covers the usual look-ahead; a deeper one
+ * grows the ring, which is never shrunk afterwards.
+ */
+class NrSlotAllocRing
+{
+  public:
+    /**
+     * \brief NrSlotAllocRing constructor
+     * \param capacity the initial number of entries, rounded up to a power of 2
+     */
+    NrSlotAllocRing(uint32_t capacity = 16);
+
+    /**
+     * \brief Store an allocation, merged with the one of the same slot, if any
+     * \param slotAllocInfo the allocation
+     */
+    void PushAllocation(const SlotAllocInfo& slotAllocInfo);
+
+    /**
+     * \brief Store an allocation for a slot, before all the stored ones
+     *
+     * The stored allocations, and the bursts of their DATA DCIs, are moved to
+     * the consecutive slots after sfn, in the order of their slots.
+     * \param sfn the slot of the allocation
+     * \param slotAllocInfo the allocation, whose bursts are in its m_sfnSf slot
+     */
+    void PushFrontAllocation(const SfnSf& sfn, const SlotAllocInfo& slotAllocInfo);
+
+    /**
+     * \param sfn the slot
+     * \return true if there is an allocation for the slot
+     */
+    bool HasAllocation(const SfnSf& sfn) const;
+
+    /**
+     * \brief Get the allocation of a slot, which has to exist
+     * \param sfn the slot
+     * \return a reference to the allocation
+     */
+    SlotAllocInfo& PeekAllocation(const SfnSf& sfn);
+
+    /**
+     * \brief Remove the allocation of a slot, which has to exist
+     * \param sfn the slot
+     * \return the allocation
+     */
+    SlotAllocInfo RetrieveAllocation(const SfnSf& sfn);
+
+    /**
+     * \brief Remove the allocation of the earliest slot; there has to be one
+     * \return the allocation
+     */
+    SlotAllocInfo RetrieveFirstAllocation();
+
+    /**
+     * \return the number of stored allocations
+     */
+    std::size_t GetNumAllocations() const;
+
+    /**
+     * \brief Add a packet to the burst of a slot and symbol
+     * \param sfn the slot
+     * \param symStart the first symbol of the burst
+     * \param streamId the stream of the burst
+     * \param p the packet
+     */
+    void AddPacket(const SfnSf& sfn, uint8_t symStart, uint8_t streamId, const Ptr<Packet>& p);
+
+    /**
+     * \brief Remove the burst of a slot and symbol
+     * \param sfn the slot
+     * \param symStart the first symbol of the burst
+     * \param streamId the stream of the burst
+     * \return the burst, or nullptr if there is none
+     */
+    Ptr<PacketBurst> RetrievePacketBurst(const SfnSf& sfn, uint8_t symStart, uint8_t streamId);
+
+    /**
+     * \return the number of stored bursts
+     */
+    std::size_t GetNumPacketBursts() const;
+
+    /**
+     * \return the number of entries of the ring
+     */
+    uint32_t GetCapacity() const;
+
+    /**
+     * \brief Remove all the allocations and bursts
+     */
+    void Clear();
+
+    /**
+     * \brief Print the stored allocations, in the order of the ring
+     * \param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /**
+     * \brief The burst of a symbol and stream
+     */
+    struct Burst
+    {
+        uint8_t m_symStart{0};    //!< the first symbol
+        uint8_t m_streamId{0};    //!< the stream
+        Ptr<PacketBurst> m_burst; //!< the packets
+    };
+
+    /**
+     * \brief The allocation and the bursts of a slot
+     */
+    struct Entry
+    {
+        uint64_t m_slot{0};                  //!< the normalized slot
+        bool m_hasAllocation{false};         //!< true if m_allocation is stored
+        SlotAllocInfo m_allocation{SfnSf()}; //!< the allocation
+        std::vector<Burst> m_bursts;         //!< the bursts
+
+        /**
+         * \return true if the entry holds nothing
+         */
+        bool IsFree() const
+        {
+            return !m_hasAllocation && m_bursts.empty();
+        }
+    };
+
+    /**
+     * \param sfn the slot
+     * \return the entry of the slot, or nullptr if it has none
+     */
+    Entry* FindEntry(const SfnSf& sfn);
+
+    /**
+     * \param sfn the slot
+     * \return the entry of the slot, or nullptr if it has none
+     */
+    const Entry* FindEntry(const SfnSf& sfn) const;
+
+    /**
+     * \brief Get the entry of a slot, taking a free or stale one if needed
+     * \param sfn the slot
+     * \return the entry
+     */
+    Entry& GetOrCreateEntry(const SfnSf& sfn);
+
+    /**
+     * \brief Double the ring until all the stored slots have their entry
+     */
+    void Grow();
+
+    /**
+     * \brief Remove the allocation of an entry
+     * \param entry the entry, with an allocation
+     * \return the allocation
+     */
+    SlotAllocInfo TakeAllocation(Entry& entry);
+
+    std::vector<Entry> m_entries;     //!< the ring, with a power of 2 entries
+    uint64_t m_mask{0};               //!< m_entries.size () - 1
+    std::size_t m_numAllocations{0};  //!< the number of stored allocations
+    std::size_t m_numPacketBursts{0}; //!< the number of stored bursts
+    uint64_t m_lastRetrievedSlot{0};  //!< the latest slot whose allocation was retrieved
+};
+
+/**
+ * \brief Stream insertion operator
+ * \param os the output stream
+ * \param ring the ring
+ * \return a reference to the output stream
+ */
+std::ostream& operator<<(std::ostream& os, const NrSlotAllocRing& ring);
+
+} // namespace ns3
+
+#endif /* NR_SLOT_ALLOC_RING_H */
@@ -224,6 +224,13 @@ NrSpectrumPhy::SetPhyUlHarqFeedbackCallback(const NrPhyUlHarqFeedbackCallback& c
     m_phyUlHarqFeedbackCallback = c;
 }
 
+void
+NrSpectrumPhy::SetPhyRemoteRxCallback(const NrPhyRemoteRxCallback& c)
+{
+    NS_LOG_FUNCTION(this);
+    m_phyRemoteRxCallback = c;
+}
+
 // inherited from SpectrumPhy
 void
 NrSpectrumPhy::SetDevice(Ptr<NetDevice> d)
@@ -399,6 +406,13 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
     Time duration = params->duration;
     NS_LOG_INFO("Start receiving signal: " << rxPsd << " duration= " << duration);
 
+    if (!m_phyRemoteRxCallback.IsNull())
+    {
+        // the node is simulated by another process, for which the signal is interference
+        m_phyRemoteRxCallback(rxPsd, duration);
+        return;
+    }
+
     Ptr<NrSpectrumSignalParametersDataFrame> nrDataRxParams =
         DynamicCast<NrSpectrumSignalParametersDataFrame>(params);
 
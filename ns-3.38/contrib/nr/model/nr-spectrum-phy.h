@@ -125,6 +125,13 @@ class NrSpectrumPhy : public SpectrumPhy
      */
     typedef Callback<void, const UlHarqInfo&> NrPhyUlHarqFeedbackCallback;
 
+    /**
+     * This callback method type is used to pass the signals received by the
+     * NrSpectrumPhy of a node which is simulated by another process of a
+     * distributed simulation, see NrDistributedHelper
+     */
+    typedef Callback<void, Ptr<const SpectrumValue>, Time> NrPhyRemoteRxCallback;
+
     /**
      * \brief Sets the callback to be called when DATA is received successfully
      * \param c the callback function
@@ -149,6 +156,16 @@ class NrSpectrumPhy : public SpectrumPhy
      */
     void SetPhyUlHarqFeedbackCallback(const NrPhyUlHarqFeedbackCallback& c);
 
+    /**
+     * \brief Sets the callback to be called instead of receiving a signal
+     *
+     * The node of this NrSpectrumPhy is simulated by another process. Every
+     * signal is passed to the callback, which sends it to that process as
+     * interference, and is not received here.
+     * \param c the callback function
+     */
+    void SetPhyRemoteRxCallback(const NrPhyRemoteRxCallback& c);
+
     // Methods inherited from spectrum phy
     void SetDevice(Ptr<NetDevice> d) override;
     Ptr<NetDevice> GetDevice() const override;
@@ -726,6 +743,8 @@ class NrSpectrumPhy : public SpectrumPhy
     NrPhyUlHarqFeedbackCallback
         m_phyUlHarqFeedbackCallback; //!< callback that is notified when the UL HARQ feedback is
                                      //!< being generated
+    NrPhyRemoteRxCallback
+        m_phyRemoteRxCallback; //!< callback receiving the signals of a node of another process
 
     // traces
     TracedCallback<Time>
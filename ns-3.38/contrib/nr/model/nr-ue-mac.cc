@@ -231,6 +231,8 @@ class MacUeMemberPhySapUser : public NrUePhySapUser
 
 
   virtual void RecvSib1(NrSib1Message sib1, NrPhySapProvider::PrachConfig prachOccasions) override;
+  bool IsDormant() const override;
+  bool IsPagingOccasion(const SfnSf& s) const override;
  private:
     NrUeMac* m_mac;
 };
@@ -258,6 +260,18 @@ MacUeMemberPhySapUser::RecvSib1(NrSib1Message sib1, NrPhySapProvider::PrachConfi
     m_mac->DoRecvSib1(sib1, prachOccasions);
 }
 
+bool
+MacUeMemberPhySapUser::IsDormant() const
+{
+    return m_mac->DoIsDormant();
+}
+
+bool
+MacUeMemberPhySapUser::IsPagingOccasion(const SfnSf& s) const
+{
+    return m_mac->DoIsPagingOccasion(s);
+}
+
 void
 MacUeMemberPhySapUser::SlotIndication(SfnSf sfn)
 {
@@ -583,6 +597,7 @@ NrUeMac::DoReportBufferStatus(LteMacSapProvider::ReportBufferStatusParameters pa
     {
         NS_LOG_INFO("INACTIVE -> TO_SEND, bufSize " << GetTotalBufSize());
         m_srState = TO_SEND;
+        m_phySapProvider->WakeUp();
     }
     
 }
@@ -1308,6 +1323,7 @@ NrUeMac::DoStartContentionBasedRandomAccessProcedure(bool redcap, bool do_2step_
     m_preambleTransmissionCounter = 1;
     m_backoffParameter = 0;
     m_startingRach = true;
+    m_phySapProvider->WakeUp();
     
 }
 
@@ -1590,6 +1606,7 @@ NrUeMac::SrSchedulingTimeout()
     if(m_srState == ACTIVE)
      {
         m_srState = TO_SEND;
+        m_phySapProvider->WakeUp();
         //we waited for an UL_DCi but didnt get one. Try it again
      }
 }
@@ -1604,6 +1621,40 @@ NrUeMac::DoStartNonContentionBasedRandomAccessProcedure(uint16_t rnti,
                   "requested PRACH MASK = " << (uint32_t)prachMask
                                             << ", but only PRACH MASK = 0 is supported");
     m_rnti = rnti;
+    m_phySapProvider->WakeUp();
+}
+
+bool
+NrUeMac::DoIsDormant() const
+{
+    if (m_srState == TO_SEND || m_startingRach || m_waitForPrachOcc)
+    {
+        return false;
+    }
+    if (!m_activeBwpDL && !m_activeBwpUL)
+    {
+        return true;
+    }
+    // RRC INACTIVE: only paging is expected, which is received as control message
+    return m_drxConfigured && m_rnti == 0 && !m_waitingForRaResponse && GetTotalBufSize() == 0;
+}
+
+bool
+NrUeMac::DoIsPagingOccasion(const SfnSf& s) const
+{
+    if (!m_drxConfigured)
+    {
+        return true;
+    }
+    if (m_edrxConfigured)
+    {
+        // an eDRX cycle of at most 1024 frames replaces the DRX cycle as T (TS 38.304 7.1);
+        // the longer ones also need the paging hyperframe and paging time window
+        NS_ABORT_MSG_IF(m_edrx > 1024,
+                        "eDRX cycles of more than 1024 frames are not supported, got " << m_edrx);
+        return NrPhySapProvider::IsPagingFrame(s.GetFrame(), m_pRnti, m_edrx);
+    }
+    return NrPhySapProvider::IsPagingFrame(s.GetFrame(), m_pRnti, m_drx);
 }
 
 void
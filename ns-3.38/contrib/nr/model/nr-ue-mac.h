@@ -415,6 +415,21 @@ class NrUeMac : public Object
 
 
     void DoRecvSib1(NrSib1Message sib1, NrPhySapProvider::PrachConfig prachOccasions);
+    /**
+     * \brief Check if the MAC has nothing to do in the next slots
+     * \return true if the BWP is not active, or if the UE is in RRC INACTIVE (DRX
+     * configured, no RNTI) with empty buffers and no random access ongoing
+     */
+    bool DoIsDormant() const;
+    /**
+     * \brief Check if the UE monitors the paging in a slot
+     * \param s the slot
+     * \return true if the slot is in a paging frame of the paging RNTI, or if no
+     * DRX cycle is configured. The paging cycle is the eDRX cycle if one is
+     * configured, otherwise the DRX cycle. eDRX cycles of more than 1024 frames,
+     * with a paging time window, are not supported.
+     */
+    bool DoIsPagingOccasion(const SfnSf& s) const;
     void ProcessULPacket ();
 
 
@@ -18,6 +18,7 @@
 #include <ns3/udp-header.h>
 #include <ns3/lte-ue-component-carrier-manager.h>
 #include "nr-ue-rrc.h"
+#include <ns3/boolean.h>
 #include <ns3/object-map.h>
 #include <ns3/pointer.h>
 
@@ -69,7 +70,25 @@ NrUeNetDevice::GetTypeId()
                           "Starting time for the energy model in ms.",
                           UintegerValue(0),
                           MakeUintegerAccessor(&NrUeNetDevice::m_energyStartTime),
-                          MakeUintegerChecker<uint32_t>());
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("EnergyStateHistorySize",
+                          "Number of power state changes kept by the energy model, 0 to keep none.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrUeNetDevice::m_energyStateHistorySize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("EnergyLogBinary",
+                          "Write the energy statistics into the binary Energystates.bin "
+                          "instead of Energystates.log.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrUeNetDevice::m_energyLogBinary),
+                          MakeBooleanChecker())
+            .AddAttribute("EnergyProjectionInterval",
+                          "Projection interval of the energy model. If not zero, the lifetime of "
+                          "the battery is extrapolated from the power observed since "
+                          "EnergyModelStartTime. Should be a multiple of the (e)DRX cycle.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NrUeNetDevice::m_energyProjectionInterval),
+                          MakeTimeChecker());
     return tid;
 }
 
@@ -214,7 +233,9 @@ void
 NrUeNetDevice::SetChip(NrChip chip)
 {
     m_energyModel = std::make_unique<NrEnergyModel>(chip,m_energyStartTime);
-    m_energyModel->m_outputDir = GetOutputDir();
+    m_energyModel->SetOutputDir(GetOutputDir(), m_energyLogBinary);
+    m_energyModel->SetStateHistorySize(m_energyStateHistorySize);
+    m_energyModel->SetProjectionInterval(m_energyProjectionInterval);
 }
 
 Ptr<NrUeMac>
@@ -199,6 +199,9 @@ class NrUeNetDevice : public NrNetDevice
     std::map<uint8_t, Ptr<BandwidthPartUe>> m_ccMap;             ///< component carrier map
     Ptr<LteUeComponentCarrierManager> m_componentCarrierManager; ///< the component carrier manager
     uint32_t m_energyStartTime;
+    uint32_t m_energyStateHistorySize; //!< state changes kept by the energy model
+    bool m_energyLogBinary;            //!< binary energy log
+    Time m_energyProjectionInterval;   //!< projection interval of the energy model
 };
 
 } // namespace ns3
@@ -209,7 +209,17 @@ NrUePhy::GetTypeId()
                             BooleanValue (false),
                             MakeBooleanAccessor (&NrUePhy::SetActiveBwpStatus,
                                                     &NrUePhy::GetActiveBwpStatus),
-                            MakeBooleanChecker ());
+                            MakeBooleanChecker ())
+            .AddAttribute("SleepWhenIdle",
+                          "Stop the slot processing while the BWP is not active or the UE "
+                          "is in RRC INACTIVE waiting for paging. The slots are started again "
+                          "when the UE has to transmit, or receives a DCI for its RNTI or a "
+                          "paging message in its paging occasion; the other control messages "
+                          "received while sleeping are ignored. The gNB then has to send the "
+                          "paging in the paging frames (NrGnbMac::PagingInPagingFrames).",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrUePhy::m_sleepWhenIdle),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -508,6 +518,15 @@ NrUePhy::PhyCtrlMessagesReceived(const Ptr<NrControlMessage>& msg)
     {
         return;
     }
+    if (m_sleeping)
+    {
+        if (!IsWakeUpMessage(msg))
+        {
+            NS_LOG_INFO("UE " << m_rnti << " sleeping, ignore message " << msg->GetMessageType());
+            return;
+        }
+        WakeUpForReception();
+    }
     if (msg->GetMessageType() == NrControlMessage::DL_DCI)
     {
         auto dciMsg = DynamicCast<NrDlDciMessage>(msg);
@@ -533,8 +552,6 @@ NrUePhy::PhyCtrlMessagesReceived(const Ptr<NrControlMessage>& msg)
                               << static_cast<uint32_t>(dciInfoElem->m_harqProcess));
         }
 
-        /* BIG ASSUMPTION: We assume that K0 is always 0 */
-
         auto it = m_harqIdToK1Map.find(dciInfoElem->m_harqProcess);
         if (it != m_harqIdToK1Map.end())
         {
@@ -550,7 +567,14 @@ NrUePhy::PhyCtrlMessagesReceived(const Ptr<NrControlMessage>& msg)
                               dciInfoElem->m_harqProcess,
                               dciMsg->GetK1Delay());
 
-        InsertAllocation(dciInfoElem);
+        if (k0Delay == 0)
+        {
+            InsertAllocation(dciInfoElem);
+        }
+        else
+        {
+            InsertFutureAllocation(dciSfn, dciInfoElem);
+        }
 
         m_phySapUser->ReceiveControlMessage(msg);
 
@@ -753,17 +777,18 @@ NrUePhy::PushCtrlAllocations(const SfnSf currentSfnSf)
 
     // The UE does not know anything from the GNB yet, so listen on the default
     // bandwidth.
-    std::vector<uint8_t> rbgBitmask(GetRbNum(), 1);
+    RbgBitmask rbgBitmask(GetRbNum(), 1);
 
     // The UE still doesn't know the TDD pattern, so just add a DL CTRL
     if (m_tddPattern.size() == 0)
     {
         NS_LOG_INFO("TDD Pattern unknown, insert DL CTRL at the beginning of the slot");
-        VarTtiAllocInfo dlCtrlSlot(std::make_shared<DciInfoElementTdma>(0,
-                                                                        m_dlCtrlSyms,
-                                                                        DciInfoElementTdma::DL,
-                                                                        DciInfoElementTdma::CTRL,
-                                                                        rbgBitmask));
+        VarTtiAllocInfo dlCtrlSlot(
+            NrMemoryPool::MakeShared<DciInfoElementTdma>(0,
+                                                         m_dlCtrlSyms,
+                                                         DciInfoElementTdma::DL,
+                                                         DciInfoElementTdma::CTRL,
+                                                         rbgBitmask));
         m_currSlotAllocInfo.m_varTtiAllocInfo.push_front(dlCtrlSlot);
         return;
     }
@@ -775,11 +800,12 @@ NrUePhy::PushCtrlAllocations(const SfnSf currentSfnSf)
         NS_LOG_INFO("The current TDD pattern indicates that we are in a "
                     << m_tddPattern[currentSlotN]
                     << " slot, so insert DL CTRL at the beginning of the slot");
-        VarTtiAllocInfo dlCtrlSlot(std::make_shared<DciInfoElementTdma>(0,
-                                                                        m_dlCtrlSyms,
-                                                                        DciInfoElementTdma::DL,
-                                                                        DciInfoElementTdma::CTRL,
-                                                                        rbgBitmask));
+        VarTtiAllocInfo dlCtrlSlot(
+            NrMemoryPool::MakeShared<DciInfoElementTdma>(0,
+                                                         m_dlCtrlSyms,
+                                                         DciInfoElementTdma::DL,
+                                                         DciInfoElementTdma::CTRL,
+                                                         rbgBitmask));
         m_currSlotAllocInfo.m_varTtiAllocInfo.push_front(dlCtrlSlot);
     }
     if (m_tddPattern[currentSlotN] > LteNrTddSlotType::DL)
@@ -788,11 +814,11 @@ NrUePhy::PushCtrlAllocations(const SfnSf currentSfnSf)
                     << m_tddPattern[currentSlotN]
                     << " slot, so insert UL CTRL at the end of the slot");
         VarTtiAllocInfo ulCtrlSlot(
-            std::make_shared<DciInfoElementTdma>(GetSymbolsPerSlot() - m_ulCtrlSyms,
-                                                 m_ulCtrlSyms,
-                                                 DciInfoElementTdma::UL,
-                                                 DciInfoElementTdma::CTRL,
-                                                 rbgBitmask));
+            NrMemoryPool::MakeShared<DciInfoElementTdma>(GetSymbolsPerSlot() - m_ulCtrlSyms,
+                                                         m_ulCtrlSyms,
+                                                         DciInfoElementTdma::UL,
+                                                         DciInfoElementTdma::CTRL,
+                                                         rbgBitmask));
         m_currSlotAllocInfo.m_varTtiAllocInfo.push_back(ulCtrlSlot);
     }
 }
@@ -865,24 +891,17 @@ NrUePhy::StartSlot(const SfnSf& s)
         VarTtiAllocInfo allocation = m_currSlotAllocInfo.m_varTtiAllocInfo.front();
         m_currSlotAllocInfo.m_varTtiAllocInfo.pop_front();
 
-        auto ctrlMsgs = PopCurrentSlotCtrlMsgs();
-        if (m_netDevice)
-        {
-            DynamicCast<NrUeNetDevice>(m_netDevice)->RouteOutgoingCtrlMsgs(ctrlMsgs, GetBwpId());
-        }
-        else
-        {
-            // No netDevice (that could happen in tests) so just redirect them to us
-            for (const auto& msg : ctrlMsgs)
-            {
-                EncodeCtrlMsg(msg);
-            }
-        }
+        SendCurrentSlotCtrlMsgs();
 
         auto nextVarTtiStart = GetSymbolPeriod() * allocation.m_dci->m_symStart;
         Simulator::Schedule(nextVarTtiStart, &NrUePhy::StartVarTti, this, allocation.m_dci, allocation.m_isMsg3);
 
         
+    }
+    else if (CanSleep())
+    {
+        //Bwp not active and nothing pending. The next slot is started by WakeUp
+        m_sleeping = true;
     }
     else
     {
@@ -1262,7 +1281,21 @@ NrUePhy::EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci)
         m_tryToPerformLbt = false;
     }
 
-    if (m_currSlotAllocInfo.m_varTtiAllocInfo.size() == 0)
+    ScheduleNextVarTti();
+
+    m_receptionEnabled = false;
+}
+
+void
+NrUePhy::ScheduleNextVarTti()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_currSlotAllocInfo.m_varTtiAllocInfo.size() == 0 && CanSleep())
+    {
+        // end of slot, and the UE is dormant. The next slot is started by WakeUp
+        m_sleeping = true;
+    }
+    else if (m_currSlotAllocInfo.m_varTtiAllocInfo.size() == 0)
     {
         // end of slot
         m_currentSlot.Add(1);
@@ -1284,8 +1317,6 @@ NrUePhy::EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci)
                             allocation.m_dci,allocation.m_isMsg3);
                          
     }
-
-    m_receptionEnabled = false;
 }
 
 void
@@ -1531,6 +1562,7 @@ NrUePhy::DoReset()
     {
         m_activeBwpDL=true;
         m_activeBwpUL =true;
+        WakeUp();
     }
     else{
         m_activeBwpDL = false;
@@ -1883,6 +1915,7 @@ NrUePhy::DoResetPhyAfterRlf()
     {
         m_activeBwpDL=true;
         m_activeBwpUL =true;
+        WakeUp();
     }
     else{
         m_activeBwpDL = false;
@@ -1924,6 +1957,7 @@ NrUePhy::DoActivateBwp(LteNrTddSlotType type)
     else{
         m_activeBwpDL = true;
     }
+    WakeUp();
 }
 
 void
@@ -2075,6 +2109,139 @@ NrUePhy::SelectRi(const std::vector<double>& avrgSinr)
 
 
 
+bool
+NrUePhy::CanSleep() const
+{
+    return m_sleepWhenIdle && m_phySapUser->IsDormant() && SlotAllocInfoSize() == 0 &&
+           IsCtrlMsgQueueEmpty() && m_ctrlMsgs.empty() && PacketBurstSize() == 0;
+}
+
+int64_t
+NrUePhy::GetSleptSlots() const
+{
+    NS_ASSERT(m_sleeping);
+    return (Simulator::Now() - m_lastSlotStart).GetTimeStep() / GetSlotPeriod().GetTimeStep();
+}
+
+int64_t
+NrUePhy::LeaveSleep()
+{
+    int64_t slots = GetSleptSlots();
+    m_currentSlot.Add(slots);
+    m_lastSlotStart += GetSlotPeriod() * slots;
+    m_sleeping = false;
+    NS_LOG_INFO("UE " << m_rnti << " wakes up in slot " << m_currentSlot);
+    return slots;
+}
+
+bool
+NrUePhy::IsWakeUpMessage(const Ptr<NrControlMessage>& msg) const
+{
+    if (msg->GetMessageType() == NrControlMessage::DL_DCI)
+    {
+        uint16_t rnti = DynamicCast<NrDlDciMessage>(msg)->GetDciInfoElement()->m_rnti;
+        return m_rnti != 0 && rnti == m_rnti;
+    }
+    if (msg->GetMessageType() == NrControlMessage::UL_DCI)
+    {
+        uint16_t rnti = DynamicCast<NrUlDciMessage>(msg)->GetDciInfoElement()->m_rnti;
+        return m_rnti != 0 && rnti == m_rnti;
+    }
+    if (msg->GetMessageType() == NrControlMessage::PAGING)
+    {
+        SfnSf slot = m_currentSlot;
+        slot.Add(GetSleptSlots());
+        return m_phySapUser->IsPagingOccasion(slot);
+    }
+    return false;
+}
+
+void
+NrUePhy::WakeUpForReception()
+{
+    NS_LOG_FUNCTION(this);
+    if (LeaveSleep() > 0)
+    {
+        // the slot in which the message is received has not been started
+        ResumeSlot();
+    }
+    // once the received messages are processed, continue with the allocations
+    // of this slot (e.g. DL data of a DCI with k0 = 0), or end the slot
+    Simulator::ScheduleNow(&NrUePhy::ScheduleNextVarTti, this);
+}
+
+void
+NrUePhy::ResumeSlot()
+{
+    NS_LOG_FUNCTION(this);
+    m_phySapUser->SlotIndication(m_currentSlot);
+
+    if (SlotAllocInfoExists(m_currentSlot))
+    {
+        m_currSlotAllocInfo = RetrieveSlotAllocInfo(m_currentSlot);
+    }
+    else
+    {
+        m_currSlotAllocInfo = SlotAllocInfo(m_currentSlot);
+    }
+    PushCtrlAllocations(m_currentSlot);
+
+    // the variable TTIs which started before the wake up are lost
+    auto& allocations = m_currSlotAllocInfo.m_varTtiAllocInfo;
+    allocations.erase(std::remove_if(allocations.begin(),
+                                     allocations.end(),
+                                     [this](const VarTtiAllocInfo& alloc) {
+                                         return m_lastSlotStart +
+                                                    GetSymbolPeriod() * alloc.m_dci->m_symStart <
+                                                Simulator::Now();
+                                     }),
+                      allocations.end());
+
+    SendCurrentSlotCtrlMsgs();
+}
+
+void
+NrUePhy::SendCurrentSlotCtrlMsgs()
+{
+    auto ctrlMsgs = PopCurrentSlotCtrlMsgs();
+    if (m_netDevice)
+    {
+        DynamicCast<NrUeNetDevice>(m_netDevice)->RouteOutgoingCtrlMsgs(ctrlMsgs, GetBwpId());
+    }
+    else
+    {
+        // No netDevice (that could happen in tests) so just redirect them to us
+        for (const auto& msg : ctrlMsgs)
+        {
+            EncodeCtrlMsg(msg);
+        }
+    }
+}
+
+void
+NrUePhy::WakeUp()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_sleeping)
+    {
+        return;
+    }
+    int64_t slots = LeaveSleep();
+
+    if (slots > 0 && Simulator::Now() == m_lastSlotStart)
+    {
+        // woken up exactly at a slot boundary: this slot has not been started yet
+        Simulator::ScheduleNow(&NrUePhy::StartSlot, this, m_currentSlot);
+        return;
+    }
+    SfnSf nextSlot = m_currentSlot;
+    nextSlot.Add(1);
+    Simulator::Schedule(m_lastSlotStart + GetSlotPeriod() - Simulator::Now(),
+                        &NrUePhy::StartSlot,
+                        this,
+                        nextSlot);
+}
+
 bool
 NrUePhy::GetActiveBwpStatus () const
 {
@@ -2086,7 +2253,10 @@ NrUePhy::SetActiveBwpStatus (bool state)
 {
   m_activeBwpDL = state;
   m_activeBwpUL = state;
-
+  if (state)
+  {
+      WakeUp();
+  }
 }
 
 NrPhySapProvider::PrachConfig
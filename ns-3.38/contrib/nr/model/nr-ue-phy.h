@@ -522,6 +522,15 @@ class NrUePhy : public NrPhy
   void SetActiveBwpStatus (bool state);
   bool GetActiveBwpStatus() const;
 
+    /**
+     * \brief Start the slots again, if the PHY is sleeping
+     *
+     * The slot is resynchronised from the slot and the time at which the PHY
+     * went to sleep, and the next slot starts at the next slot boundary (or
+     * now, if called exactly at a slot boundary).
+     */
+    void WakeUp() override;
+
   NrPhySapProvider::PrachConfig GetPrachOccasionsFromIndex(uint8_t prachIndex);
 
   protected:
@@ -635,6 +644,59 @@ class NrUePhy : public NrPhy
      */
     void StartSlot(const SfnSf& s);
 
+    /**
+     * \brief Check if the PHY can stop starting slots at the end of the current slot
+     * \return true if sleeping is enabled, the MAC is dormant and nothing is
+     * scheduled or queued for the next slots
+     */
+    bool CanSleep() const;
+
+    /**
+     * \brief Get the number of slots started since the sleeping PHY started its last slot
+     * \return the number of slot boundaries passed while sleeping
+     */
+    int64_t GetSleptSlots() const;
+
+    /**
+     * \brief Advance m_currentSlot and m_lastSlotStart of a sleeping PHY to the
+     * current time, and leave the sleeping state
+     * \return the number of slots skipped while sleeping
+     */
+    int64_t LeaveSleep();
+
+    /**
+     * \brief Check if a control message received while sleeping wakes the PHY up
+     * \param msg the received message
+     * \return true for a DCI for the RNTI of the UE, or for a paging message
+     * received in a paging occasion of the UE
+     */
+    bool IsWakeUpMessage(const Ptr<NrControlMessage>& msg) const;
+
+    /**
+     * \brief Wake up the sleeping PHY to process a message received in the current slot
+     *
+     * The current slot is started where it is (without the variable TTIs which
+     * should have already started), so that the allocations of a DCI for this
+     * slot (k0 = 0) are received.
+     */
+    void WakeUpForReception();
+
+    /**
+     * \brief Start the current slot after its beginning, when waking up inside it
+     */
+    void ResumeSlot();
+
+    /**
+     * \brief Send the control messages to transmit in the current slot
+     */
+    void SendCurrentSlotCtrlMsgs();
+
+    /**
+     * \brief Schedule the next variable TTI of the current slot, the next slot,
+     * or go to sleep if the slot is over and the UE is dormant
+     */
+    void ScheduleNextVarTti();
+
     /**
      * \brief Start the processing of a variable TTI
      * \param dci the DCI of the variable TTI
@@ -1013,6 +1075,8 @@ class NrUePhy : public NrPhy
   bool m_activeBwpUL = false;
   bool m_activeBwpDL = false;
 
+  bool m_sleepWhenIdle{false}; //!< stop the slots while the UE is dormant (attribute)
+  bool m_sleeping{false};      //!< no slot is scheduled until WakeUp is called
   
 
 };
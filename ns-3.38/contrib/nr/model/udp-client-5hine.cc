@@ -32,9 +32,13 @@
 #include "ns3/socket.h"
 #include "ns3/uinteger.h"
 #include "ns3/object-vector.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <sstream>
 
 namespace ns3
 {
@@ -76,7 +80,25 @@ UdpClient5hine::GetTypeId()
                           "the size of the header carrying the sequence number and the time stamp.",
                           UintegerValue(1024),
                           MakeUintegerAccessor(&UdpClient5hine::m_size),
-                          MakeUintegerChecker<uint32_t>(12, 65507));
+                          MakeUintegerChecker<uint32_t>(12, 65507))
+            .AddAttribute("TraceFilename",
+                          "File with the transmission times (and packet sizes) of the packets, "
+                          "relative to the start of the application. If empty, the times set "
+                          "with ScheduleTransmit are used.",
+                          StringValue(""),
+                          MakeStringAccessor(&UdpClient5hine::m_traceFilename),
+                          MakeStringChecker())
+            .AddAttribute("TraceBinary",
+                          "The trace file is a binary file of (double time in s, uint32_t size) "
+                          "records instead of a text file",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&UdpClient5hine::m_traceBinary),
+                          MakeBooleanChecker())
+            .AddAttribute("TraceChunkSize",
+                          "Number of entries read from the trace file at once",
+                          UintegerValue(4096),
+                          MakeUintegerAccessor(&UdpClient5hine::m_traceChunkSize),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -113,6 +135,12 @@ void
 UdpClient5hine::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    if (m_traceFile.is_open())
+    {
+        m_traceFile.close();
+    }
+    m_transmitTimestamps.clear();
+    m_traceChunk.clear();
     Application::DoDispose();
 }
 
@@ -188,10 +216,104 @@ UdpClient5hine::StartApplication()
 
     m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
     m_socket->SetAllowBroadcast(true);
-    for (auto v = m_transmitTimestamps.begin(); v != m_transmitTimestamps.end(); ++v)
+
+    m_startTime = Simulator::Now();
+    m_transmitCursor = 0;
+    if (!m_traceFilename.empty())
+    {
+        m_traceFile.open(m_traceFilename,
+                         m_traceBinary ? std::ios::in | std::ios::binary : std::ios::in);
+        NS_ABORT_MSG_IF(!m_traceFile.is_open(), "Can not open trace file " << m_traceFilename);
+        m_traceLine = 0;
+        m_lastTraceTime = Seconds(0);
+        m_traceChunk.clear();
+        m_traceCursor = 0;
+    }
+    ScheduleNextTransmit();
+}
+
+void
+UdpClient5hine::ScheduleNextTransmit()
+{
+    Time time;
+    uint32_t size;
+    if (!GetNextTransmit(time, size))
+    {
+        NS_LOG_INFO("No transmission left after " << m_sent << " packets");
+        return;
+    }
+    m_nextSize = size == 0 ? m_size : size;
+    NS_ABORT_MSG_IF(m_nextSize < 12, "Packet size " << m_nextSize << " smaller than the SeqTsHeader");
+    Time delay = std::max(m_startTime + time - Simulator::Now(), Time(0));
+    m_sendEvent = Simulator::Schedule(delay, &UdpClient5hine::SendOnce, this);
+}
+
+bool
+UdpClient5hine::GetNextTransmit(Time& time, uint32_t& size)
+{
+    if (m_traceFilename.empty())
+    {
+        if (m_transmitCursor >= m_transmitTimestamps.size())
+        {
+            return false;
+        }
+        time = m_transmitTimestamps[m_transmitCursor++].Get();
+        size = 0;
+        return true;
+    }
+    if (m_traceCursor >= m_traceChunk.size() && !ReadTraceChunk())
+    {
+        return false;
+    }
+    time = m_traceChunk[m_traceCursor].first;
+    size = m_traceChunk[m_traceCursor].second;
+    ++m_traceCursor;
+    return true;
+}
+
+bool
+UdpClient5hine::ReadTraceChunk()
+{
+    m_traceChunk.clear();
+    m_traceCursor = 0;
+    while (m_traceChunk.size() < m_traceChunkSize && m_traceFile)
     {
-        m_sendEvent = Simulator::Schedule((*v).Get(), &UdpClient5hine::SendOnce, this);
+        double seconds = 0;
+        uint32_t size = 0;
+        if (m_traceBinary)
+        {
+            if (!m_traceFile.read(reinterpret_cast<char*>(&seconds), sizeof(seconds)) ||
+                !m_traceFile.read(reinterpret_cast<char*>(&size), sizeof(size)))
+            {
+                break;
+            }
+        }
+        else
+        {
+            std::string line;
+            if (!std::getline(m_traceFile, line))
+            {
+                break;
+            }
+            ++m_traceLine;
+            if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#')
+            {
+                continue;
+            }
+            std::replace(line.begin(), line.end(), ',', ' ');
+            std::istringstream entry(line);
+            NS_ABORT_MSG_IF(!(entry >> seconds),
+                            "Invalid entry in line " << m_traceLine << " of " << m_traceFilename);
+            entry >> size;
+        }
+        Time time = Seconds(seconds);
+        NS_ABORT_MSG_IF(time < m_lastTraceTime,
+                        "Decreasing time " << seconds << " s in trace file " << m_traceFilename);
+        m_lastTraceTime = time;
+        m_traceChunk.emplace_back(time, size);
     }
+    NS_LOG_LOGIC("Read " << m_traceChunk.size() << " entries of " << m_traceFilename);
+    return !m_traceChunk.empty();
 }
 
 void
@@ -200,6 +322,10 @@ UdpClient5hine::StopApplication()
     NS_LOG_FUNCTION(this);
     Simulator::Cancel(m_sendEvent);
     appStopped = true;
+    if (m_traceFile.is_open())
+    {
+        m_traceFile.close();
+    }
 }
 
 void
@@ -213,7 +339,7 @@ UdpClient5hine::SendOnce()
     }
     SeqTsHeader seqTs;
     seqTs.SetSeq(m_sent);
-    Ptr<Packet> p = Create<Packet>(m_size - (8 + 4)); // 8+4 : the size of the seqTs header
+    Ptr<Packet> p = Create<Packet>(m_nextSize - (8 + 4)); // 8+4 : the size of the seqTs header
     p->AddHeader(seqTs);
 
     if ((m_socket->Send(p)) >= 0)
@@ -222,16 +348,17 @@ UdpClient5hine::SendOnce()
         ++m_sent;
         m_totalTx += p->GetSize();
 #ifdef NS3_LOG_ENABLE
-        NS_LOG_INFO("TraceDelay TX " << m_size << " bytes to " << m_peerAddressString << " Uid: "
+        NS_LOG_INFO("TraceDelay TX " << m_nextSize << " bytes to " << m_peerAddressString << " Uid: "
                                      << p->GetUid() << " Time: " << (Simulator::Now()).As(Time::S));
 #endif // NS3_LOG_ENABLE
     }
 #ifdef NS3_LOG_ENABLE
     else
     {
-        NS_LOG_INFO("Error while sending " << m_size << " bytes to " << m_peerAddressString);
+        NS_LOG_INFO("Error while sending " << m_nextSize << " bytes to " << m_peerAddressString);
     }
 #endif // NS3_LOG_ENABLE
+    ScheduleNextTransmit();
 }
 
 uint64_t
@@ -240,10 +367,21 @@ UdpClient5hine::GetTotalTx() const
     return m_totalTx;
 }
 
+uint32_t
+UdpClient5hine::GetSent() const
+{
+    return m_sent;
+}
+
 void
 UdpClient5hine::ScheduleTransmit(std::vector<TimeValue> dt)
 {
-    m_transmitTimestamps = dt;
+    // only the next transmission is scheduled, so the times have to be in order
+    std::stable_sort(dt.begin(), dt.end(), [](const TimeValue& a, const TimeValue& b) {
+        return a.Get() < b.Get();
+    });
+    m_transmitTimestamps = std::move(dt);
+    m_transmitCursor = 0;
 }
 
 } // Namespace ns3
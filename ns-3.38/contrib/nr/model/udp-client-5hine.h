@@ -25,8 +25,12 @@
 #include "ns3/application.h"
 #include "ns3/event-id.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
+#include <fstream>
+#include <vector>
+
 namespace ns3
 {
 
@@ -39,6 +43,17 @@ class Packet;
  * \brief A Udp client. Sends UDP packet carrying sequence number and time stamp
  *  in their payloads
  *
+ * The transmission times are given relative to the start of the application,
+ * either with ScheduleTransmit or with a trace file (attribute TraceFilename).
+ * Only the next transmission is scheduled; it schedules the following one
+ * when it is sent.
+ *
+ * The trace file is read in chunks of TraceChunkSize entries. A text trace has
+ * one entry per line: "<time in s>[,<packet size in bytes>]", empty lines and
+ * lines starting with '#' are ignored. A binary trace (TraceBinary = true)
+ * is a sequence of records of a double (time in s) followed by an uint32_t
+ * (packet size), both in host byte order. A packet size of 0 means
+ * PacketSize. The times of a trace file must not decrease.
  */
 class UdpClient5hine : public Application
 {
@@ -71,11 +86,16 @@ class UdpClient5hine : public Application
     uint64_t GetTotalTx() const;
 
     /**
-     * \brief Schedule the next packet transmissions
-     * \param dt timestamps for packets.
+     * \brief Set the transmission times of the packets
+     * \param dt timestamps for packets, relative to the start of the application.
      */
     void ScheduleTransmit(std::vector<TimeValue> dt);
 
+    /**
+     * \return the number of packets sent by this app
+     */
+    uint32_t GetSent() const;
+
   protected:
     void DoDispose() override;
 
@@ -89,13 +109,44 @@ class UdpClient5hine : public Application
     void Send();
 
     /**
-     * \brief Send a packet instantly
+     * \brief Send a packet of m_nextSize bytes instantly and schedule the next one
      */
     void SendOnce();
 
+    /**
+     * \brief Schedule the transmission at the cursor, if there is one left
+     */
+    void ScheduleNextTransmit();
+
+    /**
+     * \brief Get the transmission at the cursor and advance the cursor
+     * \param time the time of the transmission, relative to the start of the application
+     * \param size the size of the packet (0 for PacketSize)
+     * \return false if there is no transmission left
+     */
+    bool GetNextTransmit(Time& time, uint32_t& size);
+
+    /**
+     * \brief Read the next chunk of the trace file into m_traceChunk
+     * \return false if the end of the file has been reached
+     */
+    bool ReadTraceChunk();
+
     uint32_t m_count; //!< Maximum number of packets the application will send
     Time m_interval;  //!< Packet inter-send time
-    std::vector<TimeValue> m_transmitTimestamps;
+    std::vector<TimeValue> m_transmitTimestamps; //!< sorted transmission times
+    size_t m_transmitCursor{0};                  //!< next entry of m_transmitTimestamps
+    Time m_startTime;                            //!< time at which the application started
+
+    std::string m_traceFilename;    //!< trace file with the transmission times
+    bool m_traceBinary{false};      //!< the trace file is a binary file
+    uint32_t m_traceChunkSize{0};   //!< entries read from the trace file at once
+    std::ifstream m_traceFile;      //!< the opened trace file
+    uint64_t m_traceLine{0};        //!< last read line of a text trace file
+    Time m_lastTraceTime;           //!< time of the last entry read from the trace file
+    std::vector<std::pair<Time, uint32_t>> m_traceChunk; //!< current chunk of the trace file
+    size_t m_traceCursor{0};        //!< next entry of m_traceChunk
+    uint32_t m_nextSize{0};         //!< size of the packet of the scheduled transmission
     uint32_t m_size;  //!< Size of the sent packet (including the SeqTsHeader)
 
     uint32_t m_sent;       //!< Counter for sent packets
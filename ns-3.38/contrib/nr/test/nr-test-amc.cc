@@ -0,0 +1,190 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-amc.h>
+#include <ns3/nr-eesm-cc-t2.h>
+#include <ns3/nr-eesm-ir-t1.h>
+#include <ns3/nr-lte-mi-error-model.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <random>
+
+/**
+ * \file nr-test-amc.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the MCS search of the NrAmc.
+ * The CQI and MCS of random SINR vectors are compared with the ones of a
+ * reference linear search over all MCSs. Then the same vectors are evaluated
+ * again with the CQI cache.
+ */
+namespace ns3
+{
+
+class NrAmcMcsSearchTestCase : public TestCase
+{
+  public:
+    NrAmcMcsSearchTestCase(TypeId errorModelType)
+        : TestCase("MCS search with " + errorModelType.GetName()),
+          m_errorModelType(errorModelType)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    uint8_t LinearSearch(Ptr<NrAmc> amc,
+                         Ptr<NrErrorModel> errorModel,
+                         const SpectrumValue& sinr,
+                         uint8_t& mcs) const;
+    TypeId m_errorModelType;
+};
+
+uint8_t
+NrAmcMcsSearchTestCase::LinearSearch(Ptr<NrAmc> amc,
+                                     Ptr<NrErrorModel> errorModel,
+                                     const SpectrumValue& sinr,
+                                     uint8_t& mcs) const
+{
+    std::vector<int> rbMap;
+    for (uint32_t rb = 0; rb < sinr.GetValuesN(); ++rb)
+    {
+        if (sinr[rb] != 0.0)
+        {
+            rbMap.push_back(rb);
+        }
+    }
+
+    mcs = 0;
+    Ptr<NrErrorModelOutput> output;
+    while (mcs <= errorModel->GetMaxMcs())
+    {
+        output = errorModel->GetTbDecodificationStats(sinr,
+                                                      rbMap,
+                                                      amc->CalculateTbSize(mcs, rbMap.size()),
+                                                      mcs,
+                                                      NrErrorModel::NrErrorModelHistory());
+        if (output->m_tbler > 0.1)
+        {
+            break;
+        }
+        mcs++;
+    }
+    if (mcs > 0)
+    {
+        mcs--;
+    }
+
+    uint8_t cqi = 0;
+    if ((output->m_tbler > 0.1) && (mcs == 0))
+    {
+        cqi = 0;
+    }
+    else if (mcs == errorModel->GetMaxMcs())
+    {
+        cqi = 15;
+    }
+    else
+    {
+        double s = errorModel->GetSpectralEfficiencyForMcs(mcs);
+        while ((cqi < 15) && (errorModel->GetSpectralEfficiencyForCqi(cqi + 1) <= s))
+        {
+            ++cqi;
+        }
+    }
+    return cqi;
+}
+
+void
+NrAmcMcsSearchTestCase::DoRun()
+{
+    const uint32_t numRb = 51;
+    std::vector<double> frequencies;
+    for (uint32_t rb = 0; rb < numRb; ++rb)
+    {
+        frequencies.push_back(3.5e9 + rb * 180e3);
+    }
+    Ptr<const SpectrumModel> model = Create<SpectrumModel>(frequencies);
+
+    ObjectFactory factory;
+    factory.SetTypeId(m_errorModelType);
+    Ptr<NrErrorModel> errorModel = DynamicCast<NrErrorModel>(factory.Create());
+
+    Ptr<NrAmc> amc = CreateObject<NrAmc>();
+    amc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    Ptr<NrAmc> cachedAmc = CreateObject<NrAmc>();
+    cachedAmc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    cachedAmc->SetAttribute("CqiCacheSize", UintegerValue(8));
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> sinrDb(-10.0, 35.0);
+    std::vector<SpectrumValue> sinrs;
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        SpectrumValue sinr(model);
+        double meanDb = sinrDb(rng);
+        // a contiguous allocation in a part of the band, and a few values around the mean
+        uint32_t firstRb = rng() % numRb;
+        uint32_t numAllocated = 1 + rng() % (numRb - firstRb);
+        for (uint32_t rb = firstRb; rb < firstRb + numAllocated; ++rb)
+        {
+            sinr[rb] = std::pow(10.0, (meanDb + (rng() % 7) - 3.0) / 10.0);
+        }
+        sinrs.push_back(sinr);
+    }
+
+    for (const auto& sinr : sinrs)
+    {
+        uint8_t expectedMcs = 0;
+        uint8_t expectedCqi = LinearSearch(amc, errorModel, sinr, expectedMcs);
+        uint8_t mcs = 0;
+        uint8_t cqi = amc->CreateCqiFeedbackWbTdma(sinr, mcs);
+        NS_TEST_ASSERT_MSG_EQ(+mcs, +expectedMcs, "MCS search found another MCS");
+        NS_TEST_ASSERT_MSG_EQ(+cqi, +expectedCqi, "MCS search found another CQI");
+    }
+
+    // every vector twice in a row: the second one is served by the cache
+    for (const auto& sinr : sinrs)
+    {
+        uint8_t expectedMcs = 0;
+        uint8_t expectedCqi = amc->CreateCqiFeedbackWbTdma(sinr, expectedMcs);
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            uint8_t mcs = 0;
+            uint8_t cqi = cachedAmc->CreateCqiFeedbackWbTdma(sinr, mcs);
+            NS_TEST_ASSERT_MSG_EQ(+mcs, +expectedMcs, "Wrong MCS with the CQI cache");
+            NS_TEST_ASSERT_MSG_EQ(+cqi, +expectedCqi, "Wrong CQI with the CQI cache");
+        }
+    }
+}
+
+class NrAmcTestSuite : public TestSuite
+{
+  public:
+    NrAmcTestSuite()
+        : TestSuite("nr-test-amc", UNIT)
+    {
+        AddTestCase(new NrAmcMcsSearchTestCase(NrEesmIrT1::GetTypeId()), QUICK);
+        AddTestCase(new NrAmcMcsSearchTestCase(NrEesmCcT2::GetTypeId()), QUICK);
+        AddTestCase(new NrAmcMcsSearchTestCase(NrLteMiErrorModel::GetTypeId()), QUICK);
+    }
+};
+
+static NrAmcTestSuite nrAmcTestSuite; //!< NrAmc test suite
+
+} // namespace ns3
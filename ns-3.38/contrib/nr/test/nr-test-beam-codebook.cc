@@ -0,0 +1,185 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/beam-codebook.h>
+#include <ns3/beamforming-vector.h>
+#include <ns3/double.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+/**
+ * \file nr-test-beam-codebook.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the BeamCodebook of the CellScanBeamforming. The
+ * beams of the codebook are the ones of CreateDirectionalBfv, the codebook of
+ * a configuration is shared by its antennas, and the batched search finds the
+ * same pair as the evaluation of the long term component of each pair.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Create an antenna
+ * \param numRows the number of rows
+ * \param numColumns the number of columns
+ * \param bearing the bearing angle, in radians
+ * \return the antenna
+ */
+static Ptr<UniformPlanarArray>
+CreateAntenna(uint32_t numRows, uint32_t numColumns, double bearing)
+{
+    Ptr<UniformPlanarArray> antenna = CreateObject<UniformPlanarArray>();
+    antenna->SetAttribute("NumRows", UintegerValue(numRows));
+    antenna->SetAttribute("NumColumns", UintegerValue(numColumns));
+    antenna->SetAttribute("BearingAngle", DoubleValue(bearing));
+    return antenna;
+}
+
+class NrBeamCodebookTestCase : public TestCase
+{
+  public:
+    NrBeamCodebookTestCase()
+        : TestCase("Beam codebook and batched beam search")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrBeamCodebookTestCase::DoRun()
+{
+    BeamCodebook::ClearCache();
+    const std::vector<double> gnbThetas{60, 90, 120};
+    const std::vector<double> ueThetas{60, 75, 90, 105, 120};
+    Ptr<UniformPlanarArray> gnbAntenna = CreateAntenna(4, 4, 0);
+    Ptr<UniformPlanarArray> ueAntenna = CreateAntenna(2, 2, M_PI);
+
+    // the beams are the directional ones of the cell scan
+    Ptr<const BeamCodebook> gnbCodebook = BeamCodebook::Get(gnbAntenna, gnbThetas);
+    NS_TEST_ASSERT_MSG_EQ(gnbCodebook->GetNumBeams(), 3 * 5, "Wrong number of beams");
+    std::size_t beam = 0;
+    for (double theta : gnbThetas)
+    {
+        for (uint16_t sector = 0; sector <= 4; ++sector)
+        {
+            NS_TEST_ASSERT_MSG_EQ(gnbCodebook->GetBeamId(beam),
+                                  BeamId(sector, theta),
+                                  "Wrong order of the beams");
+            PhasedArrayModel::ComplexVector expected =
+                CreateDirectionalBfv(gnbAntenna, sector, theta);
+            PhasedArrayModel::ComplexVector w = gnbCodebook->GetBeamformingVector(beam);
+            NS_TEST_ASSERT_MSG_EQ(w.GetSize(), expected.GetSize(), "Wrong size of the beam");
+            for (std::size_t i = 0; i < w.GetSize(); ++i)
+            {
+                NS_TEST_ASSERT_MSG_EQ_TOL(std::abs(w[i] - expected[i]),
+                                          0,
+                                          1e-12,
+                                          "Wrong weight of the beam");
+            }
+            beam++;
+        }
+    }
+
+    // the codebook of a configuration is built once
+    NS_TEST_ASSERT_MSG_EQ(BeamCodebook::Get(CreateAntenna(4, 4, 0), gnbThetas),
+                          gnbCodebook,
+                          "The codebook is not shared");
+    NS_TEST_ASSERT_MSG_NE(BeamCodebook::Get(CreateAntenna(4, 4, M_PI / 3), gnbThetas),
+                          gnbCodebook,
+                          "The orientation of the antenna is ignored");
+    NS_TEST_ASSERT_MSG_NE(BeamCodebook::Get(gnbAntenna, ueThetas),
+                          gnbCodebook,
+                          "The elevations are ignored");
+    NS_TEST_ASSERT_MSG_EQ(BeamCodebook::GetCacheSize(), 3, "Wrong number of codebooks");
+
+    // the batched search against the evaluation of each pair
+    Ptr<const BeamCodebook> ueCodebook = BeamCodebook::Get(ueAntenna, ueThetas);
+    Ptr<NormalRandomVariable> normal = CreateObject<NormalRandomVariable>();
+    normal->SetStream(1);
+    const uint16_t numClusters = 12;
+    MatrixBasedChannelModel::Complex3DVector channel(4, 16, numClusters);
+    for (uint16_t c = 0; c < numClusters; ++c)
+    {
+        for (uint16_t u = 0; u < 4; ++u)
+        {
+            for (uint16_t s = 0; s < 16; ++s)
+            {
+                channel(u, s, c) = std::complex<double>(normal->GetValue(), normal->GetValue());
+            }
+        }
+    }
+
+    double max = 0;
+    std::size_t maxS = 0;
+    std::size_t maxU = 0;
+    for (std::size_t s = 0; s < gnbCodebook->GetNumBeams(); ++s)
+    {
+        for (std::size_t u = 0; u < ueCodebook->GetNumBeams(); ++u)
+        {
+            PhasedArrayModel::ComplexVector longTerm = channel.MultiplyByLeftAndRightMatrix(
+                ueCodebook->GetBeamformingVector(u).Transpose(),
+                gnbCodebook->GetBeamformingVector(s));
+            double gain = 0;
+            for (std::complex<double> c : longTerm.GetValues())
+            {
+                gain += std::norm(c);
+            }
+            if (max < gain)
+            {
+                max = gain;
+                maxS = s;
+                maxU = u;
+            }
+        }
+    }
+
+    std::size_t sBeam = 0;
+    std::size_t uBeam = 0;
+    double gain =
+        BeamCodebook::SearchBestBeamPair(channel, *gnbCodebook, *ueCodebook, true, &sBeam, &uBeam);
+    NS_TEST_ASSERT_MSG_EQ_TOL(gain, max, max * 1e-12, "Wrong gain of the best pair");
+    NS_TEST_ASSERT_MSG_EQ(sBeam, maxS, "Wrong s beam of the best pair");
+    NS_TEST_ASSERT_MSG_EQ(uBeam, maxU, "Wrong u beam of the best pair");
+
+    gain =
+        BeamCodebook::SearchBestBeamPair(channel, *gnbCodebook, *ueCodebook, false, &sBeam, &uBeam);
+    NS_TEST_ASSERT_MSG_EQ_TOL(gain, max, max * 1e-12, "Wrong gain with the u beams first");
+    NS_TEST_ASSERT_MSG_EQ(sBeam, maxS, "Wrong s beam with the u beams first");
+    NS_TEST_ASSERT_MSG_EQ(uBeam, maxU, "Wrong u beam with the u beams first");
+
+    BeamCodebook::ClearCache();
+    NS_TEST_ASSERT_MSG_EQ(BeamCodebook::GetCacheSize(), 0, "Codebooks not cleared");
+}
+
+class NrBeamCodebookTestSuite : public TestSuite
+{
+  public:
+    NrBeamCodebookTestSuite()
+        : TestSuite("nr-test-beam-codebook", UNIT)
+    {
+        AddTestCase(new NrBeamCodebookTestCase(), QUICK);
+    }
+};
+
+static NrBeamCodebookTestSuite nrBeamCodebookTestSuite; //!< beam codebook test suite
+
+} // namespace ns3
@@ -0,0 +1,127 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-binary-trace-file.h>
+#include <ns3/test.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/**
+ * \file nr-test-binary-trace-file.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the binary trace files of NrPhyRxTrace and
+ * NrMacRxTrace. Records with every field type are written with a buffer of a
+ * few records, so that the buffer is written several times, with and without
+ * the writer thread. The CSV conversion of the file must give the values
+ * of the records; a partially added record is not written.
+ */
+namespace ns3
+{
+
+class NrBinaryTraceFileTestCase : public TestCase
+{
+  public:
+    NrBinaryTraceFileTestCase(bool asyncWrite)
+        : TestCase(std::string("Binary trace file with ") +
+                   (asyncWrite ? "asynchronous" : "synchronous") + " writes"),
+          m_asyncWrite(asyncWrite)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    bool m_asyncWrite;
+};
+
+void
+NrBinaryTraceFileTestCase::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("nr-test-binary-trace-file.bin");
+    const uint32_t numRecords = 1000;
+    std::ostringstream expected;
+    expected << "Time,dir,u8,u16,u32,u64,i64,value\n";
+    {
+        // 40 bytes per record, 3 records per buffer
+        NrBinaryTraceFile file(fileName,
+                               {{"Time", NrBinaryTraceFile::TIME, {}},
+                                {"dir", NrBinaryTraceFile::LABEL, {"DL", "UL"}},
+                                {"u8", NrBinaryTraceFile::UINT8, {}},
+                                {"u16", NrBinaryTraceFile::UINT16, {}},
+                                {"u32", NrBinaryTraceFile::UINT32, {}},
+                                {"u64", NrBinaryTraceFile::UINT64, {}},
+                                {"i64", NrBinaryTraceFile::INT64, {}},
+                                {"value", NrBinaryTraceFile::DOUBLE, {}}},
+                               130,
+                               m_asyncWrite);
+        for (uint32_t i = 0; i < numRecords; ++i)
+        {
+            int64_t time = 1000000000LL * (i / 10) + 12500 * i;
+            file.AddTime(time);
+            file.AddLabel(i % 2);
+            file.Add(static_cast<uint8_t>(i));
+            file.Add(static_cast<uint16_t>(i * 7));
+            file.Add(static_cast<uint32_t>(i * 100003));
+            file.Add(static_cast<uint64_t>(i) << 40);
+            file.Add(-static_cast<int64_t>(i));
+            file.Add(i * 0.25 - 3.5);
+
+            char seconds[32];
+            std::snprintf(seconds, sizeof(seconds), "%lld.%09lld",
+                          static_cast<long long>(time / 1000000000),
+                          static_cast<long long>(time % 1000000000));
+            expected << seconds << "," << (i % 2 == 0 ? "DL" : "UL") << "," << i % 256 << ","
+                     << (i * 7) % 65536 << "," << i * 100003 << ","
+                     << (static_cast<uint64_t>(i) << 40) << "," << -static_cast<int64_t>(i)
+                     << "," << i * 0.25 - 3.5 << "\n";
+        }
+        // a partial record
+        file.AddTime(0);
+        file.AddLabel(1);
+        NS_TEST_ASSERT_MSG_EQ(file.GetNumRecords(), numRecords, "Wrong number of records");
+    }
+
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    std::ostringstream csv;
+    NS_TEST_ASSERT_MSG_EQ(NrBinaryTraceFile::ConvertToCsv(in, csv), true, "Conversion failed");
+    NS_TEST_ASSERT_MSG_EQ(csv.str(), expected.str(), "Wrong CSV of the binary trace");
+
+    std::istringstream notATrace("Time\tCellId\n0.1\t1\n");
+    std::ostringstream out;
+    NS_TEST_ASSERT_MSG_EQ(NrBinaryTraceFile::ConvertToCsv(notATrace, out),
+                          false,
+                          "A text file is not a binary trace");
+    std::remove(fileName.c_str());
+}
+
+class NrBinaryTraceFileTestSuite : public TestSuite
+{
+  public:
+    NrBinaryTraceFileTestSuite()
+        : TestSuite("nr-test-binary-trace-file", UNIT)
+    {
+        AddTestCase(new NrBinaryTraceFileTestCase(false), QUICK);
+        AddTestCase(new NrBinaryTraceFileTestCase(true), QUICK);
+    }
+};
+
+static NrBinaryTraceFileTestSuite nrBinaryTraceFileTestSuite; //!< binary trace file test suite
+
+} // namespace ns3
@@ -0,0 +1,163 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/bandwidth-part-gnb.h>
+#include <ns3/bandwidth-part-ue.h>
+#include <ns3/nr-distributed-helper.h>
+#include <ns3/nr-gnb-net-device.h>
+#include <ns3/nr-gnb-phy.h>
+#include <ns3/nr-ue-net-device.h>
+#include <ns3/nr-ue-phy.h>
+#include <ns3/test.h>
+
+/**
+ * \file nr-test-distributed-helper.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the timing of the interference exchanged between the
+ * ranks of a distributed simulation. The interference of a slot is sent in its
+ * last time step and added to the receiving PHY L1L2CtrlLatency slots later,
+ * which has to stay beyond the lookahead of the PHY. The lookahead given to
+ * the simulator is the smallest one of all the gNB and UE PHYs.
+ */
+namespace ns3
+{
+
+class NrDistributedSlotTimingTestCase : public TestCase
+{
+  public:
+    NrDistributedSlotTimingTestCase()
+        : TestCase("Send and receive times of the interference of a slot")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrDistributedSlotTimingTestCase::DoRun()
+{
+    for (uint16_t numerology = 0; numerology <= 4; ++numerology)
+    {
+        Ptr<NrGnbPhy> phy = CreateObject<NrGnbPhy>();
+        phy->SetNumerology(numerology);
+        const Time slotPeriod = phy->GetSlotPeriod();
+        const Time lookAhead = NrDistributedHelper::GetLookAhead(phy);
+        NS_TEST_ASSERT_MSG_EQ(lookAhead,
+                              slotPeriod * (phy->GetL1L2CtrlLatency() - 1),
+                              "Wrong lookahead of numerology " << numerology);
+
+        for (int64_t slot : {0, 1, 7, 10000})
+        {
+            const Time start = slotPeriod * slot;
+            // the first and the last time step of the slot, and one in between
+            for (Time time : {start, start + slotPeriod / 3, start + slotPeriod - TimeStep(1)})
+            {
+                NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetSlot(time, slotPeriod),
+                                      slot,
+                                      "Wrong slot of " << time);
+            }
+            NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetSlot(start + slotPeriod, slotPeriod),
+                                  slot + 1,
+                                  "Wrong slot of the next slot");
+
+            const Time sendTime = NrDistributedHelper::GetSendTime(slot, slotPeriod);
+            NS_TEST_ASSERT_MSG_EQ(sendTime,
+                                  start + slotPeriod - TimeStep(1),
+                                  "Not sent in the last time step of the slot");
+            NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetSlot(sendTime, slotPeriod),
+                                  slot,
+                                  "Sent after the slot");
+
+            const Time rxTime =
+                NrDistributedHelper::GetRxTime(slot, slotPeriod, phy->GetL1L2CtrlLatency());
+            NS_TEST_ASSERT_MSG_EQ(rxTime,
+                                  slotPeriod * (slot + phy->GetL1L2CtrlLatency()),
+                                  "Not received at the start of a slot");
+            // a message sent at sendTime may be received from sendTime + lookAhead on
+            NS_TEST_ASSERT_MSG_GT(rxTime - sendTime, lookAhead, "Received within the lookahead");
+        }
+    }
+}
+
+class NrDistributedLookAheadTestCase : public TestCase
+{
+  public:
+    NrDistributedLookAheadTestCase()
+        : TestCase("Lookahead of the gNB and UE devices")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrDistributedLookAheadTestCase::DoRun()
+{
+    // a gNB with two BWPs of numerology 0 and 1, a UE with a BWP of numerology 2
+    Ptr<NrGnbNetDevice> gnb = CreateObject<NrGnbNetDevice>();
+    std::map<uint8_t, Ptr<BandwidthPartGnb>> gnbCcMap;
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        Ptr<NrGnbPhy> phy = CreateObject<NrGnbPhy>();
+        phy->SetNumerology(i);
+        gnbCcMap[i] = CreateObject<BandwidthPartGnb>();
+        gnbCcMap[i]->SetPhy(phy);
+    }
+    gnb->SetCcMap(gnbCcMap);
+
+    Ptr<NrUeNetDevice> ue = CreateObject<NrUeNetDevice>();
+    Ptr<NrUePhy> uePhy = CreateObject<NrUePhy>();
+    uePhy->SetNumerology(2);
+    std::map<uint8_t, Ptr<BandwidthPartUe>> ueCcMap;
+    ueCcMap[0] = CreateObject<BandwidthPartUe>();
+    ueCcMap[0]->SetPhy(uePhy);
+    ue->SetCcMap(ueCcMap);
+
+    NetDeviceContainer gnbDevices(gnb);
+    NetDeviceContainer ueDevices(ue);
+    NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetLookAhead(gnbDevices, NetDeviceContainer()),
+                          NrDistributedHelper::GetLookAhead(gnbCcMap[1]->GetPhy()),
+                          "Not the lookahead of the shortest gNB slot");
+    NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetLookAhead(gnbDevices, ueDevices),
+                          NrDistributedHelper::GetLookAhead(uePhy),
+                          "The UE PHYs do not bound the lookahead");
+    NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetLookAhead(uePhy),
+                          MicroSeconds(250) * (uePhy->GetL1L2CtrlLatency() - 1),
+                          "Wrong lookahead of the UE");
+
+    gnb->Dispose();
+    ue->Dispose();
+}
+
+class NrDistributedHelperTestSuite : public TestSuite
+{
+  public:
+    NrDistributedHelperTestSuite()
+        : TestSuite("nr-test-distributed-helper", UNIT)
+    {
+        AddTestCase(new NrDistributedSlotTimingTestCase(), QUICK);
+        AddTestCase(new NrDistributedLookAheadTestCase(), QUICK);
+    }
+};
+
+static NrDistributedHelperTestSuite nrDistributedHelperTestSuite; //!< Distributed helper test suite
+
+} // namespace ns3
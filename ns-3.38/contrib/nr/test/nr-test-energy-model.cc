@@ -0,0 +1,187 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-energy-model.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+
+#include <fstream>
+
+/**
+ * \file nr-test-energy-model.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the state accounting of the NrEnergyModel.
+ * Two UEs change their power state at fixed times. The time and energy per
+ * state, the ring buffer of the state changes and the lines written by the
+ * shared log writer are checked. Finally the battery lifetime is projected from
+ * a periodic state pattern.
+ */
+namespace ns3
+{
+
+class NrEnergyModelTestCase : public TestCase
+{
+  public:
+    NrEnergyModelTestCase(bool binary)
+        : TestCase(std::string("Energy model state accounting, ") + (binary ? "binary" : "text") +
+                   " log"),
+          m_binary(binary)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    bool m_binary{false};
+};
+
+void
+NrEnergyModelTestCase::DoRun()
+{
+    using PowerState = NrEnergyModel::PowerState;
+    std::string outputDir = CreateTempDirFilename("");
+    RG255C chip(3.5e9, 23);
+
+    auto first = std::make_unique<NrEnergyModel>(chip, 0);
+    auto second = std::make_unique<NrEnergyModel>(chip, 0);
+    first->SetOutputDir(outputDir, m_binary);
+    second->SetOutputDir(outputDir, m_binary);
+    first->SetStateHistorySize(2);
+
+    Simulator::Schedule(MilliSeconds(1), [&]() { first->DoNotifyStateChange(PowerState::RRC_Connected, 1); });
+    Simulator::Schedule(MilliSeconds(11), [&]() { first->DoNotifyStateChange(PowerState::RRC_SENDING_PUSCH, 1); });
+    Simulator::Schedule(MilliSeconds(12), [&]() { first->DoNotifyStateChange(PowerState::RRC_Connected, 1); });
+    Simulator::Schedule(MilliSeconds(32), [&]() { first->DoNotifyStateChange(PowerState::RRC_IDLE, 1); });
+    Simulator::Schedule(MilliSeconds(5), [&]() { second->DoNotifyStateChange(PowerState::RRC_Connected, 2); });
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(first->GetTimeInState(PowerState::RRC_Connected), 30000000, "Wrong time in state");
+    NS_TEST_ASSERT_MSG_EQ(first->GetTimeInState(PowerState::RRC_SENDING_PUSCH), 1000000, "Wrong time in state");
+    NS_TEST_ASSERT_MSG_EQ(first->GetTimeInState(PowerState::RRC_IDLE_EDRX), 0, "No state change after RRC_IDLE");
+    NS_TEST_ASSERT_MSG_EQ_TOL(first->GetEnergyInState(PowerState::RRC_Connected),
+                              0.03 * chip.GetConnectedPower(),
+                              1e-12,
+                              "Wrong energy in state");
+
+    auto history = first->GetStateHistory();
+    NS_TEST_ASSERT_MSG_EQ(history.size(), 2, "Only the last state changes are kept");
+    NS_TEST_ASSERT_MSG_EQ((history[0].first == PowerState::RRC_Connected), true, "Wrong history");
+    NS_TEST_ASSERT_MSG_EQ(history[0].second, 12, "Wrong history");
+    NS_TEST_ASSERT_MSG_EQ((history[1].first == PowerState::RRC_IDLE_EDRX), true, "RRC_IDLE not mapped");
+    NS_TEST_ASSERT_MSG_EQ(history[1].second, 32, "Wrong history");
+
+    // the statistics are written when the models are destroyed, and the file when the last one is
+    first.reset();
+    second.reset();
+    Simulator::Destroy();
+
+    // first: OFF, RRC_Connected, RRC_SENDING_PUSCH, RRC_IDLE_EDRX; second: OFF, RRC_Connected
+    const uint32_t records = 6;
+    if (m_binary)
+    {
+        std::ifstream log(outputDir + "Energystates.bin", std::ios::binary | std::ios::ate);
+        NS_TEST_ASSERT_MSG_EQ(log.tellg(), records * (8 + 8 + 1 + 8 + 8), "Wrong number of records");
+    }
+    else
+    {
+        std::ifstream log(outputDir + "Energystates.log");
+        std::string line;
+        uint32_t lines = 0;
+        while (std::getline(log, line))
+        {
+            ++lines;
+        }
+        NS_TEST_ASSERT_MSG_EQ(lines, 2 * records, "Wrong number of lines");
+    }
+}
+
+class NrEnergyProjectionTestCase : public TestCase
+{
+  public:
+    NrEnergyProjectionTestCase()
+        : TestCase("Energy model lifetime projection")
+    {
+    }
+
+  private:
+    void DoRun() override;
+    void Cycle(NrEnergyModel* model);
+};
+
+void
+NrEnergyProjectionTestCase::Cycle(NrEnergyModel* model)
+{
+    // 1 ms connected in every 10 ms, eDRX otherwise
+    model->DoNotifyStateChange(NrEnergyModel::PowerState::RRC_Connected, 1);
+    Simulator::Schedule(MilliSeconds(1), [model]() {
+        model->DoNotifyStateChange(NrEnergyModel::PowerState::RRC_IDLE, 1);
+    });
+    Simulator::Schedule(MilliSeconds(10), &NrEnergyProjectionTestCase::Cycle, this, model);
+}
+
+void
+NrEnergyProjectionTestCase::DoRun()
+{
+    using PowerState = NrEnergyModel::PowerState;
+    RG255C chip(3.5e9, 23);
+    auto model = std::make_unique<NrEnergyModel>(chip, 0);
+    model->SetOutputDir(CreateTempDirFilename(""), false);
+    model->SetProjectionInterval(MilliSeconds(10));
+    Simulator::Schedule(MilliSeconds(0), &NrEnergyProjectionTestCase::Cycle, this, model.get());
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    NrEnergyModel::EnergyProjection projection = model->GetProjection();
+    double power = 0.1 * chip.GetConnectedPower() + 0.9 * chip.GetEdrxPower();
+    NS_TEST_ASSERT_MSG_EQ(projection.window, Seconds(1), "Wrong window");
+    NS_TEST_ASSERT_MSG_GT(projection.intervals, 90, "Intervals not sampled");
+    NS_TEST_ASSERT_MSG_EQ_TOL(projection.dutyCycle[uint(PowerState::RRC_Connected)], 0.1, 1e-9, "Wrong duty cycle");
+    NS_TEST_ASSERT_MSG_EQ_TOL(projection.dutyCycle[uint(PowerState::RRC_IDLE_EDRX)], 0.9, 1e-9, "Wrong duty cycle");
+    NS_TEST_ASSERT_MSG_EQ_TOL(projection.averagePower, power, power * 1e-9, "Wrong average power");
+    // every interval holds one cycle, so there is no uncertainty
+    NS_TEST_ASSERT_MSG_EQ_TOL(projection.averagePowerUpper, power, power * 1e-6, "Wrong confidence bound");
+    NS_TEST_ASSERT_MSG_EQ_TOL(projection.averagePowerLower, power, power * 1e-6, "Wrong confidence bound");
+
+    double remaining = 37000.0 - power;
+    NS_TEST_ASSERT_MSG_EQ_TOL(projection.lifetime.GetSeconds(), remaining / power, 1, "Wrong lifetime");
+    double lower;
+    double upper;
+    double fraction = model->GetEnergyRemainingFraction(Simulator::Now() + Seconds(remaining / power / 2), lower, upper);
+    NS_TEST_ASSERT_MSG_EQ_TOL(fraction, remaining / 37000.0 / 2, 1e-6, "Wrong projected fraction");
+    NS_TEST_ASSERT_MSG_EQ((lower <= fraction && fraction <= upper), true, "Fraction outside of its bounds");
+
+    model.reset();
+    Simulator::Destroy();
+}
+
+class NrEnergyModelTestSuite : public TestSuite
+{
+  public:
+    NrEnergyModelTestSuite()
+        : TestSuite("nr-test-energy-model", UNIT)
+    {
+        AddTestCase(new NrEnergyModelTestCase(false), QUICK);
+        AddTestCase(new NrEnergyModelTestCase(true), QUICK);
+        AddTestCase(new NrEnergyProjectionTestCase(), QUICK);
+    }
+};
+
+static NrEnergyModelTestSuite nrEnergyModelTestSuite; //!< Energy model test suite
+
+} // namespace ns3
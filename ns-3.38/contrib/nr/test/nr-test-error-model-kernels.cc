@@ -0,0 +1,239 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-eesm-cc-t1.h>
+#include <ns3/nr-eesm-ir-t2.h>
+#include <ns3/nr-error-model-kernels.h>
+#include <ns3/nr-lte-mi-error-model.h>
+#include <ns3/object-factory.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <random>
+
+/**
+ * \file nr-test-error-model-kernels.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the vectorised kernels of the error models.
+ * The scalar kernels must give exactly the results of the loops the error
+ * models had before. The sums of the vector instruction sets supported by the
+ * machine are compared with the scalar ones: the exponential sums within the
+ * relative tolerance of 1e-13 of NrErrorModelKernels, the mutual information
+ * sums exactly. The scalar kernels are the default ones. Then the TBLER of
+ * EESM and MIESM error models, also with HARQ history, is compared between the
+ * scalar kernels and the widest instruction set.
+ */
+namespace ns3
+{
+
+class NrErrorModelKernelsTestCase : public TestCase
+{
+  public:
+    NrErrorModelKernelsTestCase()
+        : TestCase("Vectorised error model kernels against the scalar ones")
+    {
+    }
+
+  private:
+    void DoRun() override;
+    void TestSums(const std::vector<double>& sinr, const std::vector<int>& rbs);
+    void TestErrorModel(TypeId errorModelType, const std::vector<SpectrumValue>& sinrs);
+
+    const double m_tolerance{1e-13}; //!< relative tolerance of the exponential sums
+};
+
+void
+NrErrorModelKernelsTestCase::TestSums(const std::vector<double>& sinr, const std::vector<int>& rbs)
+{
+    // the loops of NrEesmErrorModel::SinrExp and NrLteMiErrorModel::Mib before
+    const double mi[] = {0.0, 0.1, 0.25, 0.5, 0.75, 0.9};
+    NrErrorModelKernels::MiTable table;
+    table.m_mi = mi;
+    table.m_size = 6;
+    table.m_firstSinr = 0.5;
+    table.m_lastSinr = 3.0;
+    table.m_scaling = (table.m_size - 1) / (table.m_lastSinr - table.m_firstSinr);
+    const double beta = 7.3;
+    double expectedExp = 0.0;
+    double expectedMi = 0.0;
+    for (int rb : rbs)
+    {
+        expectedExp += exp(-sinr[rb] / beta);
+        double index = (sinr[rb] - table.m_firstSinr) * table.m_scaling + 1;
+        expectedMi += sinr[rb] > table.m_lastSinr
+                          ? 1
+                          : mi[static_cast<uint32_t>(std::max(0.0, std::floor(index)))];
+    }
+
+    for (auto isa : {NrErrorModelKernels::SCALAR,
+                     NrErrorModelKernels::AVX2,
+                     NrErrorModelKernels::AVX512})
+    {
+        if (!NrErrorModelKernels::IsSupported(isa))
+        {
+            continue;
+        }
+        NrErrorModelKernels::SetIsa(isa);
+        double sumExp = NrErrorModelKernels::SumExp(sinr.data(), rbs.data(), rbs.size(), beta);
+        double sumMi = NrErrorModelKernels::SumMi(sinr.data(), rbs.data(), rbs.size(), table);
+        if (isa == NrErrorModelKernels::SCALAR)
+        {
+            NS_TEST_ASSERT_MSG_EQ(sumExp, expectedExp, "Scalar exponential sum changed");
+        }
+        else
+        {
+            NS_TEST_ASSERT_MSG_EQ_TOL(sumExp,
+                                      expectedExp,
+                                      expectedExp * m_tolerance,
+                                      "Exponential sum of " << NrErrorModelKernels::GetIsaName(isa)
+                                                            << " with " << rbs.size() << " RBs");
+        }
+        NS_TEST_ASSERT_MSG_EQ(sumMi,
+                              expectedMi,
+                              "MI sum of " << NrErrorModelKernels::GetIsaName(isa) << " with "
+                                           << rbs.size() << " RBs");
+    }
+}
+
+void
+NrErrorModelKernelsTestCase::TestErrorModel(TypeId errorModelType,
+                                            const std::vector<SpectrumValue>& sinrs)
+{
+    ObjectFactory factory;
+    factory.SetTypeId(errorModelType);
+    Ptr<NrErrorModel> errorModel = DynamicCast<NrErrorModel>(factory.Create());
+
+    for (uint32_t i = 0; i < sinrs.size(); ++i)
+    {
+        std::vector<int> rbs;
+        for (uint32_t rb = 0; rb < sinrs[i].GetValuesN(); ++rb)
+        {
+            if (sinrs[i][rb] != 0.0)
+            {
+                rbs.push_back(rb);
+            }
+        }
+        uint8_t mcs = i % (errorModel->GetMaxMcs() + 1);
+        uint32_t tbSize = 100 * rbs.size() * (1 + mcs);
+
+        Ptr<NrErrorModelOutput> outputs[2];
+        NrErrorModel::NrErrorModelHistory histories[2];
+        for (uint32_t run = 0; run < 2; ++run)
+        {
+            NrErrorModelKernels::SetIsa(run == 0 ? NrErrorModelKernels::SCALAR
+                                                 : NrErrorModelKernels::AUTO);
+            // a first transmission, and a retransmission with the previous SINR
+            histories[run].push_back(errorModel->GetTbDecodificationStats(sinrs[i],
+                                                                          rbs,
+                                                                          tbSize,
+                                                                          mcs,
+                                                                          histories[run]));
+            outputs[run] = errorModel->GetTbDecodificationStats(i > 0 ? sinrs[i - 1] : sinrs[i],
+                                                                rbs,
+                                                                tbSize,
+                                                                mcs,
+                                                                histories[run]);
+        }
+        NS_TEST_ASSERT_MSG_EQ_TOL(histories[1].front()->m_tbler,
+                                  histories[0].front()->m_tbler,
+                                  1e-9,
+                                  errorModelType.GetName() << ": TBLER of SINR " << i);
+        NS_TEST_ASSERT_MSG_EQ_TOL(outputs[1]->m_tbler,
+                                  outputs[0]->m_tbler,
+                                  1e-9,
+                                  errorModelType.GetName() << ": TBLER of the retx of SINR " << i);
+    }
+}
+
+void
+NrErrorModelKernelsTestCase::DoRun()
+{
+    NrErrorModelKernels::Isa isa = NrErrorModelKernels::GetIsa();
+    NS_TEST_ASSERT_MSG_EQ(isa, NrErrorModelKernels::SCALAR, "The default kernels are not scalar");
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> sinrDb(-10.0, 40.0);
+    std::vector<double> sinr(300);
+    for (double& value : sinr)
+    {
+        value = std::pow(10.0, sinrDb(rng) / 10.0);
+    }
+    sinr[7] = 0.0;
+    sinr[9] = 1e6;
+    // every number of RBs up to two vectors of AVX-512 and a few more, with
+    // contiguous and scattered RBs
+    for (uint32_t numRbs = 1; numRbs <= 20; ++numRbs)
+    {
+        std::vector<int> contiguous;
+        std::vector<int> scattered;
+        for (uint32_t rb = 0; rb < numRbs; ++rb)
+        {
+            contiguous.push_back(rb);
+            scattered.push_back(rng() % sinr.size());
+        }
+        TestSums(sinr, contiguous);
+        TestSums(sinr, scattered);
+    }
+    std::vector<int> all;
+    for (uint32_t rb = 0; rb < 273; ++rb)
+    {
+        all.push_back(rb);
+    }
+    TestSums(sinr, all);
+
+    const uint32_t numRb = 51;
+    std::vector<double> frequencies;
+    for (uint32_t rb = 0; rb < numRb; ++rb)
+    {
+        frequencies.push_back(3.5e9 + rb * 180e3);
+    }
+    Ptr<const SpectrumModel> model = Create<SpectrumModel>(frequencies);
+    std::vector<SpectrumValue> sinrs;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        SpectrumValue value(model);
+        double meanDb = sinrDb(rng);
+        uint32_t firstRb = rng() % numRb;
+        uint32_t numAllocated = 1 + rng() % (numRb - firstRb);
+        for (uint32_t rb = firstRb; rb < firstRb + numAllocated; ++rb)
+        {
+            value[rb] = std::pow(10.0, (meanDb + (rng() % 7) - 3.0) / 10.0);
+        }
+        sinrs.push_back(value);
+    }
+    TestErrorModel(NrEesmIrT2::GetTypeId(), sinrs);
+    TestErrorModel(NrEesmCcT1::GetTypeId(), sinrs);
+    TestErrorModel(NrLteMiErrorModel::GetTypeId(), sinrs);
+
+    NrErrorModelKernels::SetIsa(isa);
+}
+
+class NrErrorModelKernelsTestSuite : public TestSuite
+{
+  public:
+    NrErrorModelKernelsTestSuite()
+        : TestSuite("nr-test-error-model-kernels", UNIT)
+    {
+        AddTestCase(new NrErrorModelKernelsTestCase(), QUICK);
+    }
+};
+
+static NrErrorModelKernelsTestSuite nrErrorModelKernelsTestSuite; //!< error model kernels test suite
+
+} // namespace ns3
@@ -0,0 +1,291 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/antenna-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+
+#include <map>
+#include <vector>
+
+/**
+ * \file nr-test-ideal-beamforming-update.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the periodic updates of the IdealBeamformingHelper.
+ * With static UEs, a moving one and one which jumps once, the incremental
+ * update on several threads gives, at each period, the beams of the search
+ * of all the pairs in the simulation thread, and it searches again only the
+ * pairs which moved.
+ */
+namespace ns3
+{
+
+/**
+ * \brief CellScanBeamforming which counts the searches of each UE
+ */
+class CountingCellScanBeamforming : public CellScanBeamforming
+{
+  public:
+    /**
+     * \brief Get the type id
+     * \return the type id of the class
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::CountingCellScanBeamforming")
+                                .SetParent<CellScanBeamforming>()
+                                .AddConstructor<CountingCellScanBeamforming>();
+        return tid;
+    }
+
+    std::unique_ptr<BeamSearchTask> PrepareBeamSearch(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override
+    {
+        ++m_searches[ueSpectrumPhy->GetDevice()->GetNode()->GetId()];
+        return CellScanBeamforming::PrepareBeamSearch(gnbSpectrumPhy, ueSpectrumPhy);
+    }
+
+    static std::map<uint32_t, uint32_t> m_searches; //!< the searches by UE node id
+};
+
+std::map<uint32_t, uint32_t> CountingCellScanBeamforming::m_searches;
+NS_OBJECT_ENSURE_REGISTERED(CountingCellScanBeamforming);
+
+class NrIdealBeamformingUpdateTestCase : public TestCase
+{
+  public:
+    NrIdealBeamformingUpdateTestCase()
+        : TestCase("Incremental and threaded updates of the ideal beams")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// the beams of the gNB and the UE of each pair, at each period
+    typedef std::vector<std::vector<PhasedArrayModel::ComplexVector>> Beams;
+
+    /**
+     * \brief Simulate the scenario
+     * \param incrementalUpdate the IncrementalUpdate attribute
+     * \param numThreads the NumThreads attribute
+     * \param [out] beams the beams after each period
+     * \param [out] searches the number of periodic searches by UE index
+     */
+    void Simulate(bool incrementalUpdate,
+                  uint32_t numThreads,
+                  Beams* beams,
+                  std::map<uint32_t, uint32_t>* searches);
+};
+
+void
+NrIdealBeamformingUpdateTestCase::Simulate(bool incrementalUpdate,
+                                           uint32_t numThreads,
+                                           Beams* beams,
+                                           std::map<uint32_t, uint32_t>* searches)
+{
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(2);
+    ueNodes.Create(5);
+
+    // UEs 0 to 2 are static, 3 moves and 4 jumps once
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(gnbNodes);
+    mobility.Install(NodeContainer(ueNodes.Get(0), ueNodes.Get(1), ueNodes.Get(2)));
+    mobility.Install(ueNodes.Get(4));
+    mobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+    mobility.Install(ueNodes.Get(3));
+    gnbNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(0, 0, 10));
+    gnbNodes.Get(1)->GetObject<MobilityModel>()->SetPosition(Vector(200, 0, 10));
+    ueNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(20, 30, 1.5));
+    ueNodes.Get(1)->GetObject<MobilityModel>()->SetPosition(Vector(-40, 10, 1.5));
+    ueNodes.Get(2)->GetObject<MobilityModel>()->SetPosition(Vector(180, -50, 1.5));
+    ueNodes.Get(3)->GetObject<MobilityModel>()->SetPosition(Vector(50, 0, 1.5));
+    ueNodes.Get(3)->GetObject<ConstantVelocityMobilityModel>()->SetVelocity(Vector(0, 20, 0));
+    ueNodes.Get(4)->GetObject<MobilityModel>()->SetPosition(Vector(220, 40, 1.5));
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    idealBeamformingHelper->SetAttribute(
+        "BeamformingMethod",
+        TypeIdValue(CountingCellScanBeamforming::GetTypeId()));
+    idealBeamformingHelper->SetAttribute("IncrementalUpdate", BooleanValue(incrementalUpdate));
+    idealBeamformingHelper->SetAttribute("NumThreads", UintegerValue(numThreads));
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+
+    // the energy log of the UEs in the temporary directory
+    Config::SetDefault("ns3::NrNetDevice::outputDir", StringValue(CreateTempDirFilename("ue-")));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    // the 51 RBs of a 20 MHz BWP expected by the resource manager
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(1));
+    nrHelper->SetGnbPhyAttribute("RbOverhead", DoubleValue(0.08));
+
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    // each gNB has the resource manager of its single BWP
+    NrMacSchedulerRessourceManager manager0("F|F|F|F|F|F|F|F|F|F|",
+                                            1,
+                                            1,
+                                            0,
+                                            CreateTempDirFilename("gnb0"),
+                                            3,
+                                            false);
+    NrMacSchedulerRessourceManager manager1("F|F|F|F|F|F|F|F|F|F|",
+                                            1,
+                                            1,
+                                            0,
+                                            CreateTempDirFilename("gnb1"),
+                                            3,
+                                            false);
+    NetDeviceContainer gnbNetDev =
+        nrHelper->InstallGnbDevice(NodeContainer(gnbNodes.Get(0)), allBwps, 1, &manager0);
+    gnbNetDev.Add(
+        nrHelper->InstallGnbDevice(NodeContainer(gnbNodes.Get(1)), allBwps, 1, &manager1));
+    NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t stream = 1;
+    stream += nrHelper->AssignStreams(gnbNetDev, stream);
+    nrHelper->AssignStreams(ueNetDev, stream);
+
+    for (auto it = gnbNetDev.Begin(); it != gnbNetDev.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueNetDev.Begin(); it != ueNetDev.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    InternetStackHelper internet;
+    internet.Install(ueNodes);
+    epcHelper->AssignUeIpv4Address(ueNetDev);
+    const std::vector<uint32_t> servingGnb{0, 0, 1, 0, 1};
+    for (uint32_t i = 0; i < ueNetDev.GetN(); ++i)
+    {
+        nrHelper->AttachToEnb(ueNetDev.Get(i), gnbNetDev.Get(servingGnb.at(i)));
+    }
+
+    CountingCellScanBeamforming::m_searches.clear();
+    Simulator::Schedule(MilliSeconds(250), [&ueNodes]() {
+        ueNodes.Get(4)->GetObject<MobilityModel>()->SetPosition(Vector(160, -60, 1.5));
+    });
+
+    // right after each period of BeamformingPeriodicity (100 ms)
+    beams->clear();
+    for (uint32_t period = 1; period <= 5; ++period)
+    {
+        Simulator::Schedule(MilliSeconds(100 * period) + NanoSeconds(1), [&, beams]() {
+            std::vector<PhasedArrayModel::ComplexVector> periodBeams;
+            for (uint32_t i = 0; i < ueNetDev.GetN(); ++i)
+            {
+                Ptr<NetDevice> gnbDev = gnbNetDev.Get(servingGnb.at(i));
+                periodBeams.push_back(NrHelper::GetGnbPhy(gnbDev, 0)
+                                          ->GetSpectrumPhy()
+                                          ->GetBeamManager()
+                                          ->GetBeamformingVector(ueNetDev.Get(i)));
+                periodBeams.push_back(NrHelper::GetUePhy(ueNetDev.Get(i), 0)
+                                          ->GetSpectrumPhy()
+                                          ->GetBeamManager()
+                                          ->GetBeamformingVector(gnbDev));
+            }
+            beams->push_back(periodBeams);
+        });
+    }
+
+    Simulator::Stop(MilliSeconds(550));
+    Simulator::Run();
+
+    searches->clear();
+    for (uint32_t i = 0; i < ueNodes.GetN(); ++i)
+    {
+        auto it = CountingCellScanBeamforming::m_searches.find(ueNodes.Get(i)->GetId());
+        if (it != CountingCellScanBeamforming::m_searches.end())
+        {
+            (*searches)[i] = it->second;
+        }
+    }
+    CountingCellScanBeamforming::m_searches.clear();
+    Simulator::Destroy();
+}
+
+void
+NrIdealBeamformingUpdateTestCase::DoRun()
+{
+    Beams fullBeams;
+    std::map<uint32_t, uint32_t> searches;
+    Simulate(false, 1, &fullBeams, &searches);
+    std::map<uint32_t, uint32_t> expectedSearches{{0, 5}, {1, 5}, {2, 5}, {3, 5}, {4, 5}};
+    NS_TEST_ASSERT_MSG_EQ((searches == expectedSearches),
+                          true,
+                          "All the pairs have to be searched again at each period");
+
+    Beams incrementalBeams;
+    Simulate(true, 4, &incrementalBeams, &searches);
+    NS_TEST_ASSERT_MSG_EQ(incrementalBeams.size(), 5, "Missing periods");
+    NS_TEST_ASSERT_MSG_EQ(fullBeams.size(), incrementalBeams.size(), "Missing periods");
+    for (std::size_t period = 0; period < fullBeams.size(); ++period)
+    {
+        for (std::size_t i = 0; i < fullBeams.at(period).size(); ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ((fullBeams.at(period).at(i) == incrementalBeams.at(period).at(i)),
+                                  true,
+                                  "Different beam " << i << " after period " << period + 1);
+        }
+    }
+
+    // the static pairs are never searched again, the moving one at each period
+    // and the jumping one once, after its course change
+    expectedSearches = {{3, 5}, {4, 1}};
+    NS_TEST_ASSERT_MSG_EQ((searches == expectedSearches), true, "Wrong pairs searched again");
+}
+
+class NrIdealBeamformingUpdateTestSuite : public TestSuite
+{
+  public:
+    NrIdealBeamformingUpdateTestSuite()
+        : TestSuite("nr-test-ideal-beamforming-update", UNIT)
+    {
+        AddTestCase(new NrIdealBeamformingUpdateTestCase(), QUICK);
+    }
+};
+
+static NrIdealBeamformingUpdateTestSuite
+    nrIdealBeamformingUpdateTestSuite; //!< Ideal beamforming update test suite
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-control-messages.h>
+#include <ns3/nr-memory-pool.h>
+#include <ns3/nr-phy-mac-common.h>
+#include <ns3/test.h>
+
+/**
+ * \file nr-test-memory-pool.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the NrMemoryPool. The blocks freed are given back to
+ * the next allocations of their size class, and the DCIs, the allocations of
+ * a slot and the control messages, created as in every slot of the MAC and
+ * the PHY, are served by the free lists once the first slots are done.
+ */
+namespace ns3
+{
+
+class NrMemoryPoolTestCase : public TestCase
+{
+  public:
+    NrMemoryPoolTestCase()
+        : TestCase("Memory pool of the DCIs, allocations and control messages")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrMemoryPoolTestCase::DoRun()
+{
+    // a block freed is reused by the next allocation of its class
+    void* first = NrMemoryPool::Allocate(40);
+    NrMemoryPool::Deallocate(first, 40);
+    NrMemoryPool::ResetStats();
+    void* second = NrMemoryPool::Allocate(33);
+    NS_TEST_ASSERT_MSG_EQ(second, first, "The free block is not reused");
+    NS_TEST_ASSERT_MSG_EQ(NrMemoryPool::GetStats().m_hits, 1, "The reuse is not counted");
+    NrMemoryPool::Deallocate(second, 33);
+
+    // the blocks beyond the largest class are not counted
+    void* large = NrMemoryPool::Allocate(NrMemoryPool::MAX_SIZE + 1);
+    NrMemoryPool::Deallocate(large, NrMemoryPool::MAX_SIZE + 1);
+    NS_TEST_ASSERT_MSG_EQ(NrMemoryPool::GetStats().m_misses, 0, "A large block is counted");
+
+    // the objects of a slot, created and destroyed as in the MAC and the PHY
+    NrMemoryPool::ResetStats();
+    for (uint32_t slot = 0; slot < 100; ++slot)
+    {
+        SlotAllocInfo alloc(SfnSf(0, 0, slot % 10, 1));
+        for (uint8_t sym = 0; sym < 4; ++sym)
+        {
+            auto dci = NrMemoryPool::MakeShared<DciInfoElementTdma>(1,
+                                                                    DciInfoElementTdma::DL,
+                                                                    sym,
+                                                                    1,
+                                                                    std::vector<uint8_t>{1},
+                                                                    std::vector<uint32_t>{100},
+                                                                    std::vector<uint8_t>{1},
+                                                                    std::vector<uint8_t>{0},
+                                                                    DciInfoElementTdma::DATA,
+                                                                    0,
+                                                                    0);
+            NS_TEST_ASSERT_MSG_EQ(dci->m_symStart, sym, "Wrong DCI");
+            alloc.m_varTtiAllocInfo.emplace_back(dci);
+        }
+        Ptr<NrDlDciMessage> msg = Create<NrDlDciMessage>(alloc.m_varTtiAllocInfo.front().m_dci);
+        NS_TEST_ASSERT_MSG_EQ(msg->GetMessageType(), NrControlMessage::DL_DCI, "Wrong message");
+        NS_TEST_ASSERT_MSG_EQ(msg->GetDciInfoElement()->m_symStart, 0, "Wrong DCI of the message");
+    }
+    NrMemoryPool::Stats stats = NrMemoryPool::GetStats();
+    NS_TEST_ASSERT_MSG_GT(stats.m_hits, 0, "No allocation is served by the pool");
+    NS_TEST_ASSERT_MSG_GT(stats.GetHitRate(), 0.9, "The blocks of the slots are not reused");
+}
+
+class NrMemoryPoolTestSuite : public TestSuite
+{
+  public:
+    NrMemoryPoolTestSuite()
+        : TestSuite("nr-test-memory-pool", UNIT)
+    {
+        AddTestCase(new NrMemoryPoolTestCase(), QUICK);
+    }
+};
+
+static NrMemoryPoolTestSuite nrMemoryPoolTestSuite; //!< memory pool test suite
+
+} // namespace ns3
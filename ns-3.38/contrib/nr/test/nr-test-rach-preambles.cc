@@ -0,0 +1,257 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/callback.h>
+#include <ns3/nr-gnb-mac.h>
+#include <ns3/test.h>
+
+#include <tuple>
+#include <vector>
+
+/**
+ * \file nr-test-rach-preambles.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the RACH preambles received by the NrGnbMac. The
+ * preambles of a slot are handled by PRACH slot, occasion and preamble id,
+ * whatever the order in which they were received, the preambles received
+ * more than once are collisions, and the RachOccasion trace reports each
+ * occasion once, with its PRACH slot and its numbers of preambles.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Scheduler SAP which keeps the RACH list of the MAC
+ */
+class RachTestSchedSapProvider : public NrMacSchedSapProvider
+{
+  public:
+    void SchedDlRlcBufferReq(const SchedDlRlcBufferReqParameters&) override
+    {
+    }
+
+    void SchedDlCqiInfoReq(const SchedDlCqiInfoReqParameters&) override
+    {
+    }
+
+    void SchedDlTriggerReq(const SchedDlTriggerReqParameters&) override
+    {
+    }
+
+    void SchedUlCqiInfoReq(const SchedUlCqiInfoReqParameters&) override
+    {
+    }
+
+    void SchedUlTriggerReq(const SchedUlTriggerReqParameters&) override
+    {
+    }
+
+    void SchedUlSrInfoReq(const SchedUlSrInfoReqParameters&) override
+    {
+    }
+
+    void SchedUlMsg3InfoReq(const SchedUlMsg3InfoReqParameters&) override
+    {
+    }
+
+    void SchedUlMacCtrlInfoReq(const SchedUlMacCtrlInfoReqParameters&) override
+    {
+    }
+
+    void SchedSetMcs(uint32_t) override
+    {
+    }
+
+    void SchedDlRachInfoReq(const SchedDlRachInfoReqParameters& params) override
+    {
+        m_rachList.insert(m_rachList.end(), params.m_rachList.begin(), params.m_rachList.end());
+    }
+
+    uint8_t GetDlCtrlSyms() const override
+    {
+        return 1;
+    }
+
+    uint8_t GetUlCtrlSyms() const override
+    {
+        return 1;
+    }
+
+    std::vector<RachListElement_s> m_rachList; //!< the RACH list given to the scheduler
+};
+
+/**
+ * \brief RRC SAP which gives the temporary RNTIs in increasing order
+ */
+class RachTestCmacSapUser : public LteEnbCmacSapUser
+{
+  public:
+    uint16_t AllocateTemporaryCellRnti() override
+    {
+        return ++m_lastRnti;
+    }
+
+    void NotifyLcConfigResult(uint16_t, uint8_t, bool) override
+    {
+    }
+
+    void RrcConfigurationUpdateInd(UeConfig) override
+    {
+    }
+
+    bool IsRandomAccessCompleted(uint16_t) override
+    {
+        return false;
+    }
+
+    bool isRedCapUe(uint16_t) override
+    {
+        return false;
+    }
+
+    void TriggerRelease(uint16_t) override
+    {
+    }
+
+    void NotifyDataActivity(uint16_t) override
+    {
+    }
+
+    bool IsSdtUsable(uint16_t) override
+    {
+        return false;
+    }
+
+    uint16_t m_lastRnti{0}; //!< the last RNTI given
+};
+
+class NrRachPreamblesTestCase : public TestCase
+{
+  public:
+    NrRachPreamblesTestCase()
+        : TestCase("Order and collisions of the received RACH preambles")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// PRACH slot, occasion and whether the preamble collided
+    typedef std::tuple<uint32_t, uint8_t, bool> OccasionUse;
+    /// PRACH slot, occasion, received preambles, preamble ids and collided ids
+    typedef std::tuple<uint32_t, uint8_t, uint16_t, uint16_t, uint16_t> OccasionTrace;
+
+    /**
+     * \brief Keep a use of an occasion
+     */
+    void PrachOccasionUsed(uint32_t prachNumber, uint8_t occasion, bool collision)
+    {
+        m_uses.emplace_back(prachNumber, occasion, collision);
+    }
+
+    /**
+     * \brief Keep a RachOccasion trace
+     */
+    void RachOccasion(uint32_t prachNumber,
+                      uint8_t occasion,
+                      uint16_t attempts,
+                      uint16_t preambles,
+                      uint16_t collidedPreambles)
+    {
+        m_traces.emplace_back(prachNumber, occasion, attempts, preambles, collidedPreambles);
+    }
+
+    std::vector<OccasionUse> m_uses;     //!< the uses of the occasions
+    std::vector<OccasionTrace> m_traces; //!< the RachOccasion traces
+};
+
+void
+NrRachPreamblesTestCase::DoRun()
+{
+    Ptr<NrGnbMac> mac = CreateObject<NrGnbMac>();
+    RachTestSchedSapProvider schedSap;
+    RachTestCmacSapUser cmacSap;
+    mac->SetNrMacSchedSapProvider(&schedSap);
+    mac->SetEnbCmacSapUser(&cmacSap);
+    mac->SetPrachConfig(NrPhySapProvider::GetPrachConfigTable().at(122));
+    mac->SetPrachOccasionUsedCallback(
+        MakeCallback(&NrRachPreamblesTestCase::PrachOccasionUsed, this));
+    mac->TraceConnectWithoutContext("RachOccasion",
+                                    MakeCallback(&NrRachPreamblesTestCase::RachOccasion, this));
+
+    // the preambles of a slot, out of order; the imsi of a preamble is 100 + its id
+    const std::vector<std::tuple<uint32_t, uint8_t, uint32_t>> received{{2, 1, 5},
+                                                                       {1, 3, 9},
+                                                                       {1, 0, 7},
+                                                                       {1, 0, 2},
+                                                                       {1, 0, 7}};
+    SfnSf sfnSf(0, 9, 1, 1);
+    mac->GetPhySapUser()->SetCurrentSfn(sfnSf);
+    for (const auto& [prachNumber, occasion, raId] : received)
+    {
+        mac->GetPhySapUser()->ReceiveRachPreamble(raId, occasion, 100 + raId, prachNumber);
+    }
+    mac->GetPhySapUser()->SlotDlIndication(sfnSf, LteNrTddSlotType::DL);
+
+    // by PRACH slot, occasion and preamble id; the preamble 7 collided
+    const std::vector<uint16_t> expectedImsis{102, 109, 105};
+    NS_TEST_ASSERT_MSG_EQ(schedSap.m_rachList.size(),
+                          expectedImsis.size(),
+                          "Wrong number of preambles given to the scheduler");
+    for (std::size_t i = 0; i < expectedImsis.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(schedSap.m_rachList.at(i).m_imsi,
+                              expectedImsis.at(i),
+                              "Wrong order of the preambles");
+        NS_TEST_ASSERT_MSG_EQ(schedSap.m_rachList.at(i).m_rnti, i + 1, "Wrong temporary RNTI");
+    }
+
+    const std::vector<OccasionUse> expectedUses{{1, 0, false},
+                                                {1, 0, true},
+                                                {1, 3, false},
+                                                {2, 1, false}};
+    NS_TEST_ASSERT_MSG_EQ((m_uses == expectedUses), true, "Wrong uses of the occasions");
+
+    const std::vector<OccasionTrace> expectedTraces{{1, 0, 3, 2, 1},
+                                                    {1, 3, 1, 1, 0},
+                                                    {2, 1, 1, 1, 0}};
+    NS_TEST_ASSERT_MSG_EQ((m_traces == expectedTraces), true, "Wrong RachOccasion traces");
+
+    // the preambles are not kept for the next slot
+    m_traces.clear();
+    mac->GetPhySapUser()->SlotDlIndication(sfnSf, LteNrTddSlotType::DL);
+    NS_TEST_ASSERT_MSG_EQ(m_traces.size(), 0, "Preambles of the previous slot handled again");
+    NS_TEST_ASSERT_MSG_EQ(schedSap.m_rachList.size(), 3, "Preambles given twice");
+
+    mac->Dispose();
+}
+
+class NrRachPreamblesTestSuite : public TestSuite
+{
+  public:
+    NrRachPreamblesTestSuite()
+        : TestSuite("nr-test-rach-preambles", UNIT)
+    {
+        AddTestCase(new NrRachPreamblesTestCase(), QUICK);
+    }
+};
+
+static NrRachPreamblesTestSuite nrRachPreamblesTestSuite; //!< RACH preambles test suite
+
+} // namespace ns3
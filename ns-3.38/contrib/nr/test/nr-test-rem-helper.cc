@@ -0,0 +1,282 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+/**
+ * \file nr-test-rem-helper.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the tiles, threads and checkpoints of the
+ * NrRadioEnvironmentMapHelper. The output file of a map doesn't depend on the
+ * size of the tiles or on the number of threads, a map interrupted after a
+ * tile is resumed from its checkpoint to the same file, and a checkpoint of
+ * another map is ignored.
+ */
+namespace ns3
+{
+
+class NrRemHelperTestCase : public TestCase
+{
+  public:
+    NrRemHelperTestCase()
+        : TestCase("Tiles, threads and checkpoints of the REM helper")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create the REM of the scenario, with checkpoints
+     * \param tileSize the TileSize attribute
+     * \param numThreads the NumThreads attribute
+     * \return the content of the REM output file
+     */
+    std::string CreateRem(uint32_t tileSize, uint32_t numThreads);
+
+    /**
+     * \brief Keep the TileDone traces, and save the output and the
+     * checkpoint once m_saveAfter points are done
+     * \param numDone the number of points done
+     * \param numPoints the number of points of the map
+     */
+    void TileDone(uint32_t numDone, uint32_t numPoints);
+
+    /**
+     * \brief Read a file
+     * \param filename the name of the file
+     * \return the content of the file
+     */
+    static std::string ReadFile(const std::string& filename);
+
+    /**
+     * \brief Write a file
+     * \param filename the name of the file
+     * \param content the content of the file
+     */
+    static void WriteFile(const std::string& filename, const std::string& content);
+
+    const std::string m_simTag{"nr-test-rem-helper"}; //!< the SimTag of the maps
+    std::vector<uint32_t> m_numDone;                  //!< the points done after each tile
+    uint32_t m_saveAfter{0};                          //!< the points done when saving the files
+    std::string m_savedOutput;                        //!< the saved output file
+    std::string m_savedCheckpoint;                    //!< the saved checkpoint
+};
+
+std::string
+NrRemHelperTestCase::ReadFile(const std::string& filename)
+{
+    std::ifstream inFile(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    std::ostringstream content;
+    content << inFile.rdbuf();
+    return content.str();
+}
+
+void
+NrRemHelperTestCase::WriteFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream outFile(filename.c_str(),
+                          std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    outFile << content;
+}
+
+void
+NrRemHelperTestCase::TileDone(uint32_t numDone, uint32_t numPoints)
+{
+    m_numDone.push_back(numDone);
+    if (numDone == m_saveAfter)
+    {
+        m_savedOutput = ReadFile("nr-rem-" + m_simTag + ".out");
+        m_savedCheckpoint = ReadFile("nr-rem-" + m_simTag + ".checkpoint");
+    }
+}
+
+std::string
+NrRemHelperTestCase::CreateRem(uint32_t tileSize, uint32_t numThreads)
+{
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(2);
+    ueNodes.Create(1);
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(gnbNodes);
+    mobility.Install(ueNodes);
+    gnbNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(0, 0, 10));
+    gnbNodes.Get(1)->GetObject<MobilityModel>()->SetPosition(Vector(80, 30, 10));
+    ueNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(30, 10, 1.5));
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    nrHelper->SetBeamformingHelper(CreateObject<IdealBeamformingHelper>());
+    nrHelper->SetEpcHelper(epcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+
+    // the energy log of the UE in the temporary directory
+    Config::SetDefault("ns3::NrNetDevice::outputDir", StringValue(CreateTempDirFilename("ue-")));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(1));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    // the 51 RBs of a 20 MHz BWP expected by the resource manager
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(1));
+    nrHelper->SetGnbPhyAttribute("RbOverhead", DoubleValue(0.08));
+
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    // each gNB has the resource manager of its single BWP
+    NrMacSchedulerRessourceManager manager0("F|F|F|F|F|F|F|F|F|F|",
+                                            1,
+                                            1,
+                                            0,
+                                            CreateTempDirFilename("gnb0"),
+                                            3,
+                                            false);
+    NrMacSchedulerRessourceManager manager1("F|F|F|F|F|F|F|F|F|F|",
+                                            1,
+                                            1,
+                                            0,
+                                            CreateTempDirFilename("gnb1"),
+                                            3,
+                                            false);
+    NetDeviceContainer gnbNetDev =
+        nrHelper->InstallGnbDevice(NodeContainer(gnbNodes.Get(0)), allBwps, 1, &manager0);
+    gnbNetDev.Add(
+        nrHelper->InstallGnbDevice(NodeContainer(gnbNodes.Get(1)), allBwps, 1, &manager1));
+    NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t stream = 1;
+    stream += nrHelper->AssignStreams(gnbNetDev, stream);
+    nrHelper->AssignStreams(ueNetDev, stream);
+
+    for (auto it = gnbNetDev.Begin(); it != gnbNetDev.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueNetDev.Begin(); it != ueNetDev.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    InternetStackHelper internet;
+    internet.Install(ueNodes);
+    epcHelper->AssignUeIpv4Address(ueNetDev);
+    nrHelper->AttachToEnb(ueNetDev.Get(0), gnbNetDev.Get(0));
+
+    Ptr<NrRadioEnvironmentMapHelper> remHelper = CreateObject<NrRadioEnvironmentMapHelper>();
+    remHelper->SetAttribute("SimTag", StringValue(m_simTag));
+    remHelper->SetAttribute("XMin", DoubleValue(-20));
+    remHelper->SetAttribute("XMax", DoubleValue(100));
+    remHelper->SetAttribute("XRes", UintegerValue(5));
+    remHelper->SetAttribute("YMin", DoubleValue(-40));
+    remHelper->SetAttribute("YMax", DoubleValue(60));
+    remHelper->SetAttribute("YRes", UintegerValue(5));
+    remHelper->SetAttribute("RemMode", EnumValue(NrRadioEnvironmentMapHelper::COVERAGE_AREA));
+    remHelper->SetAttribute("TileSize", UintegerValue(tileSize));
+    remHelper->SetAttribute("NumThreads", UintegerValue(numThreads));
+    remHelper->SetAttribute("Checkpoint", BooleanValue(true));
+    remHelper->TraceConnectWithoutContext("TileDone",
+                                          MakeCallback(&NrRemHelperTestCase::TileDone, this));
+    remHelper->CreateRem(gnbNetDev, ueNetDev.Get(0), 0);
+
+    // the helper stops the simulation once the map is done
+    m_numDone.clear();
+    Simulator::Run();
+    Simulator::Destroy();
+
+    return ReadFile("nr-rem-" + m_simTag + ".out");
+}
+
+void
+NrRemHelperTestCase::DoRun()
+{
+    const std::string outputFile = "nr-rem-" + m_simTag + ".out";
+    const std::string checkpointFile = "nr-rem-" + m_simTag + ".checkpoint";
+
+    const std::string map = CreateRem(1, 1);
+    NS_TEST_ASSERT_MSG_EQ(m_numDone.size(), 36, "One tile per point expected");
+    NS_TEST_ASSERT_MSG_EQ(std::count(map.begin(), map.end(), '\n'),
+                          36,
+                          "One line per point expected");
+    NS_TEST_ASSERT_MSG_EQ((CreateRem(7, 1) == map), true, "The map depends on the tile size");
+
+    // save the files after the second tile
+    m_saveAfter = 14;
+    NS_TEST_ASSERT_MSG_EQ((CreateRem(7, 3) == map), true, "The map depends on the threads");
+    NS_TEST_ASSERT_MSG_EQ(m_numDone.size(), 6, "Tiles of 7 points expected");
+    NS_TEST_ASSERT_MSG_EQ(m_savedOutput.empty(), false, "Output not saved after the tile");
+    NS_TEST_ASSERT_MSG_EQ(m_savedCheckpoint.empty(), false, "Checkpoint not saved after the tile");
+    NS_TEST_ASSERT_MSG_EQ(std::ifstream(checkpointFile.c_str()).is_open(),
+                          false,
+                          "Checkpoint not removed at the end of the map");
+    m_saveAfter = 0;
+
+    // a run interrupted while writing the third tile is resumed after the second one
+    WriteFile(outputFile, m_savedOutput + "10\t-40\t1.5\t12.");
+    WriteFile(checkpointFile, m_savedCheckpoint);
+    NS_TEST_ASSERT_MSG_EQ((CreateRem(7, 3) == map), true, "Wrong resumed map");
+    NS_TEST_ASSERT_MSG_EQ(m_numDone.front(), 21, "The map was not resumed after the checkpoint");
+
+    // the checkpoint of another map starts the map again, even if the output is complete
+    std::string otherOutput = m_savedOutput;
+    otherOutput.replace(0, 1, "9");
+    WriteFile(outputFile, otherOutput);
+    WriteFile(checkpointFile, "other " + m_savedCheckpoint);
+    NS_TEST_ASSERT_MSG_EQ((CreateRem(7, 3) == map), true, "Wrong map started again");
+    NS_TEST_ASSERT_MSG_EQ(m_numDone.front(), 7, "The checkpoint of another map was used");
+
+    for (const std::string suffix :
+         {".out", ".checkpoint", "-ues.txt", "-gnbs.txt", "-buildings.txt", "-plot-rem.gnuplot"})
+    {
+        std::remove(("nr-rem-" + m_simTag + suffix).c_str());
+    }
+}
+
+class NrRemHelperTestSuite : public TestSuite
+{
+  public:
+    NrRemHelperTestSuite()
+        : TestSuite("nr-test-rem-helper", UNIT)
+    {
+        AddTestCase(new NrRemHelperTestCase(), QUICK);
+    }
+};
+
+static NrRemHelperTestSuite nrRemHelperTestSuite; //!< REM helper test suite
+
+} // namespace ns3
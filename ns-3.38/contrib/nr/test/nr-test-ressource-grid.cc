@@ -0,0 +1,263 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-mac-scheduler-ressource-grid.h>
+#include <ns3/nr-mac-scheduler-ressource-manager.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+
+#include <random>
+
+/**
+ * \file nr-test-ressource-grid.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the flat ressource grid of the RedCap ressource manager.
+ * Random owners are written into the grid and every query that works on the
+ * occupancy bitmap is compared against a plain scan of the owners. The same is
+ * done for the free symbol index of the BWPs. Finally the ressource usage that
+ * the ressource manager counts while marking ressources is checked over a change
+ * of the ressource window.
+ */
+namespace ns3
+{
+
+class NrRessourceGridTestCase : public TestCase
+{
+  public:
+    NrRessourceGridTestCase(uint16_t numRb)
+        : TestCase("Ressource grid with " + std::to_string(numRb) + " RB"),
+          m_numRb(numRb)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    uint16_t m_numRb{0};
+};
+
+void
+NrRessourceGridTestCase::DoRun()
+{
+    const uint64_t numRows = 28;
+    NrMacSchedulerRessourceGrid grid;
+    grid.Resize(numRows, m_numRb);
+    std::vector<int32_t> reference(numRows * m_numRb, 0);
+    std::mt19937 rng(1);
+
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        uint64_t row = rng() % numRows;
+        uint16_t rb = rng() % m_numRb;
+        // the reserved states and RNTIs up to 65535
+        int32_t owner = rng() % 3 == 0 ? 0 : static_cast<int32_t>(rng() % 65544) - 8;
+        grid.Set(row, rb, owner);
+        reference[row * m_numRb + rb] = owner;
+
+        uint16_t lowRb = rng() % m_numRb;
+        uint16_t highRb = lowRb + rng() % (m_numRb - lowRb);
+        uint16_t minLength = 1 + rng() % 60;
+
+        uint16_t free = 0;
+        uint16_t run = 0;
+        uint16_t runStart = NrMacSchedulerRessourceGrid::NO_RUN;
+        for (uint16_t k = lowRb; k <= highRb; ++k)
+        {
+            if (reference[row * m_numRb + k] == 0)
+            {
+                ++free;
+                ++run;
+                if (run == minLength && runStart == NrMacSchedulerRessourceGrid::NO_RUN)
+                {
+                    runStart = k - minLength + 1;
+                }
+            }
+            else
+            {
+                run = 0;
+            }
+        }
+
+        NS_TEST_ASSERT_MSG_EQ(grid.Get(row, rb), owner, "Wrong owner");
+        NS_TEST_ASSERT_MSG_EQ(grid.CountFree(row, lowRb, highRb), free, "Wrong free count");
+        NS_TEST_ASSERT_MSG_EQ(grid.IsRangeFree(row, lowRb, highRb - lowRb + 1),
+                              (free == highRb - lowRb + 1),
+                              "Wrong range check");
+        NS_TEST_ASSERT_MSG_EQ(grid.FindFreeRun(row, lowRb, highRb, minLength),
+                              runStart,
+                              "Wrong free run");
+    }
+}
+
+class NrFreeSymbolIndexTestCase : public TestCase
+{
+  public:
+    NrFreeSymbolIndexTestCase(uint16_t numBwp)
+        : TestCase("Free symbol index with " + std::to_string(numBwp) + " BWP"),
+          m_numBwp(numBwp)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    uint16_t m_numBwp{0};
+};
+
+void
+NrFreeSymbolIndexTestCase::DoRun()
+{
+    NrMacSchedulerFreeSymbolIndex index;
+    index.Resize(m_numBwp, 13);
+    std::vector<uint8_t> reference(m_numBwp, 13);
+    std::mt19937 rng(2);
+
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        uint16_t bwp = rng() % m_numBwp;
+        uint8_t freeSymbols = rng() % 14;
+        index.Set(bwp, freeSymbols);
+        reference[bwp] = freeSymbols;
+
+        uint16_t firstBwp = rng() % (m_numBwp + 1);
+        uint16_t endBwp = firstBwp + rng() % (m_numBwp - firstBwp + 1);
+        uint16_t maxBwp = endBwp;
+        for (uint16_t k = firstBwp; k < endBwp; ++k)
+        {
+            if (maxBwp == endBwp || reference[k] > reference[maxBwp])
+            {
+                maxBwp = k;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(index.GetMaxBwp(firstBwp, endBwp), maxBwp, "Wrong BWP");
+    }
+}
+
+class NrRessourceUsageTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param rnti the RNTI of the UE whose ressources are marked
+     */
+    NrRessourceUsageTestCase(uint16_t rnti)
+        : TestCase("Ressource usage counted while marking ressources of RNTI " +
+                   std::to_string(rnti)),
+          m_rnti(rnti)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    void FrameUsage(uint64_t frameNumber, const RessourceUsageStats& stats);
+    static uint64_t Sum(const RessourceUsageStats& stats);
+
+    static const uint16_t NUM_RB = 102;           //!< 2 RedCap BWPs
+    static const uint64_t SYM_PER_FRAME = 20 * 14; //!< numerology 1
+    uint16_t m_rnti;
+    std::map<uint64_t, RessourceUsageStats> m_frames;
+};
+
+uint64_t
+NrRessourceUsageTestCase::Sum(const RessourceUsageStats& stats)
+{
+    return stats.PdcchRessources + stats.PdcchUsed + stats.PucchRessources +
+           stats.freeRessources_DL + stats.freeRessources_UL + stats.usedRessources_UL +
+           stats.usedRessources_DL + stats.PrachRessources + stats.ControlRessources;
+}
+
+void
+NrRessourceUsageTestCase::FrameUsage(uint64_t frameNumber, const RessourceUsageStats& stats)
+{
+    NS_TEST_ASSERT_MSG_EQ(Sum(stats), SYM_PER_FRAME * NUM_RB, "Ressources of a frame lost");
+    m_frames[frameNumber] = stats;
+}
+
+void
+NrRessourceUsageTestCase::DoRun()
+{
+    const uint16_t ue = m_rnti;
+    const uint64_t imsi = 5;
+    NrMacSchedulerRessourceManager manager("DL|DL|S|UL|UL|UL|UL|UL|UL|UL|", 1, 1, 0, "", 4, false);
+    for (uint16_t bwp = 0; bwp < 4; ++bwp)
+    {
+        manager.configureBwp(bwp, bwp < 2 ? 51 : NUM_RB, 1);
+    }
+    manager.UpdateRntiMap(imsi, ue);
+    manager.TraceConnectWithoutContext(
+        "FrameRessourceUsage",
+        MakeCallback(&NrRessourceUsageTestCase::FrameUsage, this));
+
+    // 10 RB x 4 symbols in an UL slot of frame 2 and of frame 10, which is behind the
+    // first change of the ressource window (80 ms)
+    RessourceSet res;
+    res.StartSymbol = 1;
+    res.NumberSymbols = 4;
+    res.StartRB = 0;
+    res.NumberRB = 10;
+    manager.markRessources(&res, ue, 2 * 20 + 3);
+    manager.markRessources(&res, ue, 10 * 20 + 3);
+
+    Simulator::Stop(MilliSeconds(200));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_frames.size(), 19, "One report per frame expected");
+    NS_TEST_ASSERT_MSG_EQ(m_frames[2].usedRessources_UL, 40, "Wrong UL usage");
+    NS_TEST_ASSERT_MSG_EQ(m_frames[10].usedRessources_UL, 40, "Wrong UL usage");
+    // frame 18 uses the same part of the ring buffer as frame 2, which has been cleared
+    NS_TEST_ASSERT_MSG_EQ(m_frames[18].usedRessources_UL, 0, "Ressources not cleared");
+    NS_TEST_ASSERT_MSG_EQ(m_frames[18].freeRessources_UL, m_frames[2].freeRessources_UL + 40, "Ressources not freed");
+
+    // the intervals reach back behind the changes of the ressource window at 80 and 160 ms
+    RessourceUsageStats interval = manager.calculateCapacityUsage(15, 0);
+    NS_TEST_ASSERT_MSG_EQ(Sum(interval), 17 * SYM_PER_FRAME * NUM_RB, "Wrong frames counted");
+    NS_TEST_ASSERT_MSG_EQ(interval.usedRessources_UL, 80, "Wrong UL usage of the interval");
+    interval = manager.calculateCapacityUsage(25, 50);
+    NS_TEST_ASSERT_MSG_EQ(Sum(interval), 12 * SYM_PER_FRAME * NUM_RB, "Wrong frames counted");
+    NS_TEST_ASSERT_MSG_EQ(interval.usedRessources_UL, 40, "Wrong UL usage of the interval");
+
+    manager.collectFinalResUsage();
+    RessourceUsageStats total = manager.getCapacityUsage();
+    NS_TEST_ASSERT_MSG_EQ(Sum(total), 20 * SYM_PER_FRAME * NUM_RB, "Not every frame collected");
+    NS_TEST_ASSERT_MSG_EQ(total.usedRessources_UL, 80, "Wrong collected UL usage");
+    NS_TEST_ASSERT_MSG_EQ(manager.getUeSpecificCapacityUsage().GetUlUsage(imsi), 80, "Wrong UE usage");
+
+    Simulator::Destroy();
+}
+
+class NrRessourceGridTestSuite : public TestSuite
+{
+  public:
+    NrRessourceGridTestSuite()
+        : TestSuite("nr-test-ressource-grid", UNIT)
+    {
+        AddTestCase(new NrRessourceGridTestCase(51), QUICK);
+        AddTestCase(new NrRessourceGridTestCase(255), QUICK);
+        AddTestCase(new NrRessourceGridTestCase(510), QUICK);
+        AddTestCase(new NrFreeSymbolIndexTestCase(1), QUICK);
+        AddTestCase(new NrFreeSymbolIndexTestCase(10), QUICK);
+        AddTestCase(new NrFreeSymbolIndexTestCase(16), QUICK);
+        AddTestCase(new NrRessourceUsageTestCase(7), QUICK);
+        // above 32767, and the RNTI whose 16-bit value is RESERVED
+        AddTestCase(new NrRessourceUsageTestCase(40000), QUICK);
+        AddTestCase(new NrRessourceUsageTestCase(65535), QUICK);
+    }
+};
+
+static NrRessourceGridTestSuite nrRessourceGridTestSuite; //!< Ressource grid test suite
+
+} // namespace ns3
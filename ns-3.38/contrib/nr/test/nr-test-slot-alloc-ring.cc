@@ -0,0 +1,182 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-slot-alloc-ring.h>
+#include <ns3/test.h>
+
+/**
+ * \file nr-test-slot-alloc-ring.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the NrSlotAllocRing of the PHY. The allocations and
+ * the bursts of the slots ahead of the current one are stored, merged,
+ * looked up and retrieved as with the sorted list of the PHY: first with a
+ * look-ahead within the ring, then with one which makes the ring grow, and
+ * then when an allocation is put in front of the others, as the gNB does
+ * when the channel is not granted.
+ */
+namespace ns3
+{
+
+/**
+ * \brief A DATA allocation of one symbol
+ * \param sfn the slot
+ * \param symStart the symbol
+ * \return the allocation
+ */
+static SlotAllocInfo
+CreateAllocation(const SfnSf& sfn, uint8_t symStart)
+{
+    SlotAllocInfo alloc(sfn);
+    alloc.m_type = SlotAllocInfo::DL;
+    alloc.m_numSymAlloc = 1;
+    auto dci = std::make_shared<DciInfoElementTdma>(1,
+                                                    DciInfoElementTdma::DL,
+                                                    symStart,
+                                                    1,
+                                                    std::vector<uint8_t>{1},
+                                                    std::vector<uint32_t>{100},
+                                                    std::vector<uint8_t>{1},
+                                                    std::vector<uint8_t>{0},
+                                                    DciInfoElementTdma::DATA,
+                                                    0,
+                                                    0);
+    alloc.m_varTtiAllocInfo.emplace_back(dci);
+    return alloc;
+}
+
+class NrSlotAllocRingTestCase : public TestCase
+{
+  public:
+    NrSlotAllocRingTestCase(uint32_t lookAhead)
+        : TestCase("Slot allocation ring with a look-ahead of " + std::to_string(lookAhead) +
+                   " slots"),
+          m_lookAhead(lookAhead)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    uint32_t m_lookAhead;
+};
+
+void
+NrSlotAllocRingTestCase::DoRun()
+{
+    NrSlotAllocRing ring(16);
+    SfnSf current(0, 0, 0, 1);
+    const uint32_t numSlots = 200;
+
+    for (uint32_t i = 0; i < numSlots; ++i)
+    {
+        // the MAC schedules the slot of the look-ahead, in two parts
+        SfnSf future = current.GetFutureSfnSf(m_lookAhead);
+        ring.PushAllocation(CreateAllocation(future, 1));
+        ring.PushAllocation(CreateAllocation(future, 0));
+        ring.AddPacket(future, 1, 0, Create<Packet>(10));
+        ring.AddPacket(future, 1, 0, Create<Packet>(20));
+        NS_TEST_ASSERT_MSG_EQ(ring.HasAllocation(future), true, "Missing allocation");
+        NS_TEST_ASSERT_MSG_EQ(ring.PeekAllocation(future).m_varTtiAllocInfo.size(),
+                              2,
+                              "The allocations of a slot are not merged");
+
+        if (i >= m_lookAhead)
+        {
+            NS_TEST_ASSERT_MSG_EQ(ring.GetNumAllocations(),
+                                  m_lookAhead + 1,
+                                  "Wrong number of allocations");
+            SlotAllocInfo alloc = ring.RetrieveAllocation(current);
+            NS_TEST_ASSERT_MSG_EQ(alloc.m_sfnSf.Normalize(),
+                                  current.Normalize(),
+                                  "Wrong slot of the allocation");
+            NS_TEST_ASSERT_MSG_EQ(alloc.m_varTtiAllocInfo.front().m_dci->m_symStart,
+                                  0,
+                                  "The merged allocation is not sorted");
+            NS_TEST_ASSERT_MSG_EQ(ring.HasAllocation(current), false, "Allocation not removed");
+
+            Ptr<PacketBurst> burst = ring.RetrievePacketBurst(current, 1, 0);
+            NS_TEST_ASSERT_MSG_NE(burst, nullptr, "Missing burst");
+            NS_TEST_ASSERT_MSG_EQ(burst->GetNPackets(), 2, "Wrong number of packets");
+            NS_TEST_ASSERT_MSG_EQ(burst->GetSize(), 30, "Wrong size of the burst");
+            NS_TEST_ASSERT_MSG_EQ(ring.RetrievePacketBurst(current, 1, 0),
+                                  nullptr,
+                                  "Burst not removed");
+            NS_TEST_ASSERT_MSG_EQ(ring.RetrievePacketBurst(current, 0, 0),
+                                  nullptr,
+                                  "Unexpected burst");
+        }
+        current.Add(1);
+    }
+    NS_TEST_ASSERT_MSG_GT(ring.GetCapacity(),
+                          m_lookAhead,
+                          "The ring is smaller than the look-ahead");
+    NS_TEST_ASSERT_MSG_EQ(ring.GetNumPacketBursts(), m_lookAhead, "Wrong number of bursts");
+
+    // a burst left in a past slot is dropped when its entry is needed
+    ring.AddPacket(current, 5, 0, Create<Packet>(10));
+    for (uint32_t i = 0; i <= ring.GetCapacity(); ++i)
+    {
+        SfnSf future = current.GetFutureSfnSf(m_lookAhead);
+        ring.PushAllocation(CreateAllocation(future, 1));
+        ring.RetrieveAllocation(current);
+        ring.RetrievePacketBurst(current, 1, 0);
+        current.Add(1);
+    }
+    NS_TEST_ASSERT_MSG_EQ(ring.GetNumPacketBursts(), 0, "The burst of the past slot is kept");
+
+    // the channel is not granted: the allocation of the current slot, and
+    // the following ones, are delayed by one slot with their bursts
+    SlotAllocInfo delayed = ring.RetrieveAllocation(current);
+    ring.AddPacket(current, 1, 0, Create<Packet>(40));
+    SfnSf last = current.GetFutureSfnSf(m_lookAhead - 1);
+    ring.AddPacket(last, 1, 0, Create<Packet>(50));
+    SfnSf next = current.GetFutureSfnSf(1);
+    ring.PushFrontAllocation(next, delayed);
+    NS_TEST_ASSERT_MSG_EQ(ring.GetNumAllocations(), m_lookAhead, "Allocations lost");
+    NS_TEST_ASSERT_MSG_EQ(ring.HasAllocation(last.GetFutureSfnSf(1)),
+                          true,
+                          "The last allocation is not delayed");
+    NS_TEST_ASSERT_MSG_EQ(ring.RetrieveAllocation(next).m_sfnSf.Normalize(),
+                          next.Normalize(),
+                          "Wrong slot of the delayed allocation");
+    NS_TEST_ASSERT_MSG_EQ(ring.RetrievePacketBurst(next, 1, 0)->GetSize(),
+                          40,
+                          "The burst of the delayed allocation is not moved");
+    NS_TEST_ASSERT_MSG_EQ(ring.RetrievePacketBurst(last.GetFutureSfnSf(1), 1, 0)->GetSize(),
+                          50,
+                          "The burst of the last allocation is not moved");
+
+    ring.Clear();
+    NS_TEST_ASSERT_MSG_EQ(ring.GetNumAllocations(), 0, "Allocations not cleared");
+    NS_TEST_ASSERT_MSG_EQ(ring.GetNumPacketBursts(), 0, "Bursts not cleared");
+}
+
+class NrSlotAllocRingTestSuite : public TestSuite
+{
+  public:
+    NrSlotAllocRingTestSuite()
+        : TestSuite("nr-test-slot-alloc-ring", UNIT)
+    {
+        AddTestCase(new NrSlotAllocRingTestCase(4), QUICK);
+        AddTestCase(new NrSlotAllocRingTestCase(40), QUICK);
+    }
+};
+
+static NrSlotAllocRingTestSuite nrSlotAllocRingTestSuite; //!< slot allocation ring test suite
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/boolean.h>
+#include <ns3/internet-stack-helper.h>
+#include <ns3/ipv4-address.h>
+#include <ns3/node-container.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+#include <ns3/udp-client-5hine.h>
+#include <ns3/uinteger.h>
+
+#include <fstream>
+
+/**
+ * \file nr-test-udp-client-5hine.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the transmission times of the UdpClient5hine.
+ * The client sends to the loopback address of its node. The times given with
+ * ScheduleTransmit are checked while the simulation runs, and a text and a
+ * binary trace file are streamed in chunks that are smaller than the file.
+ */
+namespace ns3
+{
+
+class NrUdpClient5hineTimestampsTestCase : public TestCase
+{
+  public:
+    NrUdpClient5hineTimestampsTestCase()
+        : TestCase("UdpClient5hine sends at the scheduled times")
+    {
+    }
+
+  private:
+    void DoRun() override;
+    void CheckSent(Ptr<UdpClient5hine> client, uint32_t sent);
+};
+
+void
+NrUdpClient5hineTimestampsTestCase::CheckSent(Ptr<UdpClient5hine> client, uint32_t sent)
+{
+    NS_TEST_ASSERT_MSG_EQ(client->GetSent(), sent, "Wrong number of packets at " << Simulator::Now().As(Time::S));
+}
+
+void
+NrUdpClient5hineTimestampsTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(1);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    Ptr<UdpClient5hine> client = CreateObject<UdpClient5hine>();
+    client->SetRemote(Ipv4Address::GetLoopback(), 9);
+    client->SetAttribute("PacketSize", UintegerValue(100));
+    nodes.Get(0)->AddApplication(client);
+    client->SetStartTime(Seconds(1));
+    client->SetStopTime(Seconds(2));
+    // not in order, the last one is after the stop of the application
+    client->ScheduleTransmit({TimeValue(MilliSeconds(300)),
+                              TimeValue(MilliSeconds(100)),
+                              TimeValue(MilliSeconds(200)),
+                              TimeValue(MilliSeconds(1500))});
+
+    Simulator::Schedule(MilliSeconds(1050), &NrUdpClient5hineTimestampsTestCase::CheckSent, this, client, 0);
+    Simulator::Schedule(MilliSeconds(1150), &NrUdpClient5hineTimestampsTestCase::CheckSent, this, client, 1);
+    Simulator::Schedule(MilliSeconds(1250), &NrUdpClient5hineTimestampsTestCase::CheckSent, this, client, 2);
+    Simulator::Schedule(MilliSeconds(1350), &NrUdpClient5hineTimestampsTestCase::CheckSent, this, client, 3);
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(client->GetSent(), 3, "Packet sent after the stop of the application");
+    NS_TEST_ASSERT_MSG_EQ(client->GetTotalTx(), 300, "Wrong number of bytes");
+    Simulator::Destroy();
+}
+
+class NrUdpClient5hineTraceTestCase : public TestCase
+{
+  public:
+    NrUdpClient5hineTraceTestCase(bool binary)
+        : TestCase(std::string("UdpClient5hine streams a ") + (binary ? "binary" : "text") +
+                   " trace file"),
+          m_binary(binary)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    bool m_binary{false};
+};
+
+void
+NrUdpClient5hineTraceTestCase::DoRun()
+{
+    const uint32_t entries = 1000;
+    std::string filename = CreateTempDirFilename(m_binary ? "trace.bin" : "trace.csv");
+    std::ofstream file(filename, m_binary ? std::ios::out | std::ios::binary : std::ios::out);
+    uint64_t totalSize = 0;
+    if (!m_binary)
+    {
+        file << "# time,size" << std::endl;
+    }
+    for (uint32_t i = 0; i < entries; ++i)
+    {
+        double seconds = i * 0.001;
+        uint32_t size = i % 10 == 0 ? 0 : 12 + i % 50; // 0: PacketSize
+        totalSize += size == 0 ? 100 : size;
+        if (m_binary)
+        {
+            file.write(reinterpret_cast<const char*>(&seconds), sizeof(seconds));
+            file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        }
+        else
+        {
+            file << seconds << "," << size << std::endl;
+        }
+    }
+    file.close();
+
+    NodeContainer nodes;
+    nodes.Create(1);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    Ptr<UdpClient5hine> client = CreateObject<UdpClient5hine>();
+    client->SetRemote(Ipv4Address::GetLoopback(), 9);
+    client->SetAttribute("PacketSize", UintegerValue(100));
+    client->SetAttribute("TraceFilename", StringValue(filename));
+    client->SetAttribute("TraceBinary", BooleanValue(m_binary));
+    client->SetAttribute("TraceChunkSize", UintegerValue(64));
+    nodes.Get(0)->AddApplication(client);
+    client->SetStartTime(Seconds(1));
+    client->SetStopTime(Seconds(3));
+
+    Simulator::Stop(Seconds(4));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(client->GetSent(), entries, "Not every entry of the trace file sent");
+    NS_TEST_ASSERT_MSG_EQ(client->GetTotalTx(), totalSize, "Wrong number of bytes");
+    Simulator::Destroy();
+}
+
+class NrUdpClient5hineTestSuite : public TestSuite
+{
+  public:
+    NrUdpClient5hineTestSuite()
+        : TestSuite("nr-test-udp-client-5hine", UNIT)
+    {
+        AddTestCase(new NrUdpClient5hineTimestampsTestCase(), QUICK);
+        AddTestCase(new NrUdpClient5hineTraceTestCase(false), QUICK);
+        AddTestCase(new NrUdpClient5hineTraceTestCase(true), QUICK);
+    }
+};
+
+static NrUdpClient5hineTestSuite nrUdpClient5hineTestSuite; //!< UdpClient5hine test suite
+
+} // namespace ns3
@@ -0,0 +1,411 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/antenna-module.h"
+#include "ns3/core-module.h"
+#include "ns3/eps-bearer-tag.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+
+#include <vector>
+
+/**
+ * \file nr-test-ue-phy-sleep.cc
+ * \ingroup test
+ *
+ * \brief Test of the UE PHY which stops its slots while its MAC is dormant
+ * (attribute SleepWhenIdle). Two UEs are attached to a gNB, and the first
+ * one is made dormant. While it sleeps, DL data is sent to the second UE:
+ * the DCIs for the other RNTI must not wake the first UE up. Then DL data is
+ * sent to the first UE: its DCI, for the same slot (k0 = 0) or for the next
+ * one (k0 = 1), wakes it up, the data is received, and the slot numbers of
+ * the UE are still aligned with the ones of the gNB.
+ *
+ * The paging frames of TS 38.304 used to wake up the UEs in RRC INACTIVE are
+ * tested too, as well as the choice of the eDRX cycle as paging cycle by the
+ * UE MAC.
+ */
+namespace ns3
+{
+
+/**
+ * \brief PHY SAP user which forwards everything to the UE MAC, but reports
+ * the MAC as dormant when asked by the test, and records the slot indications
+ */
+class SleepTestPhySapUser : public NrUePhySapUser
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param mac the SAP user of the UE MAC
+     */
+    SleepTestPhySapUser(NrUePhySapUser* mac)
+        : m_mac(mac)
+    {
+    }
+
+    void ReceivePhyPdu(Ptr<Packet> p) override
+    {
+        m_mac->ReceivePhyPdu(p);
+    }
+
+    void ReceiveControlMessage(Ptr<NrControlMessage> msg) override
+    {
+        m_mac->ReceiveControlMessage(msg);
+    }
+
+    void SlotIndication(SfnSf s) override
+    {
+        m_slots.emplace_back(Simulator::Now(), s);
+        m_mac->SlotIndication(s);
+    }
+
+    uint8_t GetNumHarqProcess() const override
+    {
+        return m_mac->GetNumHarqProcess();
+    }
+
+    void RecvSib1(NrSib1Message sib1, NrPhySapProvider::PrachConfig prachOccasions) override
+    {
+        m_mac->RecvSib1(sib1, prachOccasions);
+    }
+
+    bool IsDormant() const override
+    {
+        return m_dormant || m_mac->IsDormant();
+    }
+
+    bool IsPagingOccasion(const SfnSf& s) const override
+    {
+        return m_mac->IsPagingOccasion(s);
+    }
+
+    bool m_dormant{false};                       //!< report the MAC as dormant
+    std::vector<std::pair<Time, SfnSf>> m_slots; //!< the slot indications, with their time
+
+  private:
+    NrUePhySapUser* m_mac; //!< the SAP user of the UE MAC
+};
+
+/**
+ * \brief Send a DL packet of the default bearer from the gNB to a UE
+ * \param device the gNB device
+ * \param ue the UE device, whose RNTI is read when the packet is sent
+ */
+static void
+SendDlPacket(Ptr<NetDevice> device, Ptr<NetDevice> ue)
+{
+    Ptr<Packet> pkt = Create<Packet>(100);
+    // the packet is dropped by the UE IP stack, as there are no applications
+    Ipv4Header ipHeader;
+    pkt->AddHeader(ipHeader);
+    EpsBearerTag tag(NrHelper::GetUePhy(ue, 0)->GetRnti(), 1);
+    pkt->AddPacketTag(tag);
+    device->Send(pkt, ue->GetAddress(), Ipv4L3Protocol::PROT_NUMBER);
+}
+
+/**
+ * \brief Send an UL packet of the default bearer from a UE, which makes the
+ * UE connect to its gNB
+ * \param ue the UE device
+ */
+static void
+SendUlPacket(Ptr<NetDevice> ue)
+{
+    Ptr<Packet> pkt = Create<Packet>(20);
+    Ipv4Header ipHeader;
+    pkt->AddHeader(ipHeader);
+    ue->Send(pkt, ue->GetAddress(), Ipv4L3Protocol::PROT_NUMBER);
+}
+
+class NrUePhySleepTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param k0 the delay between the DL DCI and its data, in slots
+     */
+    NrUePhySleepTestCase(uint32_t k0)
+        : TestCase("Sleeping UE PHY woken up by a DL DCI with k0 = " + std::to_string(k0)),
+          m_k0(k0)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Count the correct DL transport blocks received by the UEs
+     */
+    void RxPacketTraceUe(RxPacketTraceParams params)
+    {
+        if (!params.m_corrupt && params.m_rnti == m_sleepingRnti)
+        {
+            ++m_rxTbs;
+        }
+    }
+
+    /**
+     * \brief Keep the slot of the gNB and the time it started, from the middle of the slot
+     */
+    void SampleGnbSlot(Ptr<NrGnbPhy> phy)
+    {
+        m_gnbSlot = phy->GetCurrentSfnSf();
+        m_gnbSlotStart = Simulator::Now() - phy->GetSlotPeriod() / 2;
+    }
+
+    uint32_t m_k0;                //!< the k0 of the DL DCIs
+    uint16_t m_sleepingRnti{0};   //!< the RNTI of the UE which sleeps
+    uint32_t m_rxTbs{0};          //!< correct DL TBs received by the sleeping UE
+    SfnSf m_gnbSlot;              //!< a slot of the gNB, before the UE sleeps
+    Time m_gnbSlotStart;          //!< the time at which m_gnbSlot started
+};
+
+void
+NrUePhySleepTestCase::DoRun()
+{
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(1);
+    ueNodes.Create(2);
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(gnbNodes);
+    mobility.Install(ueNodes);
+    gnbNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(0.0, 0.0, 10));
+    ueNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(0, 10, 1.5));
+    ueNodes.Get(1)->GetObject<MobilityModel>()->SetPosition(Vector(10, 0, 1.5));
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                         TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(3.5e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    // the DCIs are sent in a CORESET of two symbols
+    band.m_cc.front()->m_bwp.front()->m_coresetSymbols = 2;
+
+    // the energy log of the UEs in the temporary directory
+    Config::SetDefault("ns3::NrNetDevice::outputDir", StringValue(CreateTempDirFilename("ue-")));
+    // the UEs are RedCap UEs on the single BWP
+    Config::SetDefault("ns3::NrGnbRrc::BwpForRedCap", StringValue("0"));
+    // a PRACH occasion in every frame, for the random access of the UEs
+    Config::SetDefault("ns3::NrGnbRrc::PrachConfigurationIndex", UintegerValue(199));
+    // the UEs stay connected until the end of the test
+    Config::SetDefault("ns3::UeManagerNr::dataInactivityTimer", UintegerValue(60000));
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+
+    // the OFDMA schedulers are the ones which use the resource manager
+    nrHelper->SetSchedulerTypeId(NrMacSchedulerOfdmaRR::GetTypeId());
+    // no SRS: the SRS DCIs would wake the dormant UE up
+    nrHelper->SetSchedulerAttribute("EnableSrsInUlSlots", BooleanValue(false));
+    nrHelper->SetSchedulerAttribute("EnableSrsInFSlots", BooleanValue(false));
+    nrHelper->SetSchedulerAttribute("FixedMcsDl", BooleanValue(true));
+    nrHelper->SetSchedulerAttribute("StartingMcsDl", UintegerValue(1));
+    // the 51 RBs of a 20 MHz BWP expected by the resource manager
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(1));
+    nrHelper->SetGnbPhyAttribute("RbOverhead", DoubleValue(0.08));
+    // the random access needs UL slots for the Msg3
+    std::string pattern = "DL|DL|S|UL|UL|UL|UL|UL|UL|UL|";
+    nrHelper->SetGnbPhyAttribute("Pattern", StringValue(pattern));
+    nrHelper->SetGnbPhyAttribute("N0Delay", UintegerValue(m_k0));
+    nrHelper->SetUePhyAttribute("SleepWhenIdle", BooleanValue(true));
+    nrHelper->SetGnbMacAttribute("PagingInPagingFrames", BooleanValue(true));
+
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    NrMacSchedulerRessourceManager manager(pattern,
+                                           1,
+                                           1,
+                                           0,
+                                           CreateTempDirFilename("gnb"),
+                                           3,
+                                           false);
+    NetDeviceContainer gnbNetDev = nrHelper->InstallGnbDevice(gnbNodes, allBwps, 1, &manager);
+    RG255C chip(3.5e9, 23);
+    NetDeviceContainer ueNetDev = nrHelper->InstallRedCapUeDevice(ueNodes, allBwps, false, chip);
+
+    for (auto it = gnbNetDev.Begin(); it != gnbNetDev.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueNetDev.Begin(); it != ueNetDev.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    InternetStackHelper internet;
+    internet.Install(ueNodes);
+    epcHelper->AssignUeIpv4Address(ueNetDev);
+    nrHelper->AttachToClosestEnb(ueNetDev, gnbNetDev);
+
+    Ptr<NrUePhy> sleepingPhy = NrHelper::GetUePhy(ueNetDev.Get(0), 0);
+    SleepTestPhySapUser sapUser(NrHelper::GetUeMac(ueNetDev.Get(0), 0)->GetPhySapUser());
+    sleepingPhy->SetPhySapUser(&sapUser);
+    sleepingPhy->GetSpectrumPhy()->TraceConnectWithoutContext(
+        "RxPacketTraceUe",
+        MakeCallback(&NrUePhySleepTestCase::RxPacketTraceUe, this));
+    Ptr<NrGnbPhy> gnbPhy = NrHelper::GetGnbPhy(gnbNetDev.Get(0), 0);
+    Time slotPeriod = gnbPhy->GetSlotPeriod();
+
+    // the UEs connect when they have UL data
+    for (uint32_t i = 0; i < ueNetDev.GetN(); ++i)
+    {
+        Simulator::Schedule(MilliSeconds(100 + i * 10), &SendUlPacket, ueNetDev.Get(i));
+    }
+    // the UE is connected at 400 ms, and then dormant
+    Simulator::Schedule(MilliSeconds(400), [&]() {
+        m_sleepingRnti = sleepingPhy->GetRnti();
+        sapUser.m_dormant = true;
+    });
+    // data for the other UE, while the first one sleeps
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        Simulator::Schedule(MilliSeconds(500 + i * 10),
+                            &SendDlPacket,
+                            gnbNetDev.Get(0),
+                            ueNetDev.Get(1));
+    }
+    // the gNB slot, sampled in the middle of a slot
+    Simulator::Schedule(MilliSeconds(450) + slotPeriod / 2,
+                        &NrUePhySleepTestCase::SampleGnbSlot,
+                        this,
+                        gnbPhy);
+
+    std::size_t slotsAsleep = 0;
+    Simulator::Schedule(MilliSeconds(500), [&]() { slotsAsleep = sapUser.m_slots.size(); });
+    std::size_t slotsWithOtherUe = 0;
+    Simulator::Schedule(MilliSeconds(600), [&]() {
+        slotsWithOtherUe = sapUser.m_slots.size();
+        m_rxTbs = 0;
+    });
+    // data for the sleeping UE
+    Simulator::Schedule(MilliSeconds(700),
+                        &SendDlPacket,
+                        gnbNetDev.Get(0),
+                        ueNetDev.Get(0));
+
+    Simulator::Stop(MilliSeconds(800));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_NE(m_sleepingRnti, 0, "The UE is not connected");
+    NS_TEST_ASSERT_MSG_EQ(slotsWithOtherUe,
+                          slotsAsleep,
+                          "The UE was woken up by the DCIs of the other UE");
+    NS_TEST_ASSERT_MSG_GT(sapUser.m_slots.size(),
+                          slotsWithOtherUe,
+                          "The UE was not woken up by its DCI");
+    NS_TEST_ASSERT_MSG_GT(m_rxTbs, 0, "The UE did not receive its DL data");
+
+    // every slot started after the sleep is aligned with the slots of the gNB
+    for (std::size_t i = slotsAsleep; i < sapUser.m_slots.size(); ++i)
+    {
+        const auto& [time, slot] = sapUser.m_slots.at(i);
+        uint32_t ueSlots = (time - m_gnbSlotStart).GetTimeStep() / slotPeriod.GetTimeStep();
+        SfnSf expected = m_gnbSlot;
+        expected.Add(ueSlots);
+        NS_TEST_ASSERT_MSG_EQ(slot.Normalize(),
+                              expected.Normalize(),
+                              "The UE slot is not the gNB slot at " << time);
+    }
+
+    Simulator::Destroy();
+}
+
+class NrPagingFrameTestCase : public TestCase
+{
+  public:
+    NrPagingFrameTestCase()
+        : TestCase("Paging frames of TS 38.304")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        for (uint32_t cycle : {32, 64, 128, 256, 512, 1024})
+        {
+            for (uint32_t ueId : {0, 5, 100, 1024 + 5})
+            {
+                uint32_t pagingFrames = 0;
+                for (uint32_t frame = 0; frame < 1024; ++frame)
+                {
+                    if (NrPhySapProvider::IsPagingFrame(frame, ueId, cycle))
+                    {
+                        ++pagingFrames;
+                        NS_TEST_ASSERT_MSG_EQ(frame % cycle,
+                                              (ueId % 1024) % cycle,
+                                              "Wrong paging frame");
+                    }
+                }
+                NS_TEST_ASSERT_MSG_EQ(pagingFrames,
+                                      1024 / cycle,
+                                      "One paging frame per cycle expected");
+            }
+        }
+
+        // the UE MAC pages in the frames of its eDRX cycle once it is configured
+        Ptr<NrUeMac> mac = CreateObject<NrUeMac>();
+        mac->GetUeCmacSapProvider()->SetPRnti(100);
+        NS_TEST_ASSERT_MSG_EQ(mac->GetPhySapUser()->IsPagingOccasion(SfnSf(1, 0, 0, 1)),
+                              true,
+                              "Without DRX cycle every slot must be a paging occasion");
+        mac->GetUeCmacSapProvider()->NotifyDrx(32);
+        NS_TEST_ASSERT_MSG_EQ(mac->GetPhySapUser()->IsPagingOccasion(SfnSf(100 + 32, 0, 0, 1)),
+                              true,
+                              "Wrong paging frame for the DRX cycle");
+        mac->GetUeCmacSapProvider()->NotifyeDrx(256);
+        NS_TEST_ASSERT_MSG_EQ(mac->GetPhySapUser()->IsPagingOccasion(SfnSf(100 + 32, 0, 0, 1)),
+                              false,
+                              "The DRX cycle must not be used with eDRX");
+        NS_TEST_ASSERT_MSG_EQ(mac->GetPhySapUser()->IsPagingOccasion(SfnSf(100 + 256, 0, 0, 1)),
+                              true,
+                              "Wrong paging frame for the eDRX cycle");
+        mac->Dispose();
+    }
+};
+
+class NrUePhySleepTestSuite : public TestSuite
+{
+  public:
+    NrUePhySleepTestSuite()
+        : TestSuite("nr-test-ue-phy-sleep", SYSTEM)
+    {
+        AddTestCase(new NrPagingFrameTestCase(), QUICK);
+        AddTestCase(new NrUePhySleepTestCase(0), QUICK);
+        AddTestCase(new NrUePhySleepTestCase(1), QUICK);
+    }
+};
+
+static NrUePhySleepTestSuite nrUePhySleepTestSuite; //!< UE PHY sleep test suite
+
+} // namespace ns3
@@ -119,6 +119,7 @@ main(int argc, char* argv[])
     std::string outputDir = "./";
 
     double simTime = 36;  // seconds 
+    bool printMemoryPoolStats = false;
     
     CommandLine cmd(__FILE__);
 
@@ -168,6 +169,9 @@ main(int argc, char* argv[])
     cmd.AddValue("packetSize","used packetSize for datastream", packetSize);
     cmd.AddValue("inactivityTimer", "Timer to release the connection after it´s expiration",m_dataInactivityTimer);
     cmd.AddValue("transmitpower", "Ul tandmitower of user equipments",transmitPower);
+    cmd.AddValue("printMemoryPoolStats",
+                 "Print the hit rate of the NR memory pool at the end of the simulation",
+                 printMemoryPoolStats);
 
     cmd.Parse(argc, argv);
     
@@ -818,6 +822,10 @@ main(int argc, char* argv[])
 
     std::cout << "Capacity usage DL: "<<capacityUsage_DL << std::endl;
     std::cout << "Capacity usage UL: "<<capacityUsage_UL << std::endl;
+    if (printMemoryPoolStats)
+    {
+        std::cout << "Memory pool hit rate: " << NrMemoryPool::GetStats().GetHitRate() << std::endl;
+    }
 
     // Print per-flow statistics
     monitor->CheckForLostPackets();
@@ -860,7 +868,7 @@ main(int argc, char* argv[])
     outFile<< "Device specific ressource usage:"<<"\n";
     for(uint i=1;i<=enddevicesNumPergNb;++i)
     {
-        outFile<<"Ressource usage for device "<<i<<": "<<ueStats.ueResMap[i]<<" ressource blocks (enddevice)"<<"\n";
+        outFile<<"Ressource usage for device "<<i<<": "<<ueStats.GetUlUsage(i)<<" ressource blocks (enddevice)"<<"\n";
     }
 
 
@@ -74,17 +74,20 @@ UniformPlanarArray::GetTypeId()
             .AddAttribute("BearingAngle",
                           "The bearing angle in radians",
                           DoubleValue(0.0),
-                          MakeDoubleAccessor(&UniformPlanarArray::SetAlpha),
+                          MakeDoubleAccessor(&UniformPlanarArray::SetAlpha,
+                                             &UniformPlanarArray::GetAlpha),
                           MakeDoubleChecker<double>(-M_PI, M_PI))
             .AddAttribute("DowntiltAngle",
                           "The downtilt angle in radians",
                           DoubleValue(0.0),
-                          MakeDoubleAccessor(&UniformPlanarArray::SetBeta),
+                          MakeDoubleAccessor(&UniformPlanarArray::SetBeta,
+                                             &UniformPlanarArray::GetBeta),
                           MakeDoubleChecker<double>(-M_PI, M_PI))
             .AddAttribute("PolSlantAngle",
                           "The polarization slant angle in radians",
                           DoubleValue(0.0),
-                          MakeDoubleAccessor(&UniformPlanarArray::SetPolSlant),
+                          MakeDoubleAccessor(&UniformPlanarArray::SetPolSlant,
+                                             &UniformPlanarArray::GetPolSlant),
                           MakeDoubleChecker<double>(-M_PI, M_PI));
     return tid;
 }
@@ -131,6 +134,12 @@ UniformPlanarArray::SetAlpha(double alpha)
     m_sinAlpha = sin(m_alpha);
 }
 
+double
+UniformPlanarArray::GetAlpha() const
+{
+    return m_alpha;
+}
+
 void
 UniformPlanarArray::SetBeta(double beta)
 {
@@ -139,6 +148,12 @@ UniformPlanarArray::SetBeta(double beta)
     m_sinBeta = sin(m_beta);
 }
 
+double
+UniformPlanarArray::GetBeta() const
+{
+    return m_beta;
+}
+
 void
 UniformPlanarArray::SetPolSlant(double polSlant)
 {
@@ -147,6 +162,12 @@ UniformPlanarArray::SetPolSlant(double polSlant)
     m_sinPolSlant = sin(m_polSlant);
 }
 
+double
+UniformPlanarArray::GetPolSlant() const
+{
+    return m_polSlant;
+}
+
 void
 UniformPlanarArray::SetAntennaHorizontalSpacing(double s)
 {
@@ -120,6 +120,12 @@ class UniformPlanarArray : public PhasedArrayModel
      */
     void SetAlpha(double alpha);
 
+    /**
+     * \brief Get the bearing angle
+     * \return the bearing angle in radians
+     */
+    double GetAlpha() const;
+
     /**
      * \brief Set the downtilt angle
      * This method sets the downtilt angle and
@@ -128,6 +134,12 @@ class UniformPlanarArray : public PhasedArrayModel
      */
     void SetBeta(double beta);
 
+    /**
+     * \brief Get the downtilt angle
+     * \return the downtilt angle in radians
+     */
+    double GetBeta() const;
+
     /**
      * \brief Set the polarization slant angle
      * This method sets the polarization slant angle and
@@ -136,6 +148,12 @@ class UniformPlanarArray : public PhasedArrayModel
      */
     void SetPolSlant(double polSlant);
 
+    /**
+     * \brief Get the polarization slant angle
+     * \return the polarization slant angle in radians
+     */
+    double GetPolSlant() const;
+
     /**
      * Set the horizontal spacing for the antenna elements of the phased array
      * This method resets the stored beamforming vector to a ComplexVector
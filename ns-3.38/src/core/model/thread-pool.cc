@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thread-pool.h"
+
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ThreadPool implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ThreadPool");
+
+ThreadPool::ThreadPool(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    NS_ASSERT_MSG(numThreads > 0, "At least the calling thread is needed");
+    for (uint32_t part = 1; part < numThreads; ++part)
+    {
+        m_workers.emplace_back(&ThreadPool::Work, this, part);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    NS_LOG_FUNCTION(this);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+uint32_t
+ThreadPool::GetNThreads() const
+{
+    return m_workers.size() + 1;
+}
+
+void
+ThreadPool::ParallelFor(uint32_t n, const RangeFunction& function)
+{
+    if (m_workers.empty() || n < 2)
+    {
+        function(0, n);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        NS_ASSERT_MSG(m_pending == 0, "ParallelFor is not reentrant");
+        m_function = &function;
+        m_size = n;
+        m_pending = m_workers.size();
+        ++m_generation;
+    }
+    m_startCv.notify_all();
+    RunPart(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this]() { return m_pending == 0; });
+    m_function = nullptr;
+}
+
+void
+ThreadPool::Work(uint32_t part)
+{
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_startCv.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+        if (m_stop)
+        {
+            return;
+        }
+        generation = m_generation;
+        lock.unlock();
+        RunPart(part);
+        lock.lock();
+        if (--m_pending == 0)
+        {
+            m_doneCv.notify_one();
+        }
+    }
+}
+
+void
+ThreadPool::RunPart(uint32_t part) const
+{
+    uint64_t numParts = m_workers.size() + 1;
+    uint32_t begin = uint64_t(m_size) * part / numParts;
+    uint32_t end = uint64_t(m_size) * (part + 1) / numParts;
+    if (begin < end)
+    {
+        (*m_function)(begin, end);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ThreadPool declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup core
+ * \brief A fixed set of worker threads to split a loop of independent
+ * iterations.
+ *
+ * The workers are started once and wait between two calls of ParallelFor, so
+ * that a loop can be split cheaply even if it is run in every event. The
+ * range of a call is always split into the same contiguous parts, and the
+ * calling thread processes the first one. ParallelFor returns when all parts
+ * are processed.
+ *
+ * The iterations may read the simulation time, but must not otherwise touch
+ * the simulator, nor share reference counted objects: the reference counts of
+ * ns3::Ptr are not atomic. They should work on plain values, or on objects
+ * which the calling thread prepared for one iteration or one part alone.
+ */
+class ThreadPool
+{
+  public:
+    /**
+     * Function processing the iterations [begin, end)
+     */
+    typedef std::function<void(uint32_t begin, uint32_t end)> RangeFunction;
+
+    /**
+     * Constructor
+     * \param numThreads the number of threads including the calling one
+     */
+    explicit ThreadPool(uint32_t numThreads);
+
+    /** Destructor, stops and joins the workers. */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \return the number of threads including the calling one
+     */
+    uint32_t GetNThreads() const;
+
+    /**
+     * Process the iterations [0, n) in parallel and wait for them.
+     * \param n the number of iterations
+     * \param function the function processing a part of the iterations
+     */
+    void ParallelFor(uint32_t n, const RangeFunction& function);
+
+  private:
+    /**
+     * Main loop of a worker
+     * \param part the part of the range processed by this worker
+     */
+    void Work(uint32_t part);
+
+    /**
+     * Process one part of the current range
+     * \param part the index of the part
+     */
+    void RunPart(uint32_t part) const;
+
+    std::vector<std::thread> m_workers;     //!< the worker threads
+    std::mutex m_mutex;                     //!< protects the members below
+    std::condition_variable m_startCv;      //!< signals a new range to the workers
+    std::condition_variable m_doneCv;       //!< signals the end of the last part
+    const RangeFunction* m_function{nullptr}; //!< function of the current range
+    uint32_t m_size{0};                     //!< size of the current range
+    uint64_t m_generation{0};               //!< number of ranges started
+    uint32_t m_pending{0};                  //!< parts not yet processed by the workers
+    bool m_stop{false};                     //!< true if the workers have to stop
+};
+
+} // namespace ns3
+
+#endif /* THREAD_POOL_H */
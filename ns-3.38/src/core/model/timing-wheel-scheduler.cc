@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timing-wheel-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TimingWheelScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(TimingWheelScheduler);
+
+TypeId
+TimingWheelScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TimingWheelScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<TimingWheelScheduler>()
+            .AddAttribute("Granularity",
+                          "The duration of a bucket of the first wheel. The slot duration "
+                          "of the smallest numerology of slotted models, like NR, puts "
+                          "their periodic events into a few buckets.",
+                          TimeValue(MicroSeconds(125)),
+                          MakeTimeAccessor(&TimingWheelScheduler::SetGranularity),
+                          MakeTimeChecker(TimeStep(1)));
+    return tid;
+}
+
+TimingWheelScheduler::TimingWheelScheduler()
+    : m_granularity(MicroSeconds(125).GetTimeStep()),
+      m_currentSlot(0),
+      m_currentBlock(0),
+      m_currentHead(0),
+      m_level0Bitmap{},
+      m_level1Bitmap{},
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TimingWheelScheduler::~TimingWheelScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TimingWheelScheduler::SetGranularity(Time granularity)
+{
+    NS_LOG_FUNCTION(this << granularity);
+    NS_ASSERT_MSG(m_size == 0, "The granularity can only be set while the scheduler is empty");
+    m_granularity = granularity.GetTimeStep();
+    m_currentSlot = 0;
+    m_currentBlock = 0;
+}
+
+uint32_t
+TimingWheelScheduler::FindNonEmpty(const uint64_t* bitmap, uint32_t from, uint32_t size)
+{
+    for (uint32_t word = from / 64; word < size / 64; ++word)
+    {
+        uint64_t bits = bitmap[word];
+        if (word == from / 64)
+        {
+            bits &= ~uint64_t(0) << (from % 64);
+        }
+        if (bits != 0)
+        {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+    return size;
+}
+
+const Scheduler::Event&
+TimingWheelScheduler::FindEarliest(const Bucket& bucket)
+{
+    return *std::min_element(bucket.begin(), bucket.end());
+}
+
+bool
+TimingWheelScheduler::RemoveFromBucket(Bucket& bucket, const Scheduler::Event& ev)
+{
+    for (auto it = bucket.begin(); it != bucket.end(); ++it)
+    {
+        if (it->key.m_uid == ev.key.m_uid)
+        {
+            NS_ASSERT(it->impl == ev.impl);
+            *it = bucket.back();
+            bucket.pop_back();
+            return bucket.empty();
+        }
+    }
+    NS_ASSERT_MSG(false, "Event not found");
+    return false;
+}
+
+void
+TimingWheelScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    DoInsert(ev);
+    m_size++;
+}
+
+void
+TimingWheelScheduler::DoInsert(const Scheduler::Event& ev)
+{
+    // an event before the current slot can only come from a peek beyond the
+    // current time; it belongs to the current slot, which is ordered
+    uint64_t slot = std::max(ev.key.m_ts / m_granularity, m_currentSlot);
+    uint64_t block = slot / LEVEL0_BUCKETS;
+    if (slot == m_currentSlot)
+    {
+        auto it = std::upper_bound(m_current.begin() + m_currentHead, m_current.end(), ev);
+        m_current.insert(it, ev);
+    }
+    else if (block == m_currentBlock)
+    {
+        uint32_t index = slot % LEVEL0_BUCKETS;
+        m_level0[index].push_back(ev);
+        m_level0Bitmap[index / 64] |= uint64_t(1) << (index % 64);
+    }
+    else if (block < m_currentBlock + LEVEL1_BUCKETS)
+    {
+        uint32_t index = block % LEVEL1_BUCKETS;
+        m_level1[index].push_back(ev);
+        m_level1Bitmap[index / 64] |= uint64_t(1) << (index % 64);
+    }
+    else
+    {
+        m_far.insert(std::make_pair(ev.key, ev.impl));
+    }
+}
+
+bool
+TimingWheelScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_size == 0;
+}
+
+Scheduler::Event
+TimingWheelScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    if (m_currentHead < m_current.size())
+    {
+        return m_current[m_currentHead];
+    }
+    uint32_t index = FindNonEmpty(m_level0Bitmap,
+                                  m_currentSlot % LEVEL0_BUCKETS,
+                                  LEVEL0_BUCKETS);
+    if (index < LEVEL0_BUCKETS)
+    {
+        return FindEarliest(m_level0[index]);
+    }
+    for (uint64_t block = m_currentBlock + 1; block < m_currentBlock + LEVEL1_BUCKETS; ++block)
+    {
+        const Bucket& bucket = m_level1[block % LEVEL1_BUCKETS];
+        if (!bucket.empty())
+        {
+            return FindEarliest(bucket);
+        }
+    }
+    Scheduler::Event ev;
+    ev.impl = m_far.begin()->second;
+    ev.key = m_far.begin()->first;
+    return ev;
+}
+
+void
+TimingWheelScheduler::RefillFromFar()
+{
+    while (!m_far.empty() && m_far.begin()->first.m_ts / m_granularity / LEVEL0_BUCKETS <
+                                 m_currentBlock + LEVEL1_BUCKETS)
+    {
+        Scheduler::Event ev;
+        ev.impl = m_far.begin()->second;
+        ev.key = m_far.begin()->first;
+        m_far.erase(m_far.begin());
+        DoInsert(ev);
+    }
+}
+
+void
+TimingWheelScheduler::Advance()
+{
+    NS_LOG_FUNCTION(this);
+    while (m_currentHead == m_current.size() && m_size > 0)
+    {
+        uint32_t index = FindNonEmpty(m_level0Bitmap,
+                                      m_currentSlot % LEVEL0_BUCKETS,
+                                      LEVEL0_BUCKETS);
+        if (index < LEVEL0_BUCKETS)
+        {
+            // the bucket becomes the current one, and keeps the storage of the old one
+            m_current.clear();
+            m_current.swap(m_level0[index]);
+            m_level0Bitmap[index / 64] &= ~(uint64_t(1) << (index % 64));
+            std::sort(m_current.begin(), m_current.end());
+            m_currentHead = 0;
+            m_currentSlot = m_currentBlock * LEVEL0_BUCKETS + index;
+            return;
+        }
+
+        // the first wheel is empty: move to the next non-empty block
+        uint64_t next = m_currentBlock + LEVEL1_BUCKETS;
+        uint32_t from = (m_currentBlock + 1) % LEVEL1_BUCKETS;
+        uint32_t found = FindNonEmpty(m_level1Bitmap, from, LEVEL1_BUCKETS);
+        if (found < LEVEL1_BUCKETS)
+        {
+            next = m_currentBlock + 1 + (found - from);
+        }
+        else
+        {
+            found = FindNonEmpty(m_level1Bitmap, 0, LEVEL1_BUCKETS);
+            if (found < from)
+            {
+                next = m_currentBlock + 1 + (LEVEL1_BUCKETS - from) + found;
+            }
+        }
+        if (next == m_currentBlock + LEVEL1_BUCKETS)
+        {
+            // both wheels are empty: jump to the first event of the map
+            NS_ASSERT(!m_far.empty());
+            next = m_far.begin()->first.m_ts / m_granularity / LEVEL0_BUCKETS;
+        }
+
+        m_currentBlock = next;
+        m_currentSlot = m_currentBlock * LEVEL0_BUCKETS;
+        // spread the bucket of the block over the first wheel
+        uint32_t blockIndex = m_currentBlock % LEVEL1_BUCKETS;
+        Bucket& bucket = m_level1[blockIndex];
+        m_level1Bitmap[blockIndex / 64] &= ~(uint64_t(1) << (blockIndex % 64));
+        for (const auto& ev : bucket)
+        {
+            DoInsert(ev);
+        }
+        bucket.clear();
+        RefillFromFar();
+    }
+}
+
+Scheduler::Event
+TimingWheelScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    Advance();
+    Scheduler::Event ev = m_current[m_currentHead];
+    m_currentHead++;
+    m_size--;
+    if (m_currentHead == m_current.size())
+    {
+        m_current.clear();
+        m_currentHead = 0;
+    }
+    NS_LOG_DEBUG("remove " << ev.impl << " at " << ev.key.m_ts);
+    return ev;
+}
+
+void
+TimingWheelScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    // the event is where DoInsert would put it now
+    uint64_t slot = std::max(ev.key.m_ts / m_granularity, m_currentSlot);
+    uint64_t block = slot / LEVEL0_BUCKETS;
+    if (slot == m_currentSlot)
+    {
+        auto it = std::lower_bound(m_current.begin() + m_currentHead, m_current.end(), ev);
+        NS_ASSERT(it != m_current.end() && it->key.m_uid == ev.key.m_uid);
+        m_current.erase(it);
+    }
+    else if (block == m_currentBlock)
+    {
+        uint32_t index = slot % LEVEL0_BUCKETS;
+        if (RemoveFromBucket(m_level0[index], ev))
+        {
+            m_level0Bitmap[index / 64] &= ~(uint64_t(1) << (index % 64));
+        }
+    }
+    else if (block < m_currentBlock + LEVEL1_BUCKETS)
+    {
+        uint32_t index = block % LEVEL1_BUCKETS;
+        if (RemoveFromBucket(m_level1[index], ev))
+        {
+            m_level1Bitmap[index / 64] &= ~(uint64_t(1) << (index % 64));
+        }
+    }
+    else
+    {
+        auto it = m_far.find(ev.key);
+        NS_ASSERT(it != m_far.end() && it->second == ev.impl);
+        m_far.erase(it);
+    }
+    m_size--;
+}
+
+} // namespace ns3
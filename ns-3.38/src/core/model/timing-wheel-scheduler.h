@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMING_WHEEL_SCHEDULER_H
+#define TIMING_WHEEL_SCHEDULER_H
+
+#include "nstime.h"
+#include "scheduler.h"
+
+#include <array>
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::TimingWheelScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a hierarchical timing wheel event scheduler
+ *
+ * Slotted models, like the NR PHY and MAC, schedule most of their events on
+ * a few offsets of the next slots. This scheduler puts the events into
+ * buckets of the duration of a slot (the Granularity attribute) instead of
+ * ordering them all:
+ *
+ * - the first wheel has 256 buckets of one slot, covering the block of 256
+ *   slots of the current time;
+ * - the second wheel has 64 buckets of 256 slots, covering the next blocks;
+ * - the events beyond the second wheel, or the irregular ones far in the
+ *   future, are kept ordered in a std::map.
+ *
+ * The events of a bucket are not ordered. When the simulation reaches a
+ * bucket, its events are sorted into the current bucket, from which they are
+ * removed in order. Inserting an event into the current slot inserts it
+ * into the sorted events. When the first wheel is empty, the next non-empty
+ * bucket of the second wheel is spread over the first wheel, and the map
+ * fills the second wheel. Bitmaps of the non-empty buckets skip the empty
+ * ones.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Constant        | Append to a bucket, or map insert beyond the wheels
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Linear in the next bucket | Search the next bucket
+ * Remove()     | Linear in the bucket | Search the bucket
+ * RemoveNext() | Logarithmic in the bucket | Sort of the bucket when reached
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 321 x `std::vector` + `std::map`<br/>(7.8 kbytes) | Buckets
+ * Per Event | 0                                | `std::vector`
+ */
+class TimingWheelScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    TimingWheelScheduler();
+    /** Destructor. */
+    ~TimingWheelScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Number of buckets of the first wheel. */
+    static constexpr uint32_t LEVEL0_BUCKETS = 256;
+    /** Number of buckets of the second wheel. */
+    static constexpr uint32_t LEVEL1_BUCKETS = 64;
+
+    /** A bucket: the events of a time span, not ordered. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /**
+     * Set the duration of the buckets of the first wheel.
+     * This can only be used while the scheduler is empty, as invoked by
+     * the Attribute Granularity.
+     * \param [in] granularity The duration of a bucket.
+     */
+    void SetGranularity(Time granularity);
+
+    /**
+     * Find the container of an event, and insert it there.
+     * \param [in] ev The event.
+     */
+    void DoInsert(const Scheduler::Event& ev);
+
+    /**
+     * Make the current bucket hold the next events, unless the scheduler is
+     * empty.
+     */
+    void Advance();
+
+    /**
+     * Move the events of the map which are now within the second wheel.
+     */
+    void RefillFromFar();
+
+    /**
+     * Find the first non-empty bucket of a wheel.
+     * \param [in] bitmap The bitmap of the non-empty buckets of the wheel.
+     * \param [in] from The first bucket to look at.
+     * \param [in] size The number of buckets of the wheel.
+     * \return The index of the bucket, or size if they are all empty from
+     * the first bucket to the end of the wheel.
+     */
+    static uint32_t FindNonEmpty(const uint64_t* bitmap, uint32_t from, uint32_t size);
+
+    /**
+     * Find the earliest event of a bucket.
+     * \param [in] bucket The bucket, not empty.
+     * \return The earliest event.
+     */
+    static const Scheduler::Event& FindEarliest(const Bucket& bucket);
+
+    /**
+     * Remove an event from a bucket.
+     * \param [in] bucket The bucket.
+     * \param [in] ev The event.
+     * \return true if the bucket is empty afterwards.
+     */
+    static bool RemoveFromBucket(Bucket& bucket, const Scheduler::Event& ev);
+
+    /** Duration of a bucket of the first wheel, in dimensionless time units. */
+    uint64_t m_granularity;
+    /** The slot of the current bucket: timestamp / m_granularity. */
+    uint64_t m_currentSlot;
+    /** The block of 256 slots of the first wheel: slot / 256. */
+    uint64_t m_currentBlock;
+
+    /** The events of the current slot, ordered. */
+    Bucket m_current;
+    /** The first event of m_current not removed yet. */
+    std::size_t m_currentHead;
+
+    /** The first wheel, one bucket per slot of the current block. */
+    std::array<Bucket, LEVEL0_BUCKETS> m_level0;
+    /** Bitmap of the non-empty buckets of m_level0. */
+    uint64_t m_level0Bitmap[LEVEL0_BUCKETS / 64];
+    /** The second wheel, one bucket per block, indexed by block % 64. */
+    std::array<Bucket, LEVEL1_BUCKETS> m_level1;
+    /** Bitmap of the non-empty buckets of m_level1. */
+    uint64_t m_level1Bitmap[LEVEL1_BUCKETS / 64];
+    /** The events beyond the second wheel. */
+    std::map<Scheduler::EventKey, EventImpl*> m_far;
+
+    /** Number of events in the scheduler. */
+    uint64_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* TIMING_WHEEL_SCHEDULER_H */
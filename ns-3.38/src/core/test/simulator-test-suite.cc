@@ -23,6 +23,7 @@
 #include "ns3/priority-queue-scheduler.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/timing-wheel-scheduler.h"
 
 using namespace ns3;
 
@@ -717,6 +718,100 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the TimingWheelScheduler removes the events in the order of the
+ * MapScheduler.
+ *
+ * The events are spread over the current slot, the first and the second wheel and
+ * beyond, and some of them are removed before they are reached.
+ */
+class TimingWheelSchedulerOrderTestCase : public TestCase
+{
+  public:
+    TimingWheelSchedulerOrderTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TimingWheelSchedulerOrderTestCase::TimingWheelSchedulerOrderTestCase()
+    : TestCase("Check that the TimingWheelScheduler orders the events like the MapScheduler")
+{
+}
+
+void
+TimingWheelSchedulerOrderTestCase::DoRun()
+{
+    Ptr<TimingWheelScheduler> wheel = CreateObject<TimingWheelScheduler>();
+    wheel->SetAttribute("Granularity", TimeValue(NanoSeconds(1000)));
+    Ptr<MapScheduler> map = CreateObject<MapScheduler>();
+
+    // an LCG, to not depend on the random number streams
+    uint64_t state = 1;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state >> 33;
+    };
+    // the span of the current slot, of a bucket of each wheel, and beyond
+    const uint64_t spans[] = {1000, 256 * 1000, 64 * 256 * 1000, 10 * 64 * 256 * 1000};
+
+    uint64_t now = 0;
+    uint32_t uid = 0;
+    std::vector<Scheduler::Event> pending;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        uint64_t op = next() % 10;
+        if (op < 5 || pending.empty())
+        {
+            Scheduler::Event ev;
+            ev.impl = nullptr;
+            ev.key.m_ts = now + next() % spans[next() % 4];
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            wheel->Insert(ev);
+            map->Insert(ev);
+            pending.push_back(ev);
+        }
+        else if (op < 8)
+        {
+            Scheduler::Event expected = map->RemoveNext();
+            Scheduler::Event ev = wheel->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid, expected.key.m_uid, "Wrong event order");
+            now = expected.key.m_ts;
+            for (auto& p : pending)
+            {
+                if (p.key.m_uid == expected.key.m_uid)
+                {
+                    p = pending.back();
+                    pending.pop_back();
+                    break;
+                }
+            }
+        }
+        else
+        {
+            std::size_t index = next() % pending.size();
+            wheel->Remove(pending[index]);
+            map->Remove(pending[index]);
+            pending[index] = pending.back();
+            pending.pop_back();
+        }
+        NS_TEST_ASSERT_MSG_EQ(wheel->IsEmpty(), map->IsEmpty(), "Wrong number of events");
+    }
+    while (!map->IsEmpty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(wheel->PeekNext().key.m_uid,
+                              map->PeekNext().key.m_uid,
+                              "Wrong next event");
+        NS_TEST_ASSERT_MSG_EQ(wheel->RemoveNext().key.m_uid,
+                              map->RemoveNext().key.m_uid,
+                              "Wrong event order");
+    }
+    NS_TEST_ASSERT_MSG_EQ(wheel->IsEmpty(), true, "The scheduler should be empty");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -740,6 +835,9 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(TimingWheelScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new TimingWheelSchedulerOrderTestCase(), TestCase::QUICK);
     }
 };
 
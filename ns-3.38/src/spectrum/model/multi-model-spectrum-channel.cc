@@ -19,6 +19,7 @@
 
 #include "multi-model-spectrum-channel.h"
 
+#include <ns3/abort.h>
 #include <ns3/angles.h>
 #include <ns3/antenna-model.h>
 #include <ns3/double.h>
@@ -37,7 +38,9 @@
 #include <ns3/spectrum-propagation-loss-model.h>
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <utility>
 
 namespace ns3
@@ -80,7 +83,10 @@ RxSpectrumModelInfo::RxSpectrumModelInfo(Ptr<const SpectrumModel> rxSpectrumMode
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel()
-    : m_numDevices{0}
+    : m_numDevices{0},
+      m_maxRxDistance{std::numeric_limits<double>::infinity()},
+      m_rxPowerFloorDbm{-std::numeric_limits<double>::infinity()},
+      m_rxPhyGridsValid{false}
 {
     NS_LOG_FUNCTION(this);
 }
@@ -91,6 +97,14 @@ MultiModelSpectrumChannel::DoDispose()
     NS_LOG_FUNCTION(this);
     m_txSpectrumModelInfoMap.clear();
     m_rxSpectrumModelInfoMap.clear();
+    for (const auto& mobility : m_trackedMobility)
+    {
+        mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&MultiModelSpectrumChannel::RxCourseChange, this));
+    }
+    m_trackedMobility.clear();
+    m_rxPhyGrids.clear();
     SpectrumChannel::DoDispose();
 }
 
@@ -101,11 +115,137 @@ MultiModelSpectrumChannel::GetTypeId()
                             .SetParent<SpectrumChannel>()
                             .SetGroupName("Spectrum")
                             .AddConstructor<MultiModelSpectrumChannel>()
-
-        ;
+                            .AddAttribute("MaxRxDistance",
+                                          "Maximum distance in m between transmitter and "
+                                          "receiver. Receivers further away do not get the "
+                                          "signal. The receivers are indexed in a grid of this "
+                                          "cell size, so that far away receivers are not "
+                                          "visited at all. Infinite disables the check. Must be "
+                                          "positive.",
+                                          DoubleValue(std::numeric_limits<double>::infinity()),
+                                          MakeDoubleAccessor(
+                                              &MultiModelSpectrumChannel::SetMaxRxDistance),
+                                          MakeDoubleChecker<double>(
+                                              std::numeric_limits<double>::min(),
+                                              std::numeric_limits<double>::infinity()))
+                            .AddAttribute("RxPowerFloorDbm",
+                                          "Minimum received power in dBm, after the "
+                                          "PropagationLossModel and the antenna gains, but "
+                                          "before the SpectrumPropagationLossModel. Receivers "
+                                          "with a lower power do not get the signal, and "
+                                          "signals without power in the band of a receiver "
+                                          "spectrum model are not delivered to any receiver of "
+                                          "this model. Minus infinity disables the check.",
+                                          DoubleValue(-std::numeric_limits<double>::infinity()),
+                                          MakeDoubleAccessor(
+                                              &MultiModelSpectrumChannel::m_rxPowerFloorDbm),
+                                          MakeDoubleChecker<double>(
+                                              -std::numeric_limits<double>::infinity()));
     return tid;
 }
 
+void
+MultiModelSpectrumChannel::SetMaxRxDistance(double distance)
+{
+    NS_LOG_FUNCTION(this << distance);
+    // the distance is the cell size of the receiver grid
+    NS_ABORT_MSG_IF(!(distance > 0), "MaxRxDistance must be positive, not " << distance);
+    m_maxRxDistance = distance;
+    m_rxPhyGridsValid = false;
+}
+
+void
+MultiModelSpectrumChannel::RxCourseChange([[maybe_unused]] Ptr<const MobilityModel> mobility)
+{
+    m_rxPhyGridsValid = false;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetGridCellKey(int64_t x, int64_t y) const
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+int64_t
+MultiModelSpectrumChannel::GetGridCell(double coordinate) const
+{
+    // clamping keeps neighbouring cells adjacent, and the candidates are checked against
+    // the distance anyway
+    double cell = std::floor(coordinate / m_maxRxDistance);
+    return static_cast<int64_t>(std::clamp<double>(cell,
+                                                   std::numeric_limits<int32_t>::min(),
+                                                   std::numeric_limits<int32_t>::max()));
+}
+
+void
+MultiModelSpectrumChannel::UpdateRxPhyGrids()
+{
+    NS_LOG_FUNCTION(this);
+    m_rxPhyGrids.clear();
+    for (const auto& [rxSpectrumModelUid, rxInfo] : m_rxSpectrumModelInfoMap)
+    {
+        RxSpectrumPhyGrid& grid = m_rxPhyGrids[rxSpectrumModelUid];
+        for (uint32_t i = 0; i < rxInfo.m_rxPhys.size(); ++i)
+        {
+            Ptr<MobilityModel> mobility = rxInfo.m_rxPhys[i]->GetMobility();
+            if (!mobility)
+            {
+                grid.m_unindexed.push_back(i);
+                continue;
+            }
+            if (m_trackedMobility.insert(mobility).second)
+            {
+                mobility->TraceConnectWithoutContext(
+                    "CourseChange",
+                    MakeCallback(&MultiModelSpectrumChannel::RxCourseChange, this));
+            }
+            Vector velocity = mobility->GetVelocity();
+            if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+            {
+                // the position changes without a course change
+                grid.m_unindexed.push_back(i);
+                continue;
+            }
+            Vector position = mobility->GetPosition();
+            int64_t x = GetGridCell(position.x);
+            int64_t y = GetGridCell(position.y);
+            grid.m_cells[GetGridCellKey(x, y)].push_back(i);
+        }
+    }
+    m_rxPhyGridsValid = true;
+}
+
+void
+MultiModelSpectrumChannel::GetRxCandidates(SpectrumModelUid_t rxSpectrumModelUid,
+                                           const Vector& txPosition,
+                                           std::vector<uint32_t>& candidates) const
+{
+    candidates.clear();
+    auto gridIt = m_rxPhyGrids.find(rxSpectrumModelUid);
+    if (gridIt == m_rxPhyGrids.end())
+    {
+        return;
+    }
+    const RxSpectrumPhyGrid& grid = gridIt->second;
+    candidates = grid.m_unindexed;
+    // a receiver outside the 3x3 cells around the transmitter is further away than one cell
+    int64_t txX = GetGridCell(txPosition.x);
+    int64_t txY = GetGridCell(txPosition.y);
+    for (int64_t x = txX - 1; x <= txX + 1; ++x)
+    {
+        for (int64_t y = txY - 1; y <= txY + 1; ++y)
+        {
+            auto cellIt = grid.m_cells.find(GetGridCellKey(x, y));
+            if (cellIt != grid.m_cells.end())
+            {
+                candidates.insert(candidates.end(), cellIt->second.begin(), cellIt->second.end());
+            }
+        }
+    }
+    // keep the order of m_rxPhys, so that the receptions are scheduled in the same order
+    std::sort(candidates.begin(), candidates.end());
+}
+
 void
 MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
 {
@@ -126,6 +266,7 @@ MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
         {
             rxInfoIterator->second.m_rxPhys.erase(phyIt);
             --m_numDevices;
+            m_rxPhyGridsValid = false;
             break; // there should be at most one entry
         }
     }
@@ -154,6 +295,7 @@ MultiModelSpectrumChannel::AddRx(Ptr<SpectrumPhy> phy)
     // rxInfoIterator points either to the newly inserted element or to the element that
     // prevented insertion. In both cases, add the phy to the element pointed to by rxInfoIterator
     rxInfoIterator->second.m_rxPhys.push_back(phy);
+    m_rxPhyGridsValid = false;
 
     if (inserted)
     {
@@ -256,6 +398,15 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
     NS_LOG_LOGIC("converter map first element: "
                  << txInfoIteratorerator->second.m_spectrumConverterMap.begin()->first);
 
+    bool distanceCulling = txMobility && std::isfinite(m_maxRxDistance);
+    bool powerCulling = m_rxPowerFloorDbm > -std::numeric_limits<double>::infinity();
+    if (distanceCulling && !m_rxPhyGridsValid)
+    {
+        UpdateRxPhyGrids();
+    }
+    Vector txPosition = distanceCulling ? txMobility->GetPosition() : Vector();
+    std::vector<uint32_t> candidates;
+
     for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
          rxInfoIterator != m_rxSpectrumModelInfoMap.end();
          ++rxInfoIterator)
@@ -283,10 +434,27 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
             convertedTxPowerSpectrum = rxConverterIterator->second.Convert(txParams->psd);
         }
 
-        for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin();
-             rxPhyIterator != rxInfoIterator->second.m_rxPhys.end();
-             ++rxPhyIterator)
+        double txPowerDbm = 0;
+        if (powerCulling)
+        {
+            double txPowerW = Integral(*convertedTxPowerSpectrum);
+            if (txPowerW <= 0)
+            {
+                NS_LOG_LOGIC("no power in the band of SpectrumModelUid " << rxSpectrumModelUid);
+                continue;
+            }
+            txPowerDbm = 10 * std::log10(txPowerW) + 30;
+        }
+
+        const std::vector<Ptr<SpectrumPhy>>& rxPhys = rxInfoIterator->second.m_rxPhys;
+        if (distanceCulling)
+        {
+            GetRxCandidates(rxSpectrumModelUid, txPosition, candidates);
+        }
+        std::size_t numRxPhys = distanceCulling ? candidates.size() : rxPhys.size();
+        for (std::size_t rxIndex = 0; rxIndex < numRxPhys; ++rxIndex)
         {
+            auto rxPhyIterator = rxPhys.begin() + (distanceCulling ? candidates[rxIndex] : rxIndex);
             NS_ASSERT_MSG((*rxPhyIterator)->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
                           "SpectrumModel change was not notified to MultiModelSpectrumChannel "
                           "(i.e., AddRx should be called again after model is changed)");
@@ -308,23 +476,27 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-                NS_LOG_LOGIC("copying signal parameters " << txParams);
-                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
-                rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
                 Time delay = MicroSeconds(0);
+                double pathGainLinear = 1;
 
                 Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility();
 
                 if (txMobility && receiverMobility)
                 {
+                    if (distanceCulling &&
+                        txMobility->GetDistanceFrom(receiverMobility) > m_maxRxDistance)
+                    {
+                        NS_LOG_LOGIC("receiver beyond MaxRxDistance");
+                        continue;
+                    }
                     double txAntennaGain = 0;
                     double rxAntennaGain = 0;
                     double propagationGainDb = 0;
                     double pathLossDb = 0;
-                    if (rxParams->txAntenna)
+                    if (txParams->txAntenna)
                     {
                         Angles txAngles(receiverMobility->GetPosition(), txMobility->GetPosition());
-                        txAntennaGain = rxParams->txAntenna->GetGainDb(txAngles);
+                        txAntennaGain = txParams->txAntenna->GetGainDb(txAngles);
                         NS_LOG_LOGIC("txAntennaGain = " << txAntennaGain << " dB");
                         pathLossDb -= txAntennaGain;
                     }
@@ -359,8 +531,12 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                         // beyond range
                         continue;
                     }
-                    double pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
-                    *(rxParams->psd) *= pathGainLinear;
+                    if (powerCulling && txPowerDbm - pathLossDb < m_rxPowerFloorDbm)
+                    {
+                        NS_LOG_LOGIC("rx power below RxPowerFloorDbm");
+                        continue;
+                    }
+                    pathGainLinear = std::pow(10.0, (-pathLossDb) / 10.0);
 
                     if (m_propagationDelay)
                     {
@@ -368,6 +544,15 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
+                // the parameters are only copied for the receivers which get the signal
+                NS_LOG_LOGIC("copying signal parameters " << txParams);
+                Ptr<SpectrumSignalParameters> rxParams = txParams->Copy();
+                rxParams->psd = Copy<SpectrumValue>(convertedTxPowerSpectrum);
+                if (txMobility && receiverMobility)
+                {
+                    *(rxParams->psd) *= pathGainLinear;
+                }
+
                 if (rxNetDevice)
                 {
                     // the receiver has a NetDevice, so we expect that it is attached to a Node
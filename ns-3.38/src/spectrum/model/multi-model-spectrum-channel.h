@@ -20,6 +20,7 @@
 #ifndef MULTI_MODEL_SPECTRUM_CHANNEL_H
 #define MULTI_MODEL_SPECTRUM_CHANNEL_H
 
+#include <ns3/mobility-model.h>
 #include <ns3/propagation-delay-model.h>
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-converter.h>
@@ -28,6 +29,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -86,6 +88,24 @@ class RxSpectrumModelInfo
  */
 typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap_t;
 
+/**
+ * \ingroup spectrum
+ * Uniform grid over the positions of the Rx Spectrum phy objects of one
+ * Rx spectrum model. The grid stores indices into RxSpectrumModelInfo::m_rxPhys.
+ */
+class RxSpectrumPhyGrid
+{
+  public:
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells; //!< static phys per grid cell
+    std::vector<uint32_t> m_unindexed; //!< phys without mobility or with a non-zero velocity
+};
+
+/**
+ * \ingroup spectrum
+ * Container: SpectrumModelUid_t, RxSpectrumPhyGrid
+ */
+typedef std::map<SpectrumModelUid_t, RxSpectrumPhyGrid> RxSpectrumPhyGridMap_t;
+
 /**
  * \ingroup spectrum
  *
@@ -144,6 +164,55 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      */
     virtual void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+    /**
+     * Set the maximum distance between transmitter and receiver and invalidate the
+     * receiver grid, whose cell size is this distance.
+     *
+     * \param distance the maximum distance in m, which must be positive
+     */
+    void SetMaxRxDistance(double distance);
+
+    /**
+     * Rebuild the receiver grids of all Rx spectrum models, and connect to the
+     * CourseChange trace of mobility models not seen before.
+     */
+    void UpdateRxPhyGrids();
+
+    /**
+     * Invalidate the receiver grids when a receiver moves.
+     *
+     * \param mobility the mobility model of the receiver
+     */
+    void RxCourseChange(Ptr<const MobilityModel> mobility);
+
+    /**
+     * Get the indices of the receivers of a Rx spectrum model which may be
+     * closer to the transmitter than the maximum distance, in increasing order.
+     *
+     * \param rxSpectrumModelUid the Rx spectrum model
+     * \param txPosition the position of the transmitter
+     * \param [out] candidates the indices into RxSpectrumModelInfo::m_rxPhys
+     */
+    void GetRxCandidates(SpectrumModelUid_t rxSpectrumModelUid,
+                         const Vector& txPosition,
+                         std::vector<uint32_t>& candidates) const;
+
+    /**
+     * \param x the x coordinate in m
+     * \param y the y coordinate in m
+     * \return the key of the grid cell containing (x, y)
+     */
+    uint64_t GetGridCellKey(int64_t x, int64_t y) const;
+
+    /**
+     * The index is clamped to the 32 bits of the cell key, so that coordinates far
+     * away from the origin share the outermost cell instead of overflowing.
+     *
+     * \param coordinate the x or y coordinate in m
+     * \return the grid cell index of the coordinate
+     */
+    int64_t GetGridCell(double coordinate) const;
+
     /**
      * Data structure holding, for each TX SpectrumModel,  all the
      * converters to any RX SpectrumModel, and all the corresponding
@@ -162,6 +231,12 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * Number of devices connected to the channel.
      */
     std::size_t m_numDevices;
+
+    double m_maxRxDistance;    //!< receivers further away are skipped (infinite: disabled)
+    double m_rxPowerFloorDbm;  //!< receivers with a lower Rx power are skipped
+    RxSpectrumPhyGridMap_t m_rxPhyGrids; //!< receiver grids used for the distance culling
+    bool m_rxPhyGridsValid;    //!< false if the grids have to be rebuilt
+    std::set<Ptr<MobilityModel>> m_trackedMobility; //!< mobility models connected to RxCourseChange
 };
 
 } // namespace ns3
@@ -22,16 +22,20 @@
 #include "three-gpp-channel-model.h"
 
 #include "ns3/double.h"
+#include "ns3/hash.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/string.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <random>
 
 namespace ns3
@@ -245,6 +249,9 @@ static const double sqrtC_office_NLOS[6][6] = {
 };
 
 ThreeGppChannelModel::ThreeGppChannelModel()
+    : m_staticNodes(false),
+      m_staticChannelsLoaded(false),
+      m_staticChannelsDirty(false)
 {
     NS_LOG_FUNCTION(this);
     m_uniformRv = CreateObject<UniformRandomVariable>();
@@ -269,8 +276,13 @@ ThreeGppChannelModel::DoDispose()
     {
         m_channelConditionModel->Dispose();
     }
+    if (m_staticChannelsDirty && !m_staticChannelCacheFile.empty())
+    {
+        SaveStaticChannels();
+    }
     m_channelMatrixMap.clear();
     m_channelParamsMap.clear();
+    m_staticChannels.clear();
     m_channelConditionModel = nullptr;
 }
 
@@ -306,6 +318,26 @@ ThreeGppChannelModel::GetTypeId()
                           TimeValue(MilliSeconds(0)),
                           MakeTimeAccessor(&ThreeGppChannelModel::m_updatePeriod),
                           MakeTimeChecker())
+            .AddAttribute("StaticNodes",
+                          "If true, the channel of a pair of nodes without velocity is generated "
+                          "once and never updated, neither after the UpdatePeriod nor when the "
+                          "channel condition changes. The random variates of the skipped "
+                          "updates are not drawn, so the channels of the other pairs may differ "
+                          "from the ones obtained with false for the same seed and run.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&ThreeGppChannelModel::m_staticNodes),
+                          MakeBooleanChecker())
+            .AddAttribute("StaticChannelCacheFile",
+                          "File in which the channels of static node pairs are stored at the end "
+                          "of the simulation, and from which they are read in the next run of "
+                          "the same scenario, seed and run number. Empty disables the file. "
+                          "Only used if StaticNodes is true. A channel read from the file does "
+                          "not draw the random variates of its generation, so the channels "
+                          "generated afterwards for the other pairs may differ between the run "
+                          "which writes the file and the runs which read it.",
+                          StringValue(""),
+                          MakeStringAccessor(&ThreeGppChannelModel::m_staticChannelCacheFile),
+                          MakeStringChecker())
             // attributes for the blockage model
             .AddAttribute("Blockage",
                           "Enable blockage model A (sec 7.6.4.1)",
@@ -1109,9 +1141,29 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     // Compute the channel matrix key. The key is reciprocal, i.e., key (a, b) = key (b, a)
     uint64_t channelMatrixKey = GetKey(aAntenna->GetId(), bAntenna->GetId());
 
-    // retrieve the channel condition
-    Ptr<const ChannelCondition> condition =
-        m_channelConditionModel->GetChannelCondition(aMob, bMob);
+    // the channel of static nodes is generated once, or read from the cache file
+    bool staticPair =
+        m_staticNodes && aMob->GetVelocity() == Vector() && bMob->GetVelocity() == Vector();
+    uint64_t fingerprint = 0;
+    if (staticPair)
+    {
+        if (!m_staticChannelsLoaded)
+        {
+            LoadStaticChannels();
+        }
+        fingerprint = GetStaticChannelFingerprint(aMob, bMob, aAntenna, bAntenna);
+        const StaticChannel* staticChannel = FindStaticChannel(fingerprint);
+        if (staticChannel)
+        {
+            NS_LOG_DEBUG("static channel found");
+            if (m_channelParamsMap.find(channelParamsKey) == m_channelParamsMap.end())
+            {
+                m_channelParamsMap[channelParamsKey] = staticChannel->m_params;
+            }
+            m_channelMatrixMap[channelMatrixKey] = staticChannel->m_matrix;
+            return staticChannel->m_matrix;
+        }
+    }
 
     // Check if the channel is present in the map and return it, otherwise
     // generate a new channel
@@ -1121,12 +1173,11 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     bool notFoundMatrix = false;
     Ptr<ChannelMatrix> channelMatrix;
     Ptr<ThreeGppChannelParams> channelParams;
+    Ptr<const ChannelCondition> condition;
 
     if (m_channelParamsMap.find(channelParamsKey) != m_channelParamsMap.end())
     {
         channelParams = m_channelParamsMap[channelParamsKey];
-        // check if it has to be updated
-        updateParams = ChannelParamsNeedsUpdate(channelParams, condition);
     }
     else
     {
@@ -1134,6 +1185,23 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         notFoundParams = true;
     }
 
+    if (staticPair && channelParams)
+    {
+        // the parameters of a static pair are kept, e.g. for a further antenna pair
+        condition =
+            Create<ChannelCondition>(channelParams->m_losCondition, channelParams->m_o2iCondition);
+    }
+    else
+    {
+        // retrieve the channel condition
+        condition = m_channelConditionModel->GetChannelCondition(aMob, bMob);
+        if (channelParams)
+        {
+            // check if it has to be updated
+            updateParams = ChannelParamsNeedsUpdate(channelParams, condition);
+        }
+    }
+
     double x = aMob->GetPosition().x - bMob->GetPosition().x;
     double y = aMob->GetPosition().y - bMob->GetPosition().y;
     double distance2D = sqrt(x * x + y * y);
@@ -1189,9 +1257,566 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         m_channelMatrixMap[channelMatrixKey] = channelMatrix;
     }
 
+    if (staticPair)
+    {
+        StoreStaticChannel({fingerprint, channelParams, channelMatrix});
+    }
+
     return channelMatrix;
 }
 
+std::size_t
+ThreeGppChannelModel::GetNStaticChannels() const
+{
+    return m_staticChannels.size();
+}
+
+namespace
+{
+
+/**
+ * Append the type and the attributes of an object to a key, including the
+ * attributes of the objects it points to
+ * \param key the key
+ * \param object the object
+ */
+void
+AppendAttributes(std::ostream& key, Ptr<const Object> object)
+{
+    TypeId tid = object->GetInstanceTypeId();
+    key << tid.GetName() << "{";
+    for (TypeId t = tid;; t = t.GetParent())
+    {
+        for (uint32_t i = 0; i < t.GetAttributeN(); ++i)
+        {
+            TypeId::AttributeInformation info = t.GetAttribute(i);
+            if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter())
+            {
+                continue;
+            }
+            Ptr<AttributeValue> value = info.checker->Create();
+            object->GetAttribute(info.name, *value);
+            key << info.name << "=";
+            if (Ptr<PointerValue> pointer = DynamicCast<PointerValue>(value))
+            {
+                Ptr<Object> inner = pointer->GetObject();
+                if (inner)
+                {
+                    AppendAttributes(key, inner);
+                }
+            }
+            else if (Ptr<DoubleValue> number = DynamicCast<DoubleValue>(value))
+            {
+                // the string of a DoubleValue is rounded
+                key << number->Get();
+            }
+            else
+            {
+                key << value->SerializeToString(info.checker);
+            }
+            key << ",";
+        }
+        if (!t.HasParent())
+        {
+            break;
+        }
+    }
+    key << "}";
+}
+
+} // namespace
+
+uint64_t
+ThreeGppChannelModel::GetStaticChannelFingerprint(Ptr<const MobilityModel> aMob,
+                                                  Ptr<const MobilityModel> bMob,
+                                                  Ptr<const PhasedArrayModel> aAntenna,
+                                                  Ptr<const PhasedArrayModel> bAntenna)
+{
+    uint32_t aId = aMob->GetObject<Node>()->GetId();
+    uint32_t bId = bMob->GetObject<Node>()->GetId();
+    if (bId < aId)
+    {
+        std::swap(aMob, bMob);
+        std::swap(aAntenna, bAntenna);
+        std::swap(aId, bId);
+    }
+    std::ostringstream key;
+    key.precision(17);
+    key << aId << "," << aMob->GetPosition() << "," << aAntenna->GetId() << ",";
+    AppendAttributes(key, aAntenna);
+    key << ";" << bId << "," << bMob->GetPosition() << "," << bAntenna->GetId() << ",";
+    AppendAttributes(key, bAntenna);
+    return Hash64(key.str());
+}
+
+uint64_t
+ThreeGppChannelModel::GetStaticChannelScenarioHash() const
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << m_scenario << "," << m_frequency << ","
+        << m_channelConditionModel->GetInstanceTypeId().GetName() << ","
+        << RngSeedManager::GetSeed() << ","
+        << RngSeedManager::GetRun() << "," << m_uniformRv->GetStream() << ","
+        << m_uniformRvShuffle->GetStream() << "," << m_uniformRvDoppler->GetStream() << ","
+        << m_normalRv->GetStream() << "," << m_blockage << "," << m_numNonSelfBlocking << ","
+        << m_portraitMode << "," << m_blockerSpeed << "," << m_vScatt;
+    return Hash64(key.str());
+}
+
+const ThreeGppChannelModel::StaticChannel*
+ThreeGppChannelModel::FindStaticChannel(uint64_t fingerprint) const
+{
+    auto it = std::lower_bound(m_staticChannels.begin(),
+                               m_staticChannels.end(),
+                               fingerprint,
+                               [](const StaticChannel& channel, uint64_t value) {
+                                   return channel.m_fingerprint < value;
+                               });
+    if (it != m_staticChannels.end() && it->m_fingerprint == fingerprint)
+    {
+        return &(*it);
+    }
+    return nullptr;
+}
+
+void
+ThreeGppChannelModel::StoreStaticChannel(const StaticChannel& channel)
+{
+    auto it = std::lower_bound(m_staticChannels.begin(),
+                               m_staticChannels.end(),
+                               channel.m_fingerprint,
+                               [](const StaticChannel& other, uint64_t value) {
+                                   return other.m_fingerprint < value;
+                               });
+    if (it != m_staticChannels.end() && it->m_fingerprint == channel.m_fingerprint)
+    {
+        *it = channel;
+    }
+    else
+    {
+        m_staticChannels.insert(it, channel);
+    }
+    m_staticChannelsDirty = true;
+}
+
+namespace
+{
+
+/// Identifies a static channel cache file and its version
+const char STATIC_CHANNEL_MAGIC[8] = {'3', 'G', 'P', 'P', 'C', 'H', 'C', '2'};
+
+/// Largest number of clusters of Table 7.5-6, before the sub-clusters are added
+const uint32_t MAX_CLUSTERS = 20;
+
+/// Number of sub-clusters added for the two strongest clusters
+const uint32_t MAX_SUB_CLUSTERS = 4;
+
+/// Number of rays per cluster of Table 7.5-6
+const uint32_t MAX_RAYS = 20;
+
+/// Number of values of a non-self-blocking region, see R_INDEX
+const uint32_t BLOCKING_VALUES = 5;
+
+/**
+ * Write a trivially copyable value
+ * \param os the output stream
+ * \param value the value
+ */
+template <typename T>
+void
+WriteValue(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Read a trivially copyable value
+ * \param is the input stream
+ * \param value the value
+ */
+template <typename T>
+void
+ReadValue(std::istream& is, T& value)
+{
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+/**
+ * Write a vector of doubles
+ * \param os the output stream
+ * \param values the vector
+ */
+void
+WriteVector(std::ostream& os, const std::vector<double>& values)
+{
+    WriteValue<uint32_t>(os, values.size());
+    os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+}
+
+/**
+ * Write a nested vector of doubles
+ * \param os the output stream
+ * \param values the vector
+ */
+template <typename T>
+void
+WriteVector(std::ostream& os, const std::vector<std::vector<T>>& values)
+{
+    WriteValue<uint32_t>(os, values.size());
+    for (const auto& inner : values)
+    {
+        WriteVector(os, inner);
+    }
+}
+
+/**
+ * Read a vector of doubles. The fail bit is set if it has more than maxSize
+ * elements.
+ * \param is the input stream
+ * \param values the vector
+ * \param maxSize the largest allowed size
+ */
+void
+ReadVector(std::istream& is, std::vector<double>& values, uint32_t maxSize)
+{
+    uint32_t size = 0;
+    ReadValue(is, size);
+    if (size > maxSize)
+    {
+        is.setstate(std::ios::failbit);
+    }
+    values.resize(is ? size : 0);
+    is.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double));
+}
+
+/**
+ * Read a nested vector of doubles. The fail bit is set if a level has more
+ * elements than its largest allowed size.
+ * \param is the input stream
+ * \param values the vector
+ * \param maxSize the largest allowed size of the outer level
+ * \param innerMaxSizes the largest allowed sizes of the inner levels
+ */
+template <typename T, typename... Sizes>
+void
+ReadVector(std::istream& is,
+           std::vector<std::vector<T>>& values,
+           uint32_t maxSize,
+           Sizes... innerMaxSizes)
+{
+    uint32_t size = 0;
+    ReadValue(is, size);
+    if (size > maxSize)
+    {
+        is.setstate(std::ios::failbit);
+    }
+    values.resize(is ? size : 0);
+    for (auto& inner : values)
+    {
+        ReadVector(is, inner, innerMaxSizes...);
+    }
+}
+
+/**
+ * \param values a nested vector
+ * \param size the expected size of every inner vector
+ * \return true if all inner vectors have the size
+ */
+template <typename T>
+bool
+HaveSize(const std::vector<std::vector<T>>& values, std::size_t size)
+{
+    return std::all_of(values.begin(), values.end(), [size](const std::vector<T>& inner) {
+        return inner.size() == size;
+    });
+}
+
+/**
+ * Write a 3D vector
+ * \param os the output stream
+ * \param vector the vector
+ */
+void
+WriteVector3D(std::ostream& os, const Vector& vector)
+{
+    WriteValue(os, vector.x);
+    WriteValue(os, vector.y);
+    WriteValue(os, vector.z);
+}
+
+/**
+ * Read a 3D vector
+ * \param is the input stream
+ * \param vector the vector
+ */
+void
+ReadVector3D(std::istream& is, Vector& vector)
+{
+    ReadValue(is, vector.x);
+    ReadValue(is, vector.y);
+    ReadValue(is, vector.z);
+}
+
+} // namespace
+
+void
+ThreeGppChannelModel::WriteChannelParams(std::ostream& os,
+                                         Ptr<const ThreeGppChannelParams> params)
+{
+    WriteValue(os, params->m_nodeIds.first);
+    WriteValue(os, params->m_nodeIds.second);
+    WriteVector(os, params->m_delay);
+    WriteVector(os, params->m_angle);
+    WriteVector(os, params->m_alpha);
+    WriteVector(os, params->m_D);
+    WriteValue<uint8_t>(os, params->m_losCondition);
+    WriteValue<uint8_t>(os, params->m_o2iCondition);
+    WriteVector(os, params->m_nonSelfBlocking);
+    WriteVector3D(os, params->m_preLocUT);
+    WriteVector3D(os, params->m_locUT);
+    WriteVector(os, params->m_norRvAngles);
+    WriteValue(os, params->m_DS);
+    WriteValue(os, params->m_K_factor);
+    WriteValue(os, params->m_reducedClusterNumber);
+    WriteVector(os, params->m_rayAodRadian);
+    WriteVector(os, params->m_rayAoaRadian);
+    WriteVector(os, params->m_rayZodRadian);
+    WriteVector(os, params->m_rayZoaRadian);
+    WriteVector(os, params->m_clusterPhase);
+    WriteVector(os, params->m_crossPolarizationPowerRatios);
+    WriteVector3D(os, params->m_speed);
+    WriteValue(os, params->m_dis2D);
+    WriteValue(os, params->m_dis3D);
+    WriteVector(os, params->m_clusterPower);
+    WriteVector(os, params->m_attenuation_dB);
+    WriteValue(os, params->m_cluster1st);
+    WriteValue(os, params->m_cluster2nd);
+}
+
+Ptr<ThreeGppChannelModel::ThreeGppChannelParams>
+ThreeGppChannelModel::ReadChannelParams(std::istream& is) const
+{
+    const uint32_t maxClusters = MAX_CLUSTERS + MAX_SUB_CLUSTERS;
+    Ptr<ThreeGppChannelParams> params = Create<ThreeGppChannelParams>();
+    params->m_generatedTime = Simulator::Now();
+    ReadValue(is, params->m_nodeIds.first);
+    ReadValue(is, params->m_nodeIds.second);
+    ReadVector(is, params->m_delay, maxClusters);
+    ReadVector(is, params->m_angle, 4, maxClusters);
+    ReadVector(is, params->m_alpha, maxClusters);
+    ReadVector(is, params->m_D, maxClusters);
+    uint8_t condition = 0;
+    ReadValue(is, condition);
+    params->m_losCondition = static_cast<ChannelCondition::LosConditionValue>(condition);
+    ReadValue(is, condition);
+    params->m_o2iCondition = static_cast<ChannelCondition::O2iConditionValue>(condition);
+    ReadVector(is, params->m_nonSelfBlocking, m_numNonSelfBlocking, BLOCKING_VALUES);
+    ReadVector3D(is, params->m_preLocUT);
+    ReadVector3D(is, params->m_locUT);
+    ReadVector(is, params->m_norRvAngles, maxClusters, 4);
+    ReadValue(is, params->m_DS);
+    ReadValue(is, params->m_K_factor);
+    ReadValue(is, params->m_reducedClusterNumber);
+    ReadVector(is, params->m_rayAodRadian, MAX_CLUSTERS, MAX_RAYS);
+    ReadVector(is, params->m_rayAoaRadian, MAX_CLUSTERS, MAX_RAYS);
+    ReadVector(is, params->m_rayZodRadian, MAX_CLUSTERS, MAX_RAYS);
+    ReadVector(is, params->m_rayZoaRadian, MAX_CLUSTERS, MAX_RAYS);
+    ReadVector(is, params->m_clusterPhase, MAX_CLUSTERS, MAX_RAYS, 4);
+    ReadVector(is, params->m_crossPolarizationPowerRatios, MAX_CLUSTERS, MAX_RAYS);
+    ReadVector3D(is, params->m_speed);
+    ReadValue(is, params->m_dis2D);
+    ReadValue(is, params->m_dis3D);
+    ReadVector(is, params->m_clusterPower, MAX_CLUSTERS);
+    ReadVector(is, params->m_attenuation_dB, MAX_CLUSTERS);
+    ReadValue(is, params->m_cluster1st);
+    ReadValue(is, params->m_cluster2nd);
+    if (!is)
+    {
+        return params;
+    }
+
+    // the dimensions GenerateChannelParameters gives to the vectors
+    uint32_t numClusters = params->m_reducedClusterNumber;
+    uint32_t numRays =
+        params->m_rayAodRadian.empty() ? 0 : params->m_rayAodRadian.front().size();
+    uint32_t numDopplerTerms = numClusters == 1 ? numClusters + 2 : numClusters + 4;
+    bool valid = numClusters >= 1 && numClusters <= MAX_CLUSTERS &&
+                 params->m_delay.size() >= numClusters &&
+                 params->m_delay.size() <= numClusters + MAX_SUB_CLUSTERS &&
+                 params->m_angle.size() == 4 && HaveSize(params->m_angle, params->m_delay.size()) &&
+                 params->m_alpha.size() == numDopplerTerms &&
+                 params->m_D.size() == numDopplerTerms &&
+                 HaveSize(params->m_nonSelfBlocking, BLOCKING_VALUES) &&
+                 params->m_clusterPower.size() == numClusters &&
+                 (params->m_attenuation_dB.size() == 1 ||
+                  params->m_attenuation_dB.size() == numClusters) &&
+                 params->m_cluster1st < numClusters && params->m_cluster2nd < numClusters;
+    for (const auto& rays : {&params->m_rayAodRadian,
+                             &params->m_rayAoaRadian,
+                             &params->m_rayZodRadian,
+                             &params->m_rayZoaRadian,
+                             &params->m_crossPolarizationPowerRatios})
+    {
+        valid = valid && rays->size() == numClusters && HaveSize(*rays, numRays);
+    }
+    valid = valid && params->m_clusterPhase.size() == numClusters &&
+            HaveSize(params->m_clusterPhase, numRays);
+    for (const auto& phases : params->m_clusterPhase)
+    {
+        valid = valid && HaveSize(phases, 4);
+    }
+    if (!valid)
+    {
+        is.setstate(std::ios::failbit);
+    }
+    return params;
+}
+
+void
+ThreeGppChannelModel::LoadStaticChannels()
+{
+    NS_LOG_FUNCTION(this << m_staticChannelCacheFile);
+    m_staticChannelsLoaded = true;
+    if (m_staticChannelCacheFile.empty())
+    {
+        return;
+    }
+    std::ifstream file(m_staticChannelCacheFile, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        NS_LOG_INFO("no static channel cache file " << m_staticChannelCacheFile);
+        return;
+    }
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+    char magic[sizeof(STATIC_CHANNEL_MAGIC)];
+    uint64_t scenarioHash = 0;
+    uint32_t numChannels = 0;
+    file.read(magic, sizeof(magic));
+    ReadValue(file, scenarioHash);
+    ReadValue(file, numChannels);
+    if (!file || !std::equal(magic, magic + sizeof(magic), STATIC_CHANNEL_MAGIC) ||
+        scenarioHash != GetStaticChannelScenarioHash())
+    {
+        NS_LOG_WARN("static channel cache file " << m_staticChannelCacheFile
+                                                 << " ignored, it belongs to another scenario");
+        return;
+    }
+
+    std::vector<StaticChannel> channels;
+    // channel parameters shared by several antenna pairs are written once
+    std::vector<Ptr<ThreeGppChannelParams>> params;
+    for (uint32_t i = 0; i < numChannels && file; ++i)
+    {
+        StaticChannel channel;
+        uint32_t paramsIndex = 0;
+        ReadValue(file, channel.m_fingerprint);
+        ReadValue(file, paramsIndex);
+        if (paramsIndex == params.size())
+        {
+            params.push_back(ReadChannelParams(file));
+        }
+        if (paramsIndex >= params.size())
+        {
+            file.setstate(std::ios::failbit);
+            break;
+        }
+        channel.m_params = params[paramsIndex];
+
+        channel.m_matrix = Create<ChannelMatrix>();
+        channel.m_matrix->m_generatedTime = Simulator::Now();
+        ReadValue(file, channel.m_matrix->m_nodeIds.first);
+        ReadValue(file, channel.m_matrix->m_nodeIds.second);
+        ReadValue(file, channel.m_matrix->m_antennaPair.first);
+        ReadValue(file, channel.m_matrix->m_antennaPair.second);
+        uint16_t numRows = 0;
+        uint16_t numCols = 0;
+        uint16_t numPages = 0;
+        ReadValue(file, numRows);
+        ReadValue(file, numCols);
+        ReadValue(file, numPages);
+        // a page per cluster, and the file has to hold all the values
+        uint64_t matrixBytes =
+            uint64_t(numRows) * numCols * numPages * sizeof(std::complex<double>);
+        if (!file || numPages != channel.m_params->m_delay.size() ||
+            matrixBytes > uint64_t(fileSize - file.tellg()))
+        {
+            file.setstate(std::ios::failbit);
+            break;
+        }
+        channel.m_matrix->m_channel = Complex3DVector(numRows, numCols, numPages);
+        if (channel.m_matrix->m_channel.GetSize() > 0)
+        {
+            file.read(reinterpret_cast<char*>(channel.m_matrix->m_channel.GetPagePtr(0)),
+                      channel.m_matrix->m_channel.GetSize() * sizeof(std::complex<double>));
+        }
+        channels.push_back(channel);
+    }
+    if (!file)
+    {
+        // the channels are generated again and the file is overwritten
+        NS_LOG_WARN("static channel cache file " << m_staticChannelCacheFile
+                                                 << " ignored, it is corrupt");
+        return;
+    }
+
+    std::sort(channels.begin(), channels.end(), [](const StaticChannel& a, const StaticChannel& b) {
+        return a.m_fingerprint < b.m_fingerprint;
+    });
+    m_staticChannels.swap(channels);
+    m_staticChannelsDirty = false;
+    NS_LOG_INFO("read " << m_staticChannels.size() << " static channels from "
+                        << m_staticChannelCacheFile);
+}
+
+void
+ThreeGppChannelModel::SaveStaticChannels() const
+{
+    NS_LOG_FUNCTION(this << m_staticChannelCacheFile << m_staticChannels.size());
+    std::ofstream file(m_staticChannelCacheFile, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        NS_LOG_WARN("cannot write the static channel cache file " << m_staticChannelCacheFile);
+        return;
+    }
+    file.write(STATIC_CHANNEL_MAGIC, sizeof(STATIC_CHANNEL_MAGIC));
+    WriteValue(file, GetStaticChannelScenarioHash());
+    WriteValue<uint32_t>(file, m_staticChannels.size());
+
+    std::unordered_map<const ThreeGppChannelParams*, uint32_t> paramsIndex;
+    for (const auto& channel : m_staticChannels)
+    {
+        WriteValue(file, channel.m_fingerprint);
+        auto it = paramsIndex.find(PeekPointer(channel.m_params));
+        if (it != paramsIndex.end())
+        {
+            WriteValue(file, it->second);
+        }
+        else
+        {
+            uint32_t index = paramsIndex.size();
+            paramsIndex[PeekPointer(channel.m_params)] = index;
+            WriteValue(file, index);
+            WriteChannelParams(file, channel.m_params);
+        }
+
+        const Complex3DVector& matrix = channel.m_matrix->m_channel;
+        WriteValue(file, channel.m_matrix->m_nodeIds.first);
+        WriteValue(file, channel.m_matrix->m_nodeIds.second);
+        WriteValue(file, channel.m_matrix->m_antennaPair.first);
+        WriteValue(file, channel.m_matrix->m_antennaPair.second);
+        WriteValue(file, matrix.GetNumRows());
+        WriteValue(file, matrix.GetNumCols());
+        WriteValue(file, matrix.GetNumPages());
+        if (matrix.GetSize() > 0)
+        {
+            file.write(reinterpret_cast<const char*>(matrix.GetPagePtr(0)),
+                       matrix.GetSize() * sizeof(std::complex<double>));
+        }
+    }
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelParams>
 ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const MobilityModel> bMob) const
 {
@@ -27,6 +27,7 @@
 #include <ns3/matrix-based-channel-model.h>
 
 #include <complex.h>
+#include <iostream>
 #include <unordered_map>
 
 namespace ns3
@@ -136,6 +137,11 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      */
     int64_t AssignStreams(int64_t stream);
 
+    /**
+     * \return the number of channels of static node pairs in the static channel table
+     */
+    std::size_t GetNStaticChannels() const;
+
   protected:
     /**
      * Wrap an (azimuth, inclination) angle pair in a valid range.
@@ -334,6 +340,75 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     bool ChannelMatrixNeedsUpdate(Ptr<const ThreeGppChannelParams> channelParams,
                                   Ptr<const ChannelMatrix> channelMatrix);
 
+    /**
+     * Channel of a pair of static nodes and antennas, which is never updated
+     */
+    struct StaticChannel
+    {
+        uint64_t m_fingerprint;                  //!< see GetStaticChannelFingerprint
+        Ptr<ThreeGppChannelParams> m_params;     //!< the channel parameters of the node pair
+        Ptr<ChannelMatrix> m_matrix;             //!< the channel matrix of the antenna pair
+    };
+
+    /**
+     * Compute the key of a static channel in m_staticChannels, from the node
+     * IDs, the positions and the antennas, including the attributes of the
+     * antennas and of their elements. It does not depend on the order of a and b.
+     * \param aMob mobility model of the a device
+     * \param bMob mobility model of the b device
+     * \param aAntenna antenna of the a device
+     * \param bAntenna antenna of the b device
+     * \return the fingerprint
+     */
+    static uint64_t GetStaticChannelFingerprint(Ptr<const MobilityModel> aMob,
+                                                Ptr<const MobilityModel> bMob,
+                                                Ptr<const PhasedArrayModel> aAntenna,
+                                                Ptr<const PhasedArrayModel> bAntenna);
+
+    /**
+     * \return the hash of the attributes and random streams the channels depend on,
+     * which has to match the one of a static channel cache file
+     */
+    uint64_t GetStaticChannelScenarioHash() const;
+
+    /**
+     * \param fingerprint the fingerprint of the static channel
+     * \return the static channel, or nullptr if it is not in m_staticChannels
+     */
+    const StaticChannel* FindStaticChannel(uint64_t fingerprint) const;
+
+    /**
+     * Insert or replace a static channel in m_staticChannels
+     * \param channel the static channel
+     */
+    void StoreStaticChannel(const StaticChannel& channel);
+
+    /**
+     * Read the static channels from m_staticChannelCacheFile, if it exists and
+     * was written for the same scenario
+     */
+    void LoadStaticChannels();
+
+    /**
+     * Write m_staticChannels to m_staticChannelCacheFile
+     */
+    void SaveStaticChannels() const;
+
+    /**
+     * Write the channel parameters of a static channel
+     * \param os the output stream
+     * \param params the channel parameters
+     */
+    static void WriteChannelParams(std::ostream& os, Ptr<const ThreeGppChannelParams> params);
+
+    /**
+     * Read the channel parameters of a static channel. The fail bit of the
+     * stream is set if their dimensions do not fit together.
+     * \param is the input stream
+     * \return the channel parameters
+     */
+    Ptr<ThreeGppChannelParams> ReadChannelParams(std::istream& is) const;
+
     std::unordered_map<uint64_t, Ptr<ChannelMatrix>>
         m_channelMatrixMap; //!< map containing the channel realizations per pair of
                             //!< PhasedAntennaArray instances, the key of this map is reciprocal
@@ -343,6 +418,11 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                             //!< key of this map is reciprocal and uniquely identifies a pair of
                             //!< nodes
     Time m_updatePeriod;    //!< the channel update period
+    bool m_staticNodes;     //!< never update the channels of pairs of nodes without velocity
+    std::string m_staticChannelCacheFile; //!< file to reuse the static channels across runs
+    std::vector<StaticChannel> m_staticChannels; //!< static channels sorted by fingerprint
+    bool m_staticChannelsLoaded; //!< true if m_staticChannelCacheFile was read
+    bool m_staticChannelsDirty;  //!< true if static channels were generated since the file was read
     double m_frequency;     //!< the operating frequency
     std::string m_scenario; //!< the 3GPP scenario
     Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2022 Communication Networks Institute at TU Dortmund University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/core-module.h>
+#include <ns3/spectrum-module.h>
+#include <ns3/test.h>
+
+NS_LOG_COMPONENT_DEFINE("MultiModelSpectrumChannelTest");
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief SpectrumPhy which records the received PSDs
+ */
+class ChannelTestSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * \param rxSpectrumModel the Rx spectrum model
+     * \param mobility the mobility model
+     */
+    ChannelTestSpectrumPhy(Ptr<const SpectrumModel> rxSpectrumModel, Ptr<MobilityModel> mobility)
+        : m_rxSpectrumModel(rxSpectrumModel),
+          m_mobility(mobility)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice>) override
+    {
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return nullptr;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel>) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxSpectrumModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return nullptr;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        m_rxPsds.emplace_back(params->psd->ConstValuesBegin(), params->psd->ConstValuesEnd());
+    }
+
+    std::vector<std::vector<double>> m_rxPsds; //!< values of the received PSDs
+
+  private:
+    Ptr<const SpectrumModel> m_rxSpectrumModel; //!< Rx spectrum model
+    Ptr<MobilityModel> m_mobility;              //!< mobility model
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Receiver culling of the MultiModelSpectrumChannel
+ *
+ * A transmitter at the origin sends twice, at 0 s and at 10 s. The receivers
+ * are static or moving, and one of them only overlaps with the part of the band
+ * in which nothing is transmitted. The number of received signals of every
+ * receiver is compared with the expected one for the given MaxRxDistance and
+ * RxPowerFloorDbm.
+ */
+class SpectrumChannelCullingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param maxRxDistance the MaxRxDistance of the channel
+     * \param rxPowerFloorDbm the RxPowerFloorDbm of the channel
+     * \param expected the expected receptions of the receivers at 50 m, 100 m, 200 m,
+     *        the moving one, the one moved at 5 s and the one without power in its band
+     */
+    SpectrumChannelCullingTestCase(double maxRxDistance,
+                                   double rxPowerFloorDbm,
+                                   std::vector<uint32_t> expected);
+
+  private:
+    void DoRun() override;
+
+    double m_maxRxDistance;          //!< MaxRxDistance of the channel
+    double m_rxPowerFloorDbm;        //!< RxPowerFloorDbm of the channel
+    std::vector<uint32_t> m_expected; //!< expected receptions
+};
+
+SpectrumChannelCullingTestCase::SpectrumChannelCullingTestCase(double maxRxDistance,
+                                                               double rxPowerFloorDbm,
+                                                               std::vector<uint32_t> expected)
+    : TestCase("MaxRxDistance " + std::to_string(maxRxDistance) + " m, RxPowerFloorDbm " +
+               std::to_string(rxPowerFloorDbm) + " dBm"),
+      m_maxRxDistance(maxRxDistance),
+      m_rxPowerFloorDbm(rxPowerFloorDbm),
+      m_expected(expected)
+{
+}
+
+void
+SpectrumChannelCullingTestCase::DoRun()
+{
+    Bands bands;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        BandInfo band;
+        band.fl = 2e9 + i * 180e3;
+        band.fc = band.fl + 90e3;
+        band.fh = band.fl + 180e3;
+        bands.push_back(band);
+    }
+    Ptr<SpectrumModel> txModel = Create<SpectrumModel>(bands);
+    // overlaps only with the upper half of the band, in which nothing is transmitted
+    Ptr<SpectrumModel> upperModel = Create<SpectrumModel>(Bands(bands.begin() + 5, bands.end()));
+
+    Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+    Ptr<FriisPropagationLossModel> loss = CreateObject<FriisPropagationLossModel>();
+    loss->SetFrequency(2e9);
+    channel->AddPropagationLossModel(loss);
+    channel->SetAttribute("MaxRxDistance", DoubleValue(m_maxRxDistance));
+    channel->SetAttribute("RxPowerFloorDbm", DoubleValue(m_rxPowerFloorDbm));
+
+    auto createPhy = [&](Ptr<const SpectrumModel> model, Ptr<MobilityModel> mobility) {
+        Ptr<ChannelTestSpectrumPhy> phy = CreateObject<ChannelTestSpectrumPhy>(model, mobility);
+        channel->AddRx(phy);
+        return phy;
+    };
+    auto staticMobility = [](double x) {
+        Ptr<ConstantPositionMobilityModel> mobility =
+            CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(x, 0, 0));
+        return mobility;
+    };
+
+    Ptr<ChannelTestSpectrumPhy> txPhy = createPhy(txModel, staticMobility(0));
+    std::vector<Ptr<ChannelTestSpectrumPhy>> rxPhys;
+    rxPhys.push_back(createPhy(txModel, staticMobility(50)));
+    rxPhys.push_back(createPhy(txModel, staticMobility(100)));
+    rxPhys.push_back(createPhy(txModel, staticMobility(200)));
+    // at 1000 m at the first and at 100 m at the second transmission
+    Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel>();
+    moving->SetPosition(Vector(1000, 0, 0));
+    moving->SetVelocity(Vector(-90, 0, 0));
+    rxPhys.push_back(createPhy(txModel, moving));
+    Ptr<ConstantPositionMobilityModel> moved = staticMobility(1000);
+    rxPhys.push_back(createPhy(txModel, moved));
+    rxPhys.push_back(createPhy(upperModel, staticMobility(10)));
+
+    Ptr<SpectrumValue> psd = Create<SpectrumValue>(txModel);
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        (*psd)[i] = 1e-9; // -0.46 dBm in the lower half of the band
+    }
+    auto transmit = [&]() {
+        Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+        params->psd = psd;
+        params->txPhy = txPhy;
+        params->duration = MilliSeconds(1);
+        channel->StartTx(params);
+    };
+    Simulator::Schedule(Seconds(0), transmit);
+    Simulator::Schedule(Seconds(5), [&]() { moved->SetPosition(Vector(120, 0, 0)); });
+    Simulator::Schedule(Seconds(10), transmit);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(txPhy->m_rxPsds.size(), 0, "The transmitter received its own signal");
+    for (uint32_t i = 0; i < rxPhys.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(rxPhys[i]->m_rxPsds.size(),
+                              m_expected[i],
+                              "Wrong number of signals at receiver " << i);
+    }
+    channel->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Receiver culling of the MultiModelSpectrumChannel TestSuite
+ */
+class SpectrumChannelCullingTestSuite : public TestSuite
+{
+  public:
+    SpectrumChannelCullingTestSuite();
+};
+
+SpectrumChannelCullingTestSuite::SpectrumChannelCullingTestSuite()
+    : TestSuite("spectrum-channel-culling", UNIT)
+{
+    double inf = std::numeric_limits<double>::infinity();
+    // receivers: 50 m, 100 m, 200 m, moving (1000 m, 100 m), moved (1000 m, 120 m), empty band
+    AddTestCase(new SpectrumChannelCullingTestCase(inf, -inf, {2, 2, 2, 2, 2, 2}),
+                TestCase::QUICK);
+    AddTestCase(new SpectrumChannelCullingTestCase(150, -inf, {2, 2, 0, 1, 1, 2}),
+                TestCase::QUICK);
+    // Friis at 2 GHz: -72.9 dBm at 50 m, -78.9 dBm at 100 m
+    AddTestCase(new SpectrumChannelCullingTestCase(inf, -75, {2, 0, 0, 0, 0, 0}),
+                TestCase::QUICK);
+    AddTestCase(new SpectrumChannelCullingTestCase(150, -100, {2, 2, 0, 1, 1, 0}),
+                TestCase::QUICK);
+    // the grid cells of the receivers lie beyond the range of the cell key
+    AddTestCase(new SpectrumChannelCullingTestCase(1e-12, -inf, {0, 0, 0, 0, 0, 0}),
+                TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelCullingTestSuite g_spectrumChannelCullingTestSuite;
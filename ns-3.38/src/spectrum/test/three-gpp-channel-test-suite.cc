@@ -17,6 +17,7 @@
 
 #include "ns3/abort.h"
 #include "ns3/angles.h"
+#include "ns3/boolean.h"
 #include "ns3/channel-condition-model.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
@@ -36,6 +37,9 @@
 #include "ns3/uniform-planar-array.h"
 #include "ns3/wifi-spectrum-value-helper.h"
 
+#include <fstream>
+#include <limits>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("ThreeGppChannelTestSuite");
@@ -682,6 +686,130 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the static channels of the ThreeGppChannelModel class.
+ * 1) checks that the channel of static nodes is not updated after the update period
+ * 2) checks that the static channels are read from the cache file in a second
+ *    run of the same scenario
+ * 3) checks that a cached channel is not used after an antenna has been rotated
+ * 4) checks that a cache file with a wrong vector size is ignored
+ */
+class ThreeGppStaticChannelTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppStaticChannelTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+};
+
+ThreeGppStaticChannelTest::ThreeGppStaticChannelTest()
+    : TestCase("Check the static channels and their cache file")
+{
+}
+
+void
+ThreeGppStaticChannelTest::DoRun()
+{
+    std::string cacheFile = CreateTempDirFilename("static-channels.bin");
+
+    // a transmitter and two receivers, none of them moves
+    NodeContainer nodes;
+    nodes.Create(3);
+    std::vector<Ptr<MobilityModel>> mobility;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(i == 0 ? Vector(0.0, 0.0, 25.0) : Vector(100.0, 50.0 * i, 1.5));
+        nodes.Get(i)->AggregateObject(mob);
+        mobility.push_back(mob);
+        antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(2),
+            "NumRows",
+            UintegerValue(2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>())));
+    }
+
+    auto createChannelModel = [cacheFile]() {
+        Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+        channelModel->SetAttribute("Frequency", DoubleValue(3.5e9));
+        channelModel->SetAttribute("Scenario", StringValue("UMa"));
+        channelModel->SetAttribute("ChannelConditionModel",
+                                   PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+        channelModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(1)));
+        channelModel->SetAttribute("StaticNodes", BooleanValue(true));
+        channelModel->SetAttribute("StaticChannelCacheFile", StringValue(cacheFile));
+        channelModel->AssignStreams(1);
+        return channelModel;
+    };
+
+    // first run, the channels are generated and written to the cache file at the end
+    Ptr<ThreeGppChannelModel> first = createChannelModel();
+    Ptr<const ThreeGppChannelModel::ChannelMatrix> channel;
+    Simulator::Schedule(MilliSeconds(1), [&]() {
+        channel = first->GetChannel(mobility[0], mobility[1], antennas[0], antennas[1]);
+        first->GetChannel(mobility[0], mobility[2], antennas[0], antennas[2]);
+    });
+    Simulator::Schedule(MilliSeconds(10), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(first->GetChannel(mobility[1], mobility[0], antennas[1], antennas[0]),
+                              channel,
+                              "The channel of static nodes has been updated");
+    });
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(first->GetNStaticChannels(), 2, "Wrong number of static channels");
+    first->Dispose();
+    Simulator::Destroy();
+
+    // second run, the channels are read from the cache file, including the one not requested
+    Ptr<ThreeGppChannelModel> second = createChannelModel();
+    Ptr<const ThreeGppChannelModel::ChannelMatrix> cached =
+        second->GetChannel(mobility[0], mobility[1], antennas[0], antennas[1]);
+    NS_TEST_ASSERT_MSG_EQ(second->GetNStaticChannels(), 2, "Static channels not read from file");
+    NS_TEST_ASSERT_MSG_EQ((cached->m_channel == channel->m_channel),
+                          true,
+                          "The cached channel differs from the generated one");
+    NS_TEST_ASSERT_MSG_EQ((cached->m_antennaPair == channel->m_antennaPair),
+                          true,
+                          "Wrong antenna pair of the cached channel");
+    second->Dispose();
+    Simulator::Destroy();
+
+    // third run, the rotated antenna needs a new channel
+    antennas[1]->SetAttribute("BearingAngle", DoubleValue(M_PI / 3));
+    Ptr<ThreeGppChannelModel> third = createChannelModel();
+    third->GetChannel(mobility[0], mobility[1], antennas[0], antennas[1]);
+    NS_TEST_ASSERT_MSG_EQ(third->GetNStaticChannels(),
+                          3,
+                          "Cached channel used for a rotated antenna");
+    third->Dispose();
+    Simulator::Destroy();
+
+    // fourth run, the number of delays of the first channel is too large
+    {
+        std::fstream file(cacheFile, std::ios::in | std::ios::out | std::ios::binary);
+        // magic, scenario hash, number of channels, fingerprint, parameters index, node IDs
+        file.seekp(8 + 8 + 4 + 8 + 4 + 2 * 4);
+        uint32_t numDelays = std::numeric_limits<uint32_t>::max();
+        file.write(reinterpret_cast<const char*>(&numDelays), sizeof(numDelays));
+    }
+    Ptr<ThreeGppChannelModel> fourth = createChannelModel();
+    fourth->GetChannel(mobility[0], mobility[1], antennas[0], antennas[1]);
+    NS_TEST_ASSERT_MSG_EQ(fourth->GetNStaticChannels(), 1, "Corrupt cache file not ignored");
+    fourth->Dispose();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -702,6 +830,7 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+    AddTestCase(new ThreeGppStaticChannelTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization